@@ -0,0 +1,209 @@
+#include "pch.h"
+#include "DirectoryChangeBackend.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    class DirectoryChangeBackend : public SettingsWatcher::Backend
+    {
+        struct DirectoryWatch
+        {
+            std::filesystem::path directory;
+            HANDLE handle = INVALID_HANDLE_VALUE;
+            HANDLE event = nullptr;
+            OVERLAPPED overlapped{};
+            // FILE_NOTIFY_INFORMATION entries must be DWORD-aligned
+            std::vector<DWORD> buffer = std::vector<DWORD>(4096);
+
+            ~DirectoryWatch()
+            {
+                if (handle != INVALID_HANDLE_VALUE)
+                {
+                    CancelIoEx(handle, &overlapped);
+                    DWORD transferred = 0;
+                    GetOverlappedResult(handle, &overlapped, &transferred, TRUE);
+                    CloseHandle(handle);
+                }
+
+                if (event)
+                {
+                    CloseHandle(event);
+                }
+            }
+
+            bool Read()
+            {
+                ResetEvent(event);
+                overlapped = {};
+                overlapped.hEvent = event;
+                return ReadDirectoryChangesW(handle,
+                                             buffer.data(),
+                                             static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                                             FALSE,
+                                             FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                                             nullptr,
+                                             &overlapped,
+                                             nullptr);
+            }
+        };
+
+    public:
+        DirectoryChangeBackend()
+        {
+            m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        }
+
+        ~DirectoryChangeBackend()
+        {
+            m_watches.clear();
+            if (m_wakeEvent)
+            {
+                CloseHandle(m_wakeEvent);
+            }
+        }
+
+        bool WatchDirectory(const std::filesystem::path& directory) override
+        {
+            auto watch = std::make_unique<DirectoryWatch>();
+            watch->directory = directory;
+            watch->handle = CreateFileW(directory.c_str(),
+                                        FILE_LIST_DIRECTORY,
+                                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                        nullptr,
+                                        OPEN_EXISTING,
+                                        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                                        nullptr);
+            watch->event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            if (watch->handle == INVALID_HANDLE_VALUE || !watch->event || !watch->Read())
+            {
+                return false;
+            }
+
+            {
+                std::unique_lock lock{ m_mutex };
+                m_added.push_back(std::move(watch));
+            }
+            Wake();
+            return true;
+        }
+
+        void UnwatchDirectory(const std::filesystem::path& directory) override
+        {
+            // Handles can't be closed while the notification thread waits on them, so it does the cleanup
+            {
+                std::unique_lock lock{ m_mutex };
+                m_removed.push_back(directory);
+            }
+            Wake();
+        }
+
+        bool Wait(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changes, std::vector<std::filesystem::path>& lost) override
+        {
+            ApplyPendingChanges();
+
+            std::vector<HANDLE> handles{ m_wakeEvent };
+            for (const auto& watch : m_watches)
+            {
+                // WaitForMultipleObjects is limited to MAXIMUM_WAIT_OBJECTS handles, settings live in a handful of folders
+                if (handles.size() == MAXIMUM_WAIT_OBJECTS)
+                {
+                    break;
+                }
+                handles.push_back(watch->event);
+            }
+
+            const DWORD waitTimeout = timeout == SettingsWatcher::Infinite ? INFINITE : static_cast<DWORD>(std::min<long long>(timeout.count(), INFINITE - 1));
+            const DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, waitTimeout);
+            if (m_stopped)
+            {
+                return false;
+            }
+
+            if (result == WAIT_TIMEOUT || result == WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + handles.size())
+            {
+                return true;
+            }
+
+            const auto index = result - WAIT_OBJECT_0 - 1;
+            auto& watch = m_watches[index];
+            DWORD transferred = 0;
+            if (!GetOverlappedResult(watch->handle, &watch->overlapped, &transferred, FALSE) || transferred == 0)
+            {
+                // The buffer overflowed, report the whole directory as changed
+                changes.push_back(watch->directory);
+            }
+            else
+            {
+                auto data = reinterpret_cast<const BYTE*>(watch->buffer.data());
+                while (true)
+                {
+                    auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data);
+                    changes.push_back(watch->directory / std::wstring_view{ info->FileName, info->FileNameLength / sizeof(wchar_t) });
+                    if (!info->NextEntryOffset)
+                    {
+                        break;
+                    }
+                    data += info->NextEntryOffset;
+                }
+            }
+
+            if (!watch->Read())
+            {
+                // Usually the directory was deleted, the watcher retries it like one that didn't exist yet
+                lost.push_back(watch->directory);
+                m_watches.erase(m_watches.begin() + index);
+            }
+
+            return true;
+        }
+
+        void Wake() override
+        {
+            SetEvent(m_wakeEvent);
+        }
+
+        void Stop() override
+        {
+            m_stopped = true;
+            Wake();
+        }
+
+    private:
+        void ApplyPendingChanges()
+        {
+            std::unique_lock lock{ m_mutex };
+            for (auto& watch : m_added)
+            {
+                m_watches.push_back(std::move(watch));
+            }
+            m_added.clear();
+
+            for (const auto& directory : m_removed)
+            {
+                auto it = std::find_if(m_watches.begin(), m_watches.end(), [&](const auto& watch) { return watch->directory == directory; });
+                if (it != m_watches.end())
+                {
+                    m_watches.erase(it);
+                }
+            }
+            m_removed.clear();
+        }
+
+        HANDLE m_wakeEvent = nullptr;
+        std::atomic_bool m_stopped = false;
+
+        // Only used by the notification thread
+        std::vector<std::unique_ptr<DirectoryWatch>> m_watches;
+
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<DirectoryWatch>> m_added;
+        std::vector<std::filesystem::path> m_removed;
+    };
+}
+
+std::unique_ptr<SettingsWatcher::Backend> CreateDirectoryChangeBackend()
+{
+    return std::make_unique<DirectoryChangeBackend>();
+}
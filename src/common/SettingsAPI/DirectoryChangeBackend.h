@@ -0,0 +1,6 @@
+#pragma once
+
+#include "SettingsWatcher.h"
+
+// SettingsWatcher backend built on ReadDirectoryChangesW.
+std::unique_ptr<SettingsWatcher::Backend> CreateDirectoryChangeBackend();
@@ -4,23 +4,21 @@
 #define NOMINMAX
 #include <Windows.h>
 
-#include <thread>
-#include <optional>
+#include <memory>
 #include <string>
 #include <functional>
 
+#include "SettingsWatcher.h"
+
+// Calls 'callback' when the file at 'path' changes. All watchers in the process share
+// one SettingsWatcher, so no thread polls the file.
 class FileWatcher
 {
-    DWORD m_refreshPeriod;
-    std::wstring m_path;
-    std::optional<FILETIME> m_lastWrite;
-    std::function<void()> m_callback;
-    HANDLE m_abortEvent;
-    std::thread m_thread;
-    
-    std::optional<FILETIME> MyFileTime();
-    void Run();
+    std::shared_ptr<SettingsWatcher> m_watcher;
+    SettingsWatcher::Registration m_registration = 0;
+
 public:
+    // refreshPeriod is kept for source compatibility, changes are reported by the file system.
     FileWatcher(const std::wstring& path, std::function<void()> callback, DWORD refreshPeriod = 1000);
     ~FileWatcher();
 };
@@ -0,0 +1,261 @@
+#include "pch.h"
+#include "SettingsWatcher.h"
+#include "DirectoryChangeBackend.h"
+
+#include <algorithm>
+#include <cwctype>
+
+#include <common/logger/logger.h>
+
+SettingsWatcher::SettingsWatcher(std::unique_ptr<Backend> backend, std::chrono::milliseconds debounce, std::chrono::milliseconds retryInterval) :
+    m_backend(std::move(backend)),
+    m_debounce(debounce),
+    m_retryInterval(retryInterval)
+{
+    m_notificationThread = std::thread([this]() { NotificationThread(); });
+    m_executorThread = std::thread([this]() { ExecutorThread(); });
+}
+
+SettingsWatcher::~SettingsWatcher()
+{
+    {
+        std::unique_lock lock{ m_mutex };
+        m_stopped = true;
+    }
+
+    m_backend->Stop();
+    m_executorCv.notify_all();
+    m_notificationThread.join();
+    m_executorThread.join();
+}
+
+std::shared_ptr<SettingsWatcher> SettingsWatcher::Acquire()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<SettingsWatcher> current;
+
+    std::unique_lock lock{ mutex };
+    auto watcher = current.lock();
+    if (!watcher)
+    {
+        watcher = std::make_shared<SettingsWatcher>(CreateDirectoryChangeBackend());
+        current = watcher;
+    }
+
+    return watcher;
+}
+
+std::wstring SettingsWatcher::MakeKey(const std::filesystem::path& path)
+{
+    // Settings paths are compared case-insensitively, like the file system does
+    auto key = path.lexically_normal().wstring();
+    std::transform(key.begin(), key.end(), key.begin(), [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+    return key;
+}
+
+SettingsWatcher::Registration SettingsWatcher::Watch(const std::filesystem::path& path, Callback callback)
+{
+    auto directory = path.parent_path();
+
+    std::unique_lock lock{ m_mutex };
+    const auto directoryKey = MakeKey(directory);
+    if (m_directories[directoryKey]++ == 0 && !m_backend->WatchDirectory(directory))
+    {
+        // Usually a module whose settings haven't been saved yet, the notification thread keeps trying
+        RetryLater(directoryKey, directory, std::chrono::steady_clock::now());
+        m_backend->Wake();
+    }
+
+    const auto registration = ++m_lastRegistration;
+    m_watched.emplace(registration, Watched{ MakeKey(path), std::move(directory), std::move(callback) });
+    return registration;
+}
+
+void SettingsWatcher::Unwatch(Registration registration)
+{
+    std::unique_lock lock{ m_mutex };
+    auto it = m_watched.find(registration);
+    if (it == m_watched.end())
+    {
+        return;
+    }
+
+    const auto directoryKey = MakeKey(it->second.directory);
+    if (--m_directories[directoryKey] == 0)
+    {
+        m_directories.erase(directoryKey);
+        if (m_unwatchedDirectories.erase(directoryKey) == 0)
+        {
+            m_backend->UnwatchDirectory(it->second.directory);
+        }
+    }
+    m_watched.erase(it);
+
+    // A callback may unwatch itself, waiting for it to finish would never end
+    if (std::this_thread::get_id() != m_executorThread.get_id())
+    {
+        m_executorCv.wait(lock, [&] { return m_running != registration; });
+    }
+}
+
+void SettingsWatcher::NotificationThread()
+{
+    std::vector<std::filesystem::path> changes;
+    std::vector<std::filesystem::path> lost;
+    auto timeout = Infinite;
+    while (m_backend->Wait(timeout, changes, lost))
+    {
+        const auto now = std::chrono::steady_clock::now();
+
+        std::unique_lock lock{ m_mutex };
+        for (const auto& change : changes)
+        {
+            OnChange(change, now);
+        }
+        changes.clear();
+
+        for (const auto& directory : lost)
+        {
+            // Skipped if its files were unwatched meanwhile
+            const auto directoryKey = MakeKey(directory);
+            if (m_directories.contains(directoryKey))
+            {
+                Logger::warn(L"Stopped watching {}, retrying until it can be watched again", directory.wstring());
+                RetryLater(directoryKey, directory, now);
+            }
+        }
+        lost.clear();
+
+        // Nothing pending means no timeout, so an idle watcher never wakes up
+        timeout = std::min(DispatchDue(now), RetryUnwatched(now));
+    }
+}
+
+std::chrono::milliseconds SettingsWatcher::RetryUnwatched(std::chrono::steady_clock::time_point now)
+{
+    if (m_unwatchedDirectories.empty())
+    {
+        return Infinite;
+    }
+
+    if (now < m_nextRetry)
+    {
+        return std::chrono::ceil<std::chrono::milliseconds>(m_nextRetry - now);
+    }
+
+    for (auto it = m_unwatchedDirectories.begin(); it != m_unwatchedDirectories.end();)
+    {
+        if (!m_backend->WatchDirectory(it->second))
+        {
+            ++it;
+            continue;
+        }
+
+        // The files may have been written before the directory could be watched
+        const auto directory = it->second;
+        it = m_unwatchedDirectories.erase(it);
+        OnChange(directory, now);
+    }
+
+    if (m_unwatchedDirectories.empty())
+    {
+        // The new changes may be due before the next wakeup
+        return DispatchDue(now);
+    }
+
+    m_nextRetry = now + m_retryInterval;
+    return std::min(DispatchDue(now), m_retryInterval);
+}
+
+void SettingsWatcher::RetryLater(const std::wstring& directoryKey, const std::filesystem::path& directory, std::chrono::steady_clock::time_point now)
+{
+    if (m_unwatchedDirectories.empty())
+    {
+        m_nextRetry = now + m_retryInterval;
+    }
+    m_unwatchedDirectories.emplace(directoryKey, directory);
+}
+
+void SettingsWatcher::OnChange(const std::filesystem::path& path, std::chrono::steady_clock::time_point now)
+{
+    const auto key = MakeKey(path);
+    const bool isDirectory = m_directories.contains(key);
+    for (const auto& [registration, watched] : m_watched)
+    {
+        if (watched.key == key || (isDirectory && MakeKey(watched.directory) == key))
+        {
+            // Every new change postpones the callback, so a burst of writes results in one call
+            m_pending[watched.key] = now + m_debounce;
+        }
+    }
+}
+
+std::chrono::milliseconds SettingsWatcher::DispatchDue(std::chrono::steady_clock::time_point now)
+{
+    auto next = Infinite;
+    bool queued = false;
+    for (auto it = m_pending.begin(); it != m_pending.end();)
+    {
+        if (it->second > now)
+        {
+            next = std::min(next, std::chrono::ceil<std::chrono::milliseconds>(it->second - now));
+            ++it;
+            continue;
+        }
+
+        for (const auto& [registration, watched] : m_watched)
+        {
+            if (watched.key == it->first && std::find(m_queue.begin(), m_queue.end(), registration) == m_queue.end())
+            {
+                m_queue.push_back(registration);
+                queued = true;
+            }
+        }
+        it = m_pending.erase(it);
+    }
+
+    if (queued)
+    {
+        m_executorCv.notify_all();
+    }
+
+    return next;
+}
+
+void SettingsWatcher::ExecutorThread()
+{
+    std::unique_lock lock{ m_mutex };
+    while (true)
+    {
+        m_executorCv.wait(lock, [this] { return m_stopped || !m_queue.empty(); });
+        if (m_stopped)
+        {
+            return;
+        }
+
+        const auto registration = m_queue.front();
+        m_queue.pop_front();
+
+        auto it = m_watched.find(registration);
+        if (it == m_watched.end())
+        {
+            continue;
+        }
+
+        auto callback = it->second.callback;
+        m_running = registration;
+        lock.unlock();
+
+        try
+        {
+            callback();
+        }
+        catch (...)
+        {
+        }
+
+        lock.lock();
+        m_running = 0;
+        m_executorCv.notify_all();
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Watches settings files through directory change notifications.
+// One thread waits for the notifications of every watched directory and one executor
+// thread runs the callbacks, so watching more files adds neither threads nor periodic
+// wakeups. Bursts of writes to the same file are coalesced into a single callback.
+// Directories that can't be watched yet, e.g. because they don't exist or were deleted,
+// are retried periodically until they can; their files are reported as changed at that point.
+class SettingsWatcher
+{
+public:
+    using Callback = std::function<void()>;
+    using Registration = uint64_t;
+
+    // Source of the change notifications: ReadDirectoryChangesW in the product,
+    // tests can provide their own implementation.
+    class Backend
+    {
+    public:
+        virtual ~Backend() = default;
+
+        virtual bool WatchDirectory(const std::filesystem::path& directory) = 0;
+        virtual void UnwatchDirectory(const std::filesystem::path& directory) = 0;
+
+        // Waits up to 'timeout' for changes and appends the paths of the changed files to 'changes'.
+        // A directory path means that its changes couldn't be tracked individually.
+        // Directories that can't be watched anymore, e.g. because they were deleted, are appended to 'lost'
+        // and are no longer watched by the backend.
+        // Returns false once the backend is stopped.
+        virtual bool Wait(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changes, std::vector<std::filesystem::path>& lost) = 0;
+
+        // Makes a pending Wait return early.
+        virtual void Wake() = 0;
+        virtual void Stop() = 0;
+    };
+
+    static constexpr std::chrono::milliseconds DefaultDebounce{ 50 };
+    static constexpr std::chrono::milliseconds DefaultRetryInterval{ 1000 };
+    static constexpr std::chrono::milliseconds Infinite = std::chrono::milliseconds::max();
+
+    explicit SettingsWatcher(std::unique_ptr<Backend> backend,
+                             std::chrono::milliseconds debounce = DefaultDebounce,
+                             std::chrono::milliseconds retryInterval = DefaultRetryInterval);
+    ~SettingsWatcher();
+
+    SettingsWatcher(const SettingsWatcher&) = delete;
+    SettingsWatcher& operator=(const SettingsWatcher&) = delete;
+
+    Registration Watch(const std::filesystem::path& path, Callback callback);
+
+    // After Unwatch returns, the callback is not running and won't be called again.
+    void Unwatch(Registration registration);
+
+    // Process-wide watcher using the native backend. It lives while somebody holds a reference to it.
+    static std::shared_ptr<SettingsWatcher> Acquire();
+
+private:
+    struct Watched
+    {
+        std::wstring key;
+        std::filesystem::path directory;
+        Callback callback;
+    };
+
+    static std::wstring MakeKey(const std::filesystem::path& path);
+
+    void NotificationThread();
+    void ExecutorThread();
+    void OnChange(const std::filesystem::path& path, std::chrono::steady_clock::time_point now);
+    void RetryLater(const std::wstring& directoryKey, const std::filesystem::path& directory, std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds DispatchDue(std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds RetryUnwatched(std::chrono::steady_clock::time_point now);
+
+    std::unique_ptr<Backend> m_backend;
+    const std::chrono::milliseconds m_debounce;
+    const std::chrono::milliseconds m_retryInterval;
+
+    std::mutex m_mutex;
+    std::condition_variable m_executorCv;
+    Registration m_lastRegistration = 0;
+    std::map<Registration, Watched> m_watched;
+    // Number of watched files per directory.
+    std::map<std::wstring, size_t> m_directories;
+    // Directories the backend failed to watch, and when to try again.
+    std::map<std::wstring, std::filesystem::path> m_unwatchedDirectories;
+    std::chrono::steady_clock::time_point m_nextRetry;
+    // Files with pending changes, and when their callbacks are due.
+    std::map<std::wstring, std::chrono::steady_clock::time_point> m_pending;
+    std::deque<Registration> m_queue;
+    Registration m_running = 0;
+    bool m_stopped = false;
+
+    std::thread m_notificationThread;
+    std::thread m_executorThread;
+};
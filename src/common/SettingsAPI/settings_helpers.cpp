@@ -1,5 +1,9 @@
 #include "pch.h"
 #include "settings_helpers.h"
+#include "settings_store.h"
+
+#include <mutex>
+#include <unordered_map>
 
 namespace PTSettingsHelper
 {
@@ -9,24 +13,44 @@ namespace PTSettingsHelper
     constexpr inline const wchar_t* opened_at_first_launch_json_field_name = L"openedAtFirstLaunch";
     constexpr inline const wchar_t* last_version_json_field_name = L"last_version";
 
-    std::wstring get_root_save_folder_location()
+    namespace
     {
-        PWSTR local_app_path;
-        winrt::check_hresult(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &local_app_path));
-        std::wstring result{ local_app_path };
-        CoTaskMemFree(local_app_path);
-
-        result += L"\\Microsoft\\PowerToys";
-        std::filesystem::path save_path(result);
-        if (!std::filesystem::exists(save_path))
+        std::wstring resolve_root_save_folder_location()
         {
-            std::filesystem::create_directories(save_path);
+            PWSTR local_app_path;
+            winrt::check_hresult(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &local_app_path));
+            std::wstring result{ local_app_path };
+            CoTaskMemFree(local_app_path);
+
+            result += L"\\Microsoft\\PowerToys";
+            std::filesystem::path save_path(result);
+            if (!std::filesystem::exists(save_path))
+            {
+                std::filesystem::create_directories(save_path);
+            }
+            return result;
         }
+    }
+
+    std::wstring get_root_save_folder_location()
+    {
+        // Resolved once, every settings access goes through here
+        static const std::wstring result = resolve_root_save_folder_location();
         return result;
     }
 
     std::wstring get_module_save_folder_location(std::wstring_view powertoy_key)
     {
+        static std::mutex mutex;
+        static std::unordered_map<std::wstring, std::wstring> locations;
+
+        std::unique_lock lock{ mutex };
+        std::wstring key{ powertoy_key };
+        if (auto it = locations.find(key); it != locations.end())
+        {
+            return it->second;
+        }
+
         std::wstring result = get_root_save_folder_location();
         result += L"\\";
         result += powertoy_key;
@@ -35,6 +59,8 @@ namespace PTSettingsHelper
         {
             std::filesystem::create_directories(save_path);
         }
+
+        locations.emplace(std::move(key), result);
         return result;
     }
 
@@ -51,26 +77,26 @@ namespace PTSettingsHelper
     void save_module_settings(std::wstring_view powertoy_key, json::JsonObject& settings)
     {
         const std::wstring save_file_location = get_module_save_file_location(powertoy_key);
-        json::to_file(save_file_location, settings);
+        settings_store::write(save_file_location, settings);
     }
 
     json::JsonObject load_module_settings(std::wstring_view powertoy_key)
     {
         const std::wstring save_file_location = get_module_save_file_location(powertoy_key);
-        auto saved_settings = json::from_file(save_file_location);
+        auto saved_settings = settings_store::read(save_file_location);
         return saved_settings.has_value() ? std::move(*saved_settings) : json::JsonObject{};
     }
 
     void save_general_settings(const json::JsonObject& settings)
     {
         const std::wstring save_file_location = get_powertoys_general_save_file_location();
-        json::to_file(save_file_location, settings);
+        settings_store::write(save_file_location, settings);
     }
 
     json::JsonObject load_general_settings()
     {
         const std::wstring save_file_location = get_powertoys_general_save_file_location();
-        auto saved_settings = json::from_file(save_file_location);
+        auto saved_settings = settings_store::read(save_file_location);
         return saved_settings.has_value() ? std::move(*saved_settings) : json::JsonObject{};
     }
 
@@ -87,7 +113,7 @@ namespace PTSettingsHelper
         oobePath = oobePath.append(oobe_filename);
         if (std::filesystem::exists(oobePath))
         {
-            auto saved_settings = json::from_file(oobePath.c_str());
+            auto saved_settings = settings_store::read(oobePath);
             if (!saved_settings.has_value())
             {
                 return false;
@@ -108,7 +134,7 @@ namespace PTSettingsHelper
         json::JsonObject obj;
         obj.SetNamedValue(opened_at_first_launch_json_field_name, json::value(true));
 
-        json::to_file(oobePath.c_str(), obj);      
+        settings_store::write(oobePath, obj);
     }
 
     std::wstring get_last_version_run()
@@ -118,7 +144,7 @@ namespace PTSettingsHelper
         lastVersionRunPath = lastVersionRunPath.append(last_version_run_filename);
         if (std::filesystem::exists(lastVersionRunPath))
         {
-            auto saved_settings = json::from_file(lastVersionRunPath.c_str());
+            auto saved_settings = settings_store::read(lastVersionRunPath);
             if (!saved_settings.has_value())
             {
                 return L"";
@@ -138,7 +164,7 @@ namespace PTSettingsHelper
         json::JsonObject obj;
         obj.SetNamedValue(last_version_json_field_name, json::value(version));
 
-        json::to_file(lastVersionRunPath.c_str(), obj);
+        settings_store::write(lastVersionRunPath, obj);
     }
 
 }
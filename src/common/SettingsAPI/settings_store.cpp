@@ -0,0 +1,157 @@
+#include "pch.h"
+#include "settings_store.h"
+
+namespace
+{
+    constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& path)
+        {
+            file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return;
+            }
+
+            LARGE_INTEGER size{};
+            if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || size.QuadPart > MAXDWORD)
+            {
+                return;
+            }
+
+            mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping)
+            {
+                return;
+            }
+
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view)
+            {
+                content = { static_cast<const char*>(view), static_cast<size_t>(size.QuadPart) };
+            }
+        }
+
+        ~MappedFile()
+        {
+            if (view)
+            {
+                UnmapViewOfFile(view);
+            }
+
+            if (mapping)
+            {
+                CloseHandle(mapping);
+            }
+
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(file);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view content;
+
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+        void* view = nullptr;
+    };
+
+    std::string to_utf8(std::wstring_view str)
+    {
+        const int length = WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), nullptr, 0, nullptr, nullptr);
+        std::string result(length, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), result.data(), length, nullptr, nullptr);
+        return result;
+    }
+
+    HANDLE create_temp_file(const std::filesystem::path& path)
+    {
+        return CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+    }
+}
+
+namespace settings_store
+{
+    std::optional<json::JsonObject> read(const std::filesystem::path& path)
+    {
+        try
+        {
+            MappedFile file{ path };
+            auto content = file.content;
+            if (content.empty())
+            {
+                return std::nullopt;
+            }
+
+            if (content.starts_with(utf8_bom))
+            {
+                content.remove_prefix(utf8_bom.size());
+            }
+
+            // The mapped bytes are converted straight into the string the parser consumes
+            json::JsonObject result;
+            if (!json::JsonObject::TryParse(winrt::to_hstring(content), result))
+            {
+                return std::nullopt;
+            }
+            return result;
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    bool write(const std::filesystem::path& path, const json::JsonObject& obj)
+    {
+        std::string content;
+        try
+        {
+            content = to_utf8(obj.Stringify());
+        }
+        catch (...)
+        {
+            return false;
+        }
+
+        // Unique for each writer, so processes saving the same file at once don't open or rename each other's copy
+        auto temp_path = path;
+        temp_path += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+        HANDLE file = create_temp_file(temp_path);
+        if (file == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PATH_NOT_FOUND)
+        {
+            // The folder was removed after its location was resolved
+            std::error_code err;
+            std::filesystem::create_directories(path.parent_path(), err);
+            file = create_temp_file(temp_path);
+        }
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        DWORD written = 0;
+        const bool saved = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &written, nullptr) &&
+                           written == content.size() &&
+                           FlushFileBuffers(file);
+        CloseHandle(file);
+
+        if (!saved || !MoveFileExW(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        {
+            DeleteFileW(temp_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
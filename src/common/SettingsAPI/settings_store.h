@@ -0,0 +1,17 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+#include "../utils/json.h"
+
+// Reads and writes settings files with as little copying and as few system calls as possible.
+namespace settings_store
+{
+    // Maps the file into memory and parses its UTF-8 content without copying it into an intermediate buffer.
+    std::optional<json::JsonObject> read(const std::filesystem::path& path);
+
+    // Writes the whole file in a single call to a temporary file next to it, flushes it and renames it over
+    // the original, so readers and file watchers never see a partially written file.
+    bool write(const std::filesystem::path& path, const json::JsonObject& obj);
+}
@@ -0,0 +1,35 @@
+#include "pch.h"
+#include "shared_settings.h"
+
+#include <sddl.h>
+#include <string>
+
+namespace
+{
+    // System and administrators: full access. Interactive user: read and write.
+    constexpr const wchar_t* section_sddl = L"D:(A;;GA;;;SY)(A;;GA;;;BA)(A;;GRGW;;;IU)";
+}
+
+namespace shared_settings
+{
+    HANDLE create_mapping(std::wstring_view name, size_t size) noexcept
+    {
+        PSECURITY_DESCRIPTOR descriptor = nullptr;
+        if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(section_sddl, SDDL_REVISION_1, &descriptor, nullptr))
+        {
+            return nullptr;
+        }
+
+        SECURITY_ATTRIBUTES attributes{ .nLength = sizeof(attributes), .lpSecurityDescriptor = descriptor, .bInheritHandle = FALSE };
+        const std::wstring object_name{ name };
+        HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, &attributes, PAGE_READWRITE, 0, static_cast<DWORD>(size), object_name.c_str());
+        LocalFree(descriptor);
+        return mapping;
+    }
+
+    HANDLE open_mapping(std::wstring_view name) noexcept
+    {
+        const std::wstring object_name{ name };
+        return OpenFileMappingW(FILE_MAP_READ, FALSE, object_name.c_str());
+    }
+}
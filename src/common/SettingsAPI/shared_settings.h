@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <Windows.h>
+
+// Settings that a module publishes into a named shared memory section, so code that runs inside other
+// processes, like the shell extensions loaded by Explorer, can read them without touching disk.
+namespace shared_settings
+{
+    constexpr uint32_t block_magic = 0x53535450; // "PTSS"
+
+    struct header
+    {
+        uint32_t magic;
+        uint32_t layout_version;
+        uint32_t payload_size;
+        uint32_t reserved;
+        // Odd while a write is in progress, 0 until the first write
+        std::atomic<uint64_t> generation;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the generation is shared between processes");
+
+    enum class read_result
+    {
+        updated,
+        unchanged,
+        unavailable,
+    };
+
+    // Seqlock over a header followed by the payload. Writers take the block by making the generation odd
+    // and release it by making it even again. Readers copy the payload and keep it only if the generation
+    // didn't change meanwhile, so they never block writers or each other.
+    // The memory has to be zero-initialized before its first use, which is the case for new sections.
+    template<typename T>
+    class block
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        static constexpr size_t size = sizeof(header) + sizeof(T);
+
+        block(void* memory, uint32_t layout_version) noexcept :
+            m_header(static_cast<header*>(memory)),
+            m_payload(static_cast<std::byte*>(memory) + sizeof(header)),
+            m_layoutVersion(layout_version)
+        {
+        }
+
+        uint64_t generation() const noexcept
+        {
+            return m_header->generation.load(std::memory_order_acquire);
+        }
+
+        // Publishes value and returns its generation
+        uint64_t write(const T& value) noexcept
+        {
+            uint64_t current = m_header->generation.load(std::memory_order_relaxed);
+            for (int spins = 0;; ++spins)
+            {
+                // A writer that died in the middle of a write leaves the generation odd, take over after a while
+                if ((current & 1) && spins < max_writer_spins)
+                {
+                    std::this_thread::yield();
+                    current = m_header->generation.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (m_header->generation.compare_exchange_weak(current, current | 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_release);
+            m_header->magic = block_magic;
+            m_header->layout_version = m_layoutVersion;
+            m_header->payload_size = sizeof(T);
+            memcpy(m_payload, &value, sizeof(T));
+            const uint64_t published = (current | 1) + 1;
+            m_header->generation.store(published, std::memory_order_release);
+            return published;
+        }
+
+        // Copies the payload into value unless it's still at known_generation, which is updated on success.
+        // unavailable means that nothing was published with this layout yet, or that a write was in progress
+        // during every attempt.
+        read_result read(T& value, uint64_t& known_generation) const noexcept
+        {
+            for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+            {
+                const uint64_t before = m_header->generation.load(std::memory_order_acquire);
+                if (before == 0)
+                {
+                    return read_result::unavailable;
+                }
+
+                if (before == known_generation)
+                {
+                    return read_result::unchanged;
+                }
+
+                if (before & 1)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                const bool valid = m_header->magic == block_magic && m_header->layout_version == m_layoutVersion && m_header->payload_size == sizeof(T);
+                T copy;
+                memcpy(&copy, m_payload, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (m_header->generation.load(std::memory_order_relaxed) == before)
+                {
+                    if (!valid)
+                    {
+                        return read_result::unavailable;
+                    }
+
+                    value = copy;
+                    known_generation = before;
+                    return read_result::updated;
+                }
+            }
+
+            return read_result::unavailable;
+        }
+
+    private:
+        static constexpr int max_writer_spins = 10000;
+        static constexpr int max_read_attempts = 64;
+
+        header* m_header;
+        std::byte* m_payload;
+        uint32_t m_layoutVersion;
+    };
+
+    // Creates the section, or opens it if it exists, for reading and writing. Access is limited to the
+    // system, administrators and the interactive user, so the runner and Explorer can share it.
+    HANDLE create_mapping(std::wstring_view name, size_t size) noexcept;
+    // Opens an existing section for reading
+    HANDLE open_mapping(std::wstring_view name) noexcept;
+
+    // Named section holding a block<T>, mapped for the lifetime of the object
+    template<typename T>
+    class section
+    {
+    public:
+        static std::optional<section> create(std::wstring_view name, uint32_t layout_version) noexcept
+        {
+            return map(create_mapping(name, block<T>::size), FILE_MAP_READ | FILE_MAP_WRITE, layout_version);
+        }
+
+        static std::optional<section> open(std::wstring_view name, uint32_t layout_version) noexcept
+        {
+            return map(open_mapping(name), FILE_MAP_READ, layout_version);
+        }
+
+        section(section&& other) noexcept :
+            m_mapping(std::exchange(other.m_mapping, nullptr)),
+            m_view(std::exchange(other.m_view, nullptr)),
+            m_block(other.m_block)
+        {
+        }
+
+        section& operator=(section&& other) noexcept
+        {
+            std::swap(m_mapping, other.m_mapping);
+            std::swap(m_view, other.m_view);
+            std::swap(m_block, other.m_block);
+            return *this;
+        }
+
+        ~section()
+        {
+            if (m_view)
+            {
+                UnmapViewOfFile(m_view);
+            }
+
+            if (m_mapping)
+            {
+                CloseHandle(m_mapping);
+            }
+        }
+
+        block<T>& data() noexcept { return m_block; }
+
+    private:
+        section(HANDLE mapping, void* view, uint32_t layout_version) noexcept :
+            m_mapping(mapping), m_view(view), m_block(view, layout_version)
+        {
+        }
+
+        static std::optional<section> map(HANDLE mapping, DWORD access, uint32_t layout_version) noexcept
+        {
+            if (!mapping)
+            {
+                return std::nullopt;
+            }
+
+            void* view = MapViewOfFile(mapping, access, 0, 0, block<T>::size);
+            if (!view)
+            {
+                CloseHandle(mapping);
+                return std::nullopt;
+            }
+
+            return section{ mapping, view, layout_version };
+        }
+
+        HANDLE m_mapping;
+        void* m_view;
+        block<T> m_block;
+    };
+}
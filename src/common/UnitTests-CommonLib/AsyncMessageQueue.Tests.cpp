@@ -0,0 +1,218 @@
+#include "pch.h"
+#include <common/interop/async_message_queue.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsAsyncMessageQueue
+{
+    // The queue AsyncMessageQueue used to be, kept to compare against
+    template<typename T>
+    class LockedMessageQueue
+    {
+    public:
+        void queue_message(T message)
+        {
+            {
+                std::scoped_lock lock{ mutex };
+                messages.push(std::move(message));
+            }
+
+            message_ready.notify_one();
+        }
+
+        bool pop_batch(std::vector<T>& batch)
+        {
+            batch.clear();
+            std::unique_lock lock{ mutex };
+            message_ready.wait(lock, [this] { return !messages.empty() || closed; });
+            if (closed)
+            {
+                return false;
+            }
+
+            while (!messages.empty())
+            {
+                batch.push_back(std::move(messages.front()));
+                messages.pop();
+            }
+
+            return true;
+        }
+
+        void close()
+        {
+            {
+                std::scoped_lock lock{ mutex };
+                closed = true;
+            }
+
+            message_ready.notify_all();
+        }
+
+    private:
+        std::mutex mutex;
+        std::queue<T> messages;
+        std::condition_variable message_ready;
+        bool closed = false;
+    };
+
+    // Every producer sends messagesPerProducer messages counting up from 0, tagged with its index in the high bits.
+    // Checks that each producer's messages arrive complete and in order, returns the messages per second.
+    template<typename Queue>
+    double RunProducers(Queue& queue, int producers, uint64_t messagesPerProducer)
+    {
+        std::vector<uint64_t> expected(producers, 0);
+        const uint64_t total = producers * messagesPerProducer;
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&queue, producer, messagesPerProducer] {
+                for (uint64_t i = 0; i < messagesPerProducer; ++i)
+                {
+                    queue.queue_message((static_cast<uint64_t>(producer) << 32) | i);
+                }
+            });
+        }
+
+        std::vector<uint64_t> batch;
+        uint64_t received = 0;
+        while (received < total && queue.pop_batch(batch))
+        {
+            for (const auto message : batch)
+            {
+                auto& next = expected[message >> 32];
+                Assert::AreEqual(next, message & 0xFFFFFFFF);
+                ++next;
+            }
+
+            received += batch.size();
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Assert::AreEqual(total, received);
+        return total / elapsed.count();
+    }
+
+    TEST_CLASS (AsyncMessageQueueTests)
+    {
+    public:
+        TEST_METHOD (PopsInQueueOrder)
+        {
+            AsyncMessageQueue queue;
+            Assert::IsTrue(queue.queue_message(L"first"));
+            Assert::IsTrue(queue.queue_message(L""));
+            Assert::IsTrue(queue.queue_message(L"third"));
+
+            Assert::AreEqual(std::wstring{ L"first" }, queue.pop_message().value());
+
+            // An empty message is still a message
+            std::vector<std::wstring> batch;
+            Assert::IsTrue(queue.pop_batch(batch));
+            Assert::AreEqual<size_t>(2, batch.size());
+            Assert::AreEqual(std::wstring{}, batch[0]);
+            Assert::AreEqual(std::wstring{ L"third" }, batch[1]);
+        }
+
+        TEST_METHOD (MovesOnlyPayloads)
+        {
+            BasicAsyncMessageQueue<std::unique_ptr<int>> queue;
+            queue.queue_message(std::make_unique<int>(1));
+            queue.queue_message(std::make_unique<int>(2));
+
+            Assert::AreEqual(1, *queue.pop_message().value());
+            std::vector<std::unique_ptr<int>> batch;
+            Assert::IsTrue(queue.pop_batch(batch));
+            Assert::AreEqual(2, *batch.at(0));
+        }
+
+        TEST_METHOD (BatchIsLimited)
+        {
+            BasicAsyncMessageQueue<int> queue;
+            for (int i = 0; i < 5; ++i)
+            {
+                queue.queue_message(i);
+            }
+
+            std::vector<int> batch;
+            Assert::IsTrue(queue.pop_batch(batch, 3));
+            Assert::AreEqual<size_t>(3, batch.size());
+            Assert::IsTrue(queue.pop_batch(batch, 3));
+            Assert::AreEqual<size_t>(2, batch.size());
+            Assert::AreEqual(4, batch.back());
+        }
+
+        TEST_METHOD (CloseWakesUpConsumer)
+        {
+            AsyncMessageQueue queue;
+            bool popped = true;
+            std::optional<std::wstring> message;
+            std::thread consumer([&] {
+                std::vector<std::wstring> batch;
+                popped = queue.pop_batch(batch);
+                message = queue.pop_message();
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            queue.close();
+            consumer.join();
+
+            Assert::IsFalse(popped);
+            Assert::IsFalse(message.has_value());
+            Assert::IsTrue(queue.is_closed());
+            Assert::IsFalse(queue.queue_message(L"too late"));
+        }
+
+        TEST_METHOD (WaitingConsumerGetsMessage)
+        {
+            AsyncMessageQueue queue;
+            std::thread producer([&queue] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                queue.queue_message(L"message");
+            });
+
+            Assert::AreEqual(std::wstring{ L"message" }, queue.pop_message().value());
+            producer.join();
+        }
+
+        TEST_METHOD (ProducersRaceWithConsumer)
+        {
+            for (int producers = 1; producers <= 8; producers *= 2)
+            {
+                BasicAsyncMessageQueue<uint64_t> queue;
+                RunProducers(queue, producers, 20000);
+            }
+        }
+
+        TEST_METHOD (ContentionBenchmark)
+        {
+            constexpr uint64_t messagesPerProducer = 200000;
+            for (int producers = 1; producers <= 8; producers *= 2)
+            {
+                LockedMessageQueue<uint64_t> locked;
+                BasicAsyncMessageQueue<uint64_t> lockFree;
+                const auto lockedRate = RunProducers(locked, producers, messagesPerProducer);
+                const auto lockFreeRate = RunProducers(lockFree, producers, messagesPerProducer);
+                Logger::WriteMessage(std::format(L"{} producers: mutex queue {:.1f} M messages/s, lock-free queue {:.1f} M messages/s\n",
+                                                 producers,
+                                                 lockedRate / 1e6,
+                                                 lockFreeRate / 1e6)
+                                         .c_str());
+            }
+        }
+    };
+}
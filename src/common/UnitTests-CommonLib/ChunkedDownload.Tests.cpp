@@ -0,0 +1,297 @@
+#include "pch.h"
+#include <common/updating/chunked_download.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsChunkedDownload
+{
+    constexpr uint64_t chunk_size = 64 * 1024;
+
+    // Serves content from memory and fails on demand, the way a flaky connection would
+    class TestServer : public updating::range_source
+    {
+    public:
+        explicit TestServer(size_t size)
+        {
+            std::mt19937 random{ 42 };
+            content.resize(size);
+            for (auto& byte : content)
+            {
+                byte = static_cast<uint8_t>(random());
+            }
+        }
+
+        updating::remote_file_info query() override
+        {
+            return { content.size(), accepts_ranges, etag };
+        }
+
+        void read(uint64_t offset, uint64_t length, const std::function<bool(std::span<const uint8_t>)>& sink) override
+        {
+            bool drop = false;
+            std::chrono::milliseconds delay{};
+            {
+                std::scoped_lock lock(mutex);
+                if (length == 0)
+                {
+                    whole_reads++;
+                    length = content.size();
+                }
+                else if (outage_after && range_reads >= *outage_after)
+                {
+                    throw std::runtime_error("Connection refused");
+                }
+                else
+                {
+                    range_reads++;
+                    drop = drop_once.erase(offset) != 0;
+                    if (auto it = delays.find(offset); it != delays.end())
+                    {
+                        delay = it->second;
+                    }
+                }
+            }
+
+            std::this_thread::sleep_for(delay);
+
+            // Sent in pieces, like a network stream. A dropped connection stops halfway through.
+            const uint64_t end = drop ? offset + length / 2 : offset + length;
+            for (uint64_t position = offset; position < end; position += 4096)
+            {
+                if (!sink({ content.data() + position, static_cast<size_t>(std::min<uint64_t>(4096, end - position)) }))
+                {
+                    return;
+                }
+            }
+
+            if (drop)
+            {
+                throw std::runtime_error("Connection reset");
+            }
+        }
+
+        std::wstring sha256() const
+        {
+            updating::sha256 hash;
+            hash.update(content);
+            return hash.finish();
+        }
+
+        std::vector<uint8_t> content;
+        bool accepts_ranges = true;
+        std::wstring etag = L"\"v1\"";
+        // Range requests starting at these offsets are dropped the first time
+        std::set<uint64_t> drop_once;
+        // Range requests starting at these offsets are answered this much later
+        std::map<uint64_t, std::chrono::milliseconds> delays;
+        // Range requests fail once this many were served
+        std::optional<size_t> outage_after;
+        size_t range_reads = 0;
+        size_t whole_reads = 0;
+        std::mutex mutex;
+    };
+
+    TEST_CLASS (ChunkedDownloadTests)
+    {
+        std::filesystem::path destination;
+
+        std::vector<uint8_t> ReadDestination()
+        {
+            std::ifstream file(destination, std::ios::binary);
+            return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        }
+
+        static updating::download_options Options()
+        {
+            updating::download_options options;
+            options.chunk_size = chunk_size;
+            return options;
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            destination = std::filesystem::temp_directory_path() / L"PowerToysChunkedDownloadTest.bin";
+            std::filesystem::remove(destination);
+            std::filesystem::remove(updating::chunk_map_path(destination));
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup)
+        {
+            std::filesystem::remove(destination);
+            std::filesystem::remove(updating::chunk_map_path(destination));
+        }
+
+        TEST_METHOD (Sha256MatchesKnownVector)
+        {
+            updating::sha256 hash;
+            const std::string text = "abc";
+            hash.update({ reinterpret_cast<const uint8_t*>(text.data()), text.size() });
+            Assert::AreEqual(std::wstring{ L"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" }, hash.finish());
+        }
+
+        TEST_METHOD (DownloadsChunksInParallel)
+        {
+            TestServer server{ 17 * chunk_size + 123 };
+            auto options = Options();
+            options.expected_sha256 = server.sha256();
+
+            auto result = updating::download_file(server, destination, options);
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual(options.expected_sha256, result->sha256);
+            Assert::AreEqual<uint64_t>(server.content.size(), result->transferred_bytes);
+            Assert::AreEqual<size_t>(18, server.range_reads);
+            Assert::IsTrue(server.content == ReadDestination());
+            Assert::IsFalse(std::filesystem::exists(updating::chunk_map_path(destination)));
+        }
+
+        TEST_METHOD (RetriesDroppedChunks)
+        {
+            TestServer server{ 8 * chunk_size };
+            server.drop_once = { 0, 3 * chunk_size, 7 * chunk_size };
+
+            auto result = updating::download_file(server, destination, Options());
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual(server.sha256(), result->sha256);
+            Assert::AreEqual<size_t>(11, server.range_reads);
+            Assert::IsTrue(server.content == ReadDestination());
+        }
+
+        TEST_METHOD (ResumesAfterAnOutage)
+        {
+            TestServer server{ 12 * chunk_size };
+            auto options = Options();
+            options.attempts_per_chunk = 1;
+            server.outage_after = 5;
+
+            auto failed = updating::download_file(server, destination, options);
+            Assert::IsFalse(failed.has_value());
+            Assert::IsTrue(std::filesystem::exists(updating::chunk_map_path(destination)));
+
+            server.outage_after.reset();
+            server.range_reads = 0;
+            auto result = updating::download_file(server, destination, options);
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual(server.sha256(), result->sha256);
+            Assert::AreEqual<uint64_t>(12 * chunk_size - 5 * chunk_size, result->transferred_bytes);
+            Assert::AreEqual<size_t>(7, server.range_reads);
+            Assert::IsTrue(server.content == ReadDestination());
+        }
+
+        TEST_METHOD (ResumedChunksAreNotDownloadedAgain)
+        {
+            TestServer server{ 16 * chunk_size };
+            auto options = Options();
+            options.parallel_chunks = 3;
+            options.attempts_per_chunk = 1;
+            server.outage_after = 0;
+            Assert::IsFalse(updating::download_file(server, destination, options).has_value());
+
+            // As if a previous attempt got every other chunk
+            std::string completed;
+            {
+                std::fstream file(destination, std::ios::in | std::ios::out | std::ios::binary);
+                for (size_t chunk = 0; chunk < 16; chunk++)
+                {
+                    completed += chunk % 2 ? '1' : '0';
+                    if (chunk % 2)
+                    {
+                        file.seekp(chunk * chunk_size);
+                        file.write(reinterpret_cast<const char*>(server.content.data() + chunk * chunk_size), chunk_size);
+                    }
+                }
+            }
+
+            std::vector<std::string> map;
+            {
+                std::ifstream file(updating::chunk_map_path(destination));
+                for (std::string line; std::getline(file, line);)
+                {
+                    map.push_back(line);
+                }
+            }
+
+            map.back() = completed;
+            {
+                std::ofstream file(updating::chunk_map_path(destination), std::ios::trunc);
+                for (const auto& line : map)
+                {
+                    file << line << '\n';
+                }
+            }
+
+            // The other workers wait for the first chunk with the next one to download right before a resumed one
+            server.outage_after.reset();
+            server.range_reads = 0;
+            server.delays[0] = std::chrono::milliseconds(200);
+            uint64_t reported = 0;
+            options.progress = [&](const updating::download_progress& progress) { reported = std::max(reported, progress.completed_bytes); };
+            auto result = updating::download_file(server, destination, options);
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual(server.sha256(), result->sha256);
+            Assert::AreEqual<size_t>(8, server.range_reads);
+            Assert::AreEqual<uint64_t>(8 * chunk_size, result->transferred_bytes);
+            Assert::AreEqual<uint64_t>(server.content.size(), reported);
+            Assert::IsTrue(server.content == ReadDestination());
+        }
+
+        TEST_METHOD (RestartsWhenTheFileChanged)
+        {
+            TestServer server{ 6 * chunk_size };
+            auto options = Options();
+            options.attempts_per_chunk = 1;
+            server.outage_after = 3;
+            Assert::IsFalse(updating::download_file(server, destination, options).has_value());
+
+            server.outage_after.reset();
+            server.etag = L"\"v2\"";
+            server.content[0] ^= 0xff;
+            auto result = updating::download_file(server, destination, options);
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual<uint64_t>(server.content.size(), result->transferred_bytes);
+            Assert::AreEqual(server.sha256(), result->sha256);
+            Assert::IsTrue(server.content == ReadDestination());
+        }
+
+        TEST_METHOD (DownloadsWholeFileWithoutRanges)
+        {
+            TestServer server{ 3 * chunk_size + 1 };
+            server.accepts_ranges = false;
+
+            auto result = updating::download_file(server, destination, Options());
+
+            Assert::IsTrue(result.has_value());
+            Assert::AreEqual<size_t>(1, server.whole_reads);
+            Assert::AreEqual<size_t>(0, server.range_reads);
+            Assert::AreEqual(server.sha256(), result->sha256);
+            Assert::IsTrue(server.content == ReadDestination());
+        }
+
+        TEST_METHOD (RemovesFileWithWrongHash)
+        {
+            TestServer server{ 4 * chunk_size };
+            auto options = Options();
+            options.expected_sha256 = std::wstring(64, L'0');
+
+            auto result = updating::download_file(server, destination, options);
+
+            Assert::IsFalse(result.has_value());
+            Assert::IsFalse(std::filesystem::exists(destination));
+            Assert::IsFalse(std::filesystem::exists(updating::chunk_map_path(destination)));
+        }
+    };
+}
@@ -0,0 +1,103 @@
+#include "pch.h"
+#include <common/utils/CodecExtensionTable.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std::chrono_literals;
+
+namespace UnitTestsCodecExtensionTable
+{
+    using Clock = CodecExtensionTable::Clock;
+    using Selection = CodecExtensionTable::Selection;
+
+    // Codec list of a machine with the HEIF and RAW extensions installed
+    const std::vector<std::wstring> codecs = {
+        L".bmp,.dib,.rle",
+        L".jpeg,.jpe,.jpg,.jfif,.exif",
+        L".png",
+        L".heic, .heif,.HEICS",
+        L".ARW,.CR2,.DNG,.NEF",
+        L"",
+        L"no-dot,.",
+    };
+
+    auto PathsOf(const std::vector<std::wstring>& paths, size_t& visited)
+    {
+        return [&paths, &visited]() -> std::optional<std::wstring> {
+            if (visited == paths.size())
+            {
+                return std::nullopt;
+            }
+
+            return paths[visited++];
+        };
+    }
+
+    TEST_CLASS (CodecExtensionTableTests)
+    {
+    public:
+        TEST_METHOD (ParsesExtensionLists)
+        {
+            CodecExtensionTable table{ codecs };
+            Assert::AreEqual(size_t{ 16 }, table.size());
+            Assert::IsTrue(table.CanDecode(L".heif"));
+            Assert::IsTrue(table.CanDecode(L".heics"));
+            Assert::IsFalse(table.CanDecode(L"no-dot"));
+            Assert::IsFalse(table.CanDecode(L"."));
+        }
+
+        TEST_METHOD (MatchesPathsIgnoringCase)
+        {
+            CodecExtensionTable table{ codecs };
+            Assert::IsTrue(table.CanDecode(L"C:\\Photos\\IMG_0001.HEIC"));
+            Assert::IsTrue(table.CanDecode(L"C:\\Photos\\DSC00042.arw"));
+            Assert::IsTrue(table.CanDecode(L"C:\\Photos\\archive.tar.jpg"));
+            Assert::IsFalse(table.CanDecode(L"C:\\Photos\\notes.txt"));
+            Assert::IsFalse(table.CanDecode(L"C:\\Photos.jpg\\README"));
+            Assert::IsFalse(table.CanDecode(L"C:\\Photos\\jpg"));
+        }
+
+        TEST_METHOD (EmptyTable)
+        {
+            CodecExtensionTable table;
+            Assert::IsTrue(table.empty());
+            Assert::IsFalse(table.CanDecode(L"image.png"));
+        }
+
+        TEST_METHOD (FindsImageAnywhereInSelection)
+        {
+            CodecExtensionTable table{ codecs };
+            const std::vector<std::wstring> paths = { L"a.txt", L"b.docx", L"c.CR2", L"d.txt" };
+            size_t visited = 0;
+            Assert::IsTrue(table.FindImage(PathsOf(paths, visited)) == Selection::HasImages);
+            Assert::AreEqual(size_t{ 3 }, visited);
+        }
+
+        TEST_METHOD (NoImagesInSelection)
+        {
+            CodecExtensionTable table{ codecs };
+            const std::vector<std::wstring> paths = { L"a.txt", L"b.docx" };
+            size_t visited = 0;
+            Assert::IsTrue(table.FindImage(PathsOf(paths, visited)) == Selection::NoImages);
+            Assert::AreEqual(paths.size(), visited);
+
+            const std::vector<std::wstring> none;
+            visited = 0;
+            Assert::IsTrue(table.FindImage(PathsOf(none, visited)) == Selection::NoImages);
+        }
+
+        TEST_METHOD (GivesUpAfterDeadline)
+        {
+            CodecExtensionTable table{ codecs };
+            const std::vector<std::wstring> paths(1000, L"file.txt");
+            size_t visited = 0;
+
+            // Every item takes 1ms
+            auto now = Clock::time_point{} + 1h;
+            const auto deadline = now + 10ms;
+            auto clock = [&now] { return now += 1ms; };
+
+            Assert::IsTrue(table.FindImage(PathsOf(paths, visited), deadline, clock) == Selection::Pending);
+            Assert::AreEqual(size_t{ 11 }, visited);
+        }
+    };
+}
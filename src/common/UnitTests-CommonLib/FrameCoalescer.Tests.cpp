@@ -0,0 +1,130 @@
+#include "pch.h"
+#include <common/utils/FrameCoalescer.h>
+
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std::chrono_literals;
+
+namespace UnitTestsFrameCoalescer
+{
+    using Clock = FrameCoalescer::Clock;
+
+    const Clock::time_point start = Clock::time_point{} + 1h;
+    constexpr Clock::duration refreshPeriod = 16667us;
+
+    // Replays change notifications at the given interval, flushing whenever the requested delay elapses like a timer would.
+    // Returns the frames the updates were applied in.
+    std::vector<long long> Replay(FrameCoalescer& coalescer, Clock::duration eventInterval, Clock::duration length, Clock::duration timerLatency = 0ms)
+    {
+        std::vector<long long> frames;
+        std::optional<Clock::time_point> flushAt;
+        auto schedule = [&](Clock::time_point now, std::optional<Clock::duration> delay) {
+            if (delay.has_value())
+            {
+                flushAt = now + *delay + timerLatency;
+            }
+        };
+
+        constexpr auto step = 100us;
+        auto nextEvent = start;
+        for (auto now = start; now < start + length; now += step)
+        {
+            if (flushAt.has_value() && now >= *flushAt)
+            {
+                flushAt = std::nullopt;
+                if (coalescer.Flush(now))
+                {
+                    frames.push_back((now - start) / refreshPeriod);
+                }
+                else
+                {
+                    schedule(now, coalescer.Schedule(now));
+                }
+            }
+
+            if (eventInterval > 0ms && now >= nextEvent)
+            {
+                schedule(now, coalescer.Request(now));
+                nextEvent += eventInterval;
+            }
+        }
+
+        return frames;
+    }
+
+    TEST_CLASS (FrameCoalescerTests)
+    {
+    public:
+        TEST_METHOD (SingleChangeResultsInOneUpdate)
+        {
+            FrameCoalescer coalescer{ refreshPeriod, start };
+            auto delay = coalescer.Request(start + 5ms);
+            Assert::IsTrue(delay.has_value());
+            Assert::IsTrue(*delay == refreshPeriod - 5ms);
+
+            // Already scheduled
+            Assert::IsFalse(coalescer.Request(start + 6ms).has_value());
+
+            Assert::IsTrue(coalescer.Flush(start + refreshPeriod));
+            Assert::IsFalse(coalescer.Pending());
+            Assert::IsFalse(coalescer.Flush(start + refreshPeriod));
+            Assert::IsFalse(coalescer.Schedule(start + refreshPeriod).has_value());
+        }
+
+        TEST_METHOD (SecondChangeInTheSameFrameIsDeferred)
+        {
+            FrameCoalescer coalescer{ refreshPeriod, start };
+            coalescer.Request(start + 1ms);
+            Assert::IsTrue(coalescer.Flush(start + 2ms));
+
+            coalescer.Request(start + 3ms);
+            Assert::IsFalse(coalescer.Flush(start + 4ms));
+            Assert::IsTrue(coalescer.Pending());
+
+            auto delay = coalescer.Schedule(start + 4ms);
+            Assert::IsTrue(delay.has_value());
+            Assert::IsTrue(coalescer.Flush(start + 4ms + *delay));
+        }
+
+        TEST_METHOD (VblankInTheFuture)
+        {
+            // The timing reported by the compositor may refer to the upcoming vblank
+            FrameCoalescer coalescer{ refreshPeriod, start + 10 * refreshPeriod };
+            auto delay = coalescer.Request(start + 1ms);
+            Assert::IsTrue(delay.has_value());
+            Assert::IsTrue(*delay == refreshPeriod - 1ms);
+        }
+
+        TEST_METHOD (DraggingIsLimitedToTheRefreshRate)
+        {
+            // Location changes while dragging arrive much faster than the display refreshes
+            for (const auto eventInterval : { 250us, 1000us, 4000us })
+            {
+                FrameCoalescer coalescer{ refreshPeriod, start };
+                const auto frames = Replay(coalescer, eventInterval, 1s);
+                const auto events = 1s / eventInterval;
+
+                Logger::WriteMessage(std::format(L"{} events coalesced into {} updates\n", events, frames.size()).c_str());
+                Assert::IsTrue(frames.size() >= 59 && frames.size() <= 61);
+                Assert::IsTrue(std::adjacent_find(frames.begin(), frames.end()) == frames.end());
+            }
+        }
+
+        TEST_METHOD (LateTimersDontResultInMoreThanOneUpdatePerFrame)
+        {
+            FrameCoalescer coalescer{ refreshPeriod, start };
+            const auto frames = Replay(coalescer, 1ms, 1s, 15ms);
+
+            Assert::IsTrue(!frames.empty() && frames.size() <= 61);
+            Assert::IsTrue(std::adjacent_find(frames.begin(), frames.end()) == frames.end());
+        }
+
+        TEST_METHOD (SlowChangesAreNotDelayedByMoreThanAFrame)
+        {
+            FrameCoalescer coalescer{ refreshPeriod, start };
+            const auto frames = Replay(coalescer, 100ms, 1s);
+            Assert::AreEqual(size_t{ 10 }, frames.size());
+        }
+    };
+}
@@ -0,0 +1,208 @@
+#include "pch.h"
+#include <common/logger/compacting_file_sink.h>
+#include <common/logger/log_retention.h>
+
+#include <atomic>
+#include <fstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsLogRetention
+{
+    namespace fs = std::filesystem;
+
+    const LogRetention::Day day{ 2022, 7, 5 };
+    const std::vector<std::wstring> logDirectoryNames = { L"Logs", L"RunnerLogs" };
+
+    void WriteFile(const fs::path& file, const std::string& content)
+    {
+        fs::create_directories(file.parent_path());
+        std::ofstream{ file, std::ios::binary } << content;
+    }
+
+    std::string ReadFile(const fs::path& file)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    }
+
+    TEST_CLASS (LogRetentionTests)
+    {
+        fs::path root;
+
+        // A log with a message at 9:00, 10:00 and 13:00
+        fs::path WriteIndexedLog(const fs::path& directory)
+        {
+            const auto midnight = LogRetention::StartOfDay(day);
+            const auto log = directory / L"runner-log_2022-07-05.txt";
+            WriteFile(log, "nine\nten\nthirteen\n");
+            WriteFile(LogRetention::IndexPath(log),
+                      std::to_string(midnight + 9 * 3600) + " 0\n" +
+                          std::to_string(midnight + 10 * 3600) + " 5\n" +
+                          std::to_string(midnight + 13 * 3600) + " 9\n");
+            return log;
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            root = fs::temp_directory_path() / L"PowerToysLogRetentionTest";
+            fs::remove_all(root);
+            fs::create_directories(root);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup)
+        {
+            std::error_code err;
+            fs::remove_all(root, err);
+        }
+
+        TEST_METHOD (ParsesDailyLogNames)
+        {
+            const auto log = LogRetention::ParseDailyLogName(L"runner-log_2022-07-05.txt");
+            Assert::IsTrue(log.has_value());
+            Assert::AreEqual(std::wstring{ L"runner-log" }, log->stem);
+            Assert::IsTrue(log->day == day);
+            Assert::IsFalse(log->compacted);
+
+            Assert::IsTrue(LogRetention::ParseDailyLogName(L"log_2022-07-05.zip")->compacted);
+            Assert::IsFalse(LogRetention::ParseDailyLogName(L"log.txt").has_value());
+            Assert::IsFalse(LogRetention::ParseDailyLogName(L"log_2022-13-05.txt").has_value());
+            Assert::IsFalse(LogRetention::ParseDailyLogName(L"log_2022-07-05.json").has_value());
+            Assert::IsFalse(LogRetention::ParseDailyLogName(L"_2022-07-05.txt").has_value());
+        }
+
+        TEST_METHOD (NamesLogsLikeDailyFileSink)
+        {
+            Assert::AreEqual((fs::path{ L"Logs" } / L"log_2022-07-05.txt").wstring(), LogRetention::DailyLogPath(fs::path{ L"Logs" } / L"log.txt", day).wstring());
+        }
+
+        TEST_METHOD (ReadsTextLogFromIndexedHour)
+        {
+            const auto log = WriteIndexedLog(root);
+            const auto midnight = LogRetention::StartOfDay(day);
+
+            Assert::AreEqual(std::string{ "nine\nten\nthirteen\n" }, LogRetention::ReadSince(log, 0));
+            Assert::AreEqual(std::string{ "ten\nthirteen\n" }, LogRetention::ReadSince(log, midnight + 11 * 3600));
+            Assert::AreEqual(std::string{ "thirteen\n" }, LogRetention::ReadSince(log, midnight + 13 * 3600));
+            Assert::AreEqual(std::string{}, LogRetention::ReadSince(log, LogRetention::NextDay(midnight)));
+        }
+
+        TEST_METHOD (CompactsLogIntoHourlyEntries)
+        {
+            const auto log = WriteIndexedLog(root);
+            const auto midnight = LogRetention::StartOfDay(day);
+
+            Assert::IsTrue(LogRetention::Compact(log));
+
+            const auto archive = root / L"runner-log_2022-07-05.zip";
+            Assert::IsTrue(fs::exists(archive));
+            Assert::IsFalse(fs::exists(log));
+            Assert::IsFalse(fs::exists(LogRetention::IndexPath(log)));
+            Assert::AreEqual(std::string{ "nine\nten\nthirteen\n" }, LogRetention::ReadSince(archive, 0));
+            Assert::AreEqual(std::string{ "ten\nthirteen\n" }, LogRetention::ReadSince(archive, midnight + 11 * 3600));
+            Assert::AreEqual(std::string{}, LogRetention::ReadSince(archive, LogRetention::NextDay(midnight)));
+        }
+
+        TEST_METHOD (CompactsLogWithoutIndex)
+        {
+            const auto log = root / L"log_2022-07-05.txt";
+            WriteFile(log, "written by an older version\n");
+
+            Assert::IsTrue(LogRetention::Compact(log));
+            Assert::AreEqual(std::string{ "written by an older version\n" }, LogRetention::ReadSince(root / L"log_2022-07-05.zip", LogRetention::StartOfDay(day) + 3600));
+        }
+
+        TEST_METHOD (CompactsOnlyFinishedDays)
+        {
+            WriteFile(root / L"log_2022-07-04.txt", "yesterday\n");
+            WriteFile(root / L"log_2022-07-05.txt", "today\n");
+
+            const auto result = LogRetention::CompactDirectory(root, day, 30);
+
+            Assert::AreEqual<size_t>(1, result.compactedLogs);
+            Assert::IsTrue(fs::exists(root / L"log_2022-07-04.zip"));
+            Assert::IsTrue(fs::exists(root / L"log_2022-07-05.txt"));
+        }
+
+        TEST_METHOD (KeepsRetentionDaysPerDirectory)
+        {
+            WriteFile(root / L"log_2022-07-01.zip", "1");
+            WriteFile(root / L"log_2022-07-02.zip", "2");
+            WriteFile(root / L"log_2022-07-03.txt", "3");
+            WriteFile(root / L"log_2022-07-05.txt", "5");
+            WriteFile(root / L"settings_2022-07-01.json", "{}");
+
+            const auto result = LogRetention::CompactDirectory(root, day, 2);
+
+            Assert::AreEqual<size_t>(2, result.removedLogs);
+            Assert::IsFalse(fs::exists(root / L"log_2022-07-01.zip"));
+            Assert::IsFalse(fs::exists(root / L"log_2022-07-02.zip"));
+            Assert::IsTrue(fs::exists(root / L"log_2022-07-03.zip"));
+            Assert::IsTrue(fs::exists(root / L"settings_2022-07-01.json"));
+        }
+
+        TEST_METHOD (BudgetRemovesOldestLogsOfAllModules)
+        {
+            const std::string hundred(100, 'x');
+            WriteFile(root / L"FancyZones" / L"Logs" / L"log_2022-07-01.zip", hundred);
+            WriteFile(root / L"RunnerLogs" / L"runner-log_2022-07-02.txt", hundred);
+            WriteFile(root / L"RunnerLogs" / L"runner-log_2022-07-02.txt.index", "1 0\n");
+            WriteFile(root / L"Keyboard Manager" / L"Logs" / L"log_2022-07-03.zip", hundred);
+            WriteFile(root / L"RunnerLogs" / L"runner-log_2022-07-05.txt", hundred + hundred);
+            WriteFile(root / L"settings.json", hundred);
+            WriteFile(root / L"Notes" / L"notes_2022-07-01.txt", hundred);
+
+            const auto result = LogRetention::EnforceBudget(root, logDirectoryNames, 300, day);
+
+            Assert::AreEqual<size_t>(2, result.removedLogs);
+            Assert::AreEqual<uint64_t>(204, result.removedBytes);
+            Assert::AreEqual<uint64_t>(300, result.totalBytes);
+            Assert::IsFalse(fs::exists(root / L"FancyZones" / L"Logs" / L"log_2022-07-01.zip"));
+            Assert::IsFalse(fs::exists(root / L"RunnerLogs" / L"runner-log_2022-07-02.txt.index"));
+            Assert::IsTrue(fs::exists(root / L"Keyboard Manager" / L"Logs" / L"log_2022-07-03.zip"));
+            Assert::IsTrue(fs::exists(root / L"settings.json"));
+            Assert::IsTrue(fs::exists(root / L"Notes" / L"notes_2022-07-01.txt"));
+
+            // Today's log is kept even though it's over the budget alone
+            LogRetention::EnforceBudget(root, logDirectoryNames, 10, day);
+            Assert::IsTrue(fs::exists(root / L"RunnerLogs" / L"runner-log_2022-07-05.txt"));
+        }
+
+        TEST_METHOD (SinkIndexesHoursAndStartsNewDays)
+        {
+            std::atomic<int> maintenanceRuns = 0;
+            auto waitForMaintenance = [&](int runs) {
+                for (int i = 0; i < 500 && maintenanceRuns < runs; ++i)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+
+                return maintenanceRuns.load();
+            };
+
+            auto sink = std::make_shared<CompactingFileSinkMt>(root / L"log.txt", [&] { maintenanceRuns++; });
+            sink->set_pattern("%v");
+            auto log = [&](std::chrono::system_clock::time_point time, const char* text) {
+                sink->log(spdlog::details::log_msg{ time, {}, "test", spdlog::level::info, text });
+            };
+
+            const auto now = std::chrono::system_clock::now();
+            const auto firstLog = sink->CurrentLog();
+            Assert::AreEqual(1, waitForMaintenance(1));
+
+            log(now, "first");
+            log(now, "second");
+            const auto tomorrow = std::chrono::system_clock::from_time_t(LogRetention::NextDay(std::chrono::system_clock::to_time_t(now)));
+            log(tomorrow, "third");
+            sink->flush();
+
+            Assert::AreNotEqual(firstLog.wstring(), sink->CurrentLog().wstring());
+            Assert::AreEqual(std::string{ "first\nsecond\n" }, ReadFile(firstLog));
+            Assert::AreEqual(std::string{ "third\n" }, ReadFile(sink->CurrentLog()));
+            Assert::AreEqual<size_t>(1, LogRetention::ReadIndex(LogRetention::IndexPath(firstLog)).size());
+            Assert::AreEqual<size_t>(1, LogRetention::ReadIndex(LogRetention::IndexPath(sink->CurrentLog())).size());
+            Assert::AreEqual(2, waitForMaintenance(2));
+        }
+    };
+}
@@ -0,0 +1,196 @@
+#include "pch.h"
+#include <common/logger/logger.h>
+#include <common/logger/call_tracer.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/basic_file_sink.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using TestLogger = Microsoft::VisualStudio::CppUnitTestFramework::Logger;
+
+namespace UnitTestsLogger
+{
+    class CountingSink : public spdlog::sinks::base_sink<std::mutex>
+    {
+    public:
+        std::atomic_int count = 0;
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg&) override
+        {
+            count++;
+        }
+
+        void flush_() override
+        {
+        }
+    };
+
+    // Keeps the messages of every thread in the order they were logged
+    class RecordingSink : public spdlog::sinks::base_sink<std::mutex>
+    {
+    public:
+        std::map<size_t, std::vector<std::string>> messagesByThread;
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            messagesByThread[msg.thread_id].emplace_back(msg.payload.data(), msg.payload.size());
+        }
+
+        void flush_() override
+        {
+        }
+    };
+
+    void TraceNested(int depth)
+    {
+        CallTracer tracer{ "Nested" };
+        if (depth > 1)
+        {
+            TraceNested(depth - 1);
+        }
+    }
+
+    LogSettings MakeSettings(bool async, const std::wstring& overflowPolicy = LogSettings::overflowPolicyBlock)
+    {
+        LogSettings settings;
+        settings.asyncLogging = async;
+        settings.asyncOverflowPolicy = overflowPolicy;
+        return settings;
+    }
+
+    bool WaitForCount(const CountingSink& sink, int expected)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (sink.count < expected && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return sink.count == expected;
+    }
+
+    double MeasureCallSite(bool async)
+    {
+        constexpr int iterations = 100000;
+        const auto logPath = std::filesystem::temp_directory_path() / (async ? L"pt-logger-bench-async.txt" : L"pt-logger-bench-sync.txt");
+        auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logPath.wstring(), true);
+        ::Logger::init({ sink }, MakeSettings(async, LogSettings::overflowPolicyOverrunOldest));
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            ::Logger::info(L"Moving window {} to zone {} on monitor {}", i, i % 16, L"\\\\.\\DISPLAY1");
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        ::Logger::init(std::vector<spdlog::sink_ptr>{});
+        return elapsed.count() / iterations;
+    }
+
+    TEST_CLASS (LoggerTests)
+    {
+    public:
+        TEST_METHOD_CLEANUP (Cleanup)
+        {
+            ::Logger::init(std::vector<spdlog::sink_ptr>{});
+        }
+
+        TEST_METHOD (SyncLoggerWritesOnCallingThread)
+        {
+            auto sink = std::make_shared<CountingSink>();
+            ::Logger::init({ sink }, MakeSettings(false));
+
+            ::Logger::info("message");
+
+            Assert::AreEqual(1, sink->count.load());
+        }
+
+        TEST_METHOD (AsyncLoggerDeliversAllMessages)
+        {
+            constexpr int messageCount = 10000;
+            auto sink = std::make_shared<CountingSink>();
+            ::Logger::init({ sink }, MakeSettings(true));
+
+            for (int i = 0; i < messageCount; ++i)
+            {
+                ::Logger::info("message {}", i);
+            }
+            ::Logger::flush();
+
+            Assert::IsTrue(WaitForCount(*sink, messageCount));
+        }
+
+        TEST_METHOD (LogSettingsDefaultsToSyncLogging)
+        {
+            LogSettings settings;
+            Assert::IsFalse(settings.asyncLogging);
+            Assert::AreEqual(LogSettings::defaultAsyncQueueSize, settings.asyncQueueSize);
+            Assert::AreEqual(LogSettings::defaultAsyncOverflowPolicy, settings.asyncOverflowPolicy);
+        }
+
+        TEST_METHOD (LogSettingsDefaultsToNoPerfTrace)
+        {
+            LogSettings settings;
+            Assert::IsFalse(settings.perfTrace);
+        }
+
+        TEST_METHOD (LogSettingsDefaultsToLogSizeBudget)
+        {
+            LogSettings settings;
+            Assert::AreEqual(LogSettings::defaultLogSizeBudgetMB, settings.logSizeBudgetMB);
+        }
+
+        TEST_METHOD (CallTracerIndentationIsPerThread)
+        {
+            constexpr int depth = 3;
+            constexpr int iterations = 500;
+            auto sink = std::make_shared<RecordingSink>();
+            ::Logger::init({ sink }, MakeSettings(false));
+
+            auto trace = [] {
+                for (int i = 0; i < iterations; ++i)
+                {
+                    TraceNested(depth);
+                }
+            };
+            std::thread other(trace);
+            trace();
+            other.join();
+
+            // Every thread goes in and back out on its own, whatever the other one does in between
+            auto indentation = [](int level) { return level == 0 ? std::string{} : std::string(2 * level - 1, ' ') + " - "; };
+            std::vector<std::string> expected;
+            for (int level = 0; level < depth; ++level)
+            {
+                expected.push_back(indentation(level) + "Nested Enter");
+            }
+            for (int level = depth - 1; level >= 0; --level)
+            {
+                expected.push_back(indentation(level) + "Nested Exit");
+            }
+
+            Assert::AreEqual<size_t>(2, sink->messagesByThread.size());
+            for (const auto& [thread, messages] : sink->messagesByThread)
+            {
+                Assert::AreEqual(expected.size() * iterations, messages.size());
+                for (size_t i = 0; i < messages.size(); ++i)
+                {
+                    Assert::AreEqual(expected[i % expected.size()], messages[i]);
+                }
+            }
+        }
+
+        TEST_METHOD (CallSiteCostSyncVsAsync)
+        {
+            const auto syncCost = MeasureCallSite(false);
+            const auto asyncCost = MeasureCallSite(true);
+            TestLogger::WriteMessage(std::format(L"Logger::info call site: sync {:.0f} ns, async {:.0f} ns\n", syncCost, asyncCost).c_str());
+        }
+    };
+}
@@ -0,0 +1,177 @@
+#include "pch.h"
+#include <common/logger/perf_trace.h>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsPerfTrace
+{
+    using PerfTrace::Event;
+    using PerfTrace::RecordType;
+
+    std::vector<PerfTrace::Record> RecordsOfThisThread()
+    {
+        // Each thread's first record is written by the test itself before reading
+        PerfTrace::Counter(Event::IpcSend, -1);
+        for (auto& thread : PerfTrace::Snapshot())
+        {
+            if (!thread.records.empty() && thread.records.back().type == RecordType::Counter && thread.records.back().value == -1)
+            {
+                thread.records.pop_back();
+                return thread.records;
+            }
+        }
+
+        return {};
+    }
+
+    TEST_CLASS (PerfTraceTests)
+    {
+    public:
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            PerfTrace::SetEnabled(true);
+            PerfTrace::Clear();
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup)
+        {
+            PerfTrace::SetEnabled(false);
+            PerfTrace::Clear();
+        }
+
+        TEST_METHOD (SpansAreNested)
+        {
+            {
+                PerfTrace::Span outer{ Event::FancyZonesMoveSizeUpdate };
+                PerfTrace::Span inner{ Event::IpcSend };
+                PerfTrace::Counter(Event::PowerRenameItemsRenamed, 42);
+            }
+
+            const auto records = RecordsOfThisThread();
+            Assert::AreEqual<size_t>(5, records.size());
+            Assert::IsTrue(records[0].event == Event::FancyZonesMoveSizeUpdate && records[0].type == RecordType::Begin);
+            Assert::IsTrue(records[1].event == Event::IpcSend && records[1].type == RecordType::Begin);
+            Assert::IsTrue(records[2].type == RecordType::Counter);
+            Assert::AreEqual<int64_t>(42, records[2].value);
+            Assert::IsTrue(records[3].event == Event::IpcSend && records[3].type == RecordType::End);
+            Assert::IsTrue(records[4].event == Event::FancyZonesMoveSizeUpdate && records[4].type == RecordType::End);
+            Assert::IsTrue(records[0].timestamp <= records[4].timestamp);
+        }
+
+        TEST_METHOD (NothingIsRecordedWhileDisabled)
+        {
+            PerfTrace::SetEnabled(false);
+            {
+                PerfTrace::Span span{ Event::KeyboardManagerHook };
+                PerfTrace::Counter(Event::PowerRenameItemsRenamed, 1);
+            }
+
+            PerfTrace::SetEnabled(true);
+            Assert::IsTrue(RecordsOfThisThread().empty());
+        }
+
+        TEST_METHOD (SpanEndsAfterTracingIsDisabled)
+        {
+            {
+                PerfTrace::Span span{ Event::KeyboardManagerHook };
+                PerfTrace::SetEnabled(false);
+            }
+
+            PerfTrace::SetEnabled(true);
+            const auto records = RecordsOfThisThread();
+            Assert::AreEqual<size_t>(2, records.size());
+            Assert::IsTrue(records[1].type == RecordType::End);
+        }
+
+        TEST_METHOD (RingBufferKeepsLatestRecords)
+        {
+            const auto capacity = PerfTrace::details::ThreadBuffer::capacity;
+            for (uint64_t i = 0; i < capacity + 100; ++i)
+            {
+                PerfTrace::Counter(Event::PowerRenameItemsRenamed, static_cast<int64_t>(i));
+            }
+
+            // The marker written by RecordsOfThisThread pushes out one more record
+            const auto records = RecordsOfThisThread();
+            Assert::AreEqual<size_t>(capacity - 1, records.size());
+            Assert::AreEqual<int64_t>(101, records.front().value);
+            Assert::AreEqual<int64_t>(capacity + 99, records.back().value);
+        }
+
+        TEST_METHOD (ThreadsHaveTheirOwnBuffers)
+        {
+            std::thread worker([] {
+                PerfTrace::Span span{ Event::PowerRenameRegexWorker };
+            });
+            worker.join();
+
+            PerfTrace::Span span{ Event::KeyboardManagerHook };
+            size_t threadsWithRecords = 0;
+            for (const auto& thread : PerfTrace::Snapshot())
+            {
+                threadsWithRecords += !thread.records.empty();
+            }
+
+            Assert::AreEqual<size_t>(2, threadsWithRecords);
+        }
+
+        TEST_METHOD (ReadsWhileThreadsRecord)
+        {
+            std::atomic<bool> stop = false;
+            std::vector<std::thread> writers;
+            for (int i = 0; i < 4; ++i)
+            {
+                writers.emplace_back([&stop] {
+                    for (int64_t value = 0; !stop; ++value)
+                    {
+                        PerfTrace::Counter(Event::IpcReceive, value);
+                    }
+                });
+            }
+
+            for (int i = 0; i < 50; ++i)
+            {
+                for (const auto& thread : PerfTrace::Snapshot())
+                {
+                    // Every writer counts up by one, a torn or reordered record would break the sequence
+                    for (size_t j = 1; j < thread.records.size(); ++j)
+                    {
+                        Assert::AreEqual(thread.records[j - 1].value + 1, thread.records[j].value);
+                        Assert::IsTrue(thread.records[j - 1].timestamp <= thread.records[j].timestamp);
+                    }
+                }
+            }
+
+            stop = true;
+            for (auto& writer : writers)
+            {
+                writer.join();
+            }
+        }
+
+        TEST_METHOD (WritesChromeTrace)
+        {
+            std::vector<PerfTrace::ThreadTrace> threads{
+                { 3,
+                  { { 1000, 0, Event::IpcSend, RecordType::End },
+                    { 1500, 0, Event::KeyboardManagerHook, RecordType::Begin },
+                    { 2250, 7, Event::PowerRenameItemsRenamed, RecordType::Counter },
+                    { 12345, 0, Event::KeyboardManagerHook, RecordType::End } } }
+            };
+
+            std::ostringstream stream;
+            PerfTrace::WriteChromeTrace(stream, threads, 10);
+
+            const std::string expected = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                                         "{\"name\":\"HookProc\",\"cat\":\"KeyboardManager\",\"ph\":\"B\",\"ts\":1.500,\"pid\":10,\"tid\":3},\n"
+                                         "{\"name\":\"ItemsRenamed\",\"cat\":\"PowerRename\",\"ph\":\"C\",\"ts\":2.250,\"pid\":10,\"tid\":3,\"args\":{\"value\":7}},\n"
+                                         "{\"name\":\"HookProc\",\"cat\":\"KeyboardManager\",\"ph\":\"E\",\"ts\":12.345,\"pid\":10,\"tid\":3}\n"
+                                         "]}\n";
+            Assert::AreEqual(expected, stream.str());
+        }
+    };
+}
@@ -0,0 +1,330 @@
+#include "pch.h"
+#include <common/interop/pipe_message_channel.h>
+#include <common/interop/two_way_pipe_message_ipc.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsPipeMessageChannel
+{
+    // In-process stand-in for a named pipe connection.
+    struct LoopbackPipe
+    {
+        std::mutex mutex;
+        std::condition_variable data_ready;
+        std::deque<uint8_t> data;
+        bool connected = false;
+        bool listening = true;
+        int connections = 0;
+        int writes = 0;
+    };
+
+    class LoopbackTransport : public ipc::ByteTransport
+    {
+    public:
+        explicit LoopbackTransport(std::shared_ptr<LoopbackPipe> pipe) :
+            pipe(std::move(pipe))
+        {
+        }
+
+        bool connect() override
+        {
+            std::unique_lock lock{ pipe->mutex };
+            if (!pipe->listening)
+            {
+                return false;
+            }
+            pipe->connected = true;
+            pipe->connections++;
+            return true;
+        }
+
+        bool is_connected() const override
+        {
+            std::unique_lock lock{ pipe->mutex };
+            return pipe->connected;
+        }
+
+        bool write(const uint8_t* buffer, size_t size) override
+        {
+            {
+                std::unique_lock lock{ pipe->mutex };
+                if (!pipe->connected)
+                {
+                    return false;
+                }
+                pipe->data.insert(pipe->data.end(), buffer, buffer + size);
+                pipe->writes++;
+            }
+            pipe->data_ready.notify_all();
+            return true;
+        }
+
+        bool read(uint8_t* buffer, size_t size) override
+        {
+            std::unique_lock lock{ pipe->mutex };
+            pipe->data_ready.wait(lock, [&] { return pipe->data.size() >= size || !pipe->connected; });
+            if (pipe->data.size() < size)
+            {
+                return false;
+            }
+            std::copy_n(pipe->data.begin(), size, buffer);
+            pipe->data.erase(pipe->data.begin(), pipe->data.begin() + size);
+            return true;
+        }
+
+        void disconnect() override
+        {
+            {
+                std::unique_lock lock{ pipe->mutex };
+                pipe->connected = false;
+            }
+            pipe->data_ready.notify_all();
+        }
+
+    private:
+        std::shared_ptr<LoopbackPipe> pipe;
+    };
+
+    std::wstring MakeSettingsSizedMessage()
+    {
+        // Roughly the size of the settings json the runner sends to the Settings window.
+        return std::wstring(16 * 1024, L'x');
+    }
+
+    TEST_CLASS (PipeMessageChannelTests)
+    {
+    public:
+        TEST_METHOD (FrameRoundTrip)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            LoopbackTransport transport{ pipe };
+            transport.connect();
+
+            std::vector<uint8_t> buffer;
+            ipc::framing::append_frame(buffer, { 7, 3, L"{\"refresh\":{}}" });
+            Assert::IsTrue(transport.write(buffer.data(), buffer.size()));
+
+            ipc::MessageFrame frame;
+            Assert::IsTrue(ipc::framing::read_frame(transport, frame));
+            Assert::AreEqual(7u, frame.id);
+            Assert::AreEqual(3u, frame.reply_to);
+            Assert::AreEqual(std::wstring{ L"{\"refresh\":{}}" }, frame.payload);
+        }
+
+        TEST_METHOD (EmptyMessageIsDelivered)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            LoopbackTransport transport{ pipe };
+            transport.connect();
+
+            std::vector<uint8_t> buffer;
+            ipc::framing::append_frame(buffer, { 0, 0, L"" });
+            ipc::framing::append_frame(buffer, { 0, 0, L"next" });
+            transport.write(buffer.data(), buffer.size());
+
+            ipc::MessageFrame frame;
+            Assert::IsTrue(ipc::framing::read_frame(transport, frame));
+            Assert::IsTrue(frame.payload.empty());
+            Assert::IsTrue(ipc::framing::read_frame(transport, frame));
+            Assert::AreEqual(std::wstring{ L"next" }, frame.payload);
+        }
+
+        TEST_METHOD (CorruptedHeaderIsRejected)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            LoopbackTransport transport{ pipe };
+            transport.connect();
+
+            ipc::framing::Header header{ ipc::framing::max_payload_bytes + 2, 0, 0 };
+            transport.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+
+            ipc::MessageFrame frame;
+            Assert::IsFalse(ipc::framing::read_frame(transport, frame));
+        }
+
+        TEST_METHOD (BatchIsWrittenOnceOverPersistentConnection)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            ipc::FrameWriter writer{ std::make_unique<LoopbackTransport>(pipe) };
+
+            std::vector<ipc::MessageFrame> batch{ { 0, 0, L"a" }, { 0, 0, L"b" }, { 0, 0, L"c" } };
+            Assert::IsTrue(writer.write(batch));
+            Assert::IsTrue(writer.write(batch));
+
+            Assert::AreEqual(1, pipe->connections);
+            Assert::AreEqual(2, pipe->writes);
+
+            LoopbackTransport reader{ pipe };
+            ipc::MessageFrame frame;
+            for (const auto expected : { L"a", L"b", L"c", L"a", L"b", L"c" })
+            {
+                Assert::IsTrue(ipc::framing::read_frame(reader, frame));
+                Assert::AreEqual(std::wstring{ expected }, frame.payload);
+            }
+        }
+
+        TEST_METHOD (WriterReconnectsAfterDisconnect)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            ipc::FrameWriter writer{ std::make_unique<LoopbackTransport>(pipe) };
+            std::vector<ipc::MessageFrame> batch{ { 0, 0, L"a" } };
+
+            Assert::IsTrue(writer.write(batch));
+            LoopbackTransport{ pipe }.disconnect();
+            Assert::IsTrue(writer.write(batch));
+            Assert::AreEqual(2, pipe->connections);
+        }
+
+        TEST_METHOD (WriterFailsWhenOtherSideIsNotListening)
+        {
+            auto pipe = std::make_shared<LoopbackPipe>();
+            pipe->listening = false;
+            ipc::FrameWriter writer{ std::make_unique<LoopbackTransport>(pipe) };
+
+            Assert::IsFalse(writer.write({ { 0, 0, L"a" } }));
+        }
+
+        TEST_METHOD (ResponsesAreMatchedToRequests)
+        {
+            ipc::PendingResponses pending;
+            std::wstring first, second;
+            const auto firstId = pending.add([&](const std::wstring& response) { first = response; });
+            const auto secondId = pending.add([&](const std::wstring& response) { second = response; });
+            Assert::AreNotEqual(firstId, secondId);
+
+            Assert::IsTrue(pending.complete({ 0, secondId, L"2" }));
+            Assert::IsTrue(pending.complete({ 0, firstId, L"1" }));
+            Assert::IsFalse(pending.complete({ 0, firstId, L"1" }));
+
+            Assert::AreEqual(std::wstring{ L"1" }, first);
+            Assert::AreEqual(std::wstring{ L"2" }, second);
+            Assert::AreEqual(size_t{ 0 }, pending.size());
+        }
+
+        TEST_METHOD (LoopbackThroughput)
+        {
+            constexpr int messageCount = 2000;
+            constexpr int batchSize = 8;
+            auto pipe = std::make_shared<LoopbackPipe>();
+            ipc::FrameWriter writer{ std::make_unique<LoopbackTransport>(pipe) };
+            LoopbackTransport reader{ pipe };
+            reader.connect();
+
+            const auto message = MakeSettingsSizedMessage();
+            const auto start = std::chrono::high_resolution_clock::now();
+            auto consumer = std::async(std::launch::async, [&] {
+                ipc::MessageFrame frame;
+                int received = 0;
+                while (received < messageCount && ipc::framing::read_frame(reader, frame))
+                {
+                    received++;
+                }
+                return received;
+            });
+
+            std::vector<ipc::MessageFrame> batch;
+            for (int i = 0; i < messageCount; i += batchSize)
+            {
+                batch.assign(batchSize, { 0, 0, message });
+                writer.write(batch);
+            }
+
+            Assert::AreEqual(messageCount, consumer.get());
+            const auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            Logger::WriteMessage(std::format(L"Loopback: {} messages of {} chars, {:.0f} msg/s\n", messageCount, message.size(), messageCount / elapsed).c_str());
+        }
+    };
+
+    std::promise<void>* g_received = nullptr;
+    std::atomic_int g_receivedCount = 0;
+    int g_expectedCount = 0;
+
+    void OnMessage(const std::wstring&)
+    {
+        if (++g_receivedCount == g_expectedCount)
+        {
+            g_received->set_value();
+        }
+    }
+
+    TwoWayPipeMessageIPC* g_responder = nullptr;
+
+    void OnRequest(uint32_t requestId, const std::wstring& message)
+    {
+        g_responder->reply(requestId, message);
+    }
+
+    TEST_CLASS (TwoWayPipeMessageIPCTests)
+    {
+    public:
+        TEST_METHOD (NamedPipeThroughput)
+        {
+            constexpr int messageCount = 500;
+            const std::wstring serverPipe = L"\\\\.\\pipe\\powertoys_ipc_tests_server";
+            const std::wstring clientPipe = L"\\\\.\\pipe\\powertoys_ipc_tests_client";
+
+            std::promise<void> received;
+            g_received = &received;
+            g_receivedCount = 0;
+            g_expectedCount = messageCount;
+
+            TwoWayPipeMessageIPC server{ serverPipe, clientPipe, OnMessage };
+            TwoWayPipeMessageIPC client{ clientPipe, serverPipe, OnMessage };
+            server.start(nullptr);
+            client.start(nullptr);
+
+            const auto message = MakeSettingsSizedMessage();
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < messageCount; ++i)
+            {
+                client.send(message);
+            }
+
+            Assert::IsTrue(received.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+            const auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            Logger::WriteMessage(std::format(L"Named pipe: {} messages of {} chars, {:.0f} msg/s\n", messageCount, message.size(), messageCount / elapsed).c_str());
+
+            client.end();
+            server.end();
+        }
+
+        TEST_METHOD (NamedPipeRequestLatency)
+        {
+            constexpr int requestCount = 200;
+            const std::wstring serverPipe = L"\\\\.\\pipe\\powertoys_ipc_tests_responder";
+            const std::wstring clientPipe = L"\\\\.\\pipe\\powertoys_ipc_tests_requester";
+
+            TwoWayPipeMessageIPC server{ serverPipe, clientPipe, OnRequest };
+            TwoWayPipeMessageIPC client{ clientPipe, serverPipe, OnMessage };
+            g_responder = &server;
+            server.start(nullptr);
+            client.start(nullptr);
+
+            const auto message = MakeSettingsSizedMessage();
+            std::chrono::duration<double, std::milli> total{};
+            for (int i = 0; i < requestCount; ++i)
+            {
+                std::promise<std::wstring> response;
+                const auto start = std::chrono::high_resolution_clock::now();
+                client.send(message, [&response](const std::wstring& reply) { response.set_value(reply); });
+                auto future = response.get_future();
+                Assert::IsTrue(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+                total += std::chrono::high_resolution_clock::now() - start;
+                Assert::AreEqual(message.size(), future.get().size());
+            }
+
+            Logger::WriteMessage(std::format(L"Named pipe: average round trip {:.3f} ms\n", total.count() / requestCount).c_str());
+
+            client.end();
+            server.end();
+            g_responder = nullptr;
+        }
+    };
+}
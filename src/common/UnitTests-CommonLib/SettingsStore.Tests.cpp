@@ -0,0 +1,164 @@
+#include "pch.h"
+#include <common/SettingsAPI/settings_store.h>
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsSettingsStore
+{
+    const std::vector<std::wstring> moduleKeys = {
+        L"AlwaysOnTop", L"Awake", L"ColorPicker", L"FancyZones", L"File Explorer", L"FindMyMouse", L"Image Resizer",
+        L"Keyboard Manager", L"MouseHighlighter", L"MousePointerCrosshairs", L"PowerRename", L"PowerToys Run",
+        L"Shortcut Guide", L"Video Conference"
+    };
+
+    std::filesystem::path MakeRoot(std::wstring_view name)
+    {
+        auto root = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        return root;
+    }
+
+    json::JsonObject MakeModuleSettings(std::wstring_view key)
+    {
+        json::JsonObject properties;
+        for (int i = 0; i < 40; ++i)
+        {
+            json::JsonObject property;
+            property.SetNamedValue(L"value", json::value(std::format(L"{} value {}", key, i)));
+            properties.SetNamedValue(std::format(L"property_{}", i), property);
+        }
+
+        json::JsonObject settings;
+        settings.SetNamedValue(L"name", json::value(key));
+        settings.SetNamedValue(L"version", json::value(L"1.0"));
+        settings.SetNamedValue(L"properties", properties);
+        return settings;
+    }
+
+    std::filesystem::path SettingsFile(const std::filesystem::path& root, const std::wstring& key)
+    {
+        return root / key / L"settings.json";
+    }
+
+    TEST_CLASS (SettingsStoreTests)
+    {
+    public:
+        TEST_METHOD (WriteThenRead)
+        {
+            const auto root = MakeRoot(L"pt-settings-store-roundtrip");
+            const auto file = SettingsFile(root, L"FancyZones");
+            const auto settings = MakeModuleSettings(L"FancyZones");
+
+            // The module folder doesn't exist yet
+            Assert::IsTrue(settings_store::write(file, settings));
+
+            auto read = settings_store::read(file);
+            Assert::IsTrue(read.has_value());
+            Assert::AreEqual(std::wstring{ settings.Stringify() }, std::wstring{ read->Stringify() });
+            Assert::AreEqual(size_t{ 1 }, static_cast<size_t>(std::distance(std::filesystem::directory_iterator{ file.parent_path() }, std::filesystem::directory_iterator{})));
+        }
+
+        TEST_METHOD (ConcurrentWritesLeaveOneValidFile)
+        {
+            const auto root = MakeRoot(L"pt-settings-store-concurrent");
+            const auto file = SettingsFile(root, L"PowerToys Run");
+            Assert::IsTrue(settings_store::write(file, MakeModuleSettings(L"PowerToys Run")));
+
+            std::vector<std::thread> writers;
+            for (int i = 0; i < 8; ++i)
+            {
+                writers.emplace_back([&file, i] {
+                    for (int j = 0; j < 20; ++j)
+                    {
+                        settings_store::write(file, MakeModuleSettings(std::format(L"writer {}", i)));
+                    }
+                });
+            }
+
+            for (auto& writer : writers)
+            {
+                writer.join();
+            }
+
+            auto read = settings_store::read(file);
+            Assert::IsTrue(read.has_value());
+            Assert::IsTrue(std::wstring{ read->GetNamedString(L"name") }.starts_with(L"writer "));
+            Assert::AreEqual(size_t{ 1 }, static_cast<size_t>(std::distance(std::filesystem::directory_iterator{ file.parent_path() }, std::filesystem::directory_iterator{})));
+        }
+
+        TEST_METHOD (WriteReplacesExistingFile)
+        {
+            const auto root = MakeRoot(L"pt-settings-store-replace");
+            const auto file = SettingsFile(root, L"Awake");
+            Assert::IsTrue(settings_store::write(file, MakeModuleSettings(L"Awake")));
+
+            json::JsonObject updated;
+            updated.SetNamedValue(L"name", json::value(L"updated"));
+            Assert::IsTrue(settings_store::write(file, updated));
+
+            auto read = settings_store::read(file);
+            Assert::IsTrue(read.has_value());
+            Assert::AreEqual(std::wstring{ L"updated" }, std::wstring{ read->GetNamedString(L"name") });
+        }
+
+        TEST_METHOD (ReadSkipsUtf8Bom)
+        {
+            const auto root = MakeRoot(L"pt-settings-store-bom");
+            const auto file = root / L"settings.json";
+            std::ofstream{ file, std::ios::binary } << "\xEF\xBB\xBF{\"name\":\"\xC3\xA9\"}";
+
+            auto read = settings_store::read(file);
+            Assert::IsTrue(read.has_value());
+            Assert::AreEqual(std::wstring{ L"\u00e9" }, std::wstring{ read->GetNamedString(L"name") });
+        }
+
+        TEST_METHOD (ReadInvalidFiles)
+        {
+            const auto root = MakeRoot(L"pt-settings-store-invalid");
+            std::ofstream{ root / L"empty.json" };
+            std::ofstream{ root / L"array.json" } << "[]";
+            std::ofstream{ root / L"broken.json" } << "{\"name\":";
+
+            Assert::IsFalse(settings_store::read(root / L"missing.json").has_value());
+            Assert::IsFalse(settings_store::read(root / L"empty.json").has_value());
+            Assert::IsFalse(settings_store::read(root / L"array.json").has_value());
+            Assert::IsFalse(settings_store::read(root / L"broken.json").has_value());
+        }
+
+        TEST_METHOD (StartupSettingsLoadBenchmark)
+        {
+            constexpr int iterations = 50;
+            const auto root = MakeRoot(L"pt-settings-store-startup");
+            for (const auto& key : moduleKeys)
+            {
+                Assert::IsTrue(settings_store::write(SettingsFile(root, key), MakeModuleSettings(key)));
+            }
+
+            auto measure = [&](auto&& load) {
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < iterations; ++i)
+                {
+                    for (const auto& key : moduleKeys)
+                    {
+                        Assert::IsTrue(load(SettingsFile(root, key)).has_value());
+                    }
+                }
+                const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+                return elapsed.count() / iterations;
+            };
+
+            const auto streamed = measure([](const std::filesystem::path& file) { return json::from_file(file.wstring()); });
+            const auto mapped = measure([](const std::filesystem::path& file) { return settings_store::read(file); });
+            Logger::WriteMessage(std::format(L"Loading the settings of {} modules: json::from_file {:.0f} us, settings_store::read {:.0f} us\n",
+                                             moduleKeys.size(),
+                                             streamed,
+                                             mapped)
+                                     .c_str());
+        }
+    };
+}
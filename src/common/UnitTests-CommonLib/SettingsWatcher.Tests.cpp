@@ -0,0 +1,322 @@
+#include "pch.h"
+#include <common/SettingsAPI/FileWatcher.h>
+#include <common/SettingsAPI/SettingsWatcher.h>
+
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsSettingsWatcher
+{
+    // Reports the changes pushed by the test instead of the file system ones.
+    class FakeBackend : public SettingsWatcher::Backend
+    {
+    public:
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::vector<std::filesystem::path> changes;
+            // Watched directories that fail, like ones that get deleted
+            std::vector<std::filesystem::path> lost;
+            std::vector<std::filesystem::path> directories;
+            // Directories that fail to be watched, like ones that don't exist
+            std::set<std::filesystem::path> missing;
+            std::vector<std::chrono::milliseconds> timeouts;
+            bool woken = false;
+            bool stopped = false;
+        };
+
+        explicit FakeBackend(std::shared_ptr<State> state) :
+            state(std::move(state))
+        {
+        }
+
+        bool WatchDirectory(const std::filesystem::path& directory) override
+        {
+            std::unique_lock lock{ state->mutex };
+            if (state->missing.contains(directory))
+            {
+                return false;
+            }
+
+            state->directories.push_back(directory);
+            return true;
+        }
+
+        void UnwatchDirectory(const std::filesystem::path& directory) override
+        {
+            std::unique_lock lock{ state->mutex };
+            std::erase(state->directories, directory);
+        }
+
+        bool Wait(std::chrono::milliseconds timeout, std::vector<std::filesystem::path>& changes, std::vector<std::filesystem::path>& lost) override
+        {
+            std::unique_lock lock{ state->mutex };
+            state->timeouts.push_back(timeout);
+            auto ready = [this] { return state->stopped || state->woken || !state->changes.empty() || !state->lost.empty(); };
+            if (timeout == SettingsWatcher::Infinite)
+            {
+                state->cv.wait(lock, ready);
+            }
+            else
+            {
+                state->cv.wait_for(lock, timeout, ready);
+            }
+
+            changes.insert(changes.end(), state->changes.begin(), state->changes.end());
+            state->changes.clear();
+            for (const auto& directory : state->lost)
+            {
+                std::erase(state->directories, directory);
+            }
+            lost.insert(lost.end(), state->lost.begin(), state->lost.end());
+            state->lost.clear();
+            state->woken = false;
+            return !state->stopped;
+        }
+
+        void Wake() override
+        {
+            std::unique_lock lock{ state->mutex };
+            state->woken = true;
+            state->cv.notify_all();
+        }
+
+        void Stop() override
+        {
+            std::unique_lock lock{ state->mutex };
+            state->stopped = true;
+            state->cv.notify_all();
+        }
+
+    private:
+        std::shared_ptr<State> state;
+    };
+
+    void Change(FakeBackend::State& state, const std::filesystem::path& path)
+    {
+        std::unique_lock lock{ state.mutex };
+        state.changes.push_back(path);
+        state.cv.notify_all();
+    }
+
+    const std::filesystem::path settingsRoot = L"C:\\PowerToys";
+    const std::filesystem::path fancyZonesSettings = settingsRoot / L"FancyZones" / L"settings.json";
+    const std::filesystem::path fancyZonesLayouts = settingsRoot / L"FancyZones" / L"custom-layouts.json";
+    const std::filesystem::path generalSettings = settingsRoot / L"settings.json";
+
+    TEST_CLASS (SettingsWatcherTests)
+    {
+    public:
+        TEST_METHOD (BurstOfWritesResultsInOneCallback)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            std::atomic_int calls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(20) };
+                watcher.Watch(fancyZonesSettings, [&] { calls++; });
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    Change(*state, fancyZonesSettings);
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+
+            Assert::AreEqual(1, calls.load());
+        }
+
+        TEST_METHOD (CallbacksArePerPath)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            std::atomic_int settingsCalls = 0;
+            std::atomic_int layoutsCalls = 0;
+            std::atomic_int generalCalls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1) };
+                watcher.Watch(fancyZonesSettings, [&] { settingsCalls++; });
+                watcher.Watch(fancyZonesLayouts, [&] { layoutsCalls++; });
+                watcher.Watch(generalSettings, [&] { generalCalls++; });
+
+                // Paths are compared case-insensitively
+                Change(*state, settingsRoot / L"FancyZones" / L"CUSTOM-LAYOUTS.json");
+                Change(*state, settingsRoot / L"FancyZones" / L"unrelated.json");
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            Assert::AreEqual(0, settingsCalls.load());
+            Assert::AreEqual(1, layoutsCalls.load());
+            Assert::AreEqual(0, generalCalls.load());
+        }
+
+        TEST_METHOD (DirectoryChangeNotifiesEveryFileInIt)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            std::atomic_int calls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1) };
+                watcher.Watch(fancyZonesSettings, [&] { calls++; });
+                watcher.Watch(fancyZonesLayouts, [&] { calls++; });
+                watcher.Watch(generalSettings, [&] { calls++; });
+
+                Change(*state, settingsRoot / L"FancyZones");
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            Assert::AreEqual(2, calls.load());
+        }
+
+        TEST_METHOD (DirectoriesAreWatchedOnce)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            SettingsWatcher watcher{ std::make_unique<FakeBackend>(state) };
+            auto first = watcher.Watch(fancyZonesSettings, [] {});
+            auto second = watcher.Watch(fancyZonesLayouts, [] {});
+            watcher.Watch(generalSettings, [] {});
+
+            Assert::AreEqual(size_t{ 2 }, state->directories.size());
+            watcher.Unwatch(first);
+            Assert::AreEqual(size_t{ 2 }, state->directories.size());
+            watcher.Unwatch(second);
+            Assert::AreEqual(size_t{ 1 }, state->directories.size());
+        }
+
+        TEST_METHOD (MissingDirectoryIsWatchedOnceCreated)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            state->missing.insert(fancyZonesSettings.parent_path());
+            std::atomic_int calls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1), std::chrono::milliseconds(10) };
+                watcher.Watch(fancyZonesSettings, [&] { calls++; });
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                {
+                    std::unique_lock lock{ state->mutex };
+                    Assert::IsTrue(state->directories.empty());
+                    state->missing.clear();
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                std::unique_lock lock{ state->mutex };
+                Assert::AreEqual(size_t{ 1 }, state->directories.size());
+                Assert::IsTrue(state->timeouts.back() == SettingsWatcher::Infinite);
+            }
+
+            // The settings may have been written while the directory wasn't watched
+            Assert::AreEqual(1, calls.load());
+        }
+
+        TEST_METHOD (DeletedDirectoryIsWatchedOnceCreatedAgain)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            std::atomic_int calls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1), std::chrono::milliseconds(10) };
+                watcher.Watch(fancyZonesSettings, [&] { calls++; });
+                {
+                    std::unique_lock lock{ state->mutex };
+                    state->missing.insert(fancyZonesSettings.parent_path());
+                    state->lost.push_back(fancyZonesSettings.parent_path());
+                    state->cv.notify_all();
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                {
+                    std::unique_lock lock{ state->mutex };
+                    Assert::IsTrue(state->directories.empty());
+                    state->missing.clear();
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                std::unique_lock lock{ state->mutex };
+                Assert::AreEqual(size_t{ 1 }, state->directories.size());
+            }
+
+            // The settings may have been written again while the directory wasn't watched
+            Assert::AreEqual(1, calls.load());
+        }
+
+        TEST_METHOD (UnwatchingMissingDirectoryStopsRetrying)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            state->missing.insert(fancyZonesSettings.parent_path());
+            SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1), std::chrono::milliseconds(10) };
+            watcher.Unwatch(watcher.Watch(fancyZonesSettings, [] {}));
+            {
+                std::unique_lock lock{ state->mutex };
+                state->missing.clear();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            std::unique_lock lock{ state->mutex };
+            Assert::IsTrue(state->directories.empty());
+        }
+
+        TEST_METHOD (UnwatchedCallbackIsNotCalled)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            std::atomic_int calls = 0;
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(20) };
+                auto registration = watcher.Watch(fancyZonesSettings, [&] { calls++; });
+                Change(*state, fancyZonesSettings);
+                watcher.Unwatch(registration);
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            Assert::AreEqual(0, calls.load());
+        }
+
+        TEST_METHOD (IdleWatcherDoesNotWakeUp)
+        {
+            auto state = std::make_shared<FakeBackend::State>();
+            {
+                SettingsWatcher watcher{ std::make_unique<FakeBackend>(state), std::chrono::milliseconds(1) };
+                watcher.Watch(fancyZonesSettings, [] {});
+                Change(*state, fancyZonesSettings);
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            // Only the debounce of the single change is waited for with a timeout
+            std::unique_lock lock{ state->mutex };
+            Assert::IsTrue(state->timeouts.front() == SettingsWatcher::Infinite);
+            Assert::IsTrue(state->timeouts.back() == SettingsWatcher::Infinite);
+            Assert::IsTrue(state->timeouts.size() <= 5);
+        }
+
+        TEST_METHOD (FileWatcherReactionTime)
+        {
+            const auto directory = std::filesystem::temp_directory_path() / L"pt-settings-watcher-test";
+            std::filesystem::create_directories(directory);
+            const auto file = directory / L"settings.json";
+            std::ofstream{ file } << "{}";
+
+            std::promise<std::chrono::steady_clock::time_point> changed;
+            std::atomic_bool notified = false;
+            FileWatcher watcher{ file.wstring(), [&] {
+                                    if (!notified.exchange(true))
+                                    {
+                                        changed.set_value(std::chrono::steady_clock::now());
+                                    }
+                                } };
+
+            const auto written = std::chrono::steady_clock::now();
+            std::ofstream{ file } << "{\"changed\":true}";
+
+            auto future = changed.get_future();
+            Assert::IsTrue(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+            const std::chrono::duration<double, std::milli> latency = future.get() - written;
+            Logger::WriteMessage(std::format(L"FileWatcher reaction time: {:.1f} ms\n", latency.count()).c_str());
+            Assert::IsTrue(latency < std::chrono::milliseconds(100));
+        }
+    };
+}
@@ -0,0 +1,123 @@
+#include "pch.h"
+#include <common/SettingsAPI/shared_settings.h>
+
+#include <array>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsSharedSettings
+{
+    struct Payload
+    {
+        uint32_t first;
+        uint32_t values[31];
+    };
+
+    constexpr uint32_t layout = 1;
+
+    // Zeroed like a new section
+    struct Memory
+    {
+        alignas(8) std::array<std::byte, shared_settings::block<Payload>::size> bytes{};
+    };
+
+    Payload MakePayload(uint32_t value)
+    {
+        Payload payload{ .first = value };
+        for (auto& item : payload.values)
+        {
+            item = value;
+        }
+        return payload;
+    }
+
+    TEST_CLASS (SharedSettingsTests)
+    {
+    public:
+        TEST_METHOD (NothingPublished)
+        {
+            Memory memory;
+            shared_settings::block<Payload> block{ memory.bytes.data(), layout };
+
+            Payload payload{};
+            uint64_t generation = 0;
+            Assert::IsTrue(block.read(payload, generation) == shared_settings::read_result::unavailable);
+        }
+
+        TEST_METHOD (WriteThenRead)
+        {
+            Memory memory;
+            shared_settings::block<Payload> writer{ memory.bytes.data(), layout };
+            shared_settings::block<Payload> reader{ memory.bytes.data(), layout };
+
+            const uint64_t published = writer.write(MakePayload(7));
+
+            Payload payload{};
+            uint64_t generation = 0;
+            Assert::IsTrue(reader.read(payload, generation) == shared_settings::read_result::updated);
+            Assert::AreEqual(published, generation);
+            Assert::AreEqual(7u, payload.first);
+            Assert::AreEqual(7u, payload.values[30]);
+
+            Assert::IsTrue(reader.read(payload, generation) == shared_settings::read_result::unchanged);
+
+            writer.write(MakePayload(8));
+            Assert::IsTrue(reader.read(payload, generation) == shared_settings::read_result::updated);
+            Assert::AreEqual(8u, payload.first);
+        }
+
+        TEST_METHOD (OtherLayoutIsUnavailable)
+        {
+            Memory memory;
+            shared_settings::block<Payload> writer{ memory.bytes.data(), layout };
+            shared_settings::block<Payload> reader{ memory.bytes.data(), layout + 1 };
+
+            writer.write(MakePayload(7));
+
+            Payload payload{};
+            uint64_t generation = 0;
+            Assert::IsTrue(reader.read(payload, generation) == shared_settings::read_result::unavailable);
+            Assert::AreEqual(uint64_t{ 0 }, generation);
+        }
+
+        TEST_METHOD (ConcurrentReadsAreConsistent)
+        {
+            Memory memory;
+            shared_settings::block<Payload> writer{ memory.bytes.data(), layout };
+            shared_settings::block<Payload> reader{ memory.bytes.data(), layout };
+            writer.write(MakePayload(0));
+
+            constexpr uint32_t writes = 20000;
+            std::thread writing([&] {
+                for (uint32_t i = 1; i <= writes; ++i)
+                {
+                    writer.write(MakePayload(i));
+                }
+            });
+
+            uint64_t generation = 0;
+            uint32_t last = 0;
+            bool torn = false;
+            bool backwards = false;
+            while (last < writes)
+            {
+                Payload payload{};
+                if (reader.read(payload, generation) == shared_settings::read_result::updated)
+                {
+                    for (auto item : payload.values)
+                    {
+                        torn |= item != payload.first;
+                    }
+
+                    backwards |= payload.first < last;
+                    last = payload.first;
+                }
+            }
+
+            writing.join();
+            Assert::IsFalse(torn);
+            Assert::IsFalse(backwards);
+        }
+    };
+}
@@ -0,0 +1,215 @@
+#include "pch.h"
+#include <common/updating/update_cache.h>
+
+#include <fstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTestsUpdateCache
+{
+    const std::wstring releases_url = L"https://api.github.com/repos/microsoft/PowerToys/releases/latest";
+
+    // Answers like the GitHub API: 304 while the request's validators match the current release
+    class MetadataServer : public updating::metadata_source
+    {
+    public:
+        updating::metadata_response get(const std::wstring&, const std::wstring& etag, const std::wstring& last_modified) override
+        {
+            requests++;
+            received_etag = etag;
+            received_last_modified = last_modified;
+
+            const bool etag_matches = !etag.empty() && etag == this->etag;
+            const bool date_matches = this->etag.empty() && !last_modified.empty() && last_modified == this->last_modified;
+            if (etag_matches || date_matches)
+            {
+                return { 304 };
+            }
+
+            return { 200, this->etag, this->last_modified, body };
+        }
+
+        std::wstring body = L"{\"tag_name\":\"v0.60.0\"}";
+        std::wstring etag = L"W/\"1\"";
+        std::wstring last_modified = L"Tue, 05 Jul 2022 17:00:00 GMT";
+        std::wstring received_etag;
+        std::wstring received_last_modified;
+        size_t requests = 0;
+    };
+
+    class FileServer : public updating::range_source
+    {
+    public:
+        explicit FileServer(std::string text) :
+            content(text.begin(), text.end())
+        {
+        }
+
+        updating::remote_file_info query() override
+        {
+            queries++;
+            if (offline)
+            {
+                throw std::runtime_error("Host not found");
+            }
+
+            return { content.size(), true, L"\"installer\"" };
+        }
+
+        void read(uint64_t offset, uint64_t length, const std::function<bool(std::span<const uint8_t>)>& sink) override
+        {
+            sink({ content.data() + offset, static_cast<size_t>(length) });
+        }
+
+        std::wstring sha256() const
+        {
+            updating::sha256 hash;
+            hash.update(content);
+            return hash.finish();
+        }
+
+        std::vector<uint8_t> content;
+        bool offline = false;
+        size_t queries = 0;
+    };
+
+    TEST_CLASS (UpdateCacheTests)
+    {
+        std::filesystem::path cacheFile;
+        std::filesystem::path installer;
+
+        std::string ReadInstaller()
+        {
+            std::ifstream file(installer, std::ios::binary);
+            return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            cacheFile = std::filesystem::temp_directory_path() / L"PowerToysUpdateCacheTest.json";
+            installer = std::filesystem::temp_directory_path() / L"PowerToysUpdateCacheTest.exe";
+            std::filesystem::remove(cacheFile);
+            std::filesystem::remove(installer);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup)
+        {
+            std::filesystem::remove(cacheFile);
+            std::filesystem::remove(installer);
+        }
+
+        TEST_METHOD (UnchangedMetadataComesFromCache)
+        {
+            MetadataServer server;
+            updating::update_cache cache{ cacheFile };
+
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::IsTrue(server.received_etag.empty());
+
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::AreEqual(server.etag, server.received_etag);
+            Assert::AreEqual(server.last_modified, server.received_last_modified);
+
+            const auto metrics = cache.metrics();
+            Assert::AreEqual<uint64_t>(2, metrics.metadata_requests);
+            Assert::AreEqual<uint64_t>(1, metrics.metadata_not_modified);
+            Assert::AreEqual<uint64_t>(server.body.size(), metrics.metadata_bytes_saved);
+        }
+
+        TEST_METHOD (ChangedMetadataReplacesCache)
+        {
+            MetadataServer server;
+            updating::update_cache cache{ cacheFile };
+            cache.fetch_metadata(server, releases_url);
+
+            server.body = L"{\"tag_name\":\"v0.61.0\"}";
+            server.etag = L"W/\"2\"";
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::AreEqual<uint64_t>(1, cache.metrics().metadata_not_modified);
+        }
+
+        TEST_METHOD (UsesLastModifiedWithoutETag)
+        {
+            MetadataServer server;
+            server.etag.clear();
+            updating::update_cache cache{ cacheFile };
+            cache.fetch_metadata(server, releases_url);
+
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::AreEqual(server.last_modified, server.received_last_modified);
+            Assert::AreEqual<uint64_t>(1, cache.metrics().metadata_not_modified);
+        }
+
+        TEST_METHOD (CacheIsKeptBetweenInstances)
+        {
+            MetadataServer server;
+            updating::update_cache{ cacheFile }.fetch_metadata(server, releases_url);
+
+            updating::update_cache cache{ cacheFile };
+            Assert::AreEqual(server.body, cache.fetch_metadata(server, releases_url));
+            Assert::AreEqual(server.etag, server.received_etag);
+            Assert::AreEqual<uint64_t>(1, cache.metrics().metadata_not_modified);
+        }
+
+        TEST_METHOD (DownloadsFromMirrorFirst)
+        {
+            FileServer mirror{ "installer bytes" };
+            FileServer origin{ "installer bytes" };
+            updating::download_options options;
+            options.expected_sha256 = origin.sha256();
+            updating::update_cache cache{ cacheFile };
+
+            Assert::IsTrue(cache.download_installer(&mirror, origin, installer, options).has_value());
+
+            Assert::AreEqual<size_t>(0, origin.queries);
+            Assert::AreEqual(std::string{ "installer bytes" }, ReadInstaller());
+            Assert::AreEqual<uint64_t>(1, cache.metrics().mirror_downloads);
+            Assert::AreEqual<uint64_t>(mirror.content.size(), cache.metrics().mirror_bytes);
+        }
+
+        TEST_METHOD (FallsBackToOriginWhenMirrorIsOffline)
+        {
+            FileServer mirror{ "installer bytes" };
+            mirror.offline = true;
+            FileServer origin{ "installer bytes" };
+            updating::download_options options;
+            options.expected_sha256 = origin.sha256();
+            updating::update_cache cache{ cacheFile };
+
+            Assert::IsTrue(cache.download_installer(&mirror, origin, installer, options).has_value());
+
+            Assert::AreEqual<size_t>(1, origin.queries);
+            Assert::AreEqual(std::string{ "installer bytes" }, ReadInstaller());
+            Assert::AreEqual<uint64_t>(0, cache.metrics().mirror_bytes);
+        }
+
+        TEST_METHOD (FallsBackToOriginWhenMirrorHasAnotherFile)
+        {
+            FileServer mirror{ "stale installer" };
+            FileServer origin{ "installer bytes" };
+            updating::download_options options;
+            options.expected_sha256 = origin.sha256();
+            updating::update_cache cache{ cacheFile };
+
+            Assert::IsTrue(cache.download_installer(&mirror, origin, installer, options).has_value());
+
+            Assert::AreEqual(std::string{ "installer bytes" }, ReadInstaller());
+            Assert::AreEqual<uint64_t>(0, cache.metrics().mirror_downloads);
+        }
+
+        TEST_METHOD (SkipsMirrorWithoutInstallerHash)
+        {
+            FileServer mirror{ "installer bytes" };
+            FileServer origin{ "installer bytes" };
+            updating::update_cache cache{ cacheFile };
+
+            Assert::IsTrue(cache.download_installer(&mirror, origin, installer, {}).has_value());
+
+            Assert::AreEqual<size_t>(0, mirror.queries);
+            Assert::AreEqual(std::string{ "installer bytes" }, ReadInstaller());
+            Assert::AreEqual<uint64_t>(0, cache.metrics().mirror_downloads);
+        }
+    };
+}
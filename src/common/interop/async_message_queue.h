@@ -1,54 +1,174 @@
 #pragma once
-#include <queue>
-#include <thread>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
-class AsyncMessageQueue
+// Multiple producer, single consumer queue. Producers link their message in with a single atomic exchange and
+// never block; the consumer only sleeps when the queue is empty, and drains everything that's queued per wakeup.
+// Messages are moved in and out, so move-only types can be queued.
+//
+// Once closed, the queue drops new messages and the pops return right away, messages left in the queue are
+// destroyed with it.
+template<typename T>
+class BasicAsyncMessageQueue
 {
 private:
-    std::mutex queue_mutex;
-    std::queue<std::wstring> message_queue;
-    std::condition_variable message_ready;
-    bool interrupted = false;
+    struct node
+    {
+        std::atomic<node*> next = nullptr;
+        std::optional<T> message;
+    };
+
+    // Producers swap themselves in at the head, the consumer owns the tail, which is always a consumed node.
+    // Kept on separate cache lines so producers don't slow down the consumer.
+    alignas(64) std::atomic<node*> head;
+    alignas(64) node* tail;
+    alignas(64) std::atomic<bool> closed = false;
+    std::atomic<bool> consumer_waiting = false;
+    // Bumped to wake up the consumer
+    std::atomic<uint32_t> wakeups = 0;
 
-    //Disable copy
-    AsyncMessageQueue(const AsyncMessageQueue&);
-    AsyncMessageQueue& operator=(const AsyncMessageQueue&);
+    // Messages usually come in bursts, checking a few more times is cheaper than going to sleep
+    static constexpr int spins_before_waiting = 64;
+
+    bool wait_for_message()
+    {
+        int spins = 0;
+        while (!closed.load())
+        {
+            if (tail->next.load() != nullptr)
+            {
+                return true;
+            }
+
+            if (spins++ < spins_before_waiting)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            consumer_waiting.store(true);
+            const auto seen_wakeups = wakeups.load();
+            // A producer that linked its message in before the flag was set doesn't wake us up, so look again
+            if (tail->next.load() == nullptr && !closed.load())
+            {
+                wakeups.wait(seen_wakeups);
+            }
+
+            consumer_waiting.store(false);
+        }
+
+        return false;
+    }
+
+    std::optional<T> take_next()
+    {
+        node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        delete tail;
+        tail = next;
+        std::optional<T> message = std::move(next->message);
+        next->message.reset();
+        return message;
+    }
 
 public:
-    AsyncMessageQueue()
+    BasicAsyncMessageQueue() :
+        head(new node), tail(head.load())
+    {
+    }
+
+    BasicAsyncMessageQueue(const BasicAsyncMessageQueue&) = delete;
+    BasicAsyncMessageQueue& operator=(const BasicAsyncMessageQueue&) = delete;
+
+    ~BasicAsyncMessageQueue()
+    {
+        while (tail != nullptr)
+        {
+            node* next = tail->next.load();
+            delete tail;
+            tail = next;
+        }
+    }
+
+    // Returns false if the queue is closed, the message is dropped then
+    bool queue_message(T message)
     {
+        if (closed.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        node* added = new node;
+        added->message.emplace(std::move(message));
+        node* previous = head.exchange(added);
+        // Until this store the consumer can't see the message, nor any queued after it
+        previous->next.store(added);
+
+        // Only the first producer to see the consumer waiting has to wake it up
+        if (consumer_waiting.load() && consumer_waiting.exchange(false))
+        {
+            wakeups.fetch_add(1);
+            wakeups.notify_one();
+        }
+
+        return true;
     }
-    void queue_message(std::wstring message)
+
+    // Waits for the next message. Only the consumer thread may pop, nullopt once the queue is closed.
+    std::optional<T> pop_message()
     {
-        this->queue_mutex.lock();
-        this->message_queue.push(message);
-        this->queue_mutex.unlock();
-        this->message_ready.notify_one();
+        if (!wait_for_message())
+        {
+            return std::nullopt;
+        }
+
+        return take_next();
     }
-    std::wstring pop_message()
+
+    // Waits until at least one message is available and moves up to max_messages queued messages into 'messages'.
+    // Only the consumer thread may pop, returns false once the queue is closed.
+    bool pop_batch(std::vector<T>& messages, size_t max_messages = SIZE_MAX)
     {
-        std::unique_lock<std::mutex> lock(this->queue_mutex);
-        while (message_queue.empty() && !this->interrupted)
+        messages.clear();
+        if (!wait_for_message())
         {
-            this->message_ready.wait(lock);
+            return false;
         }
-        if (this->interrupted)
+
+        while (messages.size() < max_messages)
         {
-            //Just returns a empty string if the queue was interrupted.
-            return std::wstring(L"");
+            auto message = take_next();
+            if (!message)
+            {
+                break;
+            }
+
+            messages.push_back(std::move(*message));
         }
-        std::wstring message = this->message_queue.front();
-        this->message_queue.pop();
-        return message;
+
+        return true;
+    }
+
+    void close()
+    {
+        closed.store(true);
+        wakeups.fetch_add(1);
+        wakeups.notify_all();
     }
-    void interrupt()
+
+    bool is_closed() const
     {
-        this->queue_mutex.lock();
-        this->interrupted = true;
-        this->queue_mutex.unlock();
-        this->message_ready.notify_all();
+        return closed.load();
     }
 };
+
+using AsyncMessageQueue = BasicAsyncMessageQueue<std::wstring>;
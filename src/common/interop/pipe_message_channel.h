@@ -0,0 +1,185 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Platform-neutral part of TwoWayPipeMessageIPC. Messages are sent over a persistent
+// connection as a fixed-size header followed by the UTF-16 payload, so any number of
+// messages can travel over one connection and queued messages can be written at once.
+namespace ipc
+{
+    struct MessageFrame
+    {
+        // Correlation id of a request, 0 if the sender doesn't expect a response.
+        uint32_t id = 0;
+        // Id of the request this message responds to, 0 if it's not a response.
+        uint32_t reply_to = 0;
+        std::wstring payload;
+    };
+
+    // Byte stream the frames are transported over. The named pipe implementation lives in
+    // two_way_pipe_message_ipc.cpp, tests can use an in-process stand-in instead.
+    class ByteTransport
+    {
+    public:
+        virtual ~ByteTransport() = default;
+
+        // (Re)establishes the connection. Returns false if the other side isn't reachable.
+        virtual bool connect() = 0;
+        virtual bool is_connected() const = 0;
+        // Writes the whole buffer. Returns false if the connection is broken.
+        virtual bool write(const uint8_t* data, size_t size) = 0;
+        // Reads exactly 'size' bytes. Returns false if the connection is broken.
+        virtual bool read(uint8_t* data, size_t size) = 0;
+        virtual void disconnect() = 0;
+    };
+
+    namespace framing
+    {
+        struct Header
+        {
+            uint32_t payload_bytes;
+            uint32_t id;
+            uint32_t reply_to;
+        };
+
+        constexpr size_t header_size = sizeof(Header);
+
+        // Anything bigger is treated as a corrupted stream.
+        constexpr uint32_t max_payload_bytes = 64 * 1024 * 1024;
+
+        inline void append_frame(std::vector<uint8_t>& buffer, const MessageFrame& frame)
+        {
+            const Header header{ static_cast<uint32_t>(frame.payload.size() * sizeof(wchar_t)), frame.id, frame.reply_to };
+            const size_t offset = buffer.size();
+            buffer.resize(offset + header_size + header.payload_bytes);
+            std::memcpy(buffer.data() + offset, &header, header_size);
+            if (header.payload_bytes)
+            {
+                std::memcpy(buffer.data() + offset + header_size, frame.payload.data(), header.payload_bytes);
+            }
+        }
+
+        inline bool read_frame(ByteTransport& transport, MessageFrame& frame)
+        {
+            Header header{};
+            if (!transport.read(reinterpret_cast<uint8_t*>(&header), header_size))
+            {
+                return false;
+            }
+
+            if (header.payload_bytes > max_payload_bytes || header.payload_bytes % sizeof(wchar_t))
+            {
+                return false;
+            }
+
+            frame.id = header.id;
+            frame.reply_to = header.reply_to;
+            frame.payload.resize(header.payload_bytes / sizeof(wchar_t));
+            return header.payload_bytes == 0 || transport.read(reinterpret_cast<uint8_t*>(frame.payload.data()), header.payload_bytes);
+        }
+    }
+
+    // Keeps the outgoing connection open between messages and writes a whole batch of
+    // frames with a single write. A dropped connection is re-established once per batch.
+    class FrameWriter
+    {
+    public:
+        explicit FrameWriter(std::unique_ptr<ByteTransport> transport) :
+            transport(std::move(transport))
+        {
+        }
+
+        bool write(const std::vector<MessageFrame>& frames)
+        {
+            buffer.clear();
+            for (const auto& frame : frames)
+            {
+                framing::append_frame(buffer, frame);
+            }
+
+            for (int attempt = 0; attempt < 2; ++attempt)
+            {
+                if (!transport->is_connected() && !transport->connect())
+                {
+                    return false;
+                }
+
+                if (transport->write(buffer.data(), buffer.size()))
+                {
+                    return true;
+                }
+
+                transport->disconnect();
+            }
+
+            return false;
+        }
+
+        void close()
+        {
+            transport->disconnect();
+        }
+
+    private:
+        std::unique_ptr<ByteTransport> transport;
+        // Reused between batches to avoid reallocating for every write.
+        std::vector<uint8_t> buffer;
+    };
+
+    // Matches incoming responses with the callbacks of the requests they answer.
+    class PendingResponses
+    {
+    public:
+        using callback = std::function<void(const std::wstring&)>;
+
+        uint32_t add(callback on_response)
+        {
+            std::unique_lock lock{ mutex };
+            if (++last_id == 0)
+            {
+                ++last_id;
+            }
+            pending[last_id] = std::move(on_response);
+            return last_id;
+        }
+
+        // Returns false if no request with the given id is waiting for a response.
+        bool complete(const MessageFrame& frame)
+        {
+            callback on_response;
+            {
+                std::unique_lock lock{ mutex };
+                auto it = pending.find(frame.reply_to);
+                if (it == pending.end())
+                {
+                    return false;
+                }
+                on_response = std::move(it->second);
+                pending.erase(it);
+            }
+
+            if (on_response)
+            {
+                on_response(frame.payload);
+            }
+            return true;
+        }
+
+        size_t size()
+        {
+            std::unique_lock lock{ mutex };
+            return pending.size();
+        }
+
+    private:
+        std::mutex mutex;
+        uint32_t last_id = 0;
+        std::unordered_map<uint32_t, callback> pending;
+    };
+}
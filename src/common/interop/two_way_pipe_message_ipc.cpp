@@ -1,9 +1,129 @@
 #include "pch.h"
 #include "two_way_pipe_message_ipc_impl.h"
 
+#include <algorithm>
 #include <iterator>
 
-constexpr DWORD BUFSIZE = 1024;
+#include <common/logger/perf_trace.h>
+
+constexpr DWORD BUFSIZE = 64 * 1024;
+
+namespace
+{
+    // How long to wait for a busy pipe server before dropping the message batch.
+    constexpr DWORD PIPE_BUSY_TIMEOUT_MS = 2000;
+
+    class NamedPipeTransport : public ipc::ByteTransport
+    {
+    public:
+        // Client side transport, connect() opens the pipe by name.
+        explicit NamedPipeTransport(std::wstring pipe_name) :
+            pipe_name(std::move(pipe_name))
+        {
+        }
+
+        // Server side transport of an already connected pipe instance.
+        explicit NamedPipeTransport(HANDLE connected_handle) :
+            handle(connected_handle), is_server(true)
+        {
+        }
+
+        ~NamedPipeTransport()
+        {
+            disconnect();
+        }
+
+        bool connect() override
+        {
+            if (is_server)
+            {
+                return is_connected();
+            }
+
+            // Adapted from https://docs.microsoft.com/en-us/windows/win32/ipc/named-pipe-client
+            while (true)
+            {
+                handle = CreateFile(
+                    pipe_name.c_str(), // pipe name
+                    GENERIC_READ | // read and write access
+                        GENERIC_WRITE,
+                    0, // no sharing
+                    NULL, // default security attributes
+                    OPEN_EXISTING, // opens existing pipe
+                    0, // default attributes
+                    NULL); // no template file
+
+                if (handle != INVALID_HANDLE_VALUE)
+                {
+                    return true;
+                }
+
+                // Exit if an error other than ERROR_PIPE_BUSY occurs.
+                if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipe(pipe_name.c_str(), PIPE_BUSY_TIMEOUT_MS))
+                {
+                    return false;
+                }
+            }
+        }
+
+        bool is_connected() const override
+        {
+            return handle != INVALID_HANDLE_VALUE;
+        }
+
+        bool write(const uint8_t* data, size_t size) override
+        {
+            while (size > 0)
+            {
+                DWORD written = 0;
+                if (!WriteFile(handle, data, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &written, NULL))
+                {
+                    return false;
+                }
+                data += written;
+                size -= written;
+            }
+            return true;
+        }
+
+        bool read(uint8_t* data, size_t size) override
+        {
+            while (size > 0)
+            {
+                DWORD read = 0;
+                if (!ReadFile(handle, data, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &read, NULL) || read == 0)
+                {
+                    return false;
+                }
+                data += read;
+                size -= read;
+            }
+            return true;
+        }
+
+        void disconnect() override
+        {
+            if (handle == INVALID_HANDLE_VALUE)
+            {
+                return;
+            }
+
+            if (is_server)
+            {
+                // Flush the pipe to allow the client to read the pipe's contents before disconnecting.
+                FlushFileBuffers(handle);
+                DisconnectNamedPipe(handle);
+            }
+            CloseHandle(handle);
+            handle = INVALID_HANDLE_VALUE;
+        }
+
+    private:
+        std::wstring pipe_name;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        bool is_server = false;
+    };
+}
 
 TwoWayPipeMessageIPC::TwoWayPipeMessageIPC(
     std::wstring _input_pipe_name,
@@ -16,6 +136,17 @@ TwoWayPipeMessageIPC::TwoWayPipeMessageIPC(
 {
 }
 
+TwoWayPipeMessageIPC::TwoWayPipeMessageIPC(
+    std::wstring _input_pipe_name,
+    std::wstring _output_pipe_name,
+    request_callback_function p_func) :
+    impl(new TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl(
+        _input_pipe_name,
+        _output_pipe_name,
+        p_func))
+{
+}
+
 TwoWayPipeMessageIPC::~TwoWayPipeMessageIPC()
 {
     delete impl;
@@ -23,7 +154,17 @@ TwoWayPipeMessageIPC::~TwoWayPipeMessageIPC()
 
 void TwoWayPipeMessageIPC::send(std::wstring msg)
 {
-    impl->send(msg);
+    impl->send(std::move(msg));
+}
+
+void TwoWayPipeMessageIPC::send(std::wstring msg, response_callback on_response)
+{
+    impl->send(std::move(msg), std::move(on_response));
+}
+
+void TwoWayPipeMessageIPC::reply(uint32_t request_id, std::wstring msg)
+{
+    impl->reply(request_id, std::move(msg));
 }
 
 void TwoWayPipeMessageIPC::start(HANDLE _restricted_pipe_token)
@@ -46,13 +187,35 @@ TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::TwoWayPipeMessageIPCImpl(
     dispatch_inc_message_function = p_func;
 }
 
+TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::TwoWayPipeMessageIPCImpl(
+    std::wstring _input_pipe_name,
+    std::wstring _output_pipe_name,
+    request_callback_function p_func)
+{
+    input_pipe_name = _input_pipe_name;
+    output_pipe_name = _output_pipe_name;
+    dispatch_inc_request_function = p_func;
+}
+
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::send(std::wstring msg)
 {
-    output_queue.queue_message(msg);
+    output_queue.queue_message(ipc::MessageFrame{ 0, 0, std::move(msg) });
+}
+
+void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::send(std::wstring msg, response_callback on_response)
+{
+    const uint32_t id = pending_responses.add(std::move(on_response));
+    output_queue.queue_message(ipc::MessageFrame{ id, 0, std::move(msg) });
+}
+
+void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::reply(uint32_t request_id, std::wstring msg)
+{
+    output_queue.queue_message(ipc::MessageFrame{ 0, request_id, std::move(msg) });
 }
 
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::start(HANDLE _restricted_pipe_token)
 {
+    output_writer = std::make_unique<ipc::FrameWriter>(std::make_unique<NamedPipeTransport>(output_pipe_name));
     output_queue_thread = std::thread(&TwoWayPipeMessageIPCImpl::consume_output_queue_thread, this);
     input_queue_thread = std::thread(&TwoWayPipeMessageIPCImpl::consume_input_queue_thread, this);
     input_pipe_thread = std::thread(&TwoWayPipeMessageIPCImpl::start_named_pipe_server, this, _restricted_pipe_token);
@@ -61,101 +224,43 @@ void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::start(HANDLE _restricted_pi
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::end()
 {
     closed = true;
-    input_queue.interrupt();
+    input_queue.close();
     input_queue_thread.join();
-    output_queue.interrupt();
+    output_queue.close();
     output_queue_thread.join();
+    if (output_writer)
+    {
+        output_writer->close();
+    }
     pipe_connect_handle_mutex.lock();
     if (current_connect_pipe_handle != NULL)
     {
         //Cancels the Pipe currently waiting for a connection.
         CancelIoEx(current_connect_pipe_handle, NULL);
     }
-    pipe_connect_handle_mutex.unlock();
-    input_pipe_thread.join();
-}
-
-void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::send_pipe_message(std::wstring message)
-{
-    // Adapted from https://docs.microsoft.com/en-us/windows/win32/ipc/named-pipe-client
-    HANDLE output_pipe_handle;
-    const wchar_t* message_send = message.c_str();
-    BOOL fSuccess = FALSE;
-    DWORD cbToWrite, cbWritten, dwMode;
-    const wchar_t* lpszPipename = output_pipe_name.c_str();
-
-    // Try to open a named pipe; wait for it, if necessary.
-
-    while (1)
-    {
-        output_pipe_handle = CreateFile(
-            lpszPipename, // pipe name
-            GENERIC_READ | // read and write access
-                GENERIC_WRITE,
-            0, // no sharing
-            NULL, // default security attributes
-            OPEN_EXISTING, // opens existing pipe
-            0, // default attributes
-            NULL); // no template file
-
-        // Break if the pipe handle is valid.
-
-        if (output_pipe_handle != INVALID_HANDLE_VALUE)
-            break;
-
-        // Exit if an error other than ERROR_PIPE_BUSY occurs.
-        DWORD curr_error = 0;
-        if ((curr_error = GetLastError()) != ERROR_PIPE_BUSY)
-        {
-            return;
-        }
-
-        // All pipe instances are busy, so wait for 20 seconds.
-
-        if (!WaitNamedPipe(lpszPipename, 20000))
-        {
-            return;
-        }
-    }
-    dwMode = PIPE_READMODE_MESSAGE;
-    fSuccess = SetNamedPipeHandleState(
-        output_pipe_handle, // pipe handle
-        &dwMode, // new pipe mode
-        NULL, // don't set maximum bytes
-        NULL); // don't set maximum time
-    if (!fSuccess)
+    //Cancels the reads of the connections kept open by the other side.
+    for (const auto handle : active_connection_handles)
     {
-        return;
+        CancelIoEx(handle, NULL);
     }
-
-    // Send a message to the pipe server.
-
-    cbToWrite = (lstrlen(message_send)) * sizeof(WCHAR); // no need to send final '\0'. Pipe is in message mode.
-
-    fSuccess = WriteFile(
-        output_pipe_handle, // pipe handle
-        message_send, // message
-        cbToWrite, // message length
-        &cbWritten, // bytes written
-        NULL); // not overlapped
-    if (!fSuccess)
+    pipe_connect_handle_mutex.unlock();
+    input_pipe_thread.join();
+    for (auto& thread : connection_threads)
     {
-        return;
+        thread.join();
     }
-    CloseHandle(output_pipe_handle);
-    return;
+    connection_threads.clear();
+    finished_connection_threads.clear();
 }
 
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::consume_output_queue_thread()
 {
-    while (!closed)
+    std::vector<ipc::MessageFrame> batch;
+    while (!closed && output_queue.pop_batch(batch))
     {
-        std::wstring message = output_queue.pop_message();
-        if (message.length() == 0)
-        {
-            break;
-        }
-        send_pipe_message(message);
+        // Everything queued since the last wakeup goes out with a single write.
+        PerfTrace::Span span{ PerfTrace::Event::IpcSend };
+        output_writer->write(batch);
     }
 }
 
@@ -353,46 +458,40 @@ void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::handle_pipe_connection(HAND
     {
         return;
     }
-    constexpr DWORD readBlockBytes = BUFSIZE;
-    std::wstring message;
-    size_t iBlock = 0;
-    message.reserve(BUFSIZE);
-    bool ok;
-    do
-    {
-        constexpr size_t charsPerBlock = readBlockBytes / sizeof(message[0]);
-        message.resize(message.size() + charsPerBlock);
-        DWORD bytesRead = 0;
-        ok = ReadFile(
-            input_pipe_handle,
-            // read the message directly into the string block by block simultaneously resizing it
-            message.data() + iBlock * charsPerBlock,
-            readBlockBytes,
-            &bytesRead,
-            nullptr);
-
-        if (!ok && GetLastError() != ERROR_MORE_DATA)
-        {
-            break;
-        }
-        iBlock++;
-    } while (!ok);
-    // trim the message's buffer
-    const auto nullCharPos = message.find_last_not_of(L'\0');
-    if (nullCharPos != std::wstring::npos)
+
+    // The other side keeps the connection open, so read frames until it disconnects or end() cancels the read.
+    NamedPipeTransport connection{ input_pipe_handle };
+    ipc::MessageFrame frame;
+    while (!closed && ipc::framing::read_frame(connection, frame))
     {
-        message.resize(nullCharPos + 1);
+        input_queue.queue_message(std::move(frame));
+        frame = {};
     }
 
-    input_queue.queue_message(std::move(message));
+    {
+        std::unique_lock lock(pipe_connect_handle_mutex);
+        active_connection_handles.remove(input_pipe_handle);
+    }
+    connection.disconnect();
 
-    // Flush the pipe to allow the client to read the pipe's contents
-    // before disconnecting. Then disconnect the pipe, and close the
-    // handle to this pipe instance.
+    std::unique_lock lock(pipe_connect_handle_mutex);
+    finished_connection_threads.push_back(std::this_thread::get_id());
+}
 
-    FlushFileBuffers(input_pipe_handle);
-    DisconnectNamedPipe(input_pipe_handle);
-    CloseHandle(input_pipe_handle);
+// The other side reconnects for every session, so the threads of closed connections are joined as new ones come in.
+// Called with pipe_connect_handle_mutex held, the finished threads have nothing left to do but return.
+void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::join_finished_connection_threads()
+{
+    for (const auto id : finished_connection_threads)
+    {
+        auto thread = std::find_if(connection_threads.begin(), connection_threads.end(), [id](const std::thread& t) { return t.get_id() == id; });
+        if (thread != connection_threads.end())
+        {
+            thread->join();
+            connection_threads.erase(thread);
+        }
+    }
+    finished_connection_threads.clear();
 }
 
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::start_named_pipe_server(HANDLE token)
@@ -409,8 +508,8 @@ void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::start_named_pipe_server(HAN
                 pipe_name,
                 PIPE_ACCESS_DUPLEX |
                     WRITE_DAC,
-                PIPE_TYPE_MESSAGE |
-                    PIPE_READMODE_MESSAGE |
+                PIPE_TYPE_BYTE |
+                    PIPE_READMODE_BYTE |
                     PIPE_WAIT,
                 PIPE_UNLIMITED_INSTANCES,
                 BUFSIZE,
@@ -433,36 +532,47 @@ void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::start_named_pipe_server(HAN
         {
             std::unique_lock lock(pipe_connect_handle_mutex);
             current_connect_pipe_handle = NULL;
+            if (connected && !closed)
+            {
+                active_connection_handles.push_back(connect_pipe_handle);
+                join_finished_connection_threads();
+                connection_threads.emplace_back(&TwoWayPipeMessageIPCImpl::handle_pipe_connection, this, connect_pipe_handle);
+                continue;
+            }
         }
-        if (connected)
-        {
-            std::thread(&TwoWayPipeMessageIPCImpl::handle_pipe_connection, this, connect_pipe_handle).detach();
-        }
-        else
-        {
-            // Client could not connect.
-            CloseHandle(connect_pipe_handle);
-        }
+
+        // Client could not connect.
+        CloseHandle(connect_pipe_handle);
     }
 }
 
 void TwoWayPipeMessageIPC::TwoWayPipeMessageIPCImpl::consume_input_queue_thread()
 {
-    while (!closed)
+    std::vector<ipc::MessageFrame> batch;
+    while (!closed && input_queue.pop_batch(batch))
     {
-        outgoing_message = L"";
-        std::wstring message = input_queue.pop_message();
-        if (message.length() == 0)
+        PerfTrace::Span span{ PerfTrace::Event::IpcReceive };
+        for (auto& frame : batch)
         {
-            break;
-        }
+            outgoing_message = L"";
 
-        // Check if callback method exists first before trying to call it.
-        // otherwise just store the response message in a variable.
-        if (dispatch_inc_message_function != nullptr)
-        {
-            dispatch_inc_message_function(message);
+            // Responses go to the callback of the request they answer.
+            if (frame.reply_to != 0 && pending_responses.complete(frame))
+            {
+                continue;
+            }
+
+            // Check if callback method exists first before trying to call it.
+            // otherwise just store the response message in a variable.
+            if (dispatch_inc_request_function != nullptr)
+            {
+                dispatch_inc_request_function(frame.id, frame.payload);
+            }
+            else if (dispatch_inc_message_function != nullptr)
+            {
+                dispatch_inc_message_function(frame.payload);
+            }
+            outgoing_message = std::move(frame.payload);
         }
-        outgoing_message = message;
     }
-}
\ No newline at end of file
+}
@@ -1,14 +1,28 @@
 #pragma once
+#include <cstdint>
+#include <functional>
+
 class TwoWayPipeMessageIPC
 {
 public:
     typedef void (*callback_function)(const std::wstring&);
+    // Receives the correlation id of the incoming message as well, so it can be answered with reply().
+    typedef void (*request_callback_function)(uint32_t request_id, const std::wstring&);
+    using response_callback = std::function<void(const std::wstring&)>;
+
     TwoWayPipeMessageIPC(
         std::wstring _input_pipe_name,
         std::wstring _output_pipe_name,
         callback_function p_func);
+    TwoWayPipeMessageIPC(
+        std::wstring _input_pipe_name,
+        std::wstring _output_pipe_name,
+        request_callback_function p_func);
     ~TwoWayPipeMessageIPC();
     void send(std::wstring msg);
+    // Sends a request, on_response is called on the IPC thread when the other side replies to it.
+    void send(std::wstring msg, response_callback on_response);
+    void reply(uint32_t request_id, std::wstring msg);
     void start(HANDLE _restricted_pipe_token);
     void end();
 
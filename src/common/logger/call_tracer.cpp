@@ -1,22 +1,18 @@
 #include "pch.h"
 #include "call_tracer.h"
 
-#include <map>
-#include <thread>
-
 namespace
 {
     // Non-localizable
     const std::string entering = " Enter";
     const std::string exiting = " Exit";
 
-    std::mutex indentLevelMutex;
-    std::map<std::thread::id, int> indentLevel;
+    // Each thread has its own call depth, so no synchronization is needed
+    thread_local int indentLevel = 0;
 
     std::string GetIndentation()
     {
-        std::unique_lock lock(indentLevelMutex);
-        int level = indentLevel[std::this_thread::get_id()];
+        int level = indentLevel;
 
         if (level <= 0)
         {
@@ -30,14 +26,12 @@ namespace
 
     void Indent()
     {
-        std::unique_lock lock(indentLevelMutex);
-        indentLevel[std::this_thread::get_id()]++;
+        indentLevel++;
     }
 
     void Unindent()
     {
-        std::unique_lock lock(indentLevelMutex);
-        indentLevel[std::this_thread::get_id()]--;
+        indentLevel--;
     }
 }
 
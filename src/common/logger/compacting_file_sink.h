@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include "log_retention.h"
+
+// Starts a new log every day like spdlog's daily_file_sink, and indexes where the messages of each hour start,
+// see log_retention.h. Maintenance runs on a background thread whenever a log is started, it's meant to compact
+// the logs of the previous days and to enforce the size budget, without holding up the threads that log.
+// The sink is usually owned by a static logger, so the thread isn't joined: doing that in a static destructor
+// would wait under the loader lock.
+template<typename Mutex>
+class CompactingFileSink final : public spdlog::sinks::base_sink<Mutex>
+{
+public:
+    using Maintenance = std::function<void()>;
+
+    CompactingFileSink(std::filesystem::path basePath, Maintenance maintenance) :
+        m_basePath(std::move(basePath)), m_maintenance(std::make_shared<MaintenanceState>())
+    {
+        m_maintenance->run = std::move(maintenance);
+        Open(std::time(nullptr));
+    }
+
+    std::filesystem::path CurrentLog()
+    {
+        std::scoped_lock lock{ this->mutex_ };
+        return m_file.filename();
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override
+    {
+        const auto time = std::chrono::system_clock::to_time_t(msg.time);
+        if (time >= m_nextDay)
+        {
+            Open(time);
+        }
+
+        if (time / secondsPerHour != m_indexedHour)
+        {
+            m_indexedHour = time / secondsPerHour;
+            m_index << static_cast<long long>(time) << ' ' << m_file.size() << '\n';
+        }
+
+        spdlog::memory_buf_t formatted;
+        this->formatter_->format(msg, formatted);
+        m_file.write(formatted);
+    }
+
+    void flush_() override
+    {
+        m_file.flush();
+        m_index.flush();
+    }
+
+private:
+    static constexpr std::time_t secondsPerHour = 60 * 60;
+
+    // Shared with the maintenance thread, which can outlive the sink
+    struct MaintenanceState
+    {
+        std::mutex mutex;
+        bool running = false;
+        bool pending = false;
+        Maintenance run;
+    };
+
+    void Open(std::time_t time)
+    {
+        const auto path = LogRetention::DailyLogPath(m_basePath, LogRetention::LocalDay(time));
+        m_file.open(path.native());
+        m_index = std::ofstream{ LogRetention::IndexPath(path), std::ios::binary | std::ios::app };
+        m_nextDay = LogRetention::NextDay(time);
+        m_indexedHour = -1;
+        ScheduleMaintenance();
+    }
+
+    // Starts the maintenance thread, or has the running one go once more when it's done
+    void ScheduleMaintenance()
+    {
+        if (!m_maintenance->run)
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock lock{ m_maintenance->mutex };
+            if (m_maintenance->running)
+            {
+                m_maintenance->pending = true;
+                return;
+            }
+
+            m_maintenance->running = true;
+        }
+
+        try
+        {
+            std::thread([state = m_maintenance] {
+                std::unique_lock lock{ state->mutex };
+                do
+                {
+                    state->pending = false;
+                    lock.unlock();
+                    try
+                    {
+                        state->run();
+                    }
+                    catch (...)
+                    {
+                        // Tried again when the next log is started
+                    }
+
+                    lock.lock();
+                } while (state->pending);
+
+                state->running = false;
+            }).detach();
+        }
+        catch (...)
+        {
+            std::scoped_lock lock{ m_maintenance->mutex };
+            m_maintenance->running = false;
+        }
+    }
+
+    const std::filesystem::path m_basePath;
+    const std::shared_ptr<MaintenanceState> m_maintenance;
+    spdlog::details::file_helper m_file;
+    std::ofstream m_index;
+    std::time_t m_nextDay = 0;
+    std::time_t m_indexedHour = -1;
+};
+
+using CompactingFileSinkMt = CompactingFileSink<std::mutex>;
@@ -0,0 +1,512 @@
+#include "pch.h"
+#include "log_retention.h"
+
+#include <algorithm>
+#include <cwchar>
+#include <cwctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "../../../deps/cziplib/src/zip.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Non-localizable
+    const std::wstring textExtension = L".txt";
+    const std::wstring indexExtension = L".index";
+    const std::wstring archiveExtension = L".zip";
+    const std::wstring temporaryExtension = L".tmp";
+
+    constexpr size_t copyBufferSize = 1024 * 1024;
+
+    std::tm ToLocalTime(std::time_t time)
+    {
+        std::tm result{};
+#ifdef _WIN32
+        localtime_s(&result, &time);
+#else
+        localtime_r(&time, &result);
+#endif
+        return result;
+    }
+
+    // Segments of a log: where each one starts in the text and the time of its first message
+    std::vector<LogRetention::IndexEntry> Segments(const fs::path& logFile, const LogRetention::Day& day, uint64_t size)
+    {
+        std::vector<LogRetention::IndexEntry> segments;
+        for (const auto& entry : LogRetention::ReadIndex(LogRetention::IndexPath(logFile)))
+        {
+            // Entries pointing past the end were written for messages that never reached the disk
+            if (entry.offset >= size || (!segments.empty() && entry.offset <= segments.back().offset))
+            {
+                continue;
+            }
+
+            segments.push_back(entry);
+        }
+
+        if (segments.empty() || segments.front().offset != 0)
+        {
+            segments.insert(segments.begin(), { LogRetention::StartOfDay(day), 0 });
+        }
+
+        return segments;
+    }
+
+    // Index of the first segment that can contain messages written at or after since
+    size_t FirstSegmentSince(const std::vector<LogRetention::IndexEntry>& segments, std::time_t since)
+    {
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto end = i + 1 < segments.size() ? segments[i + 1].time : LogRetention::NextDay(segments[i].time);
+            if (end > since)
+            {
+                return i;
+            }
+        }
+
+        return segments.size();
+    }
+
+    bool CopyToEntry(zip_t* zip, std::ifstream& file, uint64_t length)
+    {
+        std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(length, copyBufferSize)));
+        while (length > 0)
+        {
+            const auto piece = static_cast<size_t>(std::min<uint64_t>(length, buffer.size()));
+            if (!file.read(buffer.data(), piece) || zip_entry_write(zip, buffer.data(), piece) != 0)
+            {
+                return false;
+            }
+
+            length -= piece;
+        }
+
+        return true;
+    }
+
+    bool WriteArchive(const fs::path& archive, const fs::path& logFile, const std::vector<LogRetention::IndexEntry>& segments, uint64_t size)
+    {
+        std::ifstream file{ logFile, std::ios::binary };
+        zip_t* zip = file ? zip_open(archive.string().c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w') : nullptr;
+        if (!zip)
+        {
+            return false;
+        }
+
+        bool written = true;
+        for (size_t i = 0; written && i < segments.size(); ++i)
+        {
+            const auto end = i + 1 < segments.size() ? segments[i + 1].offset : size;
+            const auto name = std::to_string(segments[i].time) + ".txt";
+            written = zip_entry_open(zip, name.c_str()) == 0;
+            if (written)
+            {
+                written = CopyToEntry(zip, file, end - segments[i].offset);
+                written = zip_entry_close(zip) == 0 && written;
+            }
+        }
+
+        zip_close(zip);
+        return written;
+    }
+
+    struct ArchiveEntry
+    {
+        std::time_t time;
+        std::string name;
+    };
+
+    std::string ReadArchiveSince(const fs::path& archive, std::time_t since)
+    {
+        zip_t* zip = zip_open(archive.string().c_str(), 0, 'r');
+        if (!zip)
+        {
+            return {};
+        }
+
+        std::vector<ArchiveEntry> entries;
+        const auto total = zip_entries_total(zip);
+        for (ssize_t i = 0; i < total; ++i)
+        {
+            if (zip_entry_openbyindex(zip, i) != 0)
+            {
+                continue;
+            }
+
+            std::string name = zip_entry_name(zip);
+            zip_entry_close(zip);
+            try
+            {
+                entries.push_back({ static_cast<std::time_t>(std::stoll(name)), std::move(name) });
+            }
+            catch (...)
+            {
+                // Not written by Compact
+            }
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.time < b.time; });
+
+        std::vector<LogRetention::IndexEntry> segments;
+        for (const auto& entry : entries)
+        {
+            segments.push_back({ entry.time, 0 });
+        }
+
+        std::string result;
+        for (size_t i = FirstSegmentSince(segments, since); i < entries.size(); ++i)
+        {
+            if (zip_entry_open(zip, entries[i].name.c_str()) != 0)
+            {
+                continue;
+            }
+
+            void* buffer = nullptr;
+            size_t size = 0;
+            if (zip_entry_read(zip, &buffer, &size) >= 0 && buffer)
+            {
+                result.append(static_cast<const char*>(buffer), size);
+            }
+
+            free(buffer);
+            zip_entry_close(zip);
+        }
+
+        zip_close(zip);
+        return result;
+    }
+
+    std::string ReadTextSince(const fs::path& logFile, const LogRetention::Day& day, std::time_t since)
+    {
+        std::error_code err;
+        const auto size = fs::file_size(logFile, err);
+        if (err)
+        {
+            return {};
+        }
+
+        const auto segments = Segments(logFile, day, size);
+        const auto first = FirstSegmentSince(segments, since);
+        if (first == segments.size())
+        {
+            return {};
+        }
+
+        // The log can still be growing, only the part that was there when it was measured is read
+        std::ifstream file{ logFile, std::ios::binary };
+        std::string result(static_cast<size_t>(size - segments[first].offset), '\0');
+        file.seekg(static_cast<std::streamoff>(segments[first].offset));
+        file.read(result.data(), static_cast<std::streamsize>(result.size()));
+        result.resize(static_cast<size_t>(file.gcount()));
+        return result;
+    }
+
+    // A log with its index, or an archive, which are kept or removed together
+    struct StoredLog
+    {
+        LogRetention::Day day;
+        std::vector<fs::path> files;
+        uint64_t bytes = 0;
+    };
+
+    // Whether one of the folders file is in has one of the names, e.g. "FancyZones\Logs\v0.60.0\log_2022-07-05.txt" for "Logs"
+    bool IsInLogDirectory(const fs::path& relativeFile, const std::vector<std::wstring>& logDirectoryNames)
+    {
+        const auto directory = relativeFile.parent_path();
+        return std::any_of(directory.begin(), directory.end(), [&](const fs::path& part) {
+            return std::find(logDirectoryNames.begin(), logDirectoryNames.end(), part.wstring()) != logDirectoryNames.end();
+        });
+    }
+
+    void AddFile(std::map<fs::path, StoredLog>& logs, const fs::path& file, uint64_t bytes)
+    {
+        auto logFile = file;
+        if (file.extension() == indexExtension)
+        {
+            logFile.replace_extension();
+        }
+
+        const auto log = LogRetention::ParseDailyLogName(logFile);
+        if (!log)
+        {
+            return;
+        }
+
+        // The text log and its archive are counted as one, one of them is only there while the log is being compacted
+        auto key = logFile;
+        key.replace_extension();
+        auto& stored = logs[key];
+        stored.day = log->day;
+        stored.files.push_back(file);
+        stored.bytes += bytes;
+    }
+
+    bool Remove(const StoredLog& log)
+    {
+        bool removed = true;
+        for (const auto& file : log.files)
+        {
+            std::error_code err;
+            removed = fs::remove(file, err) && removed;
+        }
+
+        return removed;
+    }
+}
+
+namespace LogRetention
+{
+    Day LocalDay(std::time_t time)
+    {
+        const auto local = ToLocalTime(time);
+        return { local.tm_year + 1900, local.tm_mon + 1, local.tm_mday };
+    }
+
+    std::time_t StartOfDay(const Day& day)
+    {
+        std::tm local{};
+        local.tm_year = day.year - 1900;
+        local.tm_mon = day.month - 1;
+        local.tm_mday = day.day;
+        local.tm_isdst = -1;
+        return std::mktime(&local);
+    }
+
+    std::time_t NextDay(std::time_t time)
+    {
+        auto local = ToLocalTime(time);
+        local.tm_mday += 1;
+        local.tm_hour = 0;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        local.tm_isdst = -1;
+        return std::mktime(&local);
+    }
+
+    std::optional<DailyLog> ParseDailyLogName(const fs::path& file)
+    {
+        const auto extension = file.extension().wstring();
+        if (extension != textExtension && extension != archiveExtension)
+        {
+            return std::nullopt;
+        }
+
+        // <stem>_YYYY-MM-DD
+        const auto name = file.stem().wstring();
+        const size_t dateLength = 10;
+        if (name.size() <= dateLength + 1 || name[name.size() - dateLength - 1] != L'_')
+        {
+            return std::nullopt;
+        }
+
+        const auto date = std::wstring_view{ name }.substr(name.size() - dateLength);
+        for (size_t i = 0; i < date.size(); ++i)
+        {
+            const bool separator = i == 4 || i == 7;
+            if (separator ? date[i] != L'-' : !std::iswdigit(date[i]))
+            {
+                return std::nullopt;
+            }
+        }
+
+        auto number = [&](size_t start, size_t length) {
+            int result = 0;
+            for (const auto digit : date.substr(start, length))
+            {
+                result = result * 10 + (digit - L'0');
+            }
+
+            return result;
+        };
+
+        DailyLog log;
+        log.day = { number(0, 4), number(5, 2), number(8, 2) };
+        if (log.day.month < 1 || log.day.month > 12 || log.day.day < 1 || log.day.day > 31)
+        {
+            return std::nullopt;
+        }
+
+        log.stem = name.substr(0, name.size() - dateLength - 1);
+        log.compacted = extension == archiveExtension;
+        return log;
+    }
+
+    fs::path DailyLogPath(const fs::path& basePath, const Day& day)
+    {
+        wchar_t date[16];
+        swprintf(date, std::size(date), L"_%04d-%02d-%02d", day.year, day.month, day.day);
+
+        auto name = basePath.stem().wstring() + date + basePath.extension().wstring();
+        return basePath.parent_path() / name;
+    }
+
+    fs::path IndexPath(const fs::path& logFile)
+    {
+        auto path = logFile;
+        path += indexExtension;
+        return path;
+    }
+
+    std::vector<IndexEntry> ReadIndex(const fs::path& indexFile)
+    {
+        std::vector<IndexEntry> entries;
+        std::ifstream file{ indexFile };
+        for (std::string line; std::getline(file, line);)
+        {
+            std::istringstream fields{ line };
+            long long time = 0;
+            unsigned long long offset = 0;
+            if (fields >> time >> offset)
+            {
+                entries.push_back({ static_cast<std::time_t>(time), offset });
+            }
+        }
+
+        return entries;
+    }
+
+    bool Compact(const fs::path& logFile)
+    {
+        const auto log = ParseDailyLogName(logFile);
+        std::error_code err;
+        const auto size = fs::file_size(logFile, err);
+        if (!log || log->compacted || err)
+        {
+            return false;
+        }
+
+        auto archive = logFile;
+        archive.replace_extension(archiveExtension);
+        auto temporary = archive;
+        temporary += temporaryExtension;
+
+        if (!WriteArchive(temporary, logFile, Segments(logFile, log->day, size), size))
+        {
+            fs::remove(temporary, err);
+            return false;
+        }
+
+        fs::rename(temporary, archive, err);
+        if (err)
+        {
+            fs::remove(temporary, err);
+            return false;
+        }
+
+        // The log is still open in a process that didn't write anything since midnight,
+        // it's compacted again once that process moves on to the next day
+        if (!fs::remove(logFile, err) || err)
+        {
+            fs::remove(archive, err);
+            return false;
+        }
+
+        fs::remove(IndexPath(logFile), err);
+        return true;
+    }
+
+    MaintenanceResult CompactDirectory(const fs::path& directory, const Day& today, size_t retention)
+    {
+        MaintenanceResult result;
+        std::map<fs::path, StoredLog> logs;
+        std::error_code err;
+        for (fs::directory_iterator it{ directory, err }; !err && it != fs::directory_iterator{}; it.increment(err))
+        {
+            std::error_code fileErr;
+            if (it->is_regular_file(fileErr))
+            {
+                AddFile(logs, it->path(), it->file_size(fileErr));
+            }
+        }
+
+        std::vector<StoredLog*> byAge;
+        for (auto& [key, log] : logs)
+        {
+            byAge.push_back(&log);
+        }
+
+        // Newest first
+        std::sort(byAge.begin(), byAge.end(), [](const auto* a, const auto* b) { return a->day > b->day; });
+        for (size_t i = 0; i < byAge.size(); ++i)
+        {
+            auto& log = *byAge[i];
+            if (i >= retention && log.day < today)
+            {
+                if (Remove(log))
+                {
+                    result.removedLogs++;
+                    result.removedBytes += log.bytes;
+                }
+
+                continue;
+            }
+
+            for (const auto& file : log.files)
+            {
+                const auto name = ParseDailyLogName(file);
+                if (name && !name->compacted && name->day < today && Compact(file))
+                {
+                    result.compactedLogs++;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    MaintenanceResult EnforceBudget(const fs::path& root, const std::vector<std::wstring>& logDirectoryNames, uint64_t budget, const Day& today)
+    {
+        MaintenanceResult result;
+        std::map<fs::path, StoredLog> logs;
+        std::error_code err;
+        for (fs::recursive_directory_iterator it{ root, fs::directory_options::skip_permission_denied, err }; !err && it != fs::recursive_directory_iterator{}; it.increment(err))
+        {
+            std::error_code fileErr;
+            if (it->is_regular_file(fileErr) && IsInLogDirectory(it->path().lexically_relative(root), logDirectoryNames))
+            {
+                AddFile(logs, it->path(), it->file_size(fileErr));
+            }
+        }
+
+        std::vector<const StoredLog*> byAge;
+        for (const auto& [key, log] : logs)
+        {
+            result.totalBytes += log.bytes;
+            byAge.push_back(&log);
+        }
+
+        // Oldest first, the logs of one day are removed in path order
+        std::stable_sort(byAge.begin(), byAge.end(), [](const auto* a, const auto* b) { return a->day < b->day; });
+        for (const auto* log : byAge)
+        {
+            if (result.totalBytes <= budget || log->day >= today)
+            {
+                break;
+            }
+
+            if (Remove(*log))
+            {
+                result.removedLogs++;
+                result.removedBytes += log->bytes;
+                result.totalBytes -= log->bytes;
+            }
+        }
+
+        return result;
+    }
+
+    std::string ReadSince(const fs::path& logFile, std::time_t since)
+    {
+        const auto log = ParseDailyLogName(logFile);
+        if (!log)
+        {
+            return {};
+        }
+
+        return log->compacted ? ReadArchiveSince(logFile, since) : ReadTextSince(logFile, log->day, since);
+    }
+}
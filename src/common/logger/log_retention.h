@@ -0,0 +1,83 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Keeps the daily logs of all PowerToys processes within a size budget. The log of a finished day is
+// compacted into a zip archive next to it, with one entry per hour it covers, so a time range can be
+// read back without decompressing the whole day.
+//
+// <stem>_YYYY-MM-DD.txt         the text log of a day, named like spdlog's daily_file_sink names them
+// <stem>_YYYY-MM-DD.txt.index   "<seconds since epoch> <byte offset>" for the first message of every hour
+// <stem>_YYYY-MM-DD.zip         the compacted log, entries are named "<seconds since epoch>.txt"
+namespace LogRetention
+{
+    struct Day
+    {
+        int year = 0;
+        int month = 0;
+        int day = 0;
+
+        auto operator<=>(const Day&) const = default;
+    };
+
+    // The day of time in the local time zone
+    Day LocalDay(std::time_t time);
+    // Local midnight of the day
+    std::time_t StartOfDay(const Day& day);
+    // Local midnight after time
+    std::time_t NextDay(std::time_t time);
+
+    struct DailyLog
+    {
+        // File name without the date suffix and extension, e.g. "runner-log"
+        std::wstring stem;
+        Day day;
+        bool compacted = false;
+    };
+
+    // nullopt if the file isn't a daily log or a compacted one
+    std::optional<DailyLog> ParseDailyLogName(const std::filesystem::path& file);
+    // Path of the log written on day by a sink created for basePath, e.g. "log.txt" becomes "log_2022-07-05.txt"
+    std::filesystem::path DailyLogPath(const std::filesystem::path& basePath, const Day& day);
+    std::filesystem::path IndexPath(const std::filesystem::path& logFile);
+
+    struct IndexEntry
+    {
+        std::time_t time;
+        uint64_t offset;
+    };
+
+    // Entries in the order they were written, invalid lines are skipped
+    std::vector<IndexEntry> ReadIndex(const std::filesystem::path& indexFile);
+
+    // Moves a finished log into <stem>_YYYY-MM-DD.zip and removes the text log and its index.
+    // Logs without an index are stored as a single entry starting at midnight. Nothing is removed on failure.
+    bool Compact(const std::filesystem::path& logFile);
+
+    struct MaintenanceResult
+    {
+        size_t compactedLogs = 0;
+        size_t removedLogs = 0;
+        uint64_t removedBytes = 0;
+        // Size of the daily logs that are kept
+        uint64_t totalBytes = 0;
+    };
+
+    // Compacts the logs of the days before today in directory, and removes the ones older than the newest retention days
+    MaintenanceResult CompactDirectory(const std::filesystem::path& directory, const Day& today, size_t retention);
+
+    // Removes the oldest daily logs under root until all of them together take at most budget bytes. Only the files
+    // in a folder named like one of logDirectoryNames count, anything else under root is left alone.
+    // Logs of today are kept even if they're over the budget, they can still be written to.
+    MaintenanceResult EnforceBudget(const std::filesystem::path& root, const std::vector<std::wstring>& logDirectoryNames, uint64_t budget, const Day& today);
+
+    // Messages of a daily log, text or compacted, starting with the hour that contains since.
+    // Empty if the log ended before since.
+    std::string ReadSince(const std::filesystem::path& logFile, std::time_t since);
+}
@@ -3,8 +3,14 @@
 #include "pch.h"
 #include "framework.h"
 #include "logger.h"
+#include "compacting_file_sink.h"
+#include "perf_trace.h"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
-#include <spdlog/sinks/daily_file_sink.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/msvc_sink.h>
 #include <spdlog/sinks/null_sink.h>
 #include <spdlog/sinks/stdout_color_sinks-inl.h>
@@ -12,7 +18,6 @@
 
 using spdlog::sinks_init_list;
 using spdlog::level::level_enum;
-using spdlog::sinks::daily_file_sink_mt;
 using spdlog::sinks::msvc_sink_mt;
 using std::make_shared;
 
@@ -27,11 +32,95 @@ namespace
         { L"critical", level_enum::critical },
         { L"off", level_enum::off },
     };
+
+    // Non-localizable
+    const wchar_t logRetentionMutexName[] = L"Local\\PowerToysLogRetentionMutex";
+
+    // Compacts the finished logs of one logger and keeps the logs of all PowerToys processes within the budget.
+    // Every process does it when it starts a log, the mutex keeps them from working on the same files at the same time.
+    void maintainLogs(const std::filesystem::path& logDirectory, const std::filesystem::path& logsRoot, uint64_t budget)
+    {
+        HANDLE mutex = CreateMutexW(nullptr, FALSE, logRetentionMutexName);
+        if (!mutex)
+        {
+            return;
+        }
+
+        const auto waitResult = WaitForSingleObject(mutex, INFINITE);
+        if (waitResult == WAIT_OBJECT_0 || waitResult == WAIT_ABANDONED)
+        {
+            const auto today = LogRetention::LocalDay(std::time(nullptr));
+            LogRetention::CompactDirectory(logDirectory, today, LogSettings::retention);
+            LogRetention::EnforceBudget(logsRoot, LogSettings::logDirectoryNames, budget, today);
+            ReleaseMutex(mutex);
+        }
+
+        CloseHandle(mutex);
+    }
+
+    // Writes the trace of this copy of the logger each time its dump event gets set. Started once per module, as each
+    // module that links the logger records its own trace.
+    void startPerfTraceDumps(const std::string& loggerName, const std::filesystem::path& logDirectory)
+    {
+        static std::once_flag started;
+        std::call_once(started, [&] {
+            // One auto-reset pair per module, so each request wakes this thread exactly once. They're never closed,
+            // the thread waits on them until the process exits.
+            const auto processId = GetCurrentProcessId();
+            const auto eventSuffix = [processId](size_t slot) { return std::to_wstring(processId) + L"-" + std::to_wstring(slot); };
+
+            // Takes the first slot no other module of this process has created yet
+            size_t slot = 0;
+            HANDLE dumpEvent = nullptr;
+            for (;; ++slot)
+            {
+                dumpEvent = CreateEventW(nullptr, false, false, (LogSettings::perfTraceDumpEventPrefix + eventSuffix(slot)).c_str());
+                if (!dumpEvent || GetLastError() != ERROR_ALREADY_EXISTS)
+                {
+                    break;
+                }
+
+                CloseHandle(dumpEvent);
+            }
+
+            HANDLE writtenEvent = CreateEventW(nullptr, false, false, (LogSettings::perfTraceWrittenEventPrefix + eventSuffix(slot)).c_str());
+            if (!dumpEvent || !writtenEvent)
+            {
+                if (dumpEvent)
+                {
+                    CloseHandle(dumpEvent);
+                }
+                if (writtenEvent)
+                {
+                    CloseHandle(writtenEvent);
+                }
+                return;
+            }
+
+            const auto tracePath = logDirectory / (loggerName + "-trace-" + std::to_string(processId) + "-" + std::to_string(slot) + ".json");
+            std::thread([dumpEvent, writtenEvent, processId, tracePath] {
+                while (WaitForSingleObject(dumpEvent, INFINITE) == WAIT_OBJECT_0)
+                {
+                    try
+                    {
+                        std::ofstream file{ tracePath, std::ios::binary };
+                        PerfTrace::WriteChromeTrace(file, processId);
+                    }
+                    catch (...)
+                    {
+                        Logger::error("Failed to write the perf trace");
+                    }
+
+                    SetEvent(writtenEvent);
+                }
+            }).detach();
+        });
+    }
 }
 
-level_enum getLogLevel(std::wstring_view logSettingsPath)
+level_enum getLogLevel(const LogSettings& settings)
 {
-    auto logLevel = get_log_settings(logSettingsPath).logLevel;
+    const auto& logLevel = settings.logLevel;
     if (auto it = logLevelMapping.find(logLevel); it != logLevelMapping.end())
     {
         return it->second;
@@ -44,6 +133,11 @@ level_enum getLogLevel(std::wstring_view logSettingsPath)
     return level_enum::trace;
 }
 
+spdlog::async_overflow_policy getOverflowPolicy(const LogSettings& settings)
+{
+    return settings.asyncOverflowPolicy == LogSettings::overflowPolicyBlock ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest;
+}
+
 std::shared_ptr<spdlog::logger> Logger::logger = spdlog::null_logger_mt("null");
 
 bool Logger::wasLogFailedShown()
@@ -55,22 +149,47 @@ bool Logger::wasLogFailedShown()
     return len;
 }
 
+std::shared_ptr<spdlog::logger> Logger::create_logger(std::string loggerName, std::vector<spdlog::sink_ptr> sinks, const LogSettings& settings)
+{
+    if (!settings.asyncLogging)
+    {
+        return make_shared<spdlog::logger>(std::move(loggerName), begin(sinks), end(sinks));
+    }
+
+    // Formatting and writing happen on the thread pool thread, the caller only enqueues the message.
+    // Async loggers only keep a weak reference to their pool, so it's spdlog's global one, kept until shutdown.
+    // Calling init again reuses it, with the queue size it was created with.
+    auto threadPool = spdlog::thread_pool();
+    if (!threadPool)
+    {
+        spdlog::init_thread_pool(settings.asyncQueueSize, 1);
+        threadPool = spdlog::thread_pool();
+    }
+
+    return make_shared<spdlog::async_logger>(std::move(loggerName), begin(sinks), end(sinks), threadPool, getOverflowPolicy(settings));
+}
+
 void Logger::init(std::string loggerName, std::wstring logFilePath, std::wstring_view logSettingsPath)
 {
-    auto logLevel = getLogLevel(logSettingsPath);
+    const auto settings = get_log_settings(logSettingsPath);
+    auto logLevel = getLogLevel(settings);
     try
     {
-        auto sink = make_shared<daily_file_sink_mt>(logFilePath, 0, 0, false, LogSettings::retention);
+        // The settings file is in the PowerToys folder, which has the logs of all modules
+        const auto logDirectory = std::filesystem::path{ logFilePath }.parent_path();
+        const auto logsRoot = std::filesystem::path{ logSettingsPath }.parent_path();
+        const uint64_t budget = static_cast<uint64_t>(settings.logSizeBudgetMB) * 1024 * 1024;
+        auto maintenance = [logDirectory, logsRoot, budget] { maintainLogs(logDirectory, logsRoot, budget); };
+
+        std::vector<spdlog::sink_ptr> sinks{ make_shared<CompactingFileSinkMt>(logFilePath, std::move(maintenance)) };
         if (IsDebuggerPresent())
         {
             auto msvc_sink = make_shared<msvc_sink_mt>();
             msvc_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%f] [%n] [t-%t] [%l] %v");
-            logger = make_shared<spdlog::logger>(loggerName, sinks_init_list{ sink, msvc_sink });
-        }
-        else
-        {
-            logger = make_shared<spdlog::logger>(loggerName, sink);
+            sinks.push_back(msvc_sink);
         }
+
+        logger = create_logger(loggerName, std::move(sinks), settings);
     }
     catch (...)
     {
@@ -94,6 +213,18 @@ void Logger::init(std::string loggerName, std::wstring logFilePath, std::wstring
     spdlog::register_logger(logger);
     spdlog::flush_every(std::chrono::seconds(3));
     logger->info("{} logger is initialized", loggerName);
+
+    PerfTrace::SetEnabled(settings.perfTrace);
+    if (settings.perfTrace)
+    {
+        startPerfTraceDumps(loggerName, std::filesystem::path{ logFilePath }.parent_path());
+    }
+}
+
+void Logger::shutdown()
+{
+    logger->flush();
+    spdlog::shutdown();
 }
 
 void Logger::init(std::vector<spdlog::sink_ptr> sinks)
@@ -106,3 +237,15 @@ void Logger::init(std::vector<spdlog::sink_ptr> sinks)
 
     Logger::logger = logger;
 }
+
+void Logger::init(std::vector<spdlog::sink_ptr> sinks, const LogSettings& settings)
+{
+    auto logger = create_logger("", std::move(sinks), settings);
+    if (!logger)
+    {
+        return;
+    }
+
+    logger->set_level(getLogLevel(settings));
+    Logger::logger = logger;
+}
@@ -8,12 +8,14 @@ private:
     inline const static std::wstring logFailedShown = L"logFailedShown";
     static std::shared_ptr<spdlog::logger> logger;
     static bool wasLogFailedShown();
+    static std::shared_ptr<spdlog::logger> create_logger(std::string loggerName, std::vector<spdlog::sink_ptr> sinks, const LogSettings& settings);
 
 public:
     Logger() = delete;
 
     static void init(std::string loggerName, std::wstring logFilePath, std::wstring_view logSettingsPath);
     static void init(std::vector<spdlog::sink_ptr> sinks);
+    static void init(std::vector<spdlog::sink_ptr> sinks, const LogSettings& settings);
 
     // log message should not be localized
     template<typename FormatString, typename... Args>
@@ -61,4 +63,8 @@ public:
     {
         logger->flush();
     }
+
+    // Flushes the logs and stops spdlog's background threads. Processes call it before they exit,
+    // so the threads aren't left to be joined by static destructors.
+    static void shutdown();
 };
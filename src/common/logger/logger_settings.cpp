@@ -10,6 +10,11 @@ using namespace winrt::Windows::Data::Json;
 LogSettings::LogSettings()
 {
     logLevel = defaultLogLevel;
+    asyncLogging = defaultAsyncLogging;
+    asyncQueueSize = defaultAsyncQueueSize;
+    asyncOverflowPolicy = defaultAsyncOverflowPolicy;
+    perfTrace = defaultPerfTrace;
+    logSizeBudgetMB = defaultLogSizeBudgetMB;
 }
 
 std::optional<JsonObject> from_file(std::wstring_view file_name)
@@ -47,6 +52,11 @@ JsonObject to_json(LogSettings settings)
 {
     JsonObject result;
     result.SetNamedValue(LogSettings::logLevelOption, JsonValue::CreateStringValue(settings.logLevel));
+    result.SetNamedValue(LogSettings::asyncLoggingOption, JsonValue::CreateBooleanValue(settings.asyncLogging));
+    result.SetNamedValue(LogSettings::asyncQueueSizeOption, JsonValue::CreateNumberValue(static_cast<double>(settings.asyncQueueSize)));
+    result.SetNamedValue(LogSettings::asyncOverflowPolicyOption, JsonValue::CreateStringValue(settings.asyncOverflowPolicy));
+    result.SetNamedValue(LogSettings::perfTraceOption, JsonValue::CreateBooleanValue(settings.perfTrace));
+    result.SetNamedValue(LogSettings::logSizeBudgetOption, JsonValue::CreateNumberValue(static_cast<double>(settings.logSizeBudgetMB)));
 
     return result;
 }
@@ -62,7 +72,41 @@ LogSettings to_settings(JsonObject jobject)
     {
         result.logLevel = LogSettings::defaultLogLevel;
     }
-    
+
+    // Async options are optional, log settings files created by older versions don't have them
+    try
+    {
+        result.asyncLogging = jobject.GetNamedBoolean(LogSettings::asyncLoggingOption, LogSettings::defaultAsyncLogging);
+        const auto queueSize = jobject.GetNamedNumber(LogSettings::asyncQueueSizeOption, static_cast<double>(LogSettings::defaultAsyncQueueSize));
+        result.asyncQueueSize = queueSize >= 1 ? static_cast<size_t>(queueSize) : LogSettings::defaultAsyncQueueSize;
+        result.asyncOverflowPolicy = jobject.GetNamedString(LogSettings::asyncOverflowPolicyOption, LogSettings::defaultAsyncOverflowPolicy);
+    }
+    catch (...)
+    {
+        result.asyncLogging = LogSettings::defaultAsyncLogging;
+        result.asyncQueueSize = LogSettings::defaultAsyncQueueSize;
+        result.asyncOverflowPolicy = LogSettings::defaultAsyncOverflowPolicy;
+    }
+
+    try
+    {
+        result.perfTrace = jobject.GetNamedBoolean(LogSettings::perfTraceOption, LogSettings::defaultPerfTrace);
+    }
+    catch (...)
+    {
+        result.perfTrace = LogSettings::defaultPerfTrace;
+    }
+
+    try
+    {
+        const auto budget = jobject.GetNamedNumber(LogSettings::logSizeBudgetOption, static_cast<double>(LogSettings::defaultLogSizeBudgetMB));
+        result.logSizeBudgetMB = budget >= 1 ? static_cast<size_t>(budget) : LogSettings::defaultLogSizeBudgetMB;
+    }
+    catch (...)
+    {
+        result.logSizeBudgetMB = LogSettings::defaultLogSizeBudgetMB;
+    }
+
     return result;
 }
 
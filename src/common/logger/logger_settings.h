@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 
 struct LogSettings
 {
@@ -31,8 +32,38 @@ struct LogSettings
     inline const static std::string powerRenameLoggerName = "powerrename";
     inline const static std::string alwaysOnTopLoggerName = "always-on-top";
     inline const static std::wstring alwaysOnTopLogPath = L"always-on-top-log.txt";
+    // Folders the paths above put the logs in, the size budget only applies to the daily logs in them
+    inline const static std::vector<std::wstring> logDirectoryNames = { L"Logs", L"RunnerLogs", L"UpdateLogs", L"LogsModuleInterface" };
+    // Number of days each logger keeps, the logs are also kept within logSizeBudgetMB all together
     inline const static int retention = 30;
+    inline const static std::wstring logSizeBudgetOption = L"logSizeBudgetMB";
+    inline const static size_t defaultLogSizeBudgetMB = 256;
+    inline const static std::wstring asyncLoggingOption = L"asyncLogging";
+    inline const static std::wstring asyncQueueSizeOption = L"asyncQueueSize";
+    inline const static std::wstring asyncOverflowPolicyOption = L"asyncOverflowPolicy";
+    // Callers wait for free space in the queue when it's full.
+    inline const static std::wstring overflowPolicyBlock = L"block";
+    // The oldest queued message is dropped when the queue is full.
+    inline const static std::wstring overflowPolicyOverrunOldest = L"overrun_oldest";
+    inline const static bool defaultAsyncLogging = false;
+    inline const static size_t defaultAsyncQueueSize = 8192;
+    inline const static std::wstring defaultAsyncOverflowPolicy = overflowPolicyOverrunOldest;
+    inline const static std::wstring perfTraceOption = L"perfTrace";
+    inline const static bool defaultPerfTrace = false;
+    // Loggers with perfTrace enabled write their trace next to their log when their dump event is set, then set their
+    // written event. Every module that links the logger has its own pair, both are auto-reset events named with the
+    // prefix followed by the process id, a dash and a slot. Slots are taken from 0 up in the order the modules start.
+    inline const static std::wstring perfTraceDumpEventPrefix = L"Local\\PowerToysPerfTraceDump-";
+    inline const static std::wstring perfTraceWrittenEventPrefix = L"Local\\PowerToysPerfTraceWritten-";
     std::wstring logLevel;
+    // When enabled, log messages are queued and written to the sinks by a background thread.
+    bool asyncLogging;
+    size_t asyncQueueSize;
+    std::wstring asyncOverflowPolicy;
+    // When enabled, hot paths are recorded by PerfTrace, see perf_trace.h
+    bool perfTrace;
+    // Size of the daily logs of all PowerToys processes together, the oldest ones are removed above it
+    size_t logSizeBudgetMB;
     LogSettings();
 };
 
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Binary timing trace of hot paths (hook procedures, drag handling, worker threads, IPC). Unlike the
+// text log nothing is formatted or locked while recording: every thread writes fixed size records into
+// its own ring buffer, which only keeps the latest records and is read when the trace is dumped.
+// Recording costs a single atomic load while the trace is disabled.
+namespace PerfTrace
+{
+    // Add new events at the end of the list and to events below
+    enum class Event : uint16_t
+    {
+        KeyboardManagerHook,
+        FancyZonesMoveSizeStart,
+        FancyZonesMoveSizeUpdate,
+        FancyZonesMoveSizeEnd,
+        PowerRenameRegexWorker,
+        PowerRenameFileOpWorker,
+        PowerRenameItemsRenamed,
+        IpcSend,
+        IpcReceive,
+        Count
+    };
+
+    struct EventInfo
+    {
+        Event id;
+        // Shown as the category and the name of the event in trace viewers, not localized
+        std::string_view category;
+        std::string_view name;
+    };
+
+    inline constexpr std::array<EventInfo, static_cast<size_t>(Event::Count)> events{ {
+        { Event::KeyboardManagerHook, "KeyboardManager", "HookProc" },
+        { Event::FancyZonesMoveSizeStart, "FancyZones", "MoveSizeStart" },
+        { Event::FancyZonesMoveSizeUpdate, "FancyZones", "MoveSizeUpdate" },
+        { Event::FancyZonesMoveSizeEnd, "FancyZones", "MoveSizeEnd" },
+        { Event::PowerRenameRegexWorker, "PowerRename", "RegexWorker" },
+        { Event::PowerRenameFileOpWorker, "PowerRename", "FileOpWorker" },
+        { Event::PowerRenameItemsRenamed, "PowerRename", "ItemsRenamed" },
+        { Event::IpcSend, "IPC", "Send" },
+        { Event::IpcReceive, "IPC", "Receive" },
+    } };
+
+    constexpr bool EventsMatchIds()
+    {
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            if (events[i].id != static_cast<Event>(i) || events[i].name.empty())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(EventsMatchIds(), "PerfTrace::events must describe every Event in declaration order");
+
+    constexpr const EventInfo& Describe(Event event)
+    {
+        return events[static_cast<size_t>(event)];
+    }
+
+    enum class RecordType : uint8_t
+    {
+        Begin,
+        End,
+        Counter,
+    };
+
+    struct Record
+    {
+        // Nanoseconds since the process started tracing
+        uint64_t timestamp;
+        // Only used by counters
+        int64_t value;
+        Event event;
+        RecordType type;
+    };
+
+    struct ThreadTrace
+    {
+        // Small number identifying the thread within the trace, not the OS thread id
+        uint32_t thread;
+        std::vector<Record> records;
+    };
+
+    namespace details
+    {
+        inline const auto epoch = std::chrono::steady_clock::now();
+        inline std::atomic<bool> enabled = false;
+
+        // Written by its thread only. Readers copy the records without stopping the writer and drop
+        // the ones which could have been overwritten while they were copied.
+        class ThreadBuffer
+        {
+        public:
+            // Must be a power of two
+            static constexpr uint64_t capacity = 8192;
+
+            explicit ThreadBuffer(uint32_t thread) :
+                m_thread(thread), m_slots(std::make_unique<Slot[]>(capacity))
+            {
+            }
+
+            uint32_t Thread() const noexcept { return m_thread; }
+
+            void Write(Event event, RecordType type, int64_t value) noexcept
+            {
+                const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+                const uint64_t index = m_head.load(std::memory_order_relaxed);
+
+                // Announces that the slot is about to be overwritten before touching it
+                m_reserved.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                auto& slot = m_slots[index & (capacity - 1)];
+                slot.timestamp.store(static_cast<uint64_t>(timestamp), std::memory_order_relaxed);
+                slot.value.store(static_cast<uint64_t>(value), std::memory_order_relaxed);
+                slot.kind.store(static_cast<uint32_t>(event) << 8 | static_cast<uint32_t>(type), std::memory_order_relaxed);
+                m_head.store(index + 1, std::memory_order_release);
+            }
+
+            std::vector<Record> Read() const
+            {
+                const uint64_t head = m_head.load(std::memory_order_acquire);
+                const uint64_t first = std::max(m_cleared.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0);
+
+                std::vector<Record> records;
+                records.reserve(static_cast<size_t>(head - first));
+                for (uint64_t index = first; index < head; ++index)
+                {
+                    const auto& slot = m_slots[index & (capacity - 1)];
+                    const auto kind = slot.kind.load(std::memory_order_relaxed);
+                    records.push_back({ slot.timestamp.load(std::memory_order_relaxed),
+                                        static_cast<int64_t>(slot.value.load(std::memory_order_relaxed)),
+                                        static_cast<Event>(kind >> 8),
+                                        static_cast<RecordType>(kind & 0xff) });
+                }
+
+                // Every slot the writer reused after head was read belongs to an index older than this
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t reserved = m_reserved.load(std::memory_order_relaxed);
+                const uint64_t valid = reserved > capacity ? reserved - capacity : 0;
+                if (valid > first)
+                {
+                    records.erase(records.begin(), records.begin() + static_cast<ptrdiff_t>(std::min(valid, head) - first));
+                }
+
+                return records;
+            }
+
+            void Clear() noexcept
+            {
+                m_cleared.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+            }
+
+            std::atomic<bool> retired = false;
+
+        private:
+            struct Slot
+            {
+                std::atomic<uint64_t> timestamp;
+                std::atomic<uint64_t> value;
+                std::atomic<uint32_t> kind;
+            };
+
+            const uint32_t m_thread;
+            const std::unique_ptr<Slot[]> m_slots;
+            // Number of records written so far
+            std::atomic<uint64_t> m_head = 0;
+            // Number of records the writer started, one more than m_head while a write is in progress
+            std::atomic<uint64_t> m_reserved = 0;
+            // Records before this one are not read
+            std::atomic<uint64_t> m_cleared = 0;
+        };
+
+        // Buffers of finished threads are kept so short lived workers still show up in the trace
+        inline constexpr size_t maxRetiredBuffers = 8;
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            uint32_t nextThread = 1;
+        };
+
+        // Never destroyed, detached threads can exit after the static destructors ran
+        inline Registry& GetRegistry()
+        {
+            static auto registry = new Registry;
+            return *registry;
+        }
+
+        class ThreadBufferOwner
+        {
+        public:
+            ThreadBufferOwner() = default;
+            ThreadBufferOwner(const ThreadBufferOwner&) = delete;
+            ThreadBufferOwner& operator=(const ThreadBufferOwner&) = delete;
+
+            ~ThreadBufferOwner()
+            {
+                if (!m_buffer)
+                {
+                    return;
+                }
+
+                auto& registry = GetRegistry();
+                std::scoped_lock lock{ registry.mutex };
+                m_buffer->retired = true;
+
+                auto& buffers = registry.buffers;
+                auto retired = std::count_if(buffers.begin(), buffers.end(), [](const auto& buffer) { return buffer->retired.load(); });
+                for (auto it = buffers.begin(); retired > static_cast<ptrdiff_t>(maxRetiredBuffers) && it != buffers.end();)
+                {
+                    if ((*it)->retired)
+                    {
+                        it = buffers.erase(it);
+                        --retired;
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            ThreadBuffer* Get() noexcept
+            {
+                if (!m_buffer)
+                {
+                    try
+                    {
+                        auto& registry = GetRegistry();
+                        std::scoped_lock lock{ registry.mutex };
+                        m_buffer = std::make_shared<ThreadBuffer>(registry.nextThread++);
+                        registry.buffers.push_back(m_buffer);
+                    }
+                    catch (...)
+                    {
+                        // Nothing is recorded on this thread when the buffer can't be allocated
+                        m_buffer = nullptr;
+                        return nullptr;
+                    }
+                }
+
+                return m_buffer.get();
+            }
+
+        private:
+            std::shared_ptr<ThreadBuffer> m_buffer;
+        };
+
+        inline void Write(Event event, RecordType type, int64_t value = 0) noexcept
+        {
+            thread_local ThreadBufferOwner owner;
+            if (auto buffer = owner.Get())
+            {
+                buffer->Write(event, type, value);
+            }
+        }
+    }
+
+    inline void SetEnabled(bool enabled) noexcept
+    {
+        details::enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    inline bool IsEnabled() noexcept
+    {
+        return details::enabled.load(std::memory_order_relaxed);
+    }
+
+    inline void Begin(Event event) noexcept
+    {
+        if (IsEnabled())
+        {
+            details::Write(event, RecordType::Begin);
+        }
+    }
+
+    inline void End(Event event) noexcept
+    {
+        if (IsEnabled())
+        {
+            details::Write(event, RecordType::End);
+        }
+    }
+
+    inline void Counter(Event event, int64_t value) noexcept
+    {
+        if (IsEnabled())
+        {
+            details::Write(event, RecordType::Counter, value);
+        }
+    }
+
+    // Records the time between its construction and destruction. A span started while tracing
+    // was enabled is always ended, so the trace stays balanced when tracing is turned off.
+    class Span
+    {
+    public:
+        explicit Span(Event event) noexcept :
+            m_event(event), m_active(IsEnabled())
+        {
+            if (m_active)
+            {
+                details::Write(m_event, RecordType::Begin);
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        ~Span()
+        {
+            if (m_active)
+            {
+                details::Write(m_event, RecordType::End);
+            }
+        }
+
+    private:
+        const Event m_event;
+        const bool m_active;
+    };
+
+    // Copies the records of every thread, the threads keep recording meanwhile
+    inline std::vector<ThreadTrace> Snapshot()
+    {
+        std::vector<std::shared_ptr<details::ThreadBuffer>> buffers;
+        {
+            auto& registry = details::GetRegistry();
+            std::scoped_lock lock{ registry.mutex };
+            buffers = registry.buffers;
+        }
+
+        std::vector<ThreadTrace> result;
+        for (const auto& buffer : buffers)
+        {
+            result.push_back({ buffer->Thread(), buffer->Read() });
+        }
+
+        return result;
+    }
+
+    // Drops the records written so far
+    inline void Clear()
+    {
+        auto& registry = details::GetRegistry();
+        std::scoped_lock lock{ registry.mutex };
+        for (const auto& buffer : registry.buffers)
+        {
+            buffer->Clear();
+        }
+    }
+
+    // Writes the snapshot in the Chrome trace event format, which chrome://tracing and Perfetto open.
+    // Ends whose begin was already overwritten in the ring buffer are left out.
+    inline void WriteChromeTrace(std::ostream& stream, const std::vector<ThreadTrace>& threads, uint32_t processId)
+    {
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto& thread : threads)
+        {
+            size_t depth = 0;
+            for (const auto& record : thread.records)
+            {
+                if (record.type == RecordType::Begin)
+                {
+                    depth++;
+                }
+                else if (record.type == RecordType::End)
+                {
+                    if (depth == 0)
+                    {
+                        continue;
+                    }
+
+                    depth--;
+                }
+
+                const auto& info = Describe(record.event);
+                stream << (first ? "\n" : ",\n");
+                first = false;
+
+                const char* phase = record.type == RecordType::Begin ? "B" : record.type == RecordType::End ? "E" : "C";
+                stream << "{\"name\":\"" << info.name << "\",\"cat\":\"" << info.category << "\",\"ph\":\"" << phase
+                       << "\",\"ts\":" << record.timestamp / 1000 << '.' << std::setw(3) << std::setfill('0') << record.timestamp % 1000
+                       << ",\"pid\":" << processId << ",\"tid\":" << thread.thread;
+                if (record.type == RecordType::Counter)
+                {
+                    stream << ",\"args\":{\"value\":" << record.value << '}';
+                }
+
+                stream << '}';
+            }
+        }
+
+        stream << "\n]}\n";
+    }
+
+    inline void WriteChromeTrace(std::ostream& stream, uint32_t processId)
+    {
+        WriteChromeTrace(stream, Snapshot(), processId);
+    }
+}
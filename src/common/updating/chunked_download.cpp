@@ -0,0 +1,458 @@
+#include "pch.h"
+#include "chunked_download.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bcrypt.h>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <format>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    constexpr char CHUNK_MAP_HEADER[] = "PowerToys download chunk map 1";
+    constexpr uint64_t MIN_CHUNK_SIZE = 64 * 1024;
+
+    struct chunk_map
+    {
+        std::string validator;
+        uint64_t size = 0;
+        uint64_t chunk_size = 0;
+        std::vector<bool> completed;
+    };
+
+    // Validators are ASCII in practice, anything else only has to compare equal to itself
+    std::string narrow(const std::wstring& text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (auto c : text)
+        {
+            result += c > 0x20 && c < 0x7f ? static_cast<char>(c) : '?';
+        }
+
+        return result;
+    }
+
+    std::optional<chunk_map> load_chunk_map(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        std::string header, completed;
+        chunk_map map;
+        if (!std::getline(file, header) || header != CHUNK_MAP_HEADER ||
+            !std::getline(file, map.validator) || !(file >> map.size >> map.chunk_size >> completed))
+        {
+            return std::nullopt;
+        }
+
+        for (auto c : completed)
+        {
+            map.completed.push_back(c == '1');
+        }
+
+        return map;
+    }
+
+    // Replaces the previous map only once the new one is written completely
+    void save_chunk_map(const std::filesystem::path& path, const chunk_map& map)
+    {
+        auto temporary = path;
+        temporary += L".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            file << CHUNK_MAP_HEADER << '\n'
+                 << map.validator << '\n'
+                 << map.size << '\n'
+                 << map.chunk_size << '\n';
+            for (bool completed : map.completed)
+            {
+                file << (completed ? '1' : '0');
+            }
+
+            file << '\n';
+            if (!file.flush())
+            {
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+    }
+
+    void remove_chunk_map(const std::filesystem::path& destination)
+    {
+        std::error_code ec;
+        std::filesystem::remove(updating::chunk_map_path(destination), ec);
+    }
+
+    double seconds_since(clock::time_point start)
+    {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    nonstd::expected<updating::download_result, std::wstring> verify(updating::sha256& hash, const std::filesystem::path& destination, const updating::download_options& options, uint64_t transferred, clock::time_point start)
+    {
+        updating::download_result result{ hash.finish(), transferred, seconds_since(start) };
+        if (!options.expected_sha256.empty() && result.sha256 != options.expected_sha256)
+        {
+            std::error_code ec;
+            std::filesystem::remove(destination, ec);
+            return nonstd::make_unexpected(L"The downloaded file doesn't match the expected hash");
+        }
+
+        return result;
+    }
+
+    // Servers that don't accept ranges, or don't send the size, are read in one go without resuming
+    nonstd::expected<updating::download_result, std::wstring> download_whole(updating::range_source& source, const std::filesystem::path& destination, const updating::download_options& options, const updating::remote_file_info& info, clock::time_point start)
+    {
+        remove_chunk_map(destination);
+        std::ofstream file(destination, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return nonstd::make_unexpected(L"Can't create " + destination.wstring());
+        }
+
+        updating::sha256 hash;
+        uint64_t received = 0;
+        source.read(0, 0, [&](std::span<const uint8_t> data) {
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            hash.update(data);
+            received += data.size();
+            if (options.progress)
+            {
+                options.progress({ received, info.size, received / std::max(seconds_since(start), 1e-3) });
+            }
+
+            return static_cast<bool>(file);
+        });
+
+        if (!file.flush() || (info.size != 0 && received != info.size))
+        {
+            return nonstd::make_unexpected(L"The download was interrupted");
+        }
+
+        file.close();
+        return verify(hash, destination, options, received, start);
+    }
+
+    nonstd::expected<updating::download_result, std::wstring> download_chunks(updating::range_source& source, const std::filesystem::path& destination, const updating::download_options& options, const updating::remote_file_info& info, clock::time_point start)
+    {
+        const uint64_t chunk_size = std::max(options.chunk_size, MIN_CHUNK_SIZE);
+        const size_t chunk_count = static_cast<size_t>((info.size + chunk_size - 1) / chunk_size);
+        const auto map_path = updating::chunk_map_path(destination);
+        auto chunk_length = [&](size_t chunk) { return std::min(chunk_size, info.size - chunk * chunk_size); };
+
+        // Chunks from a previous attempt are only trusted if the server still has the same file
+        chunk_map map{ narrow(info.validator), info.size, chunk_size, std::vector<bool>(chunk_count) };
+        auto previous = load_chunk_map(map_path);
+        std::error_code ec;
+        const bool resume = previous && !map.validator.empty() && previous->validator == map.validator &&
+                            previous->size == map.size && previous->chunk_size == map.chunk_size &&
+                            previous->completed.size() == chunk_count && std::filesystem::file_size(destination, ec) == info.size && !ec;
+        if (resume)
+        {
+            map.completed = previous->completed;
+        }
+        else
+        {
+            // Preallocated, the chunks are written at their offsets as they complete
+            std::ofstream(destination, std::ios::binary | std::ios::trunc).close();
+            std::filesystem::resize_file(destination, info.size, ec);
+            if (ec)
+            {
+                return nonstd::make_unexpected(L"Can't create " + destination.wstring());
+            }
+
+            save_chunk_map(map_path, map);
+        }
+
+        std::fstream file(destination, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file)
+        {
+            return nonstd::make_unexpected(L"Can't open " + destination.wstring());
+        }
+
+        const std::vector<bool> resumed = map.completed;
+        // Chunks downloaded ahead of the one being hashed are kept in memory, this bounds how far ahead
+        const size_t window = std::max(options.parallel_chunks, 1u) * size_t{ 2 };
+
+        std::mutex mutex;
+        std::condition_variable hashed_changed;
+        std::map<size_t, std::vector<uint8_t>> unhashed;
+        size_t next_chunk = 0;
+        size_t hashed_chunks = 0;
+        uint64_t completed_bytes = 0;
+        std::atomic<uint64_t> transferred = 0;
+        std::optional<std::wstring> failure;
+        updating::sha256 hash;
+
+        for (size_t chunk = 0; chunk < chunk_count; chunk++)
+        {
+            completed_bytes += resumed[chunk] ? chunk_length(chunk) : 0;
+        }
+
+        // Hashes the chunks that are available in file order, called with the mutex held
+        auto advance_hash = [&] {
+            std::vector<uint8_t> resumed_data;
+            for (; hashed_chunks < chunk_count; hashed_chunks++)
+            {
+                if (auto data = unhashed.find(hashed_chunks); data != unhashed.end())
+                {
+                    hash.update(data->second);
+                    unhashed.erase(data);
+                }
+                else if (resumed[hashed_chunks])
+                {
+                    // Downloaded by a previous attempt, so this read is the only one these bytes need
+                    resumed_data.resize(chunk_length(hashed_chunks));
+                    file.seekg(hashed_chunks * chunk_size);
+                    if (!file.read(reinterpret_cast<char*>(resumed_data.data()), resumed_data.size()))
+                    {
+                        failure = L"Can't read " + destination.wstring();
+                        break;
+                    }
+
+                    hash.update(resumed_data);
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            hashed_changed.notify_all();
+        };
+
+        auto fail = [&](std::wstring message) {
+            std::scoped_lock lock(mutex);
+            if (!failure)
+            {
+                failure = std::move(message);
+            }
+
+            hashed_changed.notify_all();
+        };
+
+        auto fetch_chunks = [&] {
+            std::vector<uint8_t> buffer;
+            for (;;)
+            {
+                size_t chunk;
+                {
+                    std::unique_lock lock(mutex);
+                    // Other workers move next_chunk while this one waits, so the resumed chunks are skipped on every check
+                    hashed_changed.wait(lock, [&] {
+                        while (next_chunk < chunk_count && resumed[next_chunk])
+                        {
+                            next_chunk++;
+                        }
+
+                        return failure || next_chunk >= chunk_count || next_chunk < hashed_chunks + window;
+                    });
+                    if (failure || next_chunk >= chunk_count)
+                    {
+                        return;
+                    }
+
+                    chunk = next_chunk++;
+                }
+
+                const uint64_t length = chunk_length(chunk);
+                bool fetched = false;
+                for (unsigned attempt = 0; attempt < std::max(options.attempts_per_chunk, 1u) && !fetched; attempt++)
+                {
+                    buffer.clear();
+                    buffer.reserve(length);
+                    try
+                    {
+                        source.read(chunk * chunk_size, length, [&](std::span<const uint8_t> data) {
+                            if (buffer.size() + data.size() > length)
+                            {
+                                return false;
+                            }
+
+                            buffer.insert(buffer.end(), data.begin(), data.end());
+                            transferred += data.size();
+                            return true;
+                        });
+                        fetched = buffer.size() == length;
+                    }
+                    catch (...)
+                    {
+                        // Retried from the start of the chunk
+                    }
+                }
+
+                if (!fetched)
+                {
+                    fail(L"The download was interrupted");
+                    return;
+                }
+
+                std::scoped_lock lock(mutex);
+                file.seekp(chunk * chunk_size);
+                if (!file.write(reinterpret_cast<const char*>(buffer.data()), length) || !file.flush())
+                {
+                    failure = L"Can't write " + destination.wstring();
+                    hashed_changed.notify_all();
+                    return;
+                }
+
+                map.completed[chunk] = true;
+                save_chunk_map(map_path, map);
+                completed_bytes += length;
+                unhashed.emplace(chunk, std::move(buffer));
+                buffer = {};
+                advance_hash();
+
+                if (options.progress)
+                {
+                    options.progress({ completed_bytes, info.size, transferred / std::max(seconds_since(start), 1e-3) });
+                }
+            }
+        };
+
+        auto worker = [&] {
+            try
+            {
+                fetch_chunks();
+            }
+            catch (...)
+            {
+                fail(L"The download failed");
+            }
+        };
+
+        {
+            std::scoped_lock lock(mutex);
+            advance_hash();
+        }
+
+        const size_t missing = std::count(resumed.begin(), resumed.end(), false);
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < std::min<size_t>(std::max(options.parallel_chunks, 1u), missing); i++)
+        {
+            try
+            {
+                workers.emplace_back(worker);
+            }
+            catch (const std::system_error&)
+            {
+                // The chunks are shared by whichever threads could be started
+                break;
+            }
+        }
+
+        worker();
+        for (auto& thread : workers)
+        {
+            thread.join();
+        }
+
+        if (failure)
+        {
+            // The completed chunks stay recorded for the next attempt
+            return nonstd::make_unexpected(*failure);
+        }
+
+        file.close();
+        remove_chunk_map(destination);
+        return verify(hash, destination, options, transferred, start);
+    }
+}
+
+namespace updating
+{
+    std::filesystem::path chunk_map_path(const std::filesystem::path& destination)
+    {
+        auto path = destination;
+        path += L".chunks";
+        return path;
+    }
+
+    nonstd::expected<download_result, std::wstring> download_file(range_source& source, const std::filesystem::path& destination, const download_options& options)
+    {
+        const auto start = clock::now();
+        try
+        {
+            const auto info = source.query();
+            if (!info.accepts_ranges || info.size == 0)
+            {
+                return download_whole(source, destination, options, info, start);
+            }
+
+            return download_chunks(source, destination, options, info, start);
+        }
+        catch (...)
+        {
+        }
+
+        return nonstd::make_unexpected(L"The download failed");
+    }
+
+    sha256::sha256()
+    {
+        BCRYPT_ALG_HANDLE algorithm = nullptr;
+        BCRYPT_HASH_HANDLE hash = nullptr;
+        if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&algorithm, BCRYPT_SHA256_ALGORITHM, nullptr, 0)) ||
+            !BCRYPT_SUCCESS(BCryptCreateHash(algorithm, &hash, nullptr, 0, nullptr, 0, 0)))
+        {
+            if (algorithm)
+            {
+                BCryptCloseAlgorithmProvider(algorithm, 0);
+            }
+
+            throw std::runtime_error("SHA-256 is not available");
+        }
+
+        m_algorithm = algorithm;
+        m_hash = hash;
+    }
+
+    sha256::~sha256()
+    {
+        if (m_hash)
+        {
+            BCryptDestroyHash(m_hash);
+        }
+
+        BCryptCloseAlgorithmProvider(m_algorithm, 0);
+    }
+
+    void sha256::update(std::span<const uint8_t> data)
+    {
+        while (!data.empty())
+        {
+            const auto size = static_cast<ULONG>(std::min<size_t>(data.size(), ULONG_MAX));
+            BCryptHashData(m_hash, const_cast<PUCHAR>(data.data()), size, 0);
+            data = data.subspan(size);
+        }
+    }
+
+    std::wstring sha256::finish()
+    {
+        UCHAR digest[32];
+        BCryptFinishHash(m_hash, digest, sizeof(digest), 0);
+        BCryptDestroyHash(m_hash);
+        m_hash = nullptr;
+
+        std::wstring result;
+        for (auto byte : digest)
+        {
+            result += std::format(L"{:02x}", byte);
+        }
+
+        return result;
+    }
+}
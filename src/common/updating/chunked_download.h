@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+
+#include <expected.hpp>
+
+namespace updating
+{
+    struct remote_file_info
+    {
+        // 0 when the server didn't send the size
+        uint64_t size = 0;
+        bool accepts_ranges = false;
+        // ETag or Last-Modified, chunks kept from a previous attempt are only used if it didn't change
+        std::wstring validator;
+    };
+
+    // The file being downloaded, as seen through the server
+    class range_source
+    {
+    public:
+        virtual ~range_source() = default;
+
+        virtual remote_file_info query() = 0;
+
+        // Passes the bytes of [offset, offset + length) to sink as they arrive, or the whole file when
+        // the server doesn't accept ranges and length is 0. Stops early when sink returns false.
+        // Throws when the transfer fails.
+        virtual void read(uint64_t offset, uint64_t length, const std::function<bool(std::span<const uint8_t>)>& sink) = 0;
+    };
+
+    struct download_progress
+    {
+        uint64_t completed_bytes;
+        uint64_t total_bytes;
+        double bytes_per_second;
+    };
+
+    struct download_options
+    {
+        uint64_t chunk_size = 4 * 1024 * 1024;
+        // Chunks downloaded at the same time
+        unsigned parallel_chunks = 4;
+        unsigned attempts_per_chunk = 3;
+        // Lowercase hex SHA-256 the file must have, not checked when empty
+        std::wstring expected_sha256;
+        std::function<void(const download_progress&)> progress;
+    };
+
+    struct download_result
+    {
+        std::wstring sha256;
+        // Bytes received in this attempt, excluding the chunks resumed from a previous one
+        uint64_t transferred_bytes = 0;
+        double seconds = 0;
+
+        double bytes_per_second() const noexcept { return seconds > 0 ? transferred_bytes / seconds : 0; }
+    };
+
+    // Downloads the file into destination, fetching several chunks at once when the server accepts ranges.
+    // The completed chunks are recorded next to the file, so an interrupted download resumes where it
+    // stopped when called again. The SHA-256 is computed while the chunks come in, in file order.
+    nonstd::expected<download_result, std::wstring> download_file(range_source& source, const std::filesystem::path& destination, const download_options& options = {});
+
+    // File recording the completed chunks of destination while it's being downloaded
+    std::filesystem::path chunk_map_path(const std::filesystem::path& destination);
+
+    class sha256
+    {
+    public:
+        sha256();
+        ~sha256();
+        sha256(const sha256&) = delete;
+        sha256& operator=(const sha256&) = delete;
+
+        void update(std::span<const uint8_t> data);
+        // Lowercase hex digest, the object can't be updated afterwards
+        std::wstring finish();
+
+    private:
+        void* m_algorithm = nullptr;
+        void* m_hash = nullptr;
+    };
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "http_range_source.h"
+
+#include <common/utils/HttpClient.h>
+
+#include <format>
+
+#include <winrt/Windows.Storage.Streams.h>
+#include <winrt/Windows.Web.Http.Filters.h>
+#include <winrt/Windows.Web.Http.Headers.h>
+
+namespace
+{
+    using namespace winrt::Windows::Web::Http;
+    using namespace winrt::Windows::Storage::Streams;
+
+    constexpr uint32_t READ_BUFFER_SIZE = 256 * 1024;
+
+    // The WinINet cache would answer conditional requests itself, and can't be mixed with partial responses
+    HttpClient create_uncached_client()
+    {
+        Filters::HttpBaseProtocolFilter filter;
+        filter.CacheControl().ReadBehavior(Filters::HttpCacheReadBehavior::NoCache);
+        filter.CacheControl().WriteBehavior(Filters::HttpCacheWriteBehavior::NoCache);
+
+        HttpClient client{ filter };
+        client.DefaultRequestHeaders().UserAgent().TryParseAdd(http::USER_AGENT);
+        return client;
+    }
+
+    std::wstring header_value(const Headers::HttpContentHeaderCollection& content_headers, const Headers::HttpResponseHeaderCollection& headers, const wchar_t* name)
+    {
+        if (auto value = headers.TryLookup(name))
+        {
+            return std::wstring{ *value };
+        }
+
+        if (auto value = content_headers.TryLookup(name))
+        {
+            return std::wstring{ *value };
+        }
+
+        return {};
+    }
+}
+
+namespace updating
+{
+    http_range_source::http_range_source(winrt::Windows::Foundation::Uri url) :
+        m_url(std::move(url)), m_client(create_uncached_client())
+    {
+    }
+
+    remote_file_info http_range_source::query()
+    {
+        HttpRequestMessage request{ HttpMethod::Head(), m_url };
+        auto response = m_client.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead).get();
+        response.EnsureSuccessStatusCode();
+
+        const auto headers = response.Headers();
+        const auto content_headers = response.Content().Headers();
+
+        remote_file_info info;
+        if (auto length = content_headers.ContentLength())
+        {
+            info.size = length.Value();
+        }
+
+        info.accepts_ranges = _wcsicmp(header_value(content_headers, headers, L"Accept-Ranges").c_str(), L"bytes") == 0;
+        info.validator = header_value(content_headers, headers, L"ETag");
+        if (info.validator.empty())
+        {
+            info.validator = header_value(content_headers, headers, L"Last-Modified");
+        }
+
+        return info;
+    }
+
+    void http_range_source::read(uint64_t offset, uint64_t length, const std::function<bool(std::span<const uint8_t>)>& sink)
+    {
+        HttpRequestMessage request{ HttpMethod::Get(), m_url };
+        if (length != 0)
+        {
+            request.Headers().TryAppendWithoutValidation(L"Range", std::format(L"bytes={}-{}", offset, offset + length - 1));
+        }
+
+        auto response = m_client.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead).get();
+        response.EnsureSuccessStatusCode();
+
+        // A server that ignores the range answers 200 with the whole file
+        if (length != 0 && response.StatusCode() != HttpStatusCode::PartialContent)
+        {
+            throw std::runtime_error("The server didn't return the requested range");
+        }
+
+        auto stream = response.Content().ReadAsInputStreamAsync().get();
+        Buffer buffer{ READ_BUFFER_SIZE };
+        for (;;)
+        {
+            auto filled = stream.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::Partial).get();
+            if (filled.Length() == 0)
+            {
+                break;
+            }
+
+            if (!sink({ filled.data(), filled.Length() }))
+            {
+                break;
+            }
+        }
+
+        stream.Close();
+    }
+
+    http_metadata_source::http_metadata_source() :
+        m_client(create_uncached_client())
+    {
+    }
+
+    metadata_response http_metadata_source::get(const std::wstring& url, const std::wstring& etag, const std::wstring& last_modified)
+    {
+        HttpRequestMessage request{ HttpMethod::Get(), winrt::Windows::Foundation::Uri{ url } };
+        if (!etag.empty())
+        {
+            request.Headers().TryAppendWithoutValidation(L"If-None-Match", etag);
+        }
+
+        if (!last_modified.empty())
+        {
+            request.Headers().TryAppendWithoutValidation(L"If-Modified-Since", last_modified);
+        }
+
+        auto response = m_client.SendRequestAsync(request).get();
+        metadata_response result;
+        result.status = static_cast<uint16_t>(response.StatusCode());
+        if (response.StatusCode() == HttpStatusCode::NotModified)
+        {
+            return result;
+        }
+
+        response.EnsureSuccessStatusCode();
+        const auto headers = response.Headers();
+        const auto content_headers = response.Content().Headers();
+        result.etag = header_value(content_headers, headers, L"ETag");
+        result.last_modified = header_value(content_headers, headers, L"Last-Modified");
+        result.body = response.Content().ReadAsStringAsync().get();
+        return result;
+    }
+}
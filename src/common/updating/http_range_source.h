@@ -0,0 +1,36 @@
+#pragma once
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Web.Http.h>
+
+#include "chunked_download.h"
+#include "update_cache.h"
+
+namespace updating
+{
+    // range_source for a file served over HTTP. Requests are blocking, so it must not be used on an STA thread.
+    class http_range_source : public range_source
+    {
+    public:
+        explicit http_range_source(winrt::Windows::Foundation::Uri url);
+
+        remote_file_info query() override;
+        void read(uint64_t offset, uint64_t length, const std::function<bool(std::span<const uint8_t>)>& sink) override;
+
+    private:
+        winrt::Windows::Foundation::Uri m_url;
+        winrt::Windows::Web::Http::HttpClient m_client;
+    };
+
+    // metadata_source for the GitHub API. Requests are blocking, so it must not be used on an STA thread.
+    class http_metadata_source : public metadata_source
+    {
+    public:
+        http_metadata_source();
+
+        metadata_response get(const std::wstring& url, const std::wstring& etag, const std::wstring& last_modified) override;
+
+    private:
+        winrt::Windows::Web::Http::HttpClient m_client;
+    };
+}
@@ -0,0 +1,210 @@
+#include "pch.h"
+#include "update_cache.h"
+
+#include <common/SettingsAPI/settings_helpers.h>
+#include <common/utils/json.h>
+
+namespace // Strings in this namespace should not be localized
+{
+    const wchar_t UPDATE_CACHE_FILENAME[] = L"UpdateCache.json";
+    const wchar_t UPDATE_CACHE_MUTEX[] = L"Local\\PowerToysUpdateCacheMutex";
+
+    const wchar_t POLICIES_KEY[] = L"SOFTWARE\\Policies\\PowerToys";
+    const wchar_t UPDATE_MIRROR_VALUE[] = L"UpdateMirrorUrl";
+    const wchar_t HTTPS_SCHEME[] = L"https://";
+
+    uint64_t get_count(const json::JsonObject& json, const wchar_t* name)
+    {
+        return static_cast<uint64_t>(json.GetNamedNumber(name, 0));
+    }
+
+    std::optional<std::wstring> read_policy_string(HKEY root, const wchar_t* value)
+    {
+        DWORD size = 0;
+        if (RegGetValueW(root, POLICIES_KEY, value, RRF_RT_REG_SZ, nullptr, nullptr, &size) != ERROR_SUCCESS || size <= sizeof(wchar_t))
+        {
+            return std::nullopt;
+        }
+
+        std::wstring result(size / sizeof(wchar_t), L'\0');
+        if (RegGetValueW(root, POLICIES_KEY, value, RRF_RT_REG_SZ, nullptr, result.data(), &size) != ERROR_SUCCESS)
+        {
+            return std::nullopt;
+        }
+
+        result.resize(wcsnlen(result.c_str(), result.size()));
+        return result;
+    }
+}
+
+namespace updating
+{
+    update_cache::update_cache(std::filesystem::path file) :
+        m_file(std::move(file))
+    {
+    }
+
+    std::filesystem::path update_cache::default_path()
+    {
+        return std::filesystem::path{ PTSettingsHelper::get_root_save_folder_location() } / UPDATE_CACHE_FILENAME;
+    }
+
+    std::wstring update_cache::fetch_metadata(metadata_source& source, const std::wstring& url)
+    {
+        cached_response cached;
+        if (auto responses = read().responses; responses.contains(url))
+        {
+            cached = std::move(responses[url]);
+        }
+
+        const bool have_body = !cached.body.empty();
+        auto response = source.get(url, have_body ? cached.etag : L"", have_body ? cached.last_modified : L"");
+        if (response.status == 304 && have_body)
+        {
+            const uint64_t saved = winrt::to_string(cached.body).size();
+            store([&](state& data) {
+                data.metrics.metadata_requests++;
+                data.metrics.metadata_not_modified++;
+                data.metrics.metadata_bytes_saved += saved;
+            });
+            return cached.body;
+        }
+
+        if (response.status < 200 || response.status >= 300)
+        {
+            throw std::runtime_error("Unexpected response to the release metadata request");
+        }
+
+        store([&](state& data) {
+            data.metrics.metadata_requests++;
+            if (!response.etag.empty() || !response.last_modified.empty())
+            {
+                data.responses[url] = { response.etag, response.last_modified, response.body };
+            }
+            else
+            {
+                data.responses.erase(url);
+            }
+        });
+        return std::move(response.body);
+    }
+
+    nonstd::expected<download_result, std::wstring> update_cache::download_installer(range_source* mirror, range_source& origin, const std::filesystem::path& destination, const download_options& options)
+    {
+        // The mirror isn't trusted on its own, what it serves is only used when it can be checked against the release
+        if (mirror && !options.expected_sha256.empty())
+        {
+            auto result = download_file(*mirror, destination, options);
+            if (result)
+            {
+                store([&](state& data) {
+                    data.metrics.mirror_downloads++;
+                    data.metrics.mirror_bytes += result->transferred_bytes;
+                });
+                return result;
+            }
+        }
+
+        return download_file(origin, destination, options);
+    }
+
+    update_cache_metrics update_cache::metrics() const
+    {
+        return read().metrics;
+    }
+
+    update_cache::state update_cache::read() const
+    {
+        std::optional<json::JsonObject> json;
+        {
+            wil::unique_mutex_nothrow mutex{ CreateMutexW(nullptr, FALSE, UPDATE_CACHE_MUTEX) };
+            auto lock = mutex.acquire();
+            json = json::from_file(m_file.native());
+        }
+
+        state result;
+        if (!json)
+        {
+            return result;
+        }
+
+        try
+        {
+            for (const auto& entry : json->GetNamedObject(L"responses", json::JsonObject{}))
+            {
+                const auto response = entry.Value().GetObjectW();
+                result.responses[std::wstring{ entry.Key() }] = { std::wstring{ response.GetNamedString(L"etag", L"") },
+                                                                  std::wstring{ response.GetNamedString(L"lastModified", L"") },
+                                                                  std::wstring{ response.GetNamedString(L"body", L"") } };
+            }
+
+            const auto metrics = json->GetNamedObject(L"metrics", json::JsonObject{});
+            result.metrics.metadata_requests = get_count(metrics, L"metadataRequests");
+            result.metrics.metadata_not_modified = get_count(metrics, L"metadataNotModified");
+            result.metrics.metadata_bytes_saved = get_count(metrics, L"metadataBytesSaved");
+            result.metrics.mirror_downloads = get_count(metrics, L"mirrorDownloads");
+            result.metrics.mirror_bytes = get_count(metrics, L"mirrorBytes");
+        }
+        catch (...)
+        {
+            return {};
+        }
+
+        return result;
+    }
+
+    void update_cache::store(const std::function<void(state&)>& modifier)
+    {
+        wil::unique_mutex_nothrow mutex{ CreateMutexW(nullptr, FALSE, UPDATE_CACHE_MUTEX) };
+        auto lock = mutex.acquire();
+
+        // The mutex is recursive, read() takes it again
+        auto data = read();
+        modifier(data);
+
+        json::JsonObject responses;
+        for (const auto& [url, response] : data.responses)
+        {
+            json::JsonObject entry;
+            entry.SetNamedValue(L"etag", json::value(response.etag));
+            entry.SetNamedValue(L"lastModified", json::value(response.last_modified));
+            entry.SetNamedValue(L"body", json::value(response.body));
+            responses.SetNamedValue(url, entry);
+        }
+
+        json::JsonObject metrics;
+        metrics.SetNamedValue(L"metadataRequests", json::value(static_cast<double>(data.metrics.metadata_requests)));
+        metrics.SetNamedValue(L"metadataNotModified", json::value(static_cast<double>(data.metrics.metadata_not_modified)));
+        metrics.SetNamedValue(L"metadataBytesSaved", json::value(static_cast<double>(data.metrics.metadata_bytes_saved)));
+        metrics.SetNamedValue(L"mirrorDownloads", json::value(static_cast<double>(data.metrics.mirror_downloads)));
+        metrics.SetNamedValue(L"mirrorBytes", json::value(static_cast<double>(data.metrics.mirror_bytes)));
+
+        json::JsonObject json;
+        json.SetNamedValue(L"responses", json::value(responses));
+        json.SetNamedValue(L"metrics", json::value(metrics));
+        json::to_file(m_file.native(), json);
+    }
+
+    std::optional<std::wstring> get_update_mirror_url()
+    {
+        // Machine policy wins over the user one
+        for (HKEY root : { HKEY_LOCAL_MACHINE, HKEY_CURRENT_USER })
+        {
+            if (auto url = read_policy_string(root, UPDATE_MIRROR_VALUE))
+            {
+                while (!url->empty() && (url->back() == L'/' || url->back() == L'\\'))
+                {
+                    url->pop_back();
+                }
+
+                // The installer runs elevated, so it isn't downloaded over a connection that can be tampered with
+                if (_wcsnicmp(url->c_str(), HTTPS_SCHEME, std::size(HTTPS_SCHEME) - 1) == 0 && url->size() > std::size(HTTPS_SCHEME) - 1)
+                {
+                    return url;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+
+#include <expected.hpp>
+
+#include "chunked_download.h"
+
+namespace updating
+{
+    struct metadata_response
+    {
+        // 200 with a body, or 304 when the conditions sent with the request still hold
+        uint16_t status = 0;
+        std::wstring etag;
+        std::wstring last_modified;
+        std::wstring body;
+    };
+
+    // Release metadata as seen through the server
+    class metadata_source
+    {
+    public:
+        virtual ~metadata_source() = default;
+
+        // GET url, conditional on etag and last_modified when they aren't empty. Throws when the request fails.
+        virtual metadata_response get(const std::wstring& url, const std::wstring& etag, const std::wstring& last_modified) = 0;
+    };
+
+    struct update_cache_metrics
+    {
+        uint64_t metadata_requests = 0;
+        uint64_t metadata_not_modified = 0;
+        // Size of the metadata that didn't have to be downloaded again
+        uint64_t metadata_bytes_saved = 0;
+        uint64_t mirror_downloads = 0;
+        // Installer bytes downloaded from the mirror instead of the public URL
+        uint64_t mirror_bytes = 0;
+    };
+
+    // Release metadata kept between update checks, so they only download it again when it changed, and the
+    // counters showing how much that and the update mirror saved. Stored as JSON next to UpdateState.json,
+    // shared between the processes that check for updates.
+    class update_cache
+    {
+    public:
+        explicit update_cache(std::filesystem::path file = default_path());
+
+        static std::filesystem::path default_path();
+
+        // Body of url, from the cache when the server reports that it didn't change
+        std::wstring fetch_metadata(metadata_source& source, const std::wstring& url);
+
+        // Downloads from mirror when there's one and options has the hash to check it against, and from origin otherwise
+        nonstd::expected<download_result, std::wstring> download_installer(range_source* mirror, range_source& origin, const std::filesystem::path& destination, const download_options& options);
+
+        update_cache_metrics metrics() const;
+
+    private:
+        struct cached_response
+        {
+            std::wstring etag;
+            std::wstring last_modified;
+            std::wstring body;
+        };
+
+        struct state
+        {
+            std::map<std::wstring, cached_response> responses;
+            update_cache_metrics metrics;
+        };
+
+        state read() const;
+        // Reads, modifies and writes the file while holding the cache mutex
+        void store(const std::function<void(state&)>& modifier);
+
+        std::filesystem::path m_file;
+    };
+
+    // Base URL of the update mirror configured by policy, where installers are looked up by file name. Only https URLs are used.
+    std::optional<std::wstring> get_update_mirror_url();
+}
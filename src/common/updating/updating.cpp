@@ -1,10 +1,14 @@
 #include "pch.h"
 
-#include <common/utils/HttpClient.h>
+#include <sstream>
+
 #include <common/version/version.h>
 #include <common/version/helper.h>
 
 #include "updating.h"
+#include "chunked_download.h"
+#include "http_range_source.h"
+#include "update_cache.h"
 
 #include <common/SettingsAPI/settings_helpers.h>
 #include <common/utils/json.h>
@@ -67,6 +71,36 @@ namespace updating
         throw std::runtime_error("Release object doesn't have the required asset");
     }
 
+    // The release notes list the hash next to each installer's name, e.g. "PowerToysSetup-0.60.0-x64.exe | 6fe0...".
+    std::wstring extract_installer_sha256(const json::JsonObject& release_object, const std::wstring& installer_filename)
+    {
+        std::wstring body{ release_object.GetNamedString(L"body", {}) };
+        std::transform(begin(body), end(body), begin(body), ::towlower);
+
+        std::wstringstream lines{ body };
+        for (std::wstring line; std::getline(lines, line);)
+        {
+            if (line.find(installer_filename) == std::wstring::npos)
+            {
+                continue;
+            }
+
+            size_t start = 0;
+            while (start < line.size())
+            {
+                const auto end = std::find_if_not(line.begin() + start, line.end(), ::iswxdigit) - line.begin();
+                if (end - start == 64)
+                {
+                    return line.substr(start, 64);
+                }
+
+                start = end + 1;
+            }
+        }
+
+        return {};
+    }
+
     std::future<nonstd::expected<github_version_info, std::wstring>> get_github_version_info_async(const bool prerelease)
     {
         // If the current version starts with 0.0.*, it means we're on a local build from a farm and shouldn't check for updates.
@@ -75,16 +109,20 @@ namespace updating
             co_return nonstd::make_unexpected(LOCAL_BUILD_ERROR);
         }
 
+        // The release metadata requests are blocking
+        co_await winrt::resume_background();
+
         try
         {
-            http::HttpClient client;
+            update_cache cache;
+            http_metadata_source source;
             json::JsonObject release_object;
             const VersionHelper current_version(VERSION_MAJOR, VERSION_MINOR, VERSION_REVISION);
             VersionHelper github_version = current_version;
 
             if (prerelease)
             {
-                const auto body = co_await client.request(Uri{ ALL_RELEASES_ENDPOINT });
+                const auto body = cache.fetch_metadata(source, ALL_RELEASES_ENDPOINT);
                 for (const auto& json : json::JsonValue::Parse(body).GetArray())
                 {
                     auto potential_release_object = json.GetObjectW();
@@ -102,7 +140,7 @@ namespace updating
             }
             else
             {
-                const auto body = co_await client.request(Uri{ LATEST_RELEASE_ENDPOINT });
+                const auto body = cache.fetch_metadata(source, LATEST_RELEASE_ENDPOINT);
                 release_object = json::JsonValue::Parse(body).GetObjectW();
                 if (auto extracted_version = extract_version_from_release_object(release_object))
                 {
@@ -116,10 +154,12 @@ namespace updating
             }
 
             auto [installer_download_url, installer_filename] = extract_installer_asset_download_info(release_object);
+            auto installer_sha256 = extract_installer_sha256(release_object, installer_filename);
             co_return new_version_download_info{ extract_release_page_url(release_object),
                                                  std::move(github_version),
                                                  std::move(installer_download_url),
-                                                 std::move(installer_filename) };
+                                                 std::move(installer_filename),
+                                                 std::move(installer_sha256) };
         }
         catch (...)
         {
@@ -151,23 +191,51 @@ namespace updating
         }
 
         *installer_download_path /= new_version.installer_filename;
+        const auto download_url = new_version.installer_download_url;
+        std::optional<Uri> mirror_url;
+        if (auto mirror = get_update_mirror_url())
+        {
+            try
+            {
+                mirror_url = Uri{ *mirror + L"/" + new_version.installer_filename };
+            }
+            catch (...)
+            {
+                // Not a valid URL, only the public one is used
+            }
+        }
+
+        download_options options;
+        options.expected_sha256 = new_version.installer_sha256;
+
+        // The requests made by download_file are blocking
+        co_await winrt::resume_background();
 
-        bool download_success = false;
         for (size_t i = 0; i < MAX_DOWNLOAD_ATTEMPTS; ++i)
         {
             try
             {
-                http::HttpClient client;
-                co_await client.download(new_version.installer_download_url, *installer_download_path);
-                download_success = true;
-                break;
+                // Every attempt resumes from the chunks completed by the previous ones
+                update_cache cache;
+                http_range_source source{ download_url };
+                std::optional<http_range_source> mirror;
+                if (mirror_url)
+                {
+                    mirror.emplace(*mirror_url);
+                }
+
+                if (cache.download_installer(mirror ? &*mirror : nullptr, source, *installer_download_path, options))
+                {
+                    co_return installer_download_path;
+                }
             }
             catch (...)
             {
                 // reattempt to download or do nothing
             }
         }
-        co_return download_success ? installer_download_path : std::nullopt;
+
+        co_return std::nullopt;
     }
 
 }
@@ -22,6 +22,8 @@ namespace updating
         VersionHelper version{ 0, 0, 0 };
         Uri installer_download_url = nullptr;
         std::wstring installer_filename;
+        // Lowercase hex SHA-256 listed in the release notes, empty when they don't have one
+        std::wstring installer_sha256;
     };
     using github_version_info = std::variant<new_version_download_info, version_up_to_date>;
 
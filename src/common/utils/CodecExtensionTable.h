@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cwctype>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// File extensions that a set of image codecs can read, built from the comma separated lists codecs
+// report (".jpeg,.jpe,.jpg"). Lookups ignore case.
+class CodecExtensionTable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Selection
+    {
+        NoImages,
+        HasImages,
+        // The deadline passed before an image was found
+        Pending,
+    };
+
+    CodecExtensionTable() = default;
+
+    explicit CodecExtensionTable(const std::vector<std::wstring>& extensionLists)
+    {
+        for (const auto& extensions : extensionLists)
+        {
+            AddExtensions(extensions);
+        }
+    }
+
+    void AddExtensions(std::wstring_view extensions)
+    {
+        while (!extensions.empty())
+        {
+            const auto comma = extensions.find(L',');
+            auto extension = extensions.substr(0, comma);
+            extensions.remove_prefix(comma == std::wstring_view::npos ? extensions.size() : comma + 1);
+
+            while (!extension.empty() && std::iswspace(extension.front()))
+            {
+                extension.remove_prefix(1);
+            }
+
+            while (!extension.empty() && std::iswspace(extension.back()))
+            {
+                extension.remove_suffix(1);
+            }
+
+            if (extension.size() > 1 && extension.front() == L'.')
+            {
+                m_extensions.insert(Lowercase(extension));
+            }
+        }
+    }
+
+    bool empty() const noexcept { return m_extensions.empty(); }
+    size_t size() const noexcept { return m_extensions.size(); }
+
+    // Whether the extension of the file at path is known, path can also be just the extension
+    bool CanDecode(std::wstring_view path) const
+    {
+        const auto dot = path.find_last_of(L"./\\");
+        if (dot == std::wstring_view::npos || path[dot] != L'.')
+        {
+            return false;
+        }
+
+        return m_extensions.contains(Lowercase(path.substr(dot)));
+    }
+
+    // Looks at the paths returned by next until one can be decoded or next returns nullopt.
+    // Gives up with Pending once now() is past the deadline.
+    template<typename NextPath, typename Now = decltype(&Clock::now)>
+    Selection FindImage(NextPath&& next, Clock::time_point deadline = Clock::time_point::max(), Now&& now = &Clock::now) const
+    {
+        while (auto path = next())
+        {
+            if (CanDecode(*path))
+            {
+                return Selection::HasImages;
+            }
+
+            if (now() > deadline)
+            {
+                return Selection::Pending;
+            }
+        }
+
+        return Selection::NoImages;
+    }
+
+private:
+    static std::wstring Lowercase(std::wstring_view text)
+    {
+        std::wstring result{ text };
+        for (auto& c : result)
+        {
+            c = static_cast<wchar_t>(std::towlower(c));
+        }
+
+        return result;
+    }
+
+    std::unordered_set<std::wstring> m_extensions;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+// Coalesces a stream of change notifications into at most one update per display refresh.
+// The clock is passed in by the caller, so the update rate doesn't depend on the thread the events arrive on.
+class FrameCoalescer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameCoalescer(Clock::duration refreshPeriod = std::chrono::microseconds(16667), Clock::time_point vblank = {}) noexcept :
+        m_refreshPeriod(refreshPeriod),
+        m_vblank(vblank)
+    {
+    }
+
+    // Updates the refresh period and the time of any past or future vblank
+    void SetTiming(Clock::duration refreshPeriod, Clock::time_point vblank) noexcept
+    {
+        if (refreshPeriod > Clock::duration::zero())
+        {
+            m_refreshPeriod = refreshPeriod;
+            m_vblank = vblank;
+        }
+    }
+
+    // Records a change. Returns the delay after which Flush should be called, or nullopt if a flush is already scheduled.
+    std::optional<Clock::duration> Request(Clock::time_point now) noexcept
+    {
+        m_pending = true;
+        return Schedule(now);
+    }
+
+    // Returns the delay until the next vblank if a change is pending and no flush is scheduled
+    std::optional<Clock::duration> Schedule(Clock::time_point now) noexcept
+    {
+        if (!m_pending || m_scheduled)
+        {
+            return std::nullopt;
+        }
+
+        m_scheduled = true;
+        return m_vblank + (FrameIndex(now) + 1) * m_refreshPeriod - now;
+    }
+
+    // Returns true if the pending change has to be applied now.
+    // Returns false if nothing changed or an update was already applied in the current frame, call Schedule in that case.
+    bool Flush(Clock::time_point now) noexcept
+    {
+        m_scheduled = false;
+        if (!m_pending)
+        {
+            return false;
+        }
+
+        const auto frame = FrameIndex(now);
+        if (m_lastFrame.has_value() && frame <= *m_lastFrame)
+        {
+            return false;
+        }
+
+        m_pending = false;
+        m_lastFrame = frame;
+        return true;
+    }
+
+    bool Pending() const noexcept
+    {
+        return m_pending;
+    }
+
+private:
+    Clock::duration m_refreshPeriod;
+    Clock::time_point m_vblank;
+    std::optional<long long> m_lastFrame;
+    bool m_pending = false;
+    bool m_scheduled = false;
+
+    long long FrameIndex(Clock::time_point now) const noexcept
+    {
+        const auto elapsed = now - m_vblank;
+        auto frame = elapsed / m_refreshPeriod;
+        if (elapsed < Clock::duration::zero() && elapsed % m_refreshPeriod != Clock::duration::zero())
+        {
+            --frame;
+        }
+
+        return frame;
+    }
+};
@@ -9,4 +9,6 @@ struct ShortcutGuideSettings
     std::wstring disabledApps = L"";
     bool shouldReactToPressedWinKey = false;
     int windowsKeyPressTime = 900;
+    bool keepResident = false;
+    int residentMemoryBudget = 64;
 };
@@ -13,8 +13,13 @@
 #include "ShortcutGuideConstants.h"
 #include "trace.h" 
 
+#include <sstream>
+
 const std::wstring instanceMutexName = L"Local\\PowerToys_ShortcutGuide_InstanceMutex";
 
+// Posted to the main thread of the resident process when the trigger event is signaled
+constexpr UINT WM_TOGGLE_OVERLAY = WM_APP + 1;
+
 // set current path to the executable path
 bool SetCurrentPath() 
 {
@@ -42,6 +47,91 @@ bool SetCurrentPath()
     return true;
 }
 
+void PumpMessages()
+{
+    MSG msg{};
+    while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+    {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+}
+
+// Keeps the overlay loaded while it's hidden and shows it whenever the module signals the trigger event
+void RunResident()
+{
+    auto window = OverlayWindow(nullptr, true);
+    window.Preload();
+
+    auto mainThreadId = GetCurrentThreadId();
+    EventWaiter triggerEventWaiter(CommonSharedConstants::SHORTCUT_GUIDE_TRIGGER_EVENT, [mainThreadId](int err) {
+        if (err != ERROR_SUCCESS)
+        {
+            Logger::error(L"Failed to wait for {} event. {}", CommonSharedConstants::SHORTCUT_GUIDE_TRIGGER_EVENT, get_last_error_or_default(err));
+            return;
+        }
+
+        PostThreadMessage(mainThreadId, WM_TOGGLE_OVERLAY, 0, 0);
+    });
+
+    EventWaiter exitEventWaiter(CommonSharedConstants::SHORTCUT_GUIDE_EXIT_EVENT, [mainThreadId](int err) {
+        if (err != ERROR_SUCCESS)
+        {
+            Logger::error(L"Failed to wait for {} event. {}", CommonSharedConstants::SHORTCUT_GUIDE_EXIT_EVENT, get_last_error_or_default(err));
+        }
+        else
+        {
+            Logger::trace(L"{} event was signaled", CommonSharedConstants::SHORTCUT_GUIDE_EXIT_EVENT);
+        }
+
+        PostThreadMessage(mainThreadId, WM_QUIT, 0, 0);
+    });
+
+    MSG msg{};
+    while (GetMessageW(&msg, nullptr, 0, 0))
+    {
+        if (msg.hwnd == nullptr && msg.message == WM_TOGGLE_OVERLAY)
+        {
+            window.Toggle(GetForegroundWindow());
+            continue;
+        }
+
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+}
+
+// Compares how long the overlay takes to show when it's created on demand and when it's kept resident.
+// Process creation isn't included in the cold start time.
+void RunStartupBenchmark()
+{
+    constexpr int iterations = 10;
+    std::chrono::duration<double, std::milli> cold{}, resident{};
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto window = OverlayWindow(nullptr, true);
+        window.Toggle(GetForegroundWindow());
+        cold += std::chrono::steady_clock::now() - start;
+        PumpMessages();
+        window.Toggle(nullptr);
+    }
+
+    auto window = OverlayWindow(nullptr, true);
+    window.Preload();
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        window.Toggle(GetForegroundWindow());
+        resident += std::chrono::steady_clock::now() - start;
+        PumpMessages();
+        window.Toggle(nullptr);
+    }
+
+    Logger::info(L"Startup benchmark: cold start {:.1f} ms, resident {:.1f} ms", cold.count() / iterations, resident.count() / iterations);
+}
+
 int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ PWSTR lpCmdLine, _In_ int nCmdShow)
 {
     winrt::init_apartment();
@@ -54,8 +144,14 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return false;
     }
 
+    // Arguments are the runner pid followed by an optional mode
+    std::wstring pid;
+    std::wstring mode;
+    std::wistringstream args(lpCmdLine);
+    args >> pid >> mode;
+
     Trace::RegisterProvider();
-    if (std::wstring(lpCmdLine).find(L' ') != std::wstring::npos)
+    if (mode == L"telemetry")
     {
         Logger::trace("Sending settings telemetry");
         auto settings = OverlayWindow::GetSettings();
@@ -77,7 +173,6 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
-    std::wstring pid = std::wstring(lpCmdLine);
     if (!pid.empty())
     {
         auto mainThreadId = GetCurrentThreadId();
@@ -96,6 +191,21 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         });
     }
 
+    if (mode == L"resident")
+    {
+        Logger::trace("Starting resident Shortcut Guide");
+        RunResident();
+        Trace::UnregisterProvider();
+        return 0;
+    }
+
+    if (mode == L"benchmark")
+    {
+        RunStartupBenchmark();
+        Trace::UnregisterProvider();
+        return 0;
+    }
+
     auto hwnd = GetForegroundWindow();
     auto window = OverlayWindow(hwnd);
     EventWaiter exitEventWaiter;
@@ -295,9 +295,18 @@ D2DOverlayWindow::D2DOverlayWindow() :
 
 void D2DOverlayWindow::show(HWND active_window, bool snappable)
 {
+    // Check if taskbar is auto-hidden. If so, don't display the number arrows
+    APPBARDATA param = {};
+    param.cbSize = sizeof(APPBARDATA);
+    const bool taskbar_auto_hidden = (UINT)SHAppBarMessage(ABM_GETSTATE, &param) == ABS_AUTOHIDE;
+
     std::unique_lock lock(mutex);
     hidden = false;
-    tasklist_buttons.clear();
+    // Buttons found while the overlay was last shown are used until the tasklist thread refreshes them
+    if (taskbar_auto_hidden)
+    {
+        tasklist_buttons.clear();
+    }
     this->active_window = active_window;
     this->active_window_snappable = snappable;
     auto old_bck = colors.start_color_menu;
@@ -360,10 +369,7 @@ void D2DOverlayWindow::show(HWND active_window, bool snappable)
     shown_start_time = std::chrono::steady_clock::now();
     lock.unlock();
     D2DWindow::show(primary_screen.left(), primary_screen.top(), primary_screen.width(), primary_screen.height());
-    // Check if taskbar is auto-hidden. If so, don't display the number arrows
-    APPBARDATA param = {};
-    param.cbSize = sizeof(APPBARDATA);
-    if ((UINT)SHAppBarMessage(ABM_GETSTATE, &param) != ABS_AUTOHIDE)
+    if (!taskbar_auto_hidden)
     {
         tasklist_cv_mutex.lock();
         tasklist_update = true;
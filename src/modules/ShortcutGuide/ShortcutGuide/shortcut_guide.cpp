@@ -178,22 +178,24 @@ namespace
     }
 }
 
-OverlayWindow::OverlayWindow(HWND activeWindow)
+OverlayWindow::OverlayWindow(HWND activeWindow, bool resident)
 {
     instance = this;
     this -> activeWindow = activeWindow;
+    this->resident = resident;
     app_name = GET_RESOURCE_STRING(IDS_SHORTCUT_GUIDE);
 
     Logger::info("Overlay Window is creating");
     init_settings();
-    keyboardHook = SetWindowsHookEx(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(NULL), NULL);
-    if (!keyboardHook)
+
+    // The resident process only needs the hook while the overlay is visible
+    if (!resident)
     {
-        Logger::warn(L"Failed to create low level keyboard hook. {}", get_last_error_or_default(GetLastError()));
+        install_keyboard_hook();
     }
 }
 
-void OverlayWindow::ShowWindow()
+bool OverlayWindow::Preload()
 {
     winkey_popup = std::make_unique<D2DOverlayWindow>();
     winkey_popup->apply_overlay_opacity(((float)overlayOpacity.value) / 100.0f);
@@ -206,12 +208,104 @@ void OverlayWindow::ShowWindow()
     catch (...)
     {
         Logger::critical("Winkey popup failed to initialize");
+        return false;
+    }
+
+    return true;
+}
+
+void OverlayWindow::ShowWindow()
+{
+    if (!Preload())
+    {
         return;
     }
 
     target_state->toggle_force_shown();
 }
 
+void OverlayWindow::Toggle(HWND activeWindow)
+{
+    if (target_state && overlay_visible())
+    {
+        CloseWindow(HideWindowType::THE_SHORTCUT_PRESSED);
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    this->activeWindow = activeWindow;
+
+    // The settings could have been changed while the overlay was hidden
+    init_settings();
+    if (IsDisabled())
+    {
+        Logger::trace("SG is disabled for the current foreground app");
+        return;
+    }
+
+    // The overlay is released when the memory budget is exceeded
+    if (!winkey_popup && !Preload())
+    {
+        target_state.reset();
+        winkey_popup.reset();
+        return;
+    }
+
+    winkey_popup->apply_overlay_opacity(((float)overlayOpacity.value) / 100.0f);
+    winkey_popup->set_theme(theme.value);
+    install_keyboard_hook();
+    target_state->toggle_force_shown();
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    Logger::trace(L"Overlay was shown in {:.1f} ms", elapsed.count());
+}
+
+void OverlayWindow::install_keyboard_hook()
+{
+    if (keyboardHook)
+    {
+        return;
+    }
+
+    wasWinPressed = false;
+    keyboardHook = SetWindowsHookEx(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(NULL), NULL);
+    if (!keyboardHook)
+    {
+        Logger::warn(L"Failed to create low level keyboard hook. {}", get_last_error_or_default(GetLastError()));
+    }
+}
+
+void OverlayWindow::remove_keyboard_hook()
+{
+    if (keyboardHook)
+    {
+        UnhookWindowsHookEx(keyboardHook);
+        keyboardHook = nullptr;
+    }
+}
+
+void OverlayWindow::release_if_over_memory_budget()
+{
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+    {
+        return;
+    }
+
+    const SIZE_T budget = static_cast<SIZE_T>(residentMemoryBudget.value) * 1024 * 1024;
+    if (counters.PrivateUsage <= budget)
+    {
+        return;
+    }
+
+    Logger::info(L"Private memory usage of {} MB exceeds the budget of {} MB. Releasing the overlay", counters.PrivateUsage / (1024 * 1024), residentMemoryBudget.value);
+    target_state->exit();
+    target_state.reset();
+    winkey_popup.reset();
+    SetProcessWorkingSetSize(GetCurrentProcess(), static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1));
+}
+
 void OverlayWindow::CloseWindow(HideWindowType type, int mainThreadId)
 {
     if (mainThreadId == 0)
@@ -219,7 +313,7 @@ void OverlayWindow::CloseWindow(HideWindowType type, int mainThreadId)
         mainThreadId = GetCurrentThreadId();
     }
 
-    if (this->winkey_popup)
+    if (this->winkey_popup && (!resident || overlay_visible()))
     {
         if (shouldReactToPressedWinKey.value)
         {
@@ -231,6 +325,16 @@ void OverlayWindow::CloseWindow(HideWindowType type, int mainThreadId)
             SendInput(1, dummyEvent, sizeof(INPUT));
         }
         this->winkey_popup->SetWindowCloseType(ToWstring(type));
+        if (resident)
+        {
+            Logger::trace(L"Hiding the overlay");
+            winkey_popup->hide();
+            target_state->toggle_force_shown();
+            remove_keyboard_hook();
+            release_if_over_memory_budget();
+            return;
+        }
+
         Logger::trace(L"Terminating process");
         PostThreadMessage(mainThreadId, WM_QUIT, 0, 0);
     }
@@ -270,11 +374,8 @@ OverlayWindow::~OverlayWindow()
     {
         winkey_popup.reset();
     }
-    
-    if (keyboardHook)
-    {
-        UnhookWindowsHookEx(keyboardHook);
-    }
+
+    remove_keyboard_hook();
 }
 
 void OverlayWindow::on_held()
@@ -310,6 +411,7 @@ void OverlayWindow::init_settings()
     theme.value = settings.theme;
     disabledApps.value = settings.disabledApps;
     shouldReactToPressedWinKey.value = settings.shouldReactToPressedWinKey;
+    residentMemoryBudget.value = settings.residentMemoryBudget;
     update_disabled_apps();
 }
 
@@ -441,5 +543,21 @@ ShortcutGuideSettings OverlayWindow::GetSettings() noexcept
     {
     }
 
+    try
+    {
+        settings.keepResident = properties.GetNamedObject(KeepResident::name).GetNamedBoolean(L"value");
+    }
+    catch (...)
+    {
+    }
+
+    try
+    {
+        settings.residentMemoryBudget = (int)properties.GetNamedObject(ResidentMemoryBudget::name).GetNamedNumber(L"value");
+    }
+    catch (...)
+    {
+    }
+
     return settings;
 }
@@ -24,8 +24,15 @@ enum class HideWindowType
 class OverlayWindow
 {
 public:
-    OverlayWindow(HWND activeWindow);
+    OverlayWindow(HWND activeWindow, bool resident = false);
     void ShowWindow();
+
+    // Creates the overlay and loads its resources without showing it
+    bool Preload();
+
+    // Used by the resident process: shows the overlay for the given window, or hides it if it's visible
+    void Toggle(HWND activeWindow);
+
     void CloseWindow(HideWindowType type, int mainThreadId = 0);
     bool IsDisabled();
 
@@ -50,8 +57,14 @@ private:
     std::vector<std::wstring> disabled_apps_array;
     void init_settings();
     void update_disabled_apps();
+    void install_keyboard_hook();
+    void remove_keyboard_hook();
+    void release_if_over_memory_budget();
     HWND activeWindow;
-    HHOOK keyboardHook;
+    HHOOK keyboardHook = nullptr;
+
+    // The resident process hides the overlay instead of exiting and reuses it
+    bool resident = false;
 
     struct OverlayOpacity
     {
@@ -89,6 +102,18 @@ private:
         static inline PCWSTR name = L"press_time";
     } windowsKeyPressTime;
 
+    struct KeepResident
+    {
+        static inline PCWSTR name = L"keep_resident";
+    } keepResident;
+
+    struct ResidentMemoryBudget
+    {
+        static inline PCWSTR name = L"resident_memory_budget";
+        // In megabytes
+        int value;
+    } residentMemoryBudget;
+
     struct OpenShortcut
     {
         static inline PCWSTR name = L"open_shortcutguide";
@@ -16,6 +16,8 @@ void Tasklist::update()
     tasklist_hwnd = FindWindowExA(tasklist_hwnd, 0, "MSTaskListWClass", nullptr);
     if (!tasklist_hwnd)
         return;
+    if (element && tasklist_hwnd == this->tasklist_hwnd)
+        return;
     if (!automation)
     {
         winrt::check_hresult(CoCreateInstance(CLSID_CUIAutomation,
@@ -26,7 +28,9 @@ void Tasklist::update()
         winrt::check_hresult(automation->CreateTrueCondition(true_condition.put()));
     }
     element = nullptr;
+    this->tasklist_hwnd = nullptr;
     winrt::check_hresult(automation->ElementFromHandle(tasklist_hwnd, element.put()));
+    this->tasklist_hwnd = tasklist_hwnd;
 }
 
 bool Tasklist::update_buttons(std::vector<TasklistButton>& buttons)
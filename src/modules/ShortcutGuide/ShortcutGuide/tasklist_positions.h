@@ -22,4 +22,6 @@ private:
     winrt::com_ptr<IUIAutomation> automation;
     winrt::com_ptr<IUIAutomationElement> element;
     winrt::com_ptr<IUIAutomationCondition> true_condition;
+    // The element is kept while the taskbar window stays the same
+    HWND tasklist_hwnd = nullptr;
 };
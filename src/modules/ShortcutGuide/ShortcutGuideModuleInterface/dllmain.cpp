@@ -35,6 +35,12 @@ public:
             Logger::warn(L"Failed to create {} event. {}", CommonSharedConstants::SHORTCUT_GUIDE_EXIT_EVENT, get_last_error_or_default(GetLastError()));
         }
 
+        triggerEvent = CreateEvent(nullptr, false, false, CommonSharedConstants::SHORTCUT_GUIDE_TRIGGER_EVENT);
+        if (!triggerEvent)
+        {
+            Logger::warn(L"Failed to create {} event. {}", CommonSharedConstants::SHORTCUT_GUIDE_TRIGGER_EVENT, get_last_error_or_default(GetLastError()));
+        }
+
         InitSettings();
     }
 
@@ -65,6 +71,7 @@ public:
                 PowerToysSettings::PowerToyValues::from_json_string(config, get_key());
 
             ParseSettings(values);
+            UpdateResidentProcess();
         }
         catch (std::exception ex)
         {
@@ -79,6 +86,7 @@ public:
         if (!_enabled)
         {
             _enabled = true;
+            UpdateResidentProcess();
         }
         else
         {
@@ -113,6 +121,11 @@ public:
             CloseHandle(exitEvent);
         }
 
+        if (triggerEvent)
+        {
+            CloseHandle(triggerEvent);
+        }
+
         delete this;
     }
 
@@ -134,6 +147,22 @@ public:
             return;
         }
 
+        if (m_keepResident && triggerEvent)
+        {
+            if (!IsProcessActive() || !m_processIsResident)
+            {
+                if (!StopProcess() || !StartResidentProcess())
+                {
+                    return;
+                }
+            }
+
+            // The resident process shows the overlay, or hides it if it's visible. It needs the right to take the foreground.
+            AllowSetForegroundWindow(GetProcessId(m_hProcess));
+            SetEvent(triggerEvent);
+            return;
+        }
+
         if (IsProcessActive())
         {
             TerminateProcess();
@@ -174,20 +203,64 @@ private:
     std::wstring app_key;
     bool _enabled = false;
     HANDLE m_hProcess = nullptr;
+
+    // If the process should stay alive with the overlay loaded while it's hidden
+    bool m_keepResident = false;
+    bool m_processIsResident = false;
     
     // Hotkey to invoke the module
     HotkeyEx m_hotkey;
 
     // If the module should be activated through the legacy pressing windows key behavior.
     const UINT DEFAULT_MILLISECONDS_WIN_KEY_SHOULD_BE_PRESSED = 900;
+    // How long an overlay process is given to close before a resident one replaces it
+    const DWORD PROCESS_EXIT_TIMEOUT_MS = 1000;
     bool m_shouldReactToPressedWinKey = false;
     UINT m_millisecondsWinKeyShouldBePressed = DEFAULT_MILLISECONDS_WIN_KEY_SHOULD_BE_PRESSED;
 
     HANDLE exitEvent;
+    HANDLE triggerEvent;
+
+    bool StartResidentProcess()
+    {
+        if (m_hProcess)
+        {
+            CloseHandle(m_hProcess);
+            m_hProcess = nullptr;
+        }
+
+        // A toggle left for a resident process that exited before taking it mustn't reach the new one
+        if (triggerEvent)
+        {
+            ResetEvent(triggerEvent);
+        }
+
+        m_processIsResident = StartProcess(L"resident");
+        return m_processIsResident;
+    }
+
+    // Starts or stops the resident process after it was turned on or off
+    void UpdateResidentProcess()
+    {
+        if (!_enabled)
+        {
+            return;
+        }
+
+        if (m_keepResident && !IsProcessActive())
+        {
+            StartResidentProcess();
+        }
+        else if (!m_keepResident && m_processIsResident && IsProcessActive())
+        {
+            TerminateProcess();
+        }
+    }
 
     bool StartProcess(std::wstring args = L"")
     {
-        if (exitEvent)
+        // Cleared only once the previous process is gone, so it can't miss the signal to exit
+        if (exitEvent && !IsProcessActive())
         {
             ResetEvent(exitEvent);
         }
@@ -219,7 +292,15 @@ private:
         }
 
         Logger::trace(L"Started SG process with pid={}", GetProcessId(sei.hProcess));
+        if (args == L"telemetry")
+        {
+            // The telemetry process exits on its own and mustn't replace the tracked overlay process
+            CloseHandle(sei.hProcess);
+            return true;
+        }
+
         m_hProcess = sei.hProcess;
+        m_processIsResident = false;
         return true;    
     }
 
@@ -247,6 +328,26 @@ private:
         }
     }
 
+    // Signals the process to exit and waits for it, so the next one doesn't find its instance mutex
+    bool StopProcess()
+    {
+        TerminateProcess();
+        if (m_hProcess && WaitForSingleObject(m_hProcess, PROCESS_EXIT_TIMEOUT_MS) != WAIT_OBJECT_0)
+        {
+            Logger::warn("SG process didn't exit in time");
+            return false;
+        }
+
+        if (m_hProcess)
+        {
+            CloseHandle(m_hProcess);
+            m_hProcess = nullptr;
+        }
+
+        m_processIsResident = false;
+        return true;
+    }
+
     bool IsProcessActive()
     {
         return m_hProcess && WaitForSingleObject(m_hProcess, 0) != WAIT_OBJECT_0;
@@ -312,6 +413,15 @@ private:
                 Logger::warn("Failed to initialize Shortcut Guide start shortcut");
             }
             try
+            {
+                auto jsonKeepResidentObject = settingsObject.GetNamedObject(L"properties").GetNamedObject(L"keep_resident");
+                m_keepResident = (bool)jsonKeepResidentObject.GetNamedBoolean(L"value");
+            }
+            catch (...)
+            {
+                m_keepResident = false;
+            }
+            try
             {
                 // Parse Legacy windows key press behavior settings
                 auto jsonUseLegacyWinKeyBehaviorObject = settingsObject.GetNamedObject(L"properties").GetNamedObject(L"use_legacy_press_win_key_behavior");
@@ -16,6 +16,13 @@ namespace NonLocalizable
     const static wchar_t* WINDOW_IS_PINNED_PROP = L"AlwaysOnTop_Pinned";
 }
 
+namespace
+{
+    // Closed windows are normally removed on EVENT_OBJECT_DESTROY, the sweep catches the ones that don't send it
+    constexpr UINT_PTR CLOSED_WINDOWS_SWEEP_TIMER_ID = 1;
+    constexpr UINT CLOSED_WINDOWS_SWEEP_INTERVAL = 5000;
+}
+
 bool isExcluded(HWND window)
 {
     auto processPath = get_process_path(window);
@@ -40,6 +47,7 @@ AlwaysOnTop::AlwaysOnTop() :
         RegisterHotkey();
         SubscribeToEvents();
         StartTrackingTopmostWindows();
+        SetTimer(m_window, CLOSED_WINDOWS_SWEEP_TIMER_ID, CLOSED_WINDOWS_SWEEP_INTERVAL, nullptr);
     }
     else
     {
@@ -69,6 +77,7 @@ bool AlwaysOnTop::InitMainWindow()
         return false;
     }
 
+    m_desktopWindow = GetDesktopWindow();
     return true;
 }
 
@@ -116,7 +125,7 @@ void AlwaysOnTop::SettingsUpdate(SettingId id)
 
         for (const auto window: toErase)
         {
-            m_topmostWindows.erase(window);
+            StopTrackingWindow(window);
         }
     }
     break;
@@ -138,6 +147,10 @@ LRESULT AlwaysOnTop::WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lp
     {
         AlwaysOnTopSettings::instance().LoadSettings();
     }
+    else if (message == WM_TIMER && wparam == CLOSED_WINDOWS_SWEEP_TIMER_ID)
+    {
+        RemoveClosedWindows();
+    }
     
     return 0;
 }
@@ -161,11 +174,7 @@ void AlwaysOnTop::ProcessCommand(HWND window)
     {
         if (UnpinTopmostWindow(window))
         {
-            auto iter = m_topmostWindows.find(window);
-            if (iter != m_topmostWindows.end())
-            {
-                m_topmostWindows.erase(iter);
-            }
+            StopTrackingWindow(window);
         }
     }
     else
@@ -222,6 +231,7 @@ void AlwaysOnTop::StartTrackingTopmostWindows()
 
 bool AlwaysOnTop::AssignBorder(HWND window)
 {
+    const bool tracked = IsTracked(window);
     if (m_virtualDesktopUtils.IsWindowOnCurrentDesktop(window) && AlwaysOnTopSettings::settings().enableFrame)
     {
         auto border = WindowBorder::Create(window, m_hinstance);
@@ -234,6 +244,11 @@ bool AlwaysOnTop::AssignBorder(HWND window)
     {
         m_topmostWindows[window] = nullptr;
     }
+
+    if (!tracked)
+    {
+        SubscribeToWindowEvents(window);
+    }
     
     return true;
 }
@@ -246,12 +261,8 @@ void AlwaysOnTop::RegisterHotkey() const
 
 void AlwaysOnTop::SubscribeToEvents()
 {
-    // subscribe to windows events
-    std::array<DWORD, 5> events_to_subscribe = {
-        EVENT_OBJECT_LOCATIONCHANGE,
-        EVENT_SYSTEM_MINIMIZESTART,
-        EVENT_SYSTEM_MINIMIZEEND,
-        EVENT_SYSTEM_MOVESIZEEND,
+    // subscribe to windows events, the events of pinned windows are subscribed per process in SubscribeToWindowEvents
+    std::array<DWORD, 1> events_to_subscribe = {
         EVENT_OBJECT_NAMECHANGE
     };
 
@@ -269,6 +280,96 @@ void AlwaysOnTop::SubscribeToEvents()
     }
 }
 
+void AlwaysOnTop::SubscribeToWindowEvents(HWND window)
+{
+    DWORD processId = 0;
+    GetWindowThreadProcessId(window, &processId);
+    if (processId == 0)
+    {
+        Logger::error(L"Failed to get the process of the pinned window, {}", get_last_error_or_default(GetLastError()));
+        return;
+    }
+
+    m_windowProcesses[window] = processId;
+    auto& process = m_processHooks[processId];
+    if (process.windowCount++ > 0)
+    {
+        return;
+    }
+
+    // Location changes fire for every object in the system, so only the processes owning pinned windows are hooked
+    std::array<std::pair<DWORD, DWORD>, 4> event_ranges_to_subscribe = { {
+        { EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE },
+        { EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE },
+        { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND },
+        { EVENT_SYSTEM_MOVESIZEEND, EVENT_SYSTEM_MOVESIZEEND },
+    } };
+
+    for (const auto& [eventMin, eventMax] : event_ranges_to_subscribe)
+    {
+        auto hook = SetWinEventHook(eventMin, eventMax, nullptr, WinHookProc, processId, 0, WINEVENT_OUTOFCONTEXT);
+        if (hook)
+        {
+            process.hooks.emplace_back(hook);
+        }
+        else
+        {
+            Logger::error(L"Failed to set win event hook for process {}", processId);
+        }
+    }
+}
+
+void AlwaysOnTop::UnsubscribeFromWindowEvents(HWND window)
+{
+    auto windowIter = m_windowProcesses.find(window);
+    if (windowIter == m_windowProcesses.end())
+    {
+        return;
+    }
+
+    auto processIter = m_processHooks.find(windowIter->second);
+    m_windowProcesses.erase(windowIter);
+    if (processIter != m_processHooks.end() && --processIter->second.windowCount == 0)
+    {
+        for (const auto hook : processIter->second.hooks)
+        {
+            UnhookWinEvent(hook);
+        }
+
+        m_processHooks.erase(processIter);
+    }
+}
+
+void AlwaysOnTop::StopTrackingWindow(HWND window)
+{
+    UnsubscribeFromWindowEvents(window);
+    m_topmostWindows.erase(window);
+}
+
+void AlwaysOnTop::RemoveClosedWindows()
+{
+    // fix for the https://github.com/microsoft/PowerToys/issues/15300
+    // windows hidden instead of closed are unpinned as well
+    std::vector<HWND> toErase{};
+    for (const auto& [window, border] : m_topmostWindows)
+    {
+        if (!IsWindowVisible(window))
+        {
+            toErase.push_back(window);
+        }
+    }
+
+    for (const auto window : toErase)
+    {
+        if (IsWindow(window))
+        {
+            UnpinTopmostWindow(window);
+        }
+
+        StopTrackingWindow(window);
+    }
+}
+
 void AlwaysOnTop::UnpinAll()
 {
     for (const auto& [topWindow, border] : m_topmostWindows)
@@ -280,13 +381,33 @@ void AlwaysOnTop::UnpinAll()
     }
 
     m_topmostWindows.clear();
+
+    for (const auto& [processId, process] : m_processHooks)
+    {
+        for (const auto hook : process.hooks)
+        {
+            UnhookWinEvent(hook);
+        }
+    }
+
+    m_processHooks.clear();
+    m_windowProcesses.clear();
 }
 
 void AlwaysOnTop::CleanUp()
 {
     UnpinAll();
+    for (const auto hook : m_staticWinEventHooks)
+    {
+        UnhookWinEvent(hook);
+    }
+
+    m_staticWinEventHooks.clear();
+    Logger::info(L"Window events processed: {}, dropped: {}", m_processedEvents, m_droppedEvents);
+
     if (m_window)
     {
+        KillTimer(m_window, CLOSED_WINDOWS_SWEEP_TIMER_ID);
         DestroyWindow(m_window);
         m_window = nullptr;
     }
@@ -340,29 +461,49 @@ bool AlwaysOnTop::IsTracked(HWND window) const noexcept
     return (iter != m_topmostWindows.end());
 }
 
+bool AlwaysOnTop::IsRelevant(const WinHookEvent* data) const noexcept
+{
+    if (!data->hwnd)
+    {
+        return false;
+    }
+
+    if (data->event == EVENT_OBJECT_NAMECHANGE)
+    {
+        return data->hwnd == m_desktopWindow;
+    }
+
+    // Events of the window's child objects (caret, cursor, scroll bars) carry the window handle too
+    return data->idObject == OBJID_WINDOW && data->idChild == CHILDID_SELF && IsTracked(data->hwnd);
+}
+
 void AlwaysOnTop::HandleWinHookEvent(WinHookEvent* data) noexcept
 {
-    if (!AlwaysOnTopSettings::settings().enableFrame || !data->hwnd)
+    if (!IsRelevant(data))
+    {
+        m_droppedEvents++;
+        return;
+    }
+
+    m_processedEvents++;
+
+    if (data->event == EVENT_OBJECT_DESTROY)
     {
+        StopTrackingWindow(data->hwnd);
         return;
     }
 
     // fix for the https://github.com/microsoft/PowerToys/issues/15300
-    // check if the window was closed, since for some EVENT_OBJECT_DESTROY doesn't work 
-    std::vector<HWND> toErase{};
-    for (const auto& [window, border] : m_topmostWindows)
+    if (data->event == EVENT_OBJECT_HIDE)
     {
-        bool visible = IsWindowVisible(window);
-        if (!visible)
-        {
-            UnpinTopmostWindow(window);
-            toErase.push_back(window);
-        }
+        UnpinTopmostWindow(data->hwnd);
+        StopTrackingWindow(data->hwnd);
+        return;
     }
 
-    for (const auto window : toErase)
+    if (!AlwaysOnTopSettings::settings().enableFrame)
     {
-        m_topmostWindows.erase(window);
+        return;
     }
 
     switch (data->event)
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include <unordered_map>
 
 #include <Settings.h>
 #include <SettingsObserver.h>
@@ -39,21 +39,39 @@ private:
         Pin = 1,
     };
 
+    // Hooks installed for the processes owning pinned windows, shared by all their pinned windows.
+    struct ProcessHooks
+    {
+        std::vector<HWINEVENTHOOK> hooks{};
+        size_t windowCount = 0;
+    };
+
     static inline AlwaysOnTop* s_instance = nullptr;
     std::vector<HWINEVENTHOOK> m_staticWinEventHooks{};
+    std::unordered_map<DWORD, ProcessHooks> m_processHooks{};
+    std::unordered_map<HWND, DWORD> m_windowProcesses{};
     Sound m_sound;
     VirtualDesktopUtils m_virtualDesktopUtils;
 
     HWND m_window{ nullptr };
+    HWND m_desktopWindow{ nullptr };
     HINSTANCE m_hinstance;
-    std::map<HWND, std::unique_ptr<WindowBorder>> m_topmostWindows{};
+    std::unordered_map<HWND, std::unique_ptr<WindowBorder>> m_topmostWindows{};
+
+    uint64_t m_processedEvents = 0;
+    uint64_t m_droppedEvents = 0;
 
     LRESULT WndProc(HWND, UINT, WPARAM, LPARAM) noexcept;
     void HandleWinHookEvent(WinHookEvent* data) noexcept;
+    bool IsRelevant(const WinHookEvent* data) const noexcept;
     
     bool InitMainWindow();
     void RegisterHotkey() const;
     void SubscribeToEvents();
+    void SubscribeToWindowEvents(HWND window);
+    void UnsubscribeFromWindowEvents(HWND window);
+    void StopTrackingWindow(HWND window);
+    void RemoveClosedWindows();
 
     void ProcessCommand(HWND window);
     void StartTrackingTopmostWindows();
@@ -50,8 +50,10 @@ bool FrameDrawer::CreateRenderTargets(const RECT& clientRect)
     }
 
     m_renderTarget = nullptr;
+    m_borderBrush = nullptr;
 
-    const auto hwndRenderTargetProperties = D2D1::HwndRenderTargetProperties(m_window, renderTargetSize, D2D1_PRESENT_OPTIONS_NONE);
+    // Updates are already paced to the display refresh by WindowBorder, waiting for the vblank again would block the event thread
+    const auto hwndRenderTargetProperties = D2D1::HwndRenderTargetProperties(m_window, renderTargetSize, D2D1_PRESENT_OPTIONS_IMMEDIATELY);
 
     hr = GetD2DFactory()->CreateHwndRenderTarget(renderTargetProperties, hwndRenderTargetProperties, m_renderTarget.put());
 
@@ -61,6 +63,12 @@ bool FrameDrawer::CreateRenderTargets(const RECT& clientRect)
     }
     m_renderTargetSizeHash = rectHash;
 
+    // The brush belongs to the render target
+    if (m_sceneRect.thickness)
+    {
+        m_renderTarget->CreateSolidColorBrush(m_sceneRect.borderColor, m_borderBrush.put());
+    }
+
     return true;
 }
 
@@ -113,9 +121,11 @@ void FrameDrawer::SetBorderRect(RECT windowRect, COLORREF color, int thickness)
     const bool atTheDesiredSize = (rectHash == m_renderTargetSizeHash) && m_renderTarget;
     if (!atTheDesiredSize)
     {
+        // Resizing keeps the render target and the brush, they're only recreated if the device was lost
         const bool resizeOk = m_renderTarget && SUCCEEDED(m_renderTarget->Resize(renderTargetSize));
         if (!resizeOk)
         {
+            m_renderTarget = nullptr;
             if (!CreateRenderTargets(clientRect))
             {
                 Logger::error(L"Failed to create render targets");
@@ -189,5 +199,11 @@ void FrameDrawer::Render()
         m_renderTarget->DrawRectangle(m_sceneRect.rect, m_borderBrush.get(), static_cast<float>(m_sceneRect.thickness * 2));
     }
 
-    m_renderTarget->EndDraw();
+    if (m_renderTarget->EndDraw() == D2DERR_RECREATE_TARGET)
+    {
+        // Recreated on the next update
+        m_renderTarget = nullptr;
+        m_borderBrush = nullptr;
+        m_renderTargetSizeHash = {};
+    }
 }
\ No newline at end of file
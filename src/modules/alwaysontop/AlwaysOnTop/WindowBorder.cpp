@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "WindowBorder.h"
 
+#include <algorithm>
+
 #include <dwmapi.h>
 #include "winrt/Windows.Foundation.h"
 
@@ -68,6 +70,26 @@ namespace
 {
     constexpr uint32_t REFRESH_BORDER_TIMER_ID = 123;
     constexpr uint32_t REFRESH_BORDER_INTERVAL = 100;
+    constexpr uint32_t UPDATE_POSITION_TIMER_ID = 124;
+
+    // Aligns the coalesced updates with the refresh of the compositor
+    void UpdateFrameTiming(FrameCoalescer& coalescer)
+    {
+        DWM_TIMING_INFO timingInfo{ .cbSize = sizeof(DWM_TIMING_INFO) };
+        LARGE_INTEGER frequency, counter;
+        if (!SUCCEEDED(DwmGetCompositionTimingInfo(nullptr, &timingInfo)) || !QueryPerformanceFrequency(&frequency) || !QueryPerformanceCounter(&counter))
+        {
+            return;
+        }
+
+        const auto now = FrameCoalescer::Clock::now();
+        auto toDuration = [&frequency](LONGLONG ticks) {
+            return std::chrono::duration_cast<FrameCoalescer::Clock::duration>(std::chrono::duration<double>(static_cast<double>(ticks) / frequency.QuadPart));
+        };
+
+        coalescer.SetTiming(toDuration(static_cast<LONGLONG>(timingInfo.qpcRefreshPeriod)),
+                            now - toDuration(counter.QuadPart - static_cast<LONGLONG>(timingInfo.qpcVBlank)));
+    }
 }
 
 bool WindowBorder::Init(HINSTANCE hinstance)
@@ -139,7 +161,31 @@ bool WindowBorder::Init(HINSTANCE hinstance)
     return true;
 }
 
-void WindowBorder::UpdateBorderPosition() const
+void WindowBorder::UpdateBorderPosition()
+{
+    if (!m_trackingWindow)
+    {
+        return;
+    }
+
+    if (!m_positionUpdates.Pending())
+    {
+        UpdateFrameTiming(m_positionUpdates);
+    }
+
+    ScheduleBorderPosition(m_positionUpdates.Request(FrameCoalescer::Clock::now()));
+}
+
+void WindowBorder::ScheduleBorderPosition(std::optional<FrameCoalescer::Clock::duration> delay)
+{
+    if (delay.has_value())
+    {
+        const auto elapse = std::chrono::ceil<std::chrono::milliseconds>(*delay).count();
+        SetTimer(m_window, UPDATE_POSITION_TIMER_ID, static_cast<UINT>(std::max<long long>(elapse, USER_TIMER_MINIMUM)), nullptr);
+    }
+}
+
+void WindowBorder::ApplyBorderPosition()
 {
     if (!m_trackingWindow)
     {
@@ -155,9 +201,13 @@ void WindowBorder::UpdateBorderPosition() const
 
     RECT rect = rectOpt.value();
     SetWindowPos(m_window, m_trackingWindow, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, SWP_NOREDRAW | SWP_NOACTIVATE);
+
+    // Only redraws if the size changed
+    RECT frameRect{ 0, 0, rect.right - rect.left, rect.bottom - rect.top };
+    m_frameDrawer->SetBorderRect(frameRect, m_frameColor, AlwaysOnTopSettings::settings().frameThickness);
 }
 
-void WindowBorder::UpdateBorderProperties() const
+void WindowBorder::UpdateBorderProperties()
 {
     if (!m_trackingWindow || !m_frameDrawer)
     {
@@ -175,19 +225,18 @@ void WindowBorder::UpdateBorderProperties() const
 
     RECT frameRect{ 0, 0, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top };
 
-    COLORREF color;
     if (AlwaysOnTopSettings::settings().frameAccentColor)
     {
         winrt::Windows::UI::ViewManagement::UISettings settings;
         auto accentValue = settings.GetColorValue(winrt::Windows::UI::ViewManagement::UIColorType::Accent);
-        color = RGB(accentValue.R, accentValue.G, accentValue.B);
+        m_frameColor = RGB(accentValue.R, accentValue.G, accentValue.B);
     }
     else
     {
-        color = AlwaysOnTopSettings::settings().frameColor;
+        m_frameColor = AlwaysOnTopSettings::settings().frameColor;
     }
 
-    m_frameDrawer->SetBorderRect(frameRect, color, AlwaysOnTopSettings::settings().frameThickness);
+    m_frameDrawer->SetBorderRect(frameRect, m_frameColor, AlwaysOnTopSettings::settings().frameThickness);
 }
 
 LRESULT WindowBorder::WndProc(UINT message, WPARAM wparam, LPARAM lparam) noexcept
@@ -201,15 +250,31 @@ LRESULT WindowBorder::WndProc(UINT message, WPARAM wparam, LPARAM lparam) noexce
         case REFRESH_BORDER_TIMER_ID:
             KillTimer(m_window, m_timer_id);
             m_timer_id = SetTimer(m_window, REFRESH_BORDER_TIMER_ID, REFRESH_BORDER_INTERVAL, nullptr);
-            UpdateBorderPosition();
+            ApplyBorderPosition();
             UpdateBorderProperties();
             break;
+        case UPDATE_POSITION_TIMER_ID:
+        {
+            KillTimer(m_window, UPDATE_POSITION_TIMER_ID);
+            const auto now = FrameCoalescer::Clock::now();
+            if (m_positionUpdates.Flush(now))
+            {
+                ApplyBorderPosition();
+            }
+            else
+            {
+                // The timer fired before the next refresh
+                ScheduleBorderPosition(m_positionUpdates.Schedule(now));
+            }
+        }
+        break;
         }
         break;
     }
     case WM_NCDESTROY:
     {
         KillTimer(m_window, m_timer_id);
+        KillTimer(m_window, UPDATE_POSITION_TIMER_ID);
         ::DefWindowProc(m_window, message, wparam, lparam);
         SetWindowLongPtr(m_window, GWLP_USERDATA, 0);
     }
@@ -247,7 +312,7 @@ void WindowBorder::SettingsUpdate(SettingId id)
     {
     case SettingId::FrameThickness:
     {
-        UpdateBorderPosition();
+        ApplyBorderPosition();
         UpdateBorderProperties();
     }
     break;
@@ -2,6 +2,8 @@
 
 #include <SettingsObserver.h>
 
+#include <common/utils/FrameCoalescer.h>
+
 class FrameDrawer;
 
 class WindowBorder : public SettingsObserver
@@ -13,8 +15,9 @@ public:
     static std::unique_ptr<WindowBorder> Create(HWND window, HINSTANCE hinstance);
     ~WindowBorder();
 
-    void UpdateBorderPosition() const;
-    void UpdateBorderProperties() const;
+    // Repositions the border on the next display refresh, coalescing the changes made until then
+    void UpdateBorderPosition();
+    void UpdateBorderProperties();
 
 protected:
     static LRESULT CALLBACK s_WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lparam) noexcept
@@ -35,9 +38,13 @@ private:
     UINT_PTR m_timer_id = {};
     HWND m_window = {};
     HWND m_trackingWindow = {};
+    COLORREF m_frameColor = {};
     std::unique_ptr<FrameDrawer> m_frameDrawer;
+    FrameCoalescer m_positionUpdates;
 
     LRESULT WndProc(UINT message, WPARAM wparam, LPARAM lparam) noexcept;
+    void ApplyBorderPosition();
+    void ScheduleBorderPosition(std::optional<FrameCoalescer::Clock::duration> delay);
 
     bool Init(HINSTANCE hinstance);
     virtual void SettingsUpdate(SettingId id) override;
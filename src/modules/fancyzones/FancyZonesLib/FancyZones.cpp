@@ -15,6 +15,7 @@
 #include <FancyZonesLib/FancyZonesData/AppliedLayouts.h>
 #include <FancyZonesLib/FancyZonesData/AppZoneHistory.h>
 #include <FancyZonesLib/FancyZonesData/CustomLayouts.h>
+#include <FancyZonesLib/FancyZonesData/DataCache.h>
 #include <FancyZonesLib/FancyZonesData/LayoutHotkeys.h>
 #include <FancyZonesLib/FancyZonesData/LayoutTemplates.h>
 #include <FancyZonesLib/FancyZonesWindowProcessing.h>
@@ -26,6 +27,7 @@
 #include <FancyZonesLib/ZoneSet.h>
 #include <FancyZonesLib/WorkArea.h>
 #include <FancyZonesLib/WindowMoveHandler.h>
+#include <FancyZonesLib/WindowPositionBatch.h>
 #include <FancyZonesLib/WindowUtils.h>
 #include <FancyZonesLib/util.h>
 
@@ -189,6 +191,7 @@ private:
     wil::unique_handle m_terminateEditorEvent; // Handle of FancyZonesEditor.exe we launch and wait on
 
     OnThreadExecutor m_dpiUnawareThread;
+    OnThreadExecutor m_windowMoverThread; // Runs the transactions that move other apps' windows together
 
     EventWaiter m_toggleEditorEventWaiter;
 
@@ -279,6 +282,10 @@ FancyZones::Destroy() noexcept
         DestroyWindow(m_window);
         m_window = nullptr;
     }
+
+    AppZoneHistory::instance().SaveCache();
+    DataCache::WaitForPendingWrites();
+    DataCache::Stop();
 }
 
 // IFancyZonesCallback
@@ -945,6 +952,9 @@ void FancyZones::UpdateWorkAreas() noexcept
 
 void FancyZones::UpdateWindowsPositions(bool suppressMove) noexcept
 {
+    // The target rects of all windows are collected first and committed together
+    WindowPositionBatch batch(&m_windowMoverThread);
+
     // For each window in each desktop...
     for (const auto [window, desktopId] : VirtualDesktop::instance().GetWindowsRelatedToDesktops())
     {
@@ -980,6 +990,8 @@ void FancyZones::UpdateWindowsPositions(bool suppressMove) noexcept
             }
         }
     }
+
+    batch.Commit();
 }
 
 void FancyZones::CycleTabs(bool reverse) noexcept
@@ -6,6 +6,7 @@
 #include <common/utils/process_path.h>
 
 #include <FancyZonesLib/GuidUtils.h>
+#include <FancyZonesLib/FancyZonesData/DataCache.h>
 #include <FancyZonesLib/FancyZonesWindowProperties.h>
 #include <FancyZonesLib/JsonHelpers.h>
 #include <FancyZonesLib/VirtualDesktop.h>
@@ -66,7 +67,7 @@ namespace JsonUtils
                 data.zoneIndexSet = {};
                 for (const auto& value : json.GetNamedArray(NonLocalizable::AppZoneHistoryIds::LayoutIndexesID))
                 {
-                    data.zoneIndexSet.push_back(static_cast<ZoneIndex>(value.GetNumber()));
+                    data.zoneIndexSet.insert(static_cast<ZoneIndex>(value.GetNumber()));
                 }
             }
             else if (json.HasKey(NonLocalizable::AppZoneHistoryIds::LayoutIndexesID))
@@ -212,6 +213,13 @@ namespace JsonUtils
 }
 
 
+namespace
+{
+    // Attributes of the JSON saved since the sidecar was last written, and the history in it if it differs from the one in memory
+    std::optional<DataCache::SourceAttributes> unsavedCacheSource;
+    std::optional<AppZoneHistory::TAppZoneHistoryMap> unsavedCacheHistory;
+}
+
 AppZoneHistory::AppZoneHistory()
 {
 }
@@ -225,13 +233,26 @@ AppZoneHistory& AppZoneHistory::instance()
 void AppZoneHistory::LoadData()
 {
     auto file = AppZoneHistoryFileName();
-    auto data = json::from_file(file);
+    unsavedCacheSource.reset();
+    unsavedCacheHistory.reset();
+    DataCache::SourceFile source{ file };
+    if (source.Exists())
+    {
+        if (auto cached = DataCache::ReadAppZoneHistory(file, source.Attributes()); cached.has_value())
+        {
+            m_history = std::move(cached.value());
+            return;
+        }
+    }
+
+    auto data = source.Parse();
 
     try
     {
         if (data)
         {
             m_history = JsonUtils::ParseAppZoneHistory(data.value());
+            DataCache::WriteAppZoneHistory(file, source.Attributes(), m_history);
         }
         else
         {
@@ -247,32 +268,39 @@ void AppZoneHistory::LoadData()
 
 void AppZoneHistory::SaveData()
 {
-    bool dirtyFlag = false;
-    std::unordered_map<std::wstring, std::vector<FancyZonesDataTypes::AppZoneHistoryData>> updatedHistory;
-    
+    // Virtual desktops that aren't saved in the registry are written as GUID_NULL, the history is only copied if there are any
+    std::optional<TAppZoneHistoryMap> updatedHistory;
     for (const auto& [path, dataVector] : m_history)
     {
-        auto updatedVector = dataVector;
-        for (auto& data : updatedVector)
+        for (size_t i = 0; i < dataVector.size(); i++)
         {
-            if (!VirtualDesktop::instance().IsVirtualDesktopIdSavedInRegistry(data.deviceId.virtualDesktopId))
+            const auto& virtualDesktopId = dataVector[i].deviceId.virtualDesktopId;
+            if (virtualDesktopId != GUID_NULL && !VirtualDesktop::IdsProvider().IsVirtualDesktopIdSavedInRegistry(virtualDesktopId))
             {
-                data.deviceId.virtualDesktopId = GUID_NULL;
-                dirtyFlag = true;
+                if (!updatedHistory)
+                {
+                    updatedHistory = m_history;
+                }
+
+                updatedHistory->at(path)[i].deviceId.virtualDesktopId = GUID_NULL;
             }
         }
-
-        updatedHistory.insert(std::make_pair(path, updatedVector));
     }
 
-    if (dirtyFlag)
-    {
-        json::to_file(AppZoneHistoryFileName(), JsonUtils::SerializeJson(updatedHistory));
-    }
-    else
+    unsavedCacheSource = DataCache::WriteSource(AppZoneHistoryFileName(), JsonUtils::SerializeJson(updatedHistory ? *updatedHistory : m_history));
+    unsavedCacheHistory = std::move(updatedHistory);
+}
+
+void AppZoneHistory::SaveCache()
+{
+    if (!unsavedCacheSource)
     {
-        json::to_file(AppZoneHistoryFileName(), JsonUtils::SerializeJson(m_history));
+        return;
     }
+
+    DataCache::WriteAppZoneHistory(AppZoneHistoryFileName(), *unsavedCacheSource, unsavedCacheHistory ? std::move(*unsavedCacheHistory) : m_history);
+    unsavedCacheSource.reset();
+    unsavedCacheHistory.reset();
 }
 
 bool AppZoneHistory::SetAppLastZones(HWND window, const FancyZonesDataTypes::DeviceIdData& deviceId, const std::wstring& zoneSetId, const ZoneIndexSet& zoneIndexSet)
@@ -552,7 +580,7 @@ void AppZoneHistory::SyncVirtualDesktops()
     // desktops in this session value in registry will be empty and we will use default GUID in
     // that case (00000000-0000-0000-0000-000000000000).
     
-    auto savedInRegistryVirtualDesktopID = VirtualDesktop::instance().GetCurrentVirtualDesktopIdFromRegistry();
+    auto savedInRegistryVirtualDesktopID = VirtualDesktop::IdsProvider().GetCurrentVirtualDesktopIdFromRegistry();
     if (!savedInRegistryVirtualDesktopID.has_value() || savedInRegistryVirtualDesktopID.value() == GUID_NULL)
     {
         return;
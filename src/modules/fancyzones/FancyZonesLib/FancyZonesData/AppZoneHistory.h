@@ -39,6 +39,9 @@ public:
 
     void LoadData();
     void SaveData();
+    // Writes the binary sidecar of the last saved history. SaveData runs on every snap, so the sidecar is only
+    // written once FancyZones is destroyed, a stale one is ignored and rebuilt on the next load.
+    void SaveCache();
 
     bool SetAppLastZones(HWND window, const FancyZonesDataTypes::DeviceIdData& deviceId, const std::wstring& zoneSetId, const ZoneIndexSet& zoneIndexSet);
     bool RemoveAppLastZone(HWND window, const FancyZonesDataTypes::DeviceIdData& deviceId, const std::wstring_view& zoneSetId);
@@ -5,6 +5,7 @@
 #include <common/logger/logger.h>
 
 #include <FancyZonesLib/GuidUtils.h>
+#include <FancyZonesLib/FancyZonesData/DataCache.h>
 #include <FancyZonesLib/FancyZonesData/CustomLayouts.h>
 #include <FancyZonesLib/FancyZonesData/LayoutDefaults.h>
 #include <FancyZonesLib/FancyZonesWinHookEventIDs.h>
@@ -221,13 +222,25 @@ AppliedLayouts& AppliedLayouts::instance()
 
 void AppliedLayouts::LoadData()
 {
-    auto data = json::from_file(AppliedLayoutsFileName());
+    auto file = AppliedLayoutsFileName();
+    DataCache::SourceFile source{ file };
+    if (source.Exists())
+    {
+        if (auto cached = DataCache::ReadAppliedLayouts(file, source.Attributes()); cached.has_value())
+        {
+            m_layouts = std::move(cached.value());
+            return;
+        }
+    }
+
+    auto data = source.Parse();
 
     try
     {
         if (data)
         {
             m_layouts = JsonUtils::ParseJson(data.value());
+            DataCache::WriteAppliedLayouts(file, source.Attributes(), m_layouts);
         }
         else
         {
@@ -249,7 +262,7 @@ void AppliedLayouts::SaveData()
     for (const auto& [id, data] : m_layouts)
     {
         auto updatedId = id;
-        if (!VirtualDesktop::instance().IsVirtualDesktopIdSavedInRegistry(id.virtualDesktopId))
+        if (!VirtualDesktop::IdsProvider().IsVirtualDesktopIdSavedInRegistry(id.virtualDesktopId))
         {
             updatedId.virtualDesktopId = GUID_NULL;
             dirtyFlag = true;
@@ -258,13 +271,11 @@ void AppliedLayouts::SaveData()
         updatedMap.insert({ updatedId, data });
     }
 
-    if (dirtyFlag)
-    {
-        json::to_file(AppliedLayoutsFileName(), JsonUtils::SerializeJson(updatedMap));
-    }
-    else
+    const auto file = AppliedLayoutsFileName();
+    const auto& savedLayouts = dirtyFlag ? updatedMap : m_layouts;
+    if (auto source = DataCache::WriteSource(file, JsonUtils::SerializeJson(savedLayouts)); source.has_value())
     {
-        json::to_file(AppliedLayoutsFileName(), JsonUtils::SerializeJson(m_layouts));
+        DataCache::WriteAppliedLayouts(file, source.value(), savedLayouts);
     }
 }
 
@@ -275,7 +286,7 @@ void AppliedLayouts::SyncVirtualDesktops()
     // desktops in this session value in registry will be empty and we will use default GUID in
     // that case (00000000-0000-0000-0000-000000000000).
 
-    auto savedInRegistryVirtualDesktopID = VirtualDesktop::instance().GetCurrentVirtualDesktopIdFromRegistry();
+    auto savedInRegistryVirtualDesktopID = VirtualDesktop::IdsProvider().GetCurrentVirtualDesktopIdFromRegistry();
     if (!savedInRegistryVirtualDesktopID.has_value() || savedInRegistryVirtualDesktopID.value() == GUID_NULL)
     {
         return;
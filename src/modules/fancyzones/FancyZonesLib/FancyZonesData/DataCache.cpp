@@ -0,0 +1,512 @@
+#include "../pch.h"
+#include "DataCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include <common/logger/logger.h>
+#include <common/utils/winapi_error.h>
+
+#include <FancyZonesLib/on_thread_executor.h>
+
+namespace NonLocalizable
+{
+    const static wchar_t* CacheExtension = L".cache";
+    const static wchar_t* TempExtension = L".tmp";
+}
+
+namespace
+{
+    constexpr uint32_t CacheMagic = 0x43425A46; // "FZBC"
+    // Increase when the layout of the header or of any payload changes
+    constexpr uint32_t CacheVersion = 2;
+
+    enum class CacheKind : uint32_t
+    {
+        AppZoneHistory = 1,
+        AppliedLayouts = 2,
+    };
+
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        CacheKind kind;
+        uint32_t reserved;
+        uint64_t sourceSize;
+        uint64_t sourceWriteTime;
+        uint64_t sourceHash;
+        uint64_t payloadSize;
+        uint64_t payloadHash;
+    };
+
+    static_assert(sizeof(CacheHeader) == 56);
+
+    constexpr std::string_view Utf8Bom = "\xEF\xBB\xBF";
+
+    // 64-bit FNV-1a
+    uint64_t Hash(std::string_view data) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : data)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    std::optional<uint64_t> LastWriteTime(const std::wstring& path) noexcept
+    {
+        WIN32_FILE_ATTRIBUTE_DATA data{};
+        if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data))
+        {
+            return std::nullopt;
+        }
+
+        return (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    }
+
+    class PayloadWriter
+    {
+    public:
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void WriteCount(size_t count)
+        {
+            Write(static_cast<uint32_t>(count));
+        }
+
+        void WriteString(const std::wstring& str)
+        {
+            WriteCount(str.size());
+            m_buffer.append(reinterpret_cast<const char*>(str.data()), str.size() * sizeof(wchar_t));
+        }
+
+        std::string& Buffer() noexcept
+        {
+            return m_buffer;
+        }
+
+    private:
+        std::string m_buffer;
+    };
+
+    // Reads the payload in place, every read is checked against the end of the mapped file
+    class PayloadReader
+    {
+    public:
+        explicit PayloadReader(std::string_view data) noexcept :
+            m_data(data)
+        {
+        }
+
+        template<typename T>
+        bool Read(T& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (m_data.size() < sizeof(T))
+            {
+                return false;
+            }
+
+            memcpy(&value, m_data.data(), sizeof(T));
+            m_data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        // Reads the number of elements that follow, each of which takes at least 'minSize' bytes
+        bool ReadCount(uint32_t& count, size_t minSize) noexcept
+        {
+            return Read(count) && count <= m_data.size() / minSize;
+        }
+
+        bool ReadString(std::wstring& str)
+        {
+            uint32_t length = 0;
+            if (!Read(length) || length > m_data.size() / sizeof(wchar_t))
+            {
+                return false;
+            }
+
+            str.resize(length);
+            memcpy(str.data(), m_data.data(), length * sizeof(wchar_t));
+            m_data.remove_prefix(length * sizeof(wchar_t));
+            return true;
+        }
+
+        bool AtEnd() const noexcept
+        {
+            return m_data.empty();
+        }
+
+    private:
+        std::string_view m_data;
+    };
+
+    void WriteDeviceId(PayloadWriter& writer, const FancyZonesDataTypes::DeviceIdData& deviceId)
+    {
+        writer.WriteString(deviceId.deviceName);
+        writer.Write(deviceId.virtualDesktopId);
+    }
+
+    bool ReadDeviceId(PayloadReader& reader, FancyZonesDataTypes::DeviceIdData& deviceId)
+    {
+        return reader.ReadString(deviceId.deviceName) && reader.Read(deviceId.virtualDesktopId);
+    }
+
+    // Payload: app count, then per app its path and history entries
+    std::string SerializeAppZoneHistory(const AppZoneHistory::TAppZoneHistoryMap& history)
+    {
+        PayloadWriter writer;
+        writer.WriteCount(history.size());
+        for (const auto& [appPath, entries] : history)
+        {
+            writer.WriteString(appPath);
+            writer.WriteCount(entries.size());
+            for (const auto& entry : entries)
+            {
+                writer.WriteString(entry.zoneSetUuid);
+                WriteDeviceId(writer, entry.deviceId);
+                writer.Write(entry.zoneIndexSet.GetWords());
+            }
+        }
+
+        return std::move(writer.Buffer());
+    }
+
+    std::optional<AppZoneHistory::TAppZoneHistoryMap> DeserializeAppZoneHistory(std::string_view payload)
+    {
+        PayloadReader reader{ payload };
+        AppZoneHistory::TAppZoneHistoryMap history{};
+
+        uint32_t appCount = 0;
+        if (!reader.ReadCount(appCount, 2 * sizeof(uint32_t)))
+        {
+            return std::nullopt;
+        }
+
+        history.reserve(appCount);
+        for (uint32_t i = 0; i < appCount; i++)
+        {
+            std::wstring appPath;
+            uint32_t entryCount = 0;
+            if (!reader.ReadString(appPath) || !reader.ReadCount(entryCount, 2 * sizeof(uint32_t) + sizeof(GUID) + sizeof(ZoneIndexSet::Words)))
+            {
+                return std::nullopt;
+            }
+
+            std::vector<FancyZonesDataTypes::AppZoneHistoryData> entries(entryCount);
+            for (auto& entry : entries)
+            {
+                ZoneIndexSet::Words zoneIndexWords{};
+                if (!reader.ReadString(entry.zoneSetUuid) || !ReadDeviceId(reader, entry.deviceId) || !reader.Read(zoneIndexWords))
+                {
+                    return std::nullopt;
+                }
+
+                entry.zoneIndexSet = ZoneIndexSet::FromWords(zoneIndexWords);
+            }
+
+            history.emplace(std::move(appPath), std::move(entries));
+        }
+
+        if (!reader.AtEnd())
+        {
+            return std::nullopt;
+        }
+
+        return history;
+    }
+
+    // Payload: layout count, then per monitor its id and layout
+    std::string SerializeAppliedLayouts(const AppliedLayouts::TAppliedLayoutsMap& layouts)
+    {
+        PayloadWriter writer;
+        writer.WriteCount(layouts.size());
+        for (const auto& [deviceId, layout] : layouts)
+        {
+            WriteDeviceId(writer, deviceId);
+            writer.Write(layout.uuid);
+            writer.Write(static_cast<int32_t>(layout.type));
+            writer.Write(static_cast<uint8_t>(layout.showSpacing));
+            writer.Write(static_cast<int32_t>(layout.spacing));
+            writer.Write(static_cast<int32_t>(layout.zoneCount));
+            writer.Write(static_cast<int32_t>(layout.sensitivityRadius));
+        }
+
+        return std::move(writer.Buffer());
+    }
+
+    std::optional<AppliedLayouts::TAppliedLayoutsMap> DeserializeAppliedLayouts(std::string_view payload)
+    {
+        PayloadReader reader{ payload };
+        AppliedLayouts::TAppliedLayoutsMap layouts{};
+
+        uint32_t count = 0;
+        if (!reader.ReadCount(count, sizeof(uint32_t) + 2 * sizeof(GUID)))
+        {
+            return std::nullopt;
+        }
+
+        layouts.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            FancyZonesDataTypes::DeviceIdData deviceId{};
+            Layout layout{};
+            int32_t type = 0;
+            uint8_t showSpacing = 0;
+            int32_t spacing = 0;
+            int32_t zoneCount = 0;
+            int32_t sensitivityRadius = 0;
+            if (!ReadDeviceId(reader, deviceId) ||
+                !reader.Read(layout.uuid) ||
+                !reader.Read(type) ||
+                !reader.Read(showSpacing) ||
+                !reader.Read(spacing) ||
+                !reader.Read(zoneCount) ||
+                !reader.Read(sensitivityRadius))
+            {
+                return std::nullopt;
+            }
+
+            layout.type = static_cast<FancyZonesDataTypes::ZoneSetLayoutType>(type);
+            layout.showSpacing = showSpacing != 0;
+            layout.spacing = spacing;
+            layout.zoneCount = zoneCount;
+            layout.sensitivityRadius = sensitivityRadius;
+            layouts.emplace(std::move(deviceId), layout);
+        }
+
+        if (!reader.AtEnd())
+        {
+            return std::nullopt;
+        }
+
+        return layouts;
+    }
+
+    // Returns the payload of a valid sidecar made from the given JSON file
+    template<typename Deserialize>
+    auto ReadCache(const std::wstring& path, CacheKind kind, const DataCache::SourceAttributes& source, Deserialize deserialize) -> decltype(deserialize(std::string_view{}))
+    {
+        DataCache::MappedFile file{ DataCache::CacheFileName(path) };
+        const auto content = file.Content();
+        if (content.size() < sizeof(CacheHeader))
+        {
+            return std::nullopt;
+        }
+
+        CacheHeader header{};
+        memcpy(&header, content.data(), sizeof(header));
+        const auto payload = content.substr(sizeof(header));
+        if (header.magic != CacheMagic ||
+            header.version != CacheVersion ||
+            header.kind != kind ||
+            header.sourceSize != source.size ||
+            header.sourceWriteTime != source.writeTime ||
+            header.sourceHash != source.hash ||
+            header.payloadSize != payload.size() ||
+            header.payloadHash != Hash(payload))
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            return deserialize(payload);
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    void WriteCache(const std::wstring& path, CacheKind kind, const DataCache::SourceAttributes& source, const std::string& payload)
+    {
+        const CacheHeader header{
+            .magic = CacheMagic,
+            .version = CacheVersion,
+            .kind = kind,
+            .reserved = 0,
+            .sourceSize = source.size,
+            .sourceWriteTime = source.writeTime,
+            .sourceHash = source.hash,
+            .payloadSize = payload.size(),
+            .payloadHash = Hash(payload),
+        };
+
+        // Readers map the sidecar, so it's replaced as a whole instead of being rewritten in place
+        const auto cachePath = DataCache::CacheFileName(path);
+        const auto tempPath = cachePath + NonLocalizable::TempExtension;
+        wil::unique_hfile file{ CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr) };
+        if (!file)
+        {
+            Logger::warn(L"Failed to create {}, {}", tempPath, get_last_error_or_default(GetLastError()));
+            return;
+        }
+
+        DWORD written = 0;
+        const bool saved = WriteFile(file.get(), &header, static_cast<DWORD>(sizeof(header)), &written, nullptr) && written == sizeof(header) &&
+                           WriteFile(file.get(), payload.data(), static_cast<DWORD>(payload.size()), &written, nullptr) && written == payload.size();
+        file.reset();
+
+        if (!saved || !MoveFileExW(tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+        {
+            Logger::warn(L"Failed to save {}, {}", cachePath, get_last_error_or_default(GetLastError()));
+            DeleteFileW(tempPath.c_str());
+        }
+    }
+
+    std::mutex executorMutex;
+    std::unique_ptr<OnThreadExecutor> executor;
+
+    std::future<void> Submit(std::function<void()> task)
+    {
+        std::lock_guard lock{ executorMutex };
+        if (!executor)
+        {
+            executor = std::make_unique<OnThreadExecutor>();
+        }
+
+        return executor->submit(OnThreadExecutor::task_t{ std::move(task) });
+    }
+}
+
+namespace DataCache
+{
+    MappedFile::MappedFile(const std::wstring& path) noexcept
+    {
+        m_file.reset(CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+        if (!m_file)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_file.get(), &size) || size.QuadPart == 0 || size.QuadPart > MAXDWORD)
+        {
+            return;
+        }
+
+        m_mapping.reset(CreateFileMappingW(m_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+        if (!m_mapping)
+        {
+            return;
+        }
+
+        m_view.reset(MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, 0));
+        if (m_view)
+        {
+            m_content = { static_cast<const char*>(m_view.get()), static_cast<size_t>(size.QuadPart) };
+        }
+    }
+
+    SourceFile::SourceFile(const std::wstring& path) :
+        m_file(path)
+    {
+        // The write time is taken first, so a write that races with reading the content can only make the sidecar stale
+        const auto writeTime = LastWriteTime(path);
+        if (!writeTime.has_value() || !Exists())
+        {
+            return;
+        }
+
+        m_attributes = SourceAttributes{
+            .size = m_file.Content().size(),
+            .writeTime = writeTime.value(),
+            .hash = Hash(m_file.Content()),
+        };
+    }
+
+    std::optional<json::JsonObject> SourceFile::Parse() const
+    {
+        auto content = m_file.Content();
+        if (content.starts_with(Utf8Bom))
+        {
+            content.remove_prefix(Utf8Bom.size());
+        }
+
+        json::JsonObject result;
+        if (!json::JsonObject::TryParse(winrt::to_hstring(content), result))
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    std::optional<SourceAttributes> WriteSource(const std::wstring& path, const json::JsonObject& obj)
+    {
+        const auto content = winrt::to_string(obj.Stringify());
+        {
+            std::ofstream file{ path, std::ios::binary };
+            if (!(file << content))
+            {
+                return std::nullopt;
+            }
+        }
+
+        const auto writeTime = LastWriteTime(path);
+        if (!writeTime.has_value())
+        {
+            return std::nullopt;
+        }
+
+        return SourceAttributes{
+            .size = content.size(),
+            .writeTime = writeTime.value(),
+            .hash = Hash(content),
+        };
+    }
+
+    std::wstring CacheFileName(const std::wstring& path)
+    {
+        return std::filesystem::path{ path }.replace_extension(NonLocalizable::CacheExtension).wstring();
+    }
+
+    std::optional<AppZoneHistory::TAppZoneHistoryMap> ReadAppZoneHistory(const std::wstring& path, const SourceAttributes& source)
+    {
+        return ReadCache(path, CacheKind::AppZoneHistory, source, DeserializeAppZoneHistory);
+    }
+
+    std::optional<AppliedLayouts::TAppliedLayoutsMap> ReadAppliedLayouts(const std::wstring& path, const SourceAttributes& source)
+    {
+        return ReadCache(path, CacheKind::AppliedLayouts, source, DeserializeAppliedLayouts);
+    }
+
+    void WriteAppZoneHistory(const std::wstring& path, const SourceAttributes& source, AppZoneHistory::TAppZoneHistoryMap history)
+    {
+        Submit([path, source, history = std::move(history)] {
+            WriteCache(path, CacheKind::AppZoneHistory, source, SerializeAppZoneHistory(history));
+        });
+    }
+
+    void WriteAppliedLayouts(const std::wstring& path, const SourceAttributes& source, AppliedLayouts::TAppliedLayoutsMap layouts)
+    {
+        Submit([path, source, layouts = std::move(layouts)] {
+            WriteCache(path, CacheKind::AppliedLayouts, source, SerializeAppliedLayouts(layouts));
+        });
+    }
+
+    void WaitForPendingWrites()
+    {
+        Submit([] {}).wait();
+    }
+
+    void Stop()
+    {
+        std::unique_ptr<OnThreadExecutor> stopped;
+        {
+            std::lock_guard lock{ executorMutex };
+            stopped = std::move(executor);
+        }
+    }
+}
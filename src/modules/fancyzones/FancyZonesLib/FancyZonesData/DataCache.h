@@ -0,0 +1,81 @@
+#pragma once
+
+#include <FancyZonesLib/FancyZonesData/AppliedLayouts.h>
+#include <FancyZonesLib/FancyZonesData/AppZoneHistory.h>
+
+#include <common/utils/json.h>
+
+// Binary sidecar of the FancyZones data files.
+// The JSON files stay the format shared with the editor and the settings. The sidecar next to each of them holds
+// the same data in a form read straight from a memory mapped file, without building a JSON document first.
+// It records the size, the last write time and the hash of the JSON it was made from and is ignored once the JSON changes.
+namespace DataCache
+{
+    // Attributes of a JSON data file the sidecar is validated against
+    struct SourceAttributes
+    {
+        uint64_t size = 0;
+        uint64_t writeTime = 0;
+        uint64_t hash = 0;
+    };
+
+    // Read-only view of a whole file
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::wstring& path) noexcept;
+
+        std::string_view Content() const noexcept
+        {
+            return m_content;
+        }
+
+    private:
+        wil::unique_hfile m_file;
+        wil::unique_handle m_mapping;
+        wil::unique_mapview_ptr<void> m_view;
+        std::string_view m_content;
+    };
+
+    // JSON data file, read without copying its content until it has to be parsed
+    class SourceFile
+    {
+    public:
+        explicit SourceFile(const std::wstring& path);
+
+        bool Exists() const noexcept
+        {
+            return !m_file.Content().empty();
+        }
+
+        const SourceAttributes& Attributes() const noexcept
+        {
+            return m_attributes;
+        }
+
+        std::optional<json::JsonObject> Parse() const;
+
+    private:
+        MappedFile m_file;
+        SourceAttributes m_attributes;
+    };
+
+    // Writes the JSON data file the same way json::to_file does and returns the attributes of the written file
+    std::optional<SourceAttributes> WriteSource(const std::wstring& path, const json::JsonObject& obj);
+
+    std::wstring CacheFileName(const std::wstring& path);
+
+    // Return nullopt if the sidecar is missing, damaged, written by another version or made from another JSON
+    std::optional<AppZoneHistory::TAppZoneHistoryMap> ReadAppZoneHistory(const std::wstring& path, const SourceAttributes& source);
+    std::optional<AppliedLayouts::TAppliedLayoutsMap> ReadAppliedLayouts(const std::wstring& path, const SourceAttributes& source);
+
+    // Regenerate the sidecar on a background thread
+    void WriteAppZoneHistory(const std::wstring& path, const SourceAttributes& source, AppZoneHistory::TAppZoneHistoryMap history);
+    void WriteAppliedLayouts(const std::wstring& path, const SourceAttributes& source, AppliedLayouts::TAppliedLayoutsMap layouts);
+
+    void WaitForPendingWrites();
+
+    // Stops the background thread, dropping the writes that haven't started yet.
+    // Has to be called before the module is unloaded.
+    void Stop();
+}
@@ -170,9 +170,10 @@ namespace std
     template<>
     struct hash<FancyZonesDataTypes::DeviceIdData>
     {
-        size_t operator()(const FancyZonesDataTypes::DeviceIdData& Value) const
+        // GUID_NULL matches any virtual desktop in operator==, so only the device name is hashed
+        size_t operator()(const FancyZonesDataTypes::DeviceIdData& Value) const noexcept
         {
-            return 0;
+            return std::hash<std::wstring_view>{}(Value.deviceName);
         }
     };
 }
@@ -270,7 +270,7 @@ namespace
             data.zoneIndexSet = {};
             for (const auto& value : json.GetNamedArray(NonLocalizable::ZoneIndexSetStr))
             {
-                data.zoneIndexSet.push_back(static_cast<ZoneIndex>(value.GetNumber()));
+                data.zoneIndexSet.insert(static_cast<ZoneIndex>(value.GetNumber()));
             }
         }
         else if (json.HasKey(NonLocalizable::ZoneIndexStr))
@@ -4,6 +4,8 @@
 #include <common/logger/logger.h>
 #include "trace.h"
 
+#include <algorithm>
+
 // Non-Localizable strings
 namespace NonLocalizable
 {
@@ -13,64 +15,56 @@ namespace NonLocalizable
     const wchar_t RegKeyVirtualDesktopsFromSession[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\SessionInfo\\%d\\VirtualDesktops";
 }
 
-std::optional<GUID> NewGetCurrentDesktopId()
+namespace
 {
-    wil::unique_hkey key{};
-    if (RegOpenKeyExW(HKEY_CURRENT_USER, NonLocalizable::RegKeyVirtualDesktops, 0, KEY_ALL_ACCESS, &key) == ERROR_SUCCESS)
+    std::optional<GUID> GetCurrentDesktopId(HKEY key)
     {
+        if (!key)
+        {
+            return std::nullopt;
+        }
+
         GUID value{};
         DWORD size = sizeof(GUID);
-        if (RegQueryValueExW(key.get(), NonLocalizable::RegCurrentVirtualDesktop, 0, nullptr, reinterpret_cast<BYTE*>(&value), &size) == ERROR_SUCCESS)
+        if (RegQueryValueExW(key, NonLocalizable::RegCurrentVirtualDesktop, 0, nullptr, reinterpret_cast<BYTE*>(&value), &size) == ERROR_SUCCESS)
         {
             return value;
         }
-    }
 
-    return std::nullopt;
-}
-
-std::optional<GUID> GetDesktopIdFromCurrentSession()
-{
-    DWORD sessionId;
-    if (!ProcessIdToSessionId(GetCurrentProcessId(), &sessionId))
-    {
         return std::nullopt;
     }
 
-    wchar_t sessionKeyPath[256]{};
-    if (FAILED(StringCchPrintfW(sessionKeyPath, ARRAYSIZE(sessionKeyPath), NonLocalizable::RegKeyVirtualDesktopsFromSession, sessionId)))
+    wil::unique_hkey OpenVirtualDesktopsRegKey()
     {
-        return std::nullopt;
+        // Only read and change notifications are needed
+        wil::unique_hkey key{};
+        RegOpenKeyExW(HKEY_CURRENT_USER, NonLocalizable::RegKeyVirtualDesktops, 0, KEY_READ, &key);
+        return key;
     }
 
-    wil::unique_hkey key{};
-    if (RegOpenKeyExW(HKEY_CURRENT_USER, sessionKeyPath, 0, KEY_ALL_ACCESS, &key) == ERROR_SUCCESS)
+    wil::unique_hkey OpenSessionVirtualDesktopsRegKey()
     {
-        GUID value{};
-        DWORD size = sizeof(GUID);
-        if (RegQueryValueExW(key.get(), NonLocalizable::RegCurrentVirtualDesktop, 0, nullptr, reinterpret_cast<BYTE*>(&value), &size) == ERROR_SUCCESS)
+        DWORD sessionId;
+        if (!ProcessIdToSessionId(GetCurrentProcessId(), &sessionId))
         {
-            return value;
+            return {};
         }
-    }
 
-    return std::nullopt;
-}
+        wchar_t sessionKeyPath[256]{};
+        if (FAILED(StringCchPrintfW(sessionKeyPath, ARRAYSIZE(sessionKeyPath), NonLocalizable::RegKeyVirtualDesktopsFromSession, sessionId)))
+        {
+            return {};
+        }
 
-HKEY OpenVirtualDesktopsRegKey()
-{
-    HKEY hKey{ nullptr };
-    if (RegOpenKeyEx(HKEY_CURRENT_USER, NonLocalizable::RegKeyVirtualDesktops, 0, KEY_ALL_ACCESS, &hKey) == ERROR_SUCCESS)
-    {
-        return hKey;
+        wil::unique_hkey key{};
+        RegOpenKeyExW(HKEY_CURRENT_USER, sessionKeyPath, 0, KEY_READ, &key);
+        return key;
     }
-    return nullptr;
-}
 
-HKEY GetVirtualDesktopsRegKey()
-{
-    static wil::unique_hkey virtualDesktopsKey{ OpenVirtualDesktopsRegKey() };
-    return virtualDesktopsKey.get();
+    bool GuidLess(const GUID& lhs, const GUID& rhs) noexcept
+    {
+        return std::memcmp(&lhs, &rhs, sizeof(GUID)) < 0;
+    }
 }
 
 VirtualDesktop::VirtualDesktop()
@@ -80,6 +74,8 @@ VirtualDesktop::VirtualDesktop()
     {
         Logger::error("Failed to create VirtualDesktopManager instance");
     }
+
+    m_registryChanged.create(wil::EventOptions::None);
 }
 
 VirtualDesktop::~VirtualDesktop()
@@ -96,39 +92,99 @@ VirtualDesktop& VirtualDesktop::instance()
     return self;
 }
 
-std::optional<GUID> VirtualDesktop::GetCurrentVirtualDesktopIdFromRegistry() const
+const VirtualDesktopIdsProvider& VirtualDesktop::IdsProvider() noexcept
 {
-    // On newer Windows builds, the current virtual desktop is persisted to
-    // a totally different reg key. Look there first.
-    std::optional<GUID> desktopId = NewGetCurrentDesktopId();
-    if (desktopId.has_value())
+    if (s_idsProvider)
     {
-        return desktopId;
+        return *s_idsProvider;
     }
 
+    return instance();
+}
+
+void VirtualDesktop::SetIdsProvider(const VirtualDesktopIdsProvider* provider) noexcept
+{
+    s_idsProvider = provider;
+}
+
+void VirtualDesktop::WatchRegistry() const
+{
+    if (!m_virtualDesktopsKey)
+    {
+        m_virtualDesktopsKey = OpenVirtualDesktopsRegKey();
+    }
+
+    // The session key only exists after the first desktop switch, which invalidates the cache as well
+    if (!m_sessionVirtualDesktopsKey)
+    {
+        m_sessionVirtualDesktopsKey = OpenSessionVirtualDesktopsRegKey();
+    }
+
+    // Notifications are one-shot, so they are requested again on every refresh
+    for (const auto& key : { m_virtualDesktopsKey.get(), m_sessionVirtualDesktopsKey.get() })
+    {
+        if (key && m_registryChanged)
+        {
+            RegNotifyChangeKeyValue(key, FALSE, REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC, m_registryChanged.get(), TRUE);
+        }
+    }
+}
+
+void VirtualDesktop::InvalidateRegistryCache() noexcept
+{
+    std::unique_lock lock{ m_registryMutex };
+    m_registryCache.valid = false;
+}
+
+const VirtualDesktop::RegistryCache& VirtualDesktop::GetRegistryCache() const
+{
+    // m_registryMutex is held by the caller
+    if (m_registryChanged && m_registryChanged.is_signaled())
+    {
+        m_registryCache.valid = false;
+    }
+
+    if (m_registryCache.valid)
+    {
+        return m_registryCache;
+    }
+
+    // Watch before reading, so changes made while reading aren't missed
+    WatchRegistry();
+
+    m_registryCache.ids = GetVirtualDesktopIdsFromRegistry(m_virtualDesktopsKey.get());
+    m_registryCache.sortedIds = m_registryCache.ids.value_or(std::vector<GUID>{});
+    std::sort(m_registryCache.sortedIds.begin(), m_registryCache.sortedIds.end(), GuidLess);
+
+    // On newer Windows builds, the current virtual desktop is persisted to
+    // a totally different reg key. Look there first.
+    m_registryCache.currentId = GetCurrentDesktopId(m_virtualDesktopsKey.get());
+
     // Explorer persists current virtual desktop identifier to registry on a per session basis, but only
     // after first virtual desktop switch happens. If the user hasn't switched virtual desktops in this
     // session, value in registry will be empty.
-    desktopId = GetDesktopIdFromCurrentSession();
-    if (desktopId.has_value())
+    if (!m_registryCache.currentId.has_value())
     {
-        return desktopId;
+        m_registryCache.currentId = GetCurrentDesktopId(m_sessionVirtualDesktopsKey.get());
     }
 
     // Fallback scenario is to get array of virtual desktops stored in registry, but not kept per session.
     // Note that we are taking first element from virtual desktop array, which is primary desktop.
     // If user has more than one virtual desktop, previous function should return correct value, as desktop
     // switch occurred in current session.
-    else
+    if (!m_registryCache.currentId.has_value() && m_registryCache.ids.has_value() && m_registryCache.ids->size() > 0)
     {
-        auto ids = GetVirtualDesktopIdsFromRegistry();
-        if (ids.has_value() && ids->size() > 0)
-        {
-            return ids->at(0);
-        }
+        m_registryCache.currentId = m_registryCache.ids->at(0);
     }
 
-    return std::nullopt;
+    m_registryCache.valid = true;
+    return m_registryCache;
+}
+
+std::optional<GUID> VirtualDesktop::GetCurrentVirtualDesktopIdFromRegistry() const
+{
+    std::unique_lock lock{ m_registryMutex };
+    return GetRegistryCache().currentId;
 }
 
 std::optional<std::vector<GUID>> VirtualDesktop::GetVirtualDesktopIdsFromRegistry(HKEY hKey) const
@@ -166,26 +222,15 @@ std::optional<std::vector<GUID>> VirtualDesktop::GetVirtualDesktopIdsFromRegistr
 
 std::optional<std::vector<GUID>> VirtualDesktop::GetVirtualDesktopIdsFromRegistry() const
 {
-    return GetVirtualDesktopIdsFromRegistry(GetVirtualDesktopsRegKey());
+    std::unique_lock lock{ m_registryMutex };
+    return GetRegistryCache().ids;
 }
 
 bool VirtualDesktop::IsVirtualDesktopIdSavedInRegistry(GUID id) const
 {
-    auto ids = GetVirtualDesktopIdsFromRegistry();
-    if (!ids.has_value())
-    {
-        return false;
-    }
-
-    for (const auto& regId : *ids)
-    {
-        if (regId == id)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    std::unique_lock lock{ m_registryMutex };
+    const auto& sortedIds = GetRegistryCache().sortedIds;
+    return std::binary_search(sortedIds.begin(), sortedIds.end(), id, GuidLess);
 }
 
 bool VirtualDesktop::IsWindowOnCurrentDesktop(HWND window) const
@@ -247,6 +292,7 @@ GUID VirtualDesktop::GetPreviousVirtualDesktopId() const noexcept
 
 void VirtualDesktop::UpdateVirtualDesktopId() noexcept
 {
+    InvalidateRegistryCache();
     m_previousDesktopId = m_currentVirtualDesktopId;
 
     auto currentVirtualDesktopId = GetCurrentVirtualDesktopIdFromRegistry();
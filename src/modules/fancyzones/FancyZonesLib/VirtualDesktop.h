@@ -1,10 +1,18 @@
 #pragma once
 
-class VirtualDesktop
+#include <mutex>
+
+#include "VirtualDesktopIdsProvider.h"
+
+class VirtualDesktop : public VirtualDesktopIdsProvider
 {
 public:
     static VirtualDesktop& instance();
 
+    // Provider used by the data layer, the registry of this instance unless another one is set by tests
+    static const VirtualDesktopIdsProvider& IdsProvider() noexcept;
+    static void SetIdsProvider(const VirtualDesktopIdsProvider* provider) noexcept;
+
     // saved values
     GUID GetCurrentVirtualDesktopId() const noexcept;
     GUID GetPreviousVirtualDesktopId() const noexcept;
@@ -16,19 +24,38 @@ public:
     std::optional<GUID> GetDesktopIdByTopLevelWindows() const;
     std::vector<std::pair<HWND, GUID>> GetWindowsRelatedToDesktops() const;
 
-    // registry
-    std::optional<GUID> GetCurrentVirtualDesktopIdFromRegistry() const;
-    std::optional<std::vector<GUID>> GetVirtualDesktopIdsFromRegistry() const;
-    bool IsVirtualDesktopIdSavedInRegistry(GUID id) const;
+    // registry, cached until the values change or the desktop is switched
+    std::optional<GUID> GetCurrentVirtualDesktopIdFromRegistry() const override;
+    std::optional<std::vector<GUID>> GetVirtualDesktopIdsFromRegistry() const override;
+    bool IsVirtualDesktopIdSavedInRegistry(GUID id) const override;
 
 private:
     VirtualDesktop();
     ~VirtualDesktop();
 
+    struct RegistryCache
+    {
+        std::optional<GUID> currentId{};
+        std::optional<std::vector<GUID>> ids{};
+        std::vector<GUID> sortedIds{};
+        bool valid{ false };
+    };
+
+    static inline const VirtualDesktopIdsProvider* s_idsProvider{ nullptr };
+
     IVirtualDesktopManager* m_vdManager{nullptr};
 
     GUID m_currentVirtualDesktopId{};
     GUID m_previousDesktopId{};
 
+    mutable std::mutex m_registryMutex;
+    mutable RegistryCache m_registryCache{};
+    mutable wil::unique_hkey m_virtualDesktopsKey{};
+    mutable wil::unique_hkey m_sessionVirtualDesktopsKey{};
+    wil::unique_event m_registryChanged{};
+
+    const RegistryCache& GetRegistryCache() const;
+    void WatchRegistry() const;
+    void InvalidateRegistryCache() noexcept;
     std::optional<std::vector<GUID>> GetVirtualDesktopIdsFromRegistry(HKEY hKey) const;
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+// Virtual desktop ids persisted by Explorer.
+// The FancyZones data layer reads them through this interface, so it can be tested with a fake provider.
+class VirtualDesktopIdsProvider
+{
+public:
+    virtual ~VirtualDesktopIdsProvider() = default;
+
+    virtual std::optional<GUID> GetCurrentVirtualDesktopIdFromRegistry() const = 0;
+    // In the order the desktops were created, the first one is the primary desktop
+    virtual std::optional<std::vector<GUID>> GetVirtualDesktopIdsFromRegistry() const = 0;
+    virtual bool IsVirtualDesktopIdSavedInRegistry(GUID id) const = 0;
+};
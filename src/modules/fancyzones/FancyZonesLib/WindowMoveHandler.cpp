@@ -2,6 +2,7 @@
 #include "WindowMoveHandler.h"
 
 #include <common/display/dpi_aware.h>
+#include <common/logger/perf_trace.h>
 #include <common/notifications/notifications.h>
 #include <common/notifications/dont_show_again.h>
 #include <common/utils/elevation.h>
@@ -61,6 +62,7 @@ WindowMoveHandler::WindowMoveHandler(const std::function<void()>& keyUpdateCallb
 
 void WindowMoveHandler::MoveSizeStart(HWND window, HMONITOR monitor, POINT const& ptScreen, const std::unordered_map<HMONITOR, winrt::com_ptr<IWorkArea>>& workAreaMap) noexcept
 {
+    PerfTrace::Span span{ PerfTrace::Event::FancyZonesMoveSizeStart };
     if (!FancyZonesWindowProcessing::IsProcessable(window))
     {
         return;
@@ -143,6 +145,7 @@ void WindowMoveHandler::MoveSizeStart(HWND window, HMONITOR monitor, POINT const
 
 void WindowMoveHandler::MoveSizeUpdate(HMONITOR monitor, POINT const& ptScreen, const std::unordered_map<HMONITOR, winrt::com_ptr<IWorkArea>>& workAreaMap) noexcept
 {
+    PerfTrace::Span span{ PerfTrace::Event::FancyZonesMoveSizeUpdate };
     if (!m_inDragging)
     {
         return;
@@ -210,6 +213,7 @@ void WindowMoveHandler::MoveSizeUpdate(HMONITOR monitor, POINT const& ptScreen,
 
 void WindowMoveHandler::MoveSizeEnd(HWND window, POINT const& ptScreen, const std::unordered_map<HMONITOR, winrt::com_ptr<IWorkArea>>& workAreaMap) noexcept
 {
+    PerfTrace::Span span{ PerfTrace::Event::FancyZonesMoveSizeEnd };
     if (window != m_draggedWindow)
     {
         return;
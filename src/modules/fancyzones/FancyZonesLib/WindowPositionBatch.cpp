@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "WindowPositionBatch.h"
+
+#include <chrono>
+
+#include <common/logger/logger.h>
+#include <common/utils/winapi_error.h>
+
+#include <FancyZonesLib/on_thread_executor.h>
+#include <FancyZonesLib/WindowPositionPlanner.h>
+#include <FancyZonesLib/WindowUtils.h>
+
+namespace
+{
+    void MoveTogether(const std::vector<WindowPositionPlanner::Request>& requests) noexcept
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        HDWP transaction = BeginDeferWindowPos(static_cast<int>(requests.size()));
+        for (const auto& request : requests)
+        {
+            if (!transaction)
+            {
+                break;
+            }
+
+            const auto& rect = request.target;
+            transaction = DeferWindowPos(transaction, request.window, nullptr, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE);
+        }
+
+        const bool committed = transaction && EndDeferWindowPos(transaction);
+        if (!committed)
+        {
+            Logger::error(L"Failed to move {} windows at once, {}", requests.size(), get_last_error_or_default(GetLastError()));
+        }
+
+        // Windows moved to a monitor with another DPI rescale themselves, placing them again sets the correct size (Issue #365)
+        size_t corrected = 0;
+        for (const auto& request : requests)
+        {
+            RECT rect{};
+            if (!committed || !GetWindowRect(request.window, &rect) || !EqualRect(&rect, &request.target))
+            {
+                FancyZonesWindowUtils::SizeWindowToRect(request.window, request.target);
+                corrected++;
+            }
+        }
+
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        Logger::info(L"Moved {} windows at once in {:.2f} ms, {} corrected", requests.size(), elapsed.count(), corrected);
+    }
+}
+
+WindowPositionBatch::WindowPositionBatch(OnThreadExecutor* mover) noexcept :
+    m_mover(mover), m_previous(s_current)
+{
+    s_current = this;
+}
+
+WindowPositionBatch::~WindowPositionBatch()
+{
+    Commit();
+}
+
+WindowPositionBatch* WindowPositionBatch::Current() noexcept
+{
+    return s_current;
+}
+
+void WindowPositionBatch::Add(HWND window, RECT rect)
+{
+    m_requests.emplace_back(window, rect);
+}
+
+void WindowPositionBatch::Commit() noexcept
+{
+    // Windows that can't be moved in the transaction are placed with SizeWindowToRect, which must not add them again
+    if (s_current == this)
+    {
+        s_current = m_previous;
+    }
+
+    if (m_requests.empty())
+    {
+        return;
+    }
+
+    std::vector<WindowPositionPlanner::Request> requests;
+    requests.reserve(m_requests.size());
+    for (const auto& [window, rect] : m_requests)
+    {
+        WindowPositionPlanner::Request request{ .window = window, .target = rect };
+        WINDOWPLACEMENT placement{ .length = sizeof(WINDOWPLACEMENT) };
+        request.restored = GetWindowRect(window, &request.current) &&
+                           GetWindowPlacement(window, &placement) &&
+                           placement.showCmd == SW_SHOWNORMAL &&
+                           !IsHungAppWindow(window);
+        // EndDeferWindowPos waits for the windows of other threads to handle the move
+        request.sameThread = GetWindowThreadProcessId(window, nullptr) == GetCurrentThreadId();
+        requests.push_back(request);
+    }
+
+    m_requests.clear();
+
+    auto plan = WindowPositionPlanner::MakePlan(requests);
+    Logger::info(L"Moving windows: {} at once, {} placed, {} skipped", plan.deferred.size(), plan.placed.size(), plan.skipped);
+
+    if (!plan.deferred.empty())
+    {
+        if (plan.waitsForOtherThreads && m_mover)
+        {
+            // The mover thread has no batch, so its corrections are placed right away
+            m_mover->submit(OnThreadExecutor::task_t{ [deferred = std::move(plan.deferred)] { MoveTogether(deferred); } });
+        }
+        else
+        {
+            MoveTogether(plan.deferred);
+        }
+    }
+
+    for (const auto& request : plan.placed)
+    {
+        FancyZonesWindowUtils::SizeWindowToRect(request.window, request.target);
+    }
+}
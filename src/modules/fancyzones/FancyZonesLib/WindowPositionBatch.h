@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+class OnThreadExecutor;
+
+// Collects the window moves requested on this thread while it exists and commits them at once,
+// so switching layouts with many zoned windows repaints them together instead of one after another.
+// The transaction waits for every window it moves, so when it includes windows of other threads it's run on the mover thread.
+// FancyZonesWindowUtils::SizeWindowToRect adds to the current batch instead of moving the window.
+class WindowPositionBatch
+{
+public:
+    explicit WindowPositionBatch(OnThreadExecutor* mover = nullptr) noexcept;
+    ~WindowPositionBatch();
+
+    WindowPositionBatch(const WindowPositionBatch&) = delete;
+    WindowPositionBatch& operator=(const WindowPositionBatch&) = delete;
+
+    static WindowPositionBatch* Current() noexcept;
+
+    void Add(HWND window, RECT rect); // Parameter rect must be in screen coordinates
+    void Commit() noexcept;
+
+private:
+    static inline thread_local WindowPositionBatch* s_current = nullptr;
+
+    OnThreadExecutor* m_mover = nullptr;
+    WindowPositionBatch* m_previous = nullptr;
+    std::vector<std::pair<HWND, RECT>> m_requests;
+};
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "WindowPositionPlanner.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace
+{
+    bool SameRect(const RECT& lhs, const RECT& rhs) noexcept
+    {
+        return lhs.left == rhs.left && lhs.top == rhs.top && lhs.right == rhs.right && lhs.bottom == rhs.bottom;
+    }
+}
+
+WindowPositionPlanner::Plan WindowPositionPlanner::MakePlan(const std::vector<Request>& requests)
+{
+    std::vector<Request> latest;
+    latest.reserve(requests.size());
+
+    std::unordered_set<HWND> seen;
+    for (auto iter = requests.rbegin(); iter != requests.rend(); ++iter)
+    {
+        if (seen.insert(iter->window).second)
+        {
+            latest.push_back(*iter);
+        }
+    }
+
+    std::reverse(latest.begin(), latest.end());
+
+    Plan plan;
+    for (const auto& request : latest)
+    {
+        if (!request.restored)
+        {
+            plan.placed.push_back(request);
+        }
+        else if (SameRect(request.current, request.target))
+        {
+            plan.skipped++;
+        }
+        else
+        {
+            plan.deferred.push_back(request);
+            plan.waitsForOtherThreads |= !request.sameThread;
+        }
+    }
+
+    return plan;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+// Decides how the windows of a batch are moved, without calling any window API, so it can be tested with plain rects
+namespace WindowPositionPlanner
+{
+    struct Request
+    {
+        HWND window{};
+        RECT current{}; // Screen coordinates
+        RECT target{}; // Screen coordinates
+        bool restored{}; // Neither minimized nor maximized and responding, so it can be moved in a deferred transaction
+        bool sameThread{}; // Created by the calling thread, a transaction waits for the windows of other threads to handle the move
+    };
+
+    struct Plan
+    {
+        std::vector<Request> deferred{}; // Moved together in one transaction
+        std::vector<Request> placed{}; // Moved one by one with their window placement, without waiting for them
+        size_t skipped{}; // Already at their target
+        bool waitsForOtherThreads{}; // Some deferred windows belong to other threads, so the transaction shouldn't run on the calling one
+    };
+
+    // The last request of a window wins
+    Plan MakePlan(const std::vector<Request>& requests);
+}
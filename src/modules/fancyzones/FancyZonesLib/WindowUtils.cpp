@@ -11,6 +11,7 @@
 
 #include <FancyZonesLib/FancyZonesWindowProperties.h>
 #include <FancyZonesLib/Settings.h>
+#include <FancyZonesLib/WindowPositionBatch.h>
 
 // Non-Localizable strings
 namespace NonLocalizable
@@ -297,6 +298,12 @@ void FancyZonesWindowUtils::SwitchToWindow(HWND window) noexcept
 
 void FancyZonesWindowUtils::SizeWindowToRect(HWND window, RECT rect) noexcept
 {
+    if (auto batch = WindowPositionBatch::Current())
+    {
+        batch->Add(window, rect);
+        return;
+    }
+
     WINDOWPLACEMENT placement{};
     ::GetWindowPlacement(window, &placement);
 
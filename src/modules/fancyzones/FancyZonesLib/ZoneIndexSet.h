@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+
+using ZoneIndex = int64_t;
+
+/**
+ * Set of zone indexes, stored as a fixed-width bitmask. A layout has at most MaxZones zones (same limit as
+ * the editor), so sets are copied, compared and combined without allocating. Iteration visits the indexes
+ * in ascending order, indexes outside of [0, MaxZones) are ignored.
+ */
+class ZoneIndexSet
+{
+public:
+    static constexpr ZoneIndex MaxZones = 128;
+    static constexpr size_t WordBits = 64;
+    static constexpr size_t WordCount = MaxZones / WordBits;
+
+    using Words = std::array<uint64_t, WordCount>;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ZoneIndex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ZoneIndex*;
+        using reference = ZoneIndex;
+
+        constexpr const_iterator() noexcept = default;
+
+        constexpr ZoneIndex operator*() const noexcept
+        {
+            return static_cast<ZoneIndex>(m_word * WordBits + std::countr_zero(m_bits));
+        }
+
+        constexpr const_iterator& operator++() noexcept
+        {
+            m_bits &= m_bits - 1;
+            SkipEmptyWords();
+            return *this;
+        }
+
+        constexpr const_iterator operator++(int) noexcept
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        constexpr bool operator==(const const_iterator& other) const noexcept
+        {
+            return m_word == other.m_word && m_bits == other.m_bits;
+        }
+
+    private:
+        friend class ZoneIndexSet;
+
+        constexpr const_iterator(const Words* words, size_t word) noexcept :
+            m_words(words), m_word(word), m_bits(word < WordCount ? (*words)[word] : 0)
+        {
+            SkipEmptyWords();
+        }
+
+        constexpr void SkipEmptyWords() noexcept
+        {
+            while (m_bits == 0 && m_word < WordCount && ++m_word < WordCount)
+            {
+                m_bits = (*m_words)[m_word];
+            }
+        }
+
+        const Words* m_words = nullptr;
+        size_t m_word = WordCount;
+        uint64_t m_bits = 0;
+    };
+
+    using iterator = const_iterator;
+
+    constexpr ZoneIndexSet() noexcept = default;
+
+    constexpr ZoneIndexSet(std::initializer_list<ZoneIndex> indexes) noexcept
+    {
+        for (ZoneIndex index : indexes)
+        {
+            insert(index);
+        }
+    }
+
+    static constexpr ZoneIndexSet FromWords(const Words& words) noexcept
+    {
+        ZoneIndexSet result;
+        result.m_words = words;
+        return result;
+    }
+
+    constexpr const Words& GetWords() const noexcept { return m_words; }
+
+    constexpr bool empty() const noexcept
+    {
+        for (uint64_t word : m_words)
+        {
+            if (word != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        size_t result = 0;
+        for (uint64_t word : m_words)
+        {
+            result += std::popcount(word);
+        }
+
+        return result;
+    }
+
+    constexpr bool contains(ZoneIndex index) const noexcept
+    {
+        return IsValid(index) && (m_words[Word(index)] & Bit(index)) != 0;
+    }
+
+    constexpr void insert(ZoneIndex index) noexcept
+    {
+        if (IsValid(index))
+        {
+            m_words[Word(index)] |= Bit(index);
+        }
+    }
+
+    constexpr void erase(ZoneIndex index) noexcept
+    {
+        if (IsValid(index))
+        {
+            m_words[Word(index)] &= ~Bit(index);
+        }
+    }
+
+    constexpr void clear() noexcept { m_words = {}; }
+
+    // Smallest index in the set, the set must not be empty
+    constexpr ZoneIndex front() const noexcept { return *begin(); }
+
+    // Largest index in the set, the set must not be empty
+    constexpr ZoneIndex back() const noexcept
+    {
+        for (size_t word = WordCount; word-- > 0;)
+        {
+            if (m_words[word] != 0)
+            {
+                return static_cast<ZoneIndex>(word * WordBits + WordBits - 1 - std::countl_zero(m_words[word]));
+            }
+        }
+
+        return -1;
+    }
+
+    constexpr const_iterator begin() const noexcept { return const_iterator(&m_words, 0); }
+    constexpr const_iterator end() const noexcept { return const_iterator(&m_words, WordCount); }
+
+    constexpr ZoneIndexSet& operator|=(const ZoneIndexSet& other) noexcept
+    {
+        for (size_t word = 0; word < WordCount; word++)
+        {
+            m_words[word] |= other.m_words[word];
+        }
+
+        return *this;
+    }
+
+    constexpr ZoneIndexSet& operator&=(const ZoneIndexSet& other) noexcept
+    {
+        for (size_t word = 0; word < WordCount; word++)
+        {
+            m_words[word] &= other.m_words[word];
+        }
+
+        return *this;
+    }
+
+    friend constexpr ZoneIndexSet operator|(ZoneIndexSet lhs, const ZoneIndexSet& rhs) noexcept { return lhs |= rhs; }
+    friend constexpr ZoneIndexSet operator&(ZoneIndexSet lhs, const ZoneIndexSet& rhs) noexcept { return lhs &= rhs; }
+
+    constexpr bool operator==(const ZoneIndexSet& other) const noexcept = default;
+    constexpr auto operator<=>(const ZoneIndexSet& other) const noexcept = default;
+
+private:
+    static constexpr bool IsValid(ZoneIndex index) noexcept { return index >= 0 && index < MaxZones; }
+    static constexpr size_t Word(ZoneIndex index) noexcept { return static_cast<size_t>(index) / WordBits; }
+    static constexpr uint64_t Bit(ZoneIndex index) noexcept { return 1ull << (static_cast<size_t>(index) % WordBits); }
+
+    Words m_words{};
+};
@@ -87,7 +87,7 @@ ZoneSet::GetAllZones() const noexcept
     ZoneIndexSet capturedZones;
     for (const auto& [zoneId, zone] : m_zones)
     {
-		capturedZones.emplace_back(zoneId);
+        capturedZones.insert(zoneId);
     }
 
     return capturedZones;
@@ -105,19 +105,19 @@ ZoneSet::ZonesFromPoint(POINT pt) const noexcept
         if (zoneRect.left - m_config.SensitivityRadius <= pt.x && pt.x <= zoneRect.right + m_config.SensitivityRadius &&
             zoneRect.top - m_config.SensitivityRadius <= pt.y && pt.y <= zoneRect.bottom + m_config.SensitivityRadius)
         {
-            capturedZones.emplace_back(zoneId);
+            capturedZones.insert(zoneId);
         }
             
         if (zoneRect.left <= pt.x && pt.x < zoneRect.right &&
             zoneRect.top <= pt.y && pt.y < zoneRect.bottom)
         {
-            strictlyCapturedZones.emplace_back(zoneId);
+            strictlyCapturedZones.insert(zoneId);
         }
     }
 
     // If only one zone is captured, but it's not strictly captured
     // don't consider it as captured
-    if (capturedZones.size() == 1 && strictlyCapturedZones.size() == 0)
+    if (capturedZones.size() == 1 && strictlyCapturedZones.empty())
     {
         return {};
     }
@@ -125,16 +125,16 @@ ZoneSet::ZonesFromPoint(POINT pt) const noexcept
     // If captured zones do not overlap, return all of them
     // Otherwise, return one of them based on the chosen selection algorithm.
     bool overlap = false;
-    for (size_t i = 0; i < capturedZones.size(); ++i)
+    for (auto i = capturedZones.begin(); i != capturedZones.end(); ++i)
     {
-        for (size_t j = i + 1; j < capturedZones.size(); ++j)
+        for (auto j = std::next(i); j != capturedZones.end(); ++j)
         {
             RECT rectI;
             RECT rectJ;
             try
             {
-                rectI = m_zones.at(capturedZones[i])->GetZoneRect();
-                rectJ = m_zones.at(capturedZones[j])->GetZoneRect();
+                rectI = m_zones.at(*i)->GetZoneRect();
+                rectJ = m_zones.at(*j)->GetZoneRect();
             }
             catch (std::out_of_range)
             {
@@ -175,7 +175,7 @@ ZoneSet::ZonesFromPoint(POINT pt) const noexcept
         catch (std::out_of_range)
         {
             Logger::error("Exception out_of_range was thrown in ZoneSet::ZonesFromPoint");
-            return { capturedZones[0] };
+            return { capturedZones.front() };
         }
     }
 
@@ -247,7 +247,7 @@ ZoneSet::MoveWindowIntoZoneByIndexSet(HWND window, HWND workAreaWindow, const Zo
                 sizeEmpty = false;
             }
 
-            indexSet.push_back(id);
+            indexSet.insert(id);
         }
     }
 
@@ -283,13 +283,13 @@ ZoneSet::MoveWindowIntoZoneByDirectionAndIndex(HWND window, HWND workAreaWindow,
     auto numZones = m_zones.size();
 
     // The window was not assigned to any zone here
-    if (indexSet.size() == 0)
+    if (indexSet.empty())
     {
         MoveWindowIntoZoneByIndex(window, workAreaWindow, vkCode == VK_LEFT ? numZones - 1 : 0);
         return true;
     }
 
-    ZoneIndex oldId = indexSet[0];
+    ZoneIndex oldId = indexSet.front();
 
     // We reached the edge
     if ((vkCode == VK_LEFT && oldId == 0) || (vkCode == VK_RIGHT && oldId == numZones - 1))
@@ -333,7 +333,7 @@ ZoneSet::MoveWindowIntoZoneByDirectionAndPosition(HWND window, HWND workAreaWind
     }
 
     std::vector<RECT> zoneRects;
-    ZoneIndexSet freeZoneIndices;
+    std::vector<ZoneIndex> freeZoneIndices;
 
     for (const auto& [zoneId, zone] : m_zones)
     {
@@ -397,7 +397,7 @@ ZoneSet::ExtendWindowByDirectionAndPosition(HWND window, HWND workAreaWindow, DW
         auto oldZones = GetZoneIndexSetFromWindow(window);
         std::vector<bool> usedZoneIndices(m_zones.size(), false);
         std::vector<RECT> zoneRects;
-        ZoneIndexSet freeZoneIndices;
+        std::vector<ZoneIndex> freeZoneIndices;
 
         // If selectManyZones = true for the second time, use the last zone into which we moved
         // instead of the window rect and enable moving to all zones except the old one
@@ -640,7 +640,7 @@ bool ZoneSet::IsZoneEmpty(ZoneIndex zoneIndex) const noexcept
 {
     for (auto& [window, zones] : m_windowIndexSet)
     {
-        if (find(begin(zones), end(zones), zoneIndex) != end(zones))
+        if (zones.contains(zoneIndex))
         {
             return false;
         }
@@ -651,8 +651,8 @@ bool ZoneSet::IsZoneEmpty(ZoneIndex zoneIndex) const noexcept
 
 ZoneIndexSet ZoneSet::GetCombinedZoneRange(const ZoneIndexSet& initialZones, const ZoneIndexSet& finalZones) const noexcept
 {
-    ZoneIndexSet combinedZones, result;
-    std::set_union(begin(initialZones), end(initialZones), begin(finalZones), end(finalZones), std::back_inserter(combinedZones));
+    const ZoneIndexSet combinedZones = initialZones | finalZones;
+    ZoneIndexSet result;
 
     RECT boundingRect;
     bool boundingRectEmpty = true;
@@ -685,7 +685,7 @@ ZoneIndexSet ZoneSet::GetCombinedZoneRange(const ZoneIndexSet& initialZones, con
             if (boundingRect.left <= rect.left && rect.right <= boundingRect.right &&
                 boundingRect.top <= rect.top && rect.bottom <= boundingRect.bottom)
             {
-                result.push_back(zoneId);
+                result.insert(zoneId);
             }
         }
     }
@@ -703,12 +703,12 @@ ZoneIndexSet ZoneSet::ZoneSelectSubregion(const ZoneIndexSet& capturedZones, POI
     };
 
     // Compute the overlapped rectangle.
-    RECT overlap = m_zones.at(capturedZones[0])->GetZoneRect();
+    RECT overlap = m_zones.at(capturedZones.front())->GetZoneRect();
     expand(overlap);
 
-    for (size_t i = 1; i < capturedZones.size(); ++i)
+    for (auto it = std::next(capturedZones.begin()); it != capturedZones.end(); ++it)
     {
-        RECT current = m_zones.at(capturedZones[i])->GetZoneRect();
+        RECT current = m_zones.at(*it)->GetZoneRect();
         expand(current);
 
         overlap.top = max(overlap.top, current.top);
@@ -722,20 +722,21 @@ ZoneIndexSet ZoneSet::ZoneSelectSubregion(const ZoneIndexSet& capturedZones, POI
     int height = max(overlap.bottom - overlap.top, 1);
 
     bool verticalSplit = height > width;
+    const auto zoneCount = static_cast<ZoneIndex>(capturedZones.size());
     ZoneIndex zoneIndex;
 
     if (verticalSplit)
     {
-        zoneIndex = (pt.y - overlap.top) * capturedZones.size() / height;
+        zoneIndex = (pt.y - overlap.top) * zoneCount / height;
     }
     else
     {
-        zoneIndex = (pt.x - overlap.left) * capturedZones.size() / width;
+        zoneIndex = (pt.x - overlap.left) * zoneCount / width;
     }
 
-    zoneIndex = std::clamp(zoneIndex, ZoneIndex(0), static_cast<ZoneIndex>(capturedZones.size()) - 1);
+    zoneIndex = std::clamp(zoneIndex, ZoneIndex(0), zoneCount - 1);
 
-    return { capturedZones[zoneIndex] };
+    return { *std::next(capturedZones.begin(), zoneIndex) };
 }
 
 ZoneIndexSet ZoneSet::ZoneSelectClosestCenter(const ZoneIndexSet& capturedZones, POINT pt) const
@@ -767,17 +768,17 @@ ZoneIndexSet ZoneSet::ZoneSelectClosestCenter(const ZoneIndexSet& capturedZones,
 template<class CompareF>
 ZoneIndexSet ZoneSet::ZoneSelectPriority(const ZoneIndexSet& capturedZones, CompareF compare) const
 {
-    size_t chosen = 0;
+    ZoneIndex chosen = capturedZones.front();
 
-    for (size_t i = 1; i < capturedZones.size(); ++i)
+    for (auto it = std::next(capturedZones.begin()); it != capturedZones.end(); ++it)
     {
-        if (compare(m_zones.at(capturedZones[i]), m_zones.at(capturedZones[chosen])))
+        if (compare(m_zones.at(*it), m_zones.at(chosen)))
         {
-            chosen = i;
+            chosen = *it;
         }
     }
 
-    return { capturedZones[chosen] };
+    return { chosen };
 }
 
 winrt::com_ptr<IZoneSet> MakeZoneSet(ZoneSetConfig const& config) noexcept
@@ -294,12 +294,6 @@ void ZonesOverlay::DrawActiveZoneSet(const ZonesMap& zones,
     inactiveColor.a = colors.highlightOpacity / 100.f;
     highlightColor.a = colors.highlightOpacity / 100.f;
 
-    std::vector<bool> isHighlighted(zones.size() + 1, false);
-    for (ZoneIndex x : highlightZones)
-    {
-        isHighlighted[x] = true;
-    }
-
     // First draw the inactive zones
     for (const auto& [zoneId, zone] : zones)
     {
@@ -308,7 +302,7 @@ void ZonesOverlay::DrawActiveZoneSet(const ZonesMap& zones,
             continue;
         }
 
-        if (!isHighlighted[zoneId])
+        if (!highlightZones.contains(zoneId))
         {
             DrawableRect drawableRect{
                 .rect = ConvertRect(zone->GetZoneRect()),
@@ -331,7 +325,7 @@ void ZonesOverlay::DrawActiveZoneSet(const ZonesMap& zones,
             continue;
         }
 
-        if (isHighlighted[zoneId])
+        if (highlightZones.contains(zoneId))
         {
             DrawableRect drawableRect{
                 .rect = ConvertRect(zone->GetZoneRect()),
@@ -0,0 +1,291 @@
+#include "pch.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include <FancyZonesLib/FancyZonesData/DataCache.h>
+
+#include "util.h"
+#include <modules/fancyzones/FancyZonesLib/util.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    TEST_MODULE_CLEANUP(StopDataCache)
+    {
+        // The sidecars are written on a thread that has to be stopped before the test module is unloaded
+        DataCache::Stop();
+    }
+
+    const GUID cacheTestDesktop = FancyZonesUtils::GuidFromString(L"{72FA9FC0-26A6-4B37-A834-491C148DFC58}").value();
+    const DataCache::SourceAttributes cacheTestSource{ .size = 1024, .writeTime = 133000000000000000, .hash = 0x0123456789ABCDEF };
+
+    AppZoneHistory::TAppZoneHistoryMap MakeAppZoneHistory(size_t apps, size_t entriesPerApp)
+    {
+        AppZoneHistory::TAppZoneHistoryMap history{};
+        for (size_t i = 0; i < apps; i++)
+        {
+            std::vector<FancyZonesDataTypes::AppZoneHistoryData> entries;
+            for (size_t j = 0; j < entriesPerApp; j++)
+            {
+                entries.push_back(FancyZonesDataTypes::AppZoneHistoryData{
+                    .zoneSetUuid = L"{61FA9FC0-26A6-4B37-A834-491C148DFC57}",
+                    .deviceId = { .deviceName = L"monitor-" + std::to_wstring(j), .virtualDesktopId = cacheTestDesktop },
+                    .zoneIndexSet = { static_cast<ZoneIndex>(i % 4), static_cast<ZoneIndex>(i % 4 + 1) } });
+            }
+
+            history[L"C:\\Program Files\\app-" + std::to_wstring(i) + L"\\app.exe"] = std::move(entries);
+        }
+
+        return history;
+    }
+
+    // Writes the history as app-zone-history.json
+    void WriteAppZoneHistoryFile(const AppZoneHistory::TAppZoneHistoryMap& history)
+    {
+        json::JsonArray appZoneHistoryArray{};
+        for (const auto& [appPath, entries] : history)
+        {
+            json::JsonArray historyArray{};
+            for (const auto& entry : entries)
+            {
+                json::JsonObject device{};
+                device.SetNamedValue(NonLocalizable::AppZoneHistoryIds::MonitorID, json::value(entry.deviceId.deviceName));
+                device.SetNamedValue(NonLocalizable::AppZoneHistoryIds::VirtualDesktopID, json::value(FancyZonesUtils::GuidToString(entry.deviceId.virtualDesktopId).value()));
+
+                json::JsonArray zones{};
+                for (ZoneIndex index : entry.zoneIndexSet)
+                {
+                    zones.Append(json::value(static_cast<int>(index)));
+                }
+
+                json::JsonObject historyObj{};
+                historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::LayoutIdID, json::value(entry.zoneSetUuid));
+                historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::DeviceID, device);
+                historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::LayoutIndexesID, zones);
+                historyArray.Append(historyObj);
+            }
+
+            json::JsonObject obj{};
+            obj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::AppPathID, json::value(appPath));
+            obj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::HistoryID, historyArray);
+            appZoneHistoryArray.Append(obj);
+        }
+
+        json::JsonObject root{};
+        root.SetNamedValue(NonLocalizable::AppZoneHistoryIds::AppZoneHistoryID, appZoneHistoryArray);
+        json::to_file(AppZoneHistory::AppZoneHistoryFileName(), root);
+    }
+
+    void AssertEqualHistory(const AppZoneHistory::TAppZoneHistoryMap& expected, const AppZoneHistory::TAppZoneHistoryMap& actual)
+    {
+        Assert::AreEqual(expected.size(), actual.size());
+        for (const auto& [appPath, expectedEntries] : expected)
+        {
+            const auto& actualEntries = actual.at(appPath);
+            Assert::AreEqual(expectedEntries.size(), actualEntries.size());
+            for (size_t i = 0; i < expectedEntries.size(); i++)
+            {
+                Assert::AreEqual(expectedEntries[i].zoneSetUuid, actualEntries[i].zoneSetUuid);
+                Assert::AreEqual(expectedEntries[i].deviceId.deviceName, actualEntries[i].deviceId.deviceName);
+                Assert::IsTrue(expectedEntries[i].deviceId.virtualDesktopId == actualEntries[i].deviceId.virtualDesktopId);
+                Assert::IsTrue(expectedEntries[i].zoneIndexSet == actualEntries[i].zoneIndexSet);
+            }
+        }
+    }
+
+    TEST_CLASS (DataCacheUnitTests)
+    {
+        std::wstring m_historyFile = AppZoneHistory::AppZoneHistoryFileName();
+        std::wstring m_layoutsFile = AppliedLayouts::AppliedLayoutsFileName();
+
+        TEST_METHOD_CLEANUP(CleanUp)
+        {
+            DataCache::WaitForPendingWrites();
+            std::filesystem::remove(m_historyFile);
+            std::filesystem::remove(DataCache::CacheFileName(m_historyFile));
+            std::filesystem::remove(DataCache::CacheFileName(m_layoutsFile));
+        }
+
+        TEST_METHOD (CacheFileNextToJson)
+        {
+            Assert::AreEqual(std::wstring{ L"C:\\FancyZones\\app-zone-history.cache" }, DataCache::CacheFileName(L"C:\\FancyZones\\app-zone-history.json"));
+        }
+
+        TEST_METHOD (NoCache)
+        {
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, cacheTestSource).has_value());
+            Assert::IsFalse(DataCache::ReadAppliedLayouts(m_layoutsFile, cacheTestSource).has_value());
+        }
+
+        TEST_METHOD (AppZoneHistoryRoundTrip)
+        {
+            const auto expected = MakeAppZoneHistory(10, 3);
+            DataCache::WriteAppZoneHistory(m_historyFile, cacheTestSource, expected);
+            DataCache::WaitForPendingWrites();
+
+            const auto actual = DataCache::ReadAppZoneHistory(m_historyFile, cacheTestSource);
+            Assert::IsTrue(actual.has_value());
+            AssertEqualHistory(expected, actual.value());
+        }
+
+        TEST_METHOD (EmptyAppZoneHistoryRoundTrip)
+        {
+            DataCache::WriteAppZoneHistory(m_historyFile, cacheTestSource, {});
+            DataCache::WaitForPendingWrites();
+
+            const auto actual = DataCache::ReadAppZoneHistory(m_historyFile, cacheTestSource);
+            Assert::IsTrue(actual.has_value());
+            Assert::IsTrue(actual->empty());
+        }
+
+        TEST_METHOD (AppliedLayoutsRoundTrip)
+        {
+            const FancyZonesDataTypes::DeviceIdData deviceId{ .deviceName = L"AOC0001#5&37ac4db&0&UID160002", .virtualDesktopId = cacheTestDesktop };
+            const Layout expected{
+                .uuid = FancyZonesUtils::GuidFromString(L"{33A2B101-06E0-437B-A61E-CDBECF502906}").value(),
+                .type = FancyZonesDataTypes::ZoneSetLayoutType::Custom,
+                .showSpacing = false,
+                .spacing = 8,
+                .zoneCount = 5,
+                .sensitivityRadius = 30,
+            };
+
+            DataCache::WriteAppliedLayouts(m_layoutsFile, cacheTestSource, { { deviceId, expected } });
+            DataCache::WaitForPendingWrites();
+
+            const auto actual = DataCache::ReadAppliedLayouts(m_layoutsFile, cacheTestSource);
+            Assert::IsTrue(actual.has_value());
+            Assert::AreEqual(size_t{ 1 }, actual->size());
+
+            const auto& layout = actual->at(deviceId);
+            Assert::IsTrue(expected.uuid == layout.uuid);
+            Assert::IsTrue(expected.type == layout.type);
+            Assert::AreEqual(expected.showSpacing, layout.showSpacing);
+            Assert::AreEqual(expected.spacing, layout.spacing);
+            Assert::AreEqual(expected.zoneCount, layout.zoneCount);
+            Assert::AreEqual(expected.sensitivityRadius, layout.sensitivityRadius);
+        }
+
+        TEST_METHOD (ChangedSourceInvalidatesCache)
+        {
+            DataCache::WriteAppZoneHistory(m_historyFile, cacheTestSource, MakeAppZoneHistory(1, 1));
+            DataCache::WaitForPendingWrites();
+
+            auto source = cacheTestSource;
+            source.size++;
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, source).has_value());
+
+            source = cacheTestSource;
+            source.writeTime++;
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, source).has_value());
+
+            source = cacheTestSource;
+            source.hash++;
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, source).has_value());
+        }
+
+        TEST_METHOD (CacheOfAnotherFileIsIgnored)
+        {
+            DataCache::WriteAppZoneHistory(m_layoutsFile, cacheTestSource, MakeAppZoneHistory(1, 1));
+            DataCache::WaitForPendingWrites();
+
+            Assert::IsFalse(DataCache::ReadAppliedLayouts(m_layoutsFile, cacheTestSource).has_value());
+        }
+
+        TEST_METHOD (DamagedCacheIsIgnored)
+        {
+            DataCache::WriteAppZoneHistory(m_historyFile, cacheTestSource, MakeAppZoneHistory(10, 1));
+            DataCache::WaitForPendingWrites();
+
+            const auto cacheFile = DataCache::CacheFileName(m_historyFile);
+            std::string content;
+            {
+                std::ifstream file{ cacheFile, std::ios::binary };
+                content.assign(std::istreambuf_iterator<char>{ file }, {});
+            }
+
+            // Flipped byte in the payload
+            auto damaged = content;
+            damaged.back() = static_cast<char>(damaged.back() ^ 0xFF);
+            std::ofstream{ cacheFile, std::ios::binary } << damaged;
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, cacheTestSource).has_value());
+
+            // Truncated file
+            std::ofstream{ cacheFile, std::ios::binary } << content.substr(0, content.size() / 2);
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, cacheTestSource).has_value());
+        }
+
+        TEST_METHOD (LoadDataRegeneratesCache)
+        {
+            const auto expected = MakeAppZoneHistory(10, 2);
+            WriteAppZoneHistoryFile(expected);
+
+            AppZoneHistory::instance().LoadData();
+            DataCache::WaitForPendingWrites();
+
+            DataCache::SourceFile source{ m_historyFile };
+            const auto cached = DataCache::ReadAppZoneHistory(m_historyFile, source.Attributes());
+            Assert::IsTrue(cached.has_value());
+            AssertEqualHistory(expected, cached.value());
+        }
+
+        TEST_METHOD (LoadDataIgnoresCacheOfPreviousJson)
+        {
+            WriteAppZoneHistoryFile(MakeAppZoneHistory(10, 2));
+            AppZoneHistory::instance().LoadData();
+            DataCache::WaitForPendingWrites();
+
+            // Edited outside of FancyZones
+            const auto expected = MakeAppZoneHistory(4, 1);
+            WriteAppZoneHistoryFile(expected);
+            AppZoneHistory::instance().LoadData();
+
+            AssertEqualHistory(expected, AppZoneHistory::instance().GetFullAppZoneHistory());
+        }
+
+        TEST_METHOD (SaveCacheWritesLastSavedHistory)
+        {
+            WriteAppZoneHistoryFile(MakeAppZoneHistory(10, 2));
+            AppZoneHistory::instance().LoadData();
+            AppZoneHistory::instance().RemoveApp(L"C:\\Program Files\\app-0\\app.exe");
+            AppZoneHistory::instance().SaveData();
+            DataCache::WaitForPendingWrites();
+
+            // Saving the history on every snap leaves the sidecar stale until it's written at the end
+            DataCache::SourceFile source{ m_historyFile };
+            Assert::IsFalse(DataCache::ReadAppZoneHistory(m_historyFile, source.Attributes()).has_value());
+
+            AppZoneHistory::instance().SaveCache();
+            DataCache::WaitForPendingWrites();
+            const auto cached = DataCache::ReadAppZoneHistory(m_historyFile, source.Attributes());
+            Assert::IsTrue(cached.has_value());
+            Assert::AreEqual(size_t{ 9 }, cached->size());
+        }
+
+        TEST_METHOD (ColdStartBenchmark)
+        {
+            constexpr size_t apps = 5000;
+            constexpr size_t entriesPerApp = 3;
+            const auto expected = MakeAppZoneHistory(apps, entriesPerApp);
+            WriteAppZoneHistoryFile(expected);
+
+            auto measure = [] {
+                const auto start = std::chrono::high_resolution_clock::now();
+                AppZoneHistory::instance().LoadData();
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+                return elapsed.count();
+            };
+
+            const auto json = measure();
+            AssertEqualHistory(expected, AppZoneHistory::instance().GetFullAppZoneHistory());
+            DataCache::WaitForPendingWrites();
+
+            const auto cached = measure();
+            AssertEqualHistory(expected, AppZoneHistory::instance().GetFullAppZoneHistory());
+
+            Logger::WriteMessage(std::format(L"Loading {} history entries: json {:.2f} ms, binary cache {:.2f} ms\n", apps * entriesPerApp, json, cached).c_str());
+        }
+    };
+}
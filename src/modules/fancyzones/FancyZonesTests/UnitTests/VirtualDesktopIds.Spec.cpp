@@ -0,0 +1,180 @@
+#include "pch.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <map>
+
+#include <FancyZonesLib/FancyZonesData/AppZoneHistory.h>
+#include <FancyZonesLib/VirtualDesktop.h>
+
+#include "util.h"
+#include <modules/fancyzones/FancyZonesLib/util.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    // Desktop ids set by the test instead of the ones saved by Explorer
+    class FakeVirtualDesktopIds : public VirtualDesktopIdsProvider
+    {
+    public:
+        std::optional<GUID> currentId{};
+        std::vector<GUID> ids{};
+        mutable size_t lookups = 0;
+
+        std::optional<GUID> GetCurrentVirtualDesktopIdFromRegistry() const override
+        {
+            return currentId;
+        }
+
+        std::optional<std::vector<GUID>> GetVirtualDesktopIdsFromRegistry() const override
+        {
+            return ids;
+        }
+
+        bool IsVirtualDesktopIdSavedInRegistry(GUID id) const override
+        {
+            lookups++;
+            return std::find(ids.begin(), ids.end(), id) != ids.end();
+        }
+    };
+
+    const GUID savedDesktop = FancyZonesUtils::GuidFromString(L"{72FA9FC0-26A6-4B37-A834-491C148DFC58}").value();
+    const GUID deletedDesktop = FancyZonesUtils::GuidFromString(L"{8A0A7E36-5F3C-4C0A-9D2B-2E1B6F0C9A11}").value();
+
+    // Writes the history of the given number of apps, every other one on the deleted desktop
+    void WriteAppZoneHistory(size_t count, GUID otherDesktop = deletedDesktop)
+    {
+        json::JsonArray appZoneHistoryArray{};
+        for (size_t i = 0; i < count; i++)
+        {
+            json::JsonObject device{};
+            device.SetNamedValue(NonLocalizable::AppZoneHistoryIds::MonitorID, json::value(L"monitor-1"));
+            device.SetNamedValue(NonLocalizable::AppZoneHistoryIds::VirtualDesktopID, json::value(FancyZonesUtils::GuidToString(i % 2 ? otherDesktop : savedDesktop).value()));
+
+            json::JsonArray zones{};
+            zones.Append(json::value(static_cast<int>(i % 4)));
+
+            json::JsonObject historyObj{};
+            historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::LayoutIdID, json::value(L"{61FA9FC0-26A6-4B37-A834-491C148DFC57}"));
+            historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::DeviceID, device);
+            historyObj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::LayoutIndexesID, zones);
+
+            json::JsonArray history{};
+            history.Append(historyObj);
+
+            json::JsonObject obj{};
+            obj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::AppPathID, json::value(L"app-" + std::to_wstring(i)));
+            obj.SetNamedValue(NonLocalizable::AppZoneHistoryIds::HistoryID, history);
+            appZoneHistoryArray.Append(obj);
+        }
+
+        json::JsonObject root{};
+        root.SetNamedValue(NonLocalizable::AppZoneHistoryIds::AppZoneHistoryID, appZoneHistoryArray);
+        json::to_file(AppZoneHistory::AppZoneHistoryFileName(), root);
+    }
+
+    // Virtual desktop ids of the saved history by app path
+    std::map<std::wstring, std::wstring> ReadSavedDesktopIds()
+    {
+        std::map<std::wstring, std::wstring> result;
+        auto root = json::from_file(AppZoneHistory::AppZoneHistoryFileName());
+        Assert::IsTrue(root.has_value());
+
+        const auto apps = root->GetNamedArray(NonLocalizable::AppZoneHistoryIds::AppZoneHistoryID);
+        for (uint32_t i = 0; i < apps.Size(); i++)
+        {
+            const auto app = apps.GetObjectAt(i);
+            const auto history = app.GetNamedArray(NonLocalizable::AppZoneHistoryIds::HistoryID);
+            for (uint32_t j = 0; j < history.Size(); j++)
+            {
+                const auto device = history.GetObjectAt(j).GetNamedObject(NonLocalizable::AppZoneHistoryIds::DeviceID);
+                result[app.GetNamedString(NonLocalizable::AppZoneHistoryIds::AppPathID).c_str()] = device.GetNamedString(NonLocalizable::AppZoneHistoryIds::VirtualDesktopID).c_str();
+            }
+        }
+
+        return result;
+    }
+
+    TEST_CLASS (VirtualDesktopIdsUnitTests)
+    {
+        FakeVirtualDesktopIds m_desktops{};
+
+        TEST_METHOD_INITIALIZE(Init)
+        {
+            m_desktops.currentId = savedDesktop;
+            m_desktops.ids = { savedDesktop };
+            VirtualDesktop::SetIdsProvider(&m_desktops);
+        }
+
+        TEST_METHOD_CLEANUP(CleanUp)
+        {
+            VirtualDesktop::SetIdsProvider(nullptr);
+            std::filesystem::remove(AppZoneHistory::AppZoneHistoryFileName());
+        }
+
+        TEST_METHOD (SaveResetsDeletedDesktops)
+        {
+            WriteAppZoneHistory(4);
+            AppZoneHistory::instance().LoadData();
+            AppZoneHistory::instance().SaveData();
+
+            const auto saved = ReadSavedDesktopIds();
+            const auto savedStr = FancyZonesUtils::GuidToString(savedDesktop).value();
+            const auto nullStr = FancyZonesUtils::GuidToString(GUID_NULL).value();
+            Assert::AreEqual(size_t{ 4 }, saved.size());
+            Assert::AreEqual(savedStr, saved.at(L"app-0"));
+            Assert::AreEqual(nullStr, saved.at(L"app-1"));
+            Assert::AreEqual(savedStr, saved.at(L"app-2"));
+            Assert::AreEqual(nullStr, saved.at(L"app-3"));
+        }
+
+        TEST_METHOD (SaveKeepsKnownDesktops)
+        {
+            m_desktops.ids = { deletedDesktop, savedDesktop };
+            WriteAppZoneHistory(4);
+            AppZoneHistory::instance().LoadData();
+            AppZoneHistory::instance().SaveData();
+
+            const auto saved = ReadSavedDesktopIds();
+            Assert::AreEqual(FancyZonesUtils::GuidToString(deletedDesktop).value(), saved.at(L"app-1"));
+        }
+
+        TEST_METHOD (SyncReplacesNullDesktopWithCurrent)
+        {
+            WriteAppZoneHistory(2, GUID_NULL);
+            AppZoneHistory::instance().LoadData();
+            AppZoneHistory::instance().SyncVirtualDesktops();
+
+            const auto& history = AppZoneHistory::instance().GetFullAppZoneHistory();
+            Assert::IsTrue(history.at(L"app-1").front().deviceId.virtualDesktopId == savedDesktop);
+        }
+
+        TEST_METHOD (SaveDataBenchmark)
+        {
+            constexpr size_t entries = 500;
+            constexpr int iterations = 10;
+            WriteAppZoneHistory(entries);
+            AppZoneHistory::instance().LoadData();
+
+            auto measure = [&] {
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < iterations; i++)
+                {
+                    AppZoneHistory::instance().SaveData();
+                }
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+                return elapsed.count() / iterations;
+            };
+
+            const auto fake = measure();
+            Assert::AreEqual(entries * iterations, m_desktops.lookups);
+
+            // The ids saved by Explorer, read from the registry once and cached afterwards
+            VirtualDesktop::SetIdsProvider(nullptr);
+            const auto registry = measure();
+
+            Logger::WriteMessage(std::format(L"Saving {} history entries: fake desktops {:.2f} ms, registry desktops {:.2f} ms\n", entries, fake, registry).c_str());
+        }
+    };
+}
@@ -0,0 +1,121 @@
+#include "pch.h"
+
+#include <FancyZonesLib/WindowPositionPlanner.h>
+
+#include "util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace FancyZonesUnitTests
+{
+    HWND TestWindow(size_t index)
+    {
+        return reinterpret_cast<HWND>(index + 1);
+    }
+
+    TEST_CLASS (WindowPositionPlannerUnitTests)
+    {
+        TEST_METHOD (EmptyBatch)
+        {
+            const auto plan = WindowPositionPlanner::MakePlan({});
+            Assert::IsTrue(plan.deferred.empty());
+            Assert::IsTrue(plan.placed.empty());
+            Assert::AreEqual(size_t{ 0 }, plan.skipped);
+        }
+
+        TEST_METHOD (WindowAtTargetIsSkipped)
+        {
+            const RECT rect{ 0, 0, 960, 1080 };
+            const auto plan = WindowPositionPlanner::MakePlan({
+                { .window = TestWindow(0), .current = rect, .target = rect, .restored = true, .sameThread = true },
+                { .window = TestWindow(1), .current = rect, .target = { 960, 0, 1920, 1080 }, .restored = true, .sameThread = true },
+            });
+
+            Assert::AreEqual(size_t{ 1 }, plan.skipped);
+            Assert::AreEqual(size_t{ 1 }, plan.deferred.size());
+            Assert::IsTrue(plan.deferred.front().window == TestWindow(1));
+        }
+
+        TEST_METHOD (MinimizedAndMaximizedWindowsArePlaced)
+        {
+            // Their current rect isn't their normal position, so they're placed even if it matches
+            const RECT rect{ 0, 0, 960, 1080 };
+            const auto plan = WindowPositionPlanner::MakePlan({
+                { .window = TestWindow(0), .current = rect, .target = rect, .restored = false },
+            });
+
+            Assert::AreEqual(size_t{ 0 }, plan.skipped);
+            Assert::AreEqual(size_t{ 1 }, plan.placed.size());
+            Assert::IsTrue(plan.deferred.empty());
+        }
+
+        TEST_METHOD (OtherThreadsWindowsAreDeferred)
+        {
+            // The transaction waits for the other process to handle the move, so it's not run on the calling thread
+            const RECT rect{ 0, 0, 960, 1080 };
+            const auto plan = WindowPositionPlanner::MakePlan({
+                { .window = TestWindow(0), .current = rect, .target = { 960, 0, 1920, 1080 }, .restored = true, .sameThread = false },
+                { .window = TestWindow(1), .current = rect, .target = { 960, 0, 1920, 1080 }, .restored = true, .sameThread = true },
+            });
+
+            Assert::IsTrue(plan.placed.empty());
+            Assert::AreEqual(size_t{ 2 }, plan.deferred.size());
+            Assert::IsTrue(plan.waitsForOtherThreads);
+        }
+
+        TEST_METHOD (SameThreadWindowsDontWait)
+        {
+            const RECT rect{ 0, 0, 960, 1080 };
+            const auto plan = WindowPositionPlanner::MakePlan({
+                { .window = TestWindow(0), .current = rect, .target = { 960, 0, 1920, 1080 }, .restored = true, .sameThread = true },
+                { .window = TestWindow(1), .current = rect, .target = rect, .restored = true, .sameThread = false },
+            });
+
+            Assert::AreEqual(size_t{ 1 }, plan.deferred.size());
+            Assert::AreEqual(size_t{ 1 }, plan.skipped);
+            Assert::IsFalse(plan.waitsForOtherThreads);
+        }
+
+        TEST_METHOD (LastRequestOfWindowWins)
+        {
+            const RECT rect{ 0, 0, 960, 1080 };
+            const RECT first{ 960, 0, 1920, 1080 };
+            const RECT last{ 0, 0, 1920, 540 };
+            const auto plan = WindowPositionPlanner::MakePlan({
+                { .window = TestWindow(0), .current = rect, .target = first, .restored = true, .sameThread = true },
+                { .window = TestWindow(1), .current = rect, .target = first, .restored = true, .sameThread = true },
+                { .window = TestWindow(0), .current = rect, .target = last, .restored = true, .sameThread = true },
+            });
+
+            Assert::AreEqual(size_t{ 2 }, plan.deferred.size());
+            Assert::IsTrue(plan.deferred[0].window == TestWindow(1));
+            Assert::IsTrue(plan.deferred[1].window == TestWindow(0));
+            CustomAssert::AreEqual(last, plan.deferred[1].target);
+        }
+
+        TEST_METHOD (LayoutSwitchAcrossMonitors)
+        {
+            // 40 zoned windows of other apps on 3 monitors, every fourth one already in its new zone and every tenth one minimized
+            constexpr size_t windowCount = 40;
+            const std::vector<RECT> monitors = { { 0, 0, 1920, 1080 }, { 1920, 0, 3840, 1080 }, { -2560, 0, 0, 1440 } };
+
+            std::vector<WindowPositionPlanner::Request> requests;
+            for (size_t i = 0; i < windowCount; i++)
+            {
+                const auto& monitor = monitors[i % monitors.size()];
+                const LONG width = (monitor.right - monitor.left) / 2;
+                const LONG column = static_cast<LONG>(i % 2);
+                const RECT target{ monitor.left + column * width, monitor.top, monitor.left + (column + 1) * width, monitor.bottom };
+                const RECT current = i % 4 == 0 ? target : monitor;
+                requests.push_back({ .window = TestWindow(i), .current = current, .target = target, .restored = i % 10 != 9, .sameThread = false });
+            }
+
+            const auto plan = WindowPositionPlanner::MakePlan(requests);
+            Assert::AreEqual(size_t{ 10 }, plan.skipped);
+            Assert::AreEqual(size_t{ 4 }, plan.placed.size());
+            Assert::AreEqual(size_t{ 26 }, plan.deferred.size());
+            Assert::IsTrue(plan.waitsForOtherThreads);
+            Assert::AreEqual(windowCount, plan.skipped + plan.placed.size() + plan.deferred.size());
+        }
+    };
+}
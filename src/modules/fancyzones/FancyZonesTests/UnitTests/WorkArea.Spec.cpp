@@ -265,7 +265,7 @@ namespace FancyZonesUnitTests
                 const auto zoneSet = workArea->ZoneSet();
                 zoneSet->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
                 const auto actualZoneIndexSet = zoneSet->GetZoneIndexSetFromWindow(window);
-                Assert::IsFalse(std::vector<ZoneIndex>{} == actualZoneIndexSet);
+                Assert::IsFalse(ZoneIndexSet{} == actualZoneIndexSet);
             }
 
             TEST_METHOD (MoveSizeEndWindowNotAdded)
@@ -281,7 +281,7 @@ namespace FancyZonesUnitTests
 
                 const auto zoneSet = workArea->ZoneSet();
                 const auto actualZoneIndexSet = zoneSet->GetZoneIndexSetFromWindow(window);
-                Assert::IsTrue(std::vector<ZoneIndex>{} == actualZoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{} == actualZoneIndexSet);
             }
 
             TEST_METHOD (MoveSizeEndDifferentWindows)
@@ -321,7 +321,7 @@ namespace FancyZonesUnitTests
                 const auto zoneSet = workArea->ZoneSet();
                 zoneSet->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
                 const auto actualZoneIndex = zoneSet->GetZoneIndexSetFromWindow(window);
-                Assert::IsFalse(std::vector<ZoneIndex>{} == actualZoneIndex); // with invalid point zone remains the same
+                Assert::IsFalse(ZoneIndexSet{} == actualZoneIndex); // with invalid point zone remains the same
             }
 
             TEST_METHOD (MoveWindowIntoZoneByIndex)
@@ -346,7 +346,7 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)1, actualAppZoneHistory.size());
                 const auto& appHistoryArray = actualAppZoneHistory.begin()->second;
                 Assert::AreEqual((size_t)1, appHistoryArray.size());
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == appHistoryArray[0].zoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{ 0 } == appHistoryArray[0].zoneIndexSet);
             }
 
             TEST_METHOD (MoveWindowIntoZoneByDirectionManyTimes)
@@ -363,7 +363,7 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)1, actualAppZoneHistory.size());
                 const auto& appHistoryArray = actualAppZoneHistory.begin()->second;
                 Assert::AreEqual((size_t)1, appHistoryArray.size());
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == appHistoryArray[0].zoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{ 2 } == appHistoryArray[0].zoneIndexSet);
             }
 
             TEST_METHOD (SaveWindowProcessToZoneIndexNullptrWindow)
@@ -406,7 +406,7 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)1, AppZoneHistory::instance().GetFullAppZoneHistory().size());
                 const auto& appHistoryArray1 = AppZoneHistory::instance().GetFullAppZoneHistory().at(processPath);
                 Assert::AreEqual((size_t)1, appHistoryArray1.size());
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == appHistoryArray1[0].zoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{ 0 } == appHistoryArray1[0].zoneIndexSet);
 
                 // add zone without window
                 workArea->ZoneSet()->CalculateZones(RECT{ 0, 0, 1920, 1080 }, 1, 0);
@@ -415,7 +415,7 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)1, AppZoneHistory::instance().GetFullAppZoneHistory().size());
                 const auto& appHistoryArray2 = AppZoneHistory::instance().GetFullAppZoneHistory().at(processPath);
                 Assert::AreEqual((size_t)1, appHistoryArray2.size());
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == appHistoryArray2[0].zoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{ 0 } == appHistoryArray2[0].zoneIndexSet);
             }
 
             TEST_METHOD (SaveWindowProcessToZoneIndexWindowAdded)
@@ -436,7 +436,7 @@ namespace FancyZonesUnitTests
                 Assert::AreEqual((size_t)1, AppZoneHistory::instance().GetFullAppZoneHistory().size());
                 const auto& appHistoryArray = AppZoneHistory::instance().GetFullAppZoneHistory().at(processPath);
                 Assert::AreEqual((size_t)1, appHistoryArray.size());
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == appHistoryArray[0].zoneIndexSet);
+                Assert::IsTrue(ZoneIndexSet{ 2 } == appHistoryArray[0].zoneIndexSet);
 
                 workArea->SaveWindowProcessToZoneIndex(window);
 
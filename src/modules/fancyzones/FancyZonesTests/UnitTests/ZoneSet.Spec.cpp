@@ -194,7 +194,7 @@ namespace FancyZonesUnitTests
                 Assert::IsTrue(zones.size() == 1);
 
                 auto expected = MakeZone({ 10, 10, 50, 50 }, 3);
-                auto actual = set->GetZones()[zones[0]];
+                auto actual = set->GetZones()[zones.front()];
                 compareZones(expected, actual);
             }
 
@@ -211,10 +211,10 @@ namespace FancyZonesUnitTests
                 Assert::IsTrue(actual.size() == 2);
 
                 auto zone1 = MakeZone({ 0, 0, 100, 100 }, 0);
-                compareZones(zone1, set->GetZones()[actual[0]]);
+                compareZones(zone1, set->GetZones()[actual.front()]);
 
                 auto zone3 = MakeZone({ 0, 100, 100, 200 }, 2);
-                compareZones(zone3, set->GetZones()[actual[1]]);
+                compareZones(zone3, set->GetZones()[actual.back()]);
             }
 
             TEST_METHOD (ZoneIndexFromWindowUnknown)
@@ -225,7 +225,7 @@ namespace FancyZonesUnitTests
                 m_set->MoveWindowIntoZoneByIndexSet(window, workArea, { 0 });
 
                 auto actual = m_set->GetZoneIndexSetFromWindow(Mocks::Window());
-                Assert::IsTrue(std::vector<ZoneIndex>{} == actual);
+                Assert::IsTrue(ZoneIndexSet{} == actual);
             }
 
             TEST_METHOD (ZoneIndexFromWindowNull)
@@ -236,7 +236,7 @@ namespace FancyZonesUnitTests
                 m_set->MoveWindowIntoZoneByIndexSet(window, workArea, { 0 });
 
                 auto actual = m_set->GetZoneIndexSetFromWindow(nullptr);
-                Assert::IsTrue(std::vector<ZoneIndex>{} == actual);
+                Assert::IsTrue(ZoneIndexSet{} == actual);
             }
 
             TEST_METHOD (MoveWindowIntoZoneByIndex)
@@ -250,7 +250,7 @@ namespace FancyZonesUnitTests
 
                 HWND window = Mocks::Window();
                 set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 1);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByIndexWithNoZones)
@@ -265,7 +265,7 @@ namespace FancyZonesUnitTests
 
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 100);
-                Assert::IsTrue(std::vector<ZoneIndex>{} == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{} == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByIndexSeveralTimesSameWindow)
@@ -274,13 +274,13 @@ namespace FancyZonesUnitTests
 
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 1);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 2);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByIndexSeveralTimesSameIndex)
@@ -289,11 +289,11 @@ namespace FancyZonesUnitTests
 
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByPointEmpty)
@@ -308,7 +308,7 @@ namespace FancyZonesUnitTests
                 auto window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByPoint(window, Mocks::Window(), POINT{ 1921, 1081 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{} == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{} == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByPointInnerPoint)
@@ -318,7 +318,7 @@ namespace FancyZonesUnitTests
                 auto window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByPoint(window, Mocks::Window(), POINT{ 50, 50 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByPointInnerPointOverlappingZones)
@@ -332,7 +332,7 @@ namespace FancyZonesUnitTests
                 auto window = Mocks::Window();
                 set->MoveWindowIntoZoneByPoint(window, Mocks::Window(), POINT{ 50, 50 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByPointDropAddWindow)
@@ -349,7 +349,7 @@ namespace FancyZonesUnitTests
                 set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
                 set->MoveWindowIntoZoneByPoint(window, Mocks::Window(), POINT{ 50, 50 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == set->GetZoneIndexSetFromWindow(window));
             }
     };
 
@@ -388,14 +388,14 @@ namespace FancyZonesUnitTests
             {
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveLeftNoZones)
             {
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveRightTwice)
@@ -403,7 +403,7 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveLeftTwice)
@@ -411,7 +411,7 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveRightMoreThanZonesCount)
@@ -422,7 +422,7 @@ namespace FancyZonesUnitTests
                     m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
                 }
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveLeftMoreThanZonesCount)
@@ -433,7 +433,7 @@ namespace FancyZonesUnitTests
                     m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
                 }
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByDirectionRight)
@@ -441,10 +441,10 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveRightWithSameWindowAdded)
@@ -452,13 +452,13 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndexSet(window, Mocks::Window(), { 0, 1 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0, 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0, 1 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveRightWithDifferentWindowsAdded)
@@ -468,18 +468,18 @@ namespace FancyZonesUnitTests
                 m_set->MoveWindowIntoZoneByIndex(window1, Mocks::Window(), { 0 });
                 m_set->MoveWindowIntoZoneByIndex(window2, Mocks::Window(), { 1 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window1, Mocks::Window(), VK_RIGHT, true);
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window1, Mocks::Window(), VK_RIGHT, true);
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByDirectionLeft)
@@ -487,10 +487,10 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 2);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveLeftWithSameWindowAdded)
@@ -498,13 +498,13 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndexSet(window, Mocks::Window(), { 1, 2 });
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1, 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 1, 2 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveLeftWithDifferentWindowsAdded)
@@ -514,16 +514,16 @@ namespace FancyZonesUnitTests
                 m_set->MoveWindowIntoZoneByIndex(window1, Mocks::Window(), 1);
                 m_set->MoveWindowIntoZoneByIndex(window2, Mocks::Window(), 2);
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window2));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window2, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window2));
 
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window2, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 1 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window2));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByDirectionWrapAroundRight)
@@ -531,7 +531,7 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 2);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_RIGHT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveWindowIntoZoneByDirectionWrapAroundLeft)
@@ -539,7 +539,7 @@ namespace FancyZonesUnitTests
                 HWND window = Mocks::Window();
                 m_set->MoveWindowIntoZoneByIndex(window, Mocks::Window(), 0);
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window, Mocks::Window(), VK_LEFT, true);
-                Assert::IsTrue(std::vector<ZoneIndex>{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
+                Assert::IsTrue(ZoneIndexSet{ 2 } == m_set->GetZoneIndexSetFromWindow(window));
             }
 
             TEST_METHOD (MoveSecondWindowIntoSameZone)
@@ -550,8 +550,8 @@ namespace FancyZonesUnitTests
                 HWND window2 = Mocks::Window();
                 m_set->MoveWindowIntoZoneByDirectionAndIndex(window2, Mocks::Window(), VK_RIGHT, true);
 
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window1));
-                Assert::IsTrue(std::vector<ZoneIndex>{ 0 } == m_set->GetZoneIndexSetFromWindow(window2));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window1));
+                Assert::IsTrue(ZoneIndexSet{ 0 } == m_set->GetZoneIndexSetFromWindow(window2));
             }
 
             TEST_METHOD (MoveRightMoreThanZoneCountReturnsFalse)
@@ -951,8 +951,7 @@ namespace FancyZonesUnitTests
             // test
             ZoneIndexSet set = bitmask.ToIndexSet();
             Assert::AreEqual(static_cast<size_t>(2), set.size());
-            Assert::AreEqual(static_cast<ZoneIndex>(0), set[0]);
-            Assert::AreEqual(static_cast<ZoneIndex>(64), set[1]);
+            Assert::IsTrue(ZoneIndexSet{ 0, 64 } == set);
         }
 
         TEST_METHOD (BitmaskConvertTest)
@@ -965,10 +964,7 @@ namespace FancyZonesUnitTests
             // test
             ZoneIndexSet actual = bitmask.ToIndexSet();
             Assert::AreEqual(set.size(), actual.size());
-            for (int i = 0; i < set.size(); i++)
-            {
-                Assert::AreEqual(set[i], actual[i]);
-            }
+            Assert::IsTrue(set == actual);
         }
 
         TEST_METHOD (BitmaskConvert2Test)
@@ -977,7 +973,7 @@ namespace FancyZonesUnitTests
             ZoneIndexSet set;
             for (int i = 0; i < 128; i++)
             {
-                set.push_back(i);
+                set.insert(i);
             }
 
             ZoneIndexSetBitmask bitmask = ZoneIndexSetBitmask::FromIndexSet(set);
@@ -985,11 +981,74 @@ namespace FancyZonesUnitTests
             // test
             ZoneIndexSet actual = bitmask.ToIndexSet();
 
-            Assert::AreEqual(set.size(), actual.size());
-            for (int i = 0; i < set.size(); i++)
-            {
-                Assert::AreEqual(set[i], actual[i]);
-            }
+            Assert::AreEqual(static_cast<size_t>(128), actual.size());
+            Assert::IsTrue(set == actual);
+        }
+
+        TEST_METHOD (IterationIsAscending)
+        {
+            // prepare
+            ZoneIndexSet set{ 100, 3, 64, 0, 63, 127 };
+
+            // test
+            std::vector<ZoneIndex> actual(set.begin(), set.end());
+            Assert::IsTrue(std::vector<ZoneIndex>{ 0, 3, 63, 64, 100, 127 } == actual);
+            Assert::AreEqual(static_cast<ZoneIndex>(0), set.front());
+            Assert::AreEqual(static_cast<ZoneIndex>(127), set.back());
+        }
+
+        TEST_METHOD (IndexesOutOfRangeAreIgnored)
+        {
+            // prepare
+            ZoneIndexSet set{ -1, 128, 1000 };
+
+            // test
+            Assert::IsTrue(set.empty());
+            Assert::IsFalse(set.contains(128));
+            Assert::IsTrue(set.begin() == set.end());
+        }
+
+        TEST_METHOD (InsertEraseContains)
+        {
+            // prepare
+            ZoneIndexSet set;
+            set.insert(70);
+            set.insert(70);
+            set.insert(5);
+
+            // test
+            Assert::AreEqual(static_cast<size_t>(2), set.size());
+            Assert::IsTrue(set.contains(70));
+            set.erase(70);
+            Assert::IsFalse(set.contains(70));
+            Assert::IsTrue(ZoneIndexSet{ 5 } == set);
+            set.clear();
+            Assert::IsTrue(set.empty());
+        }
+
+        TEST_METHOD (UnionAndIntersection)
+        {
+            // prepare
+            ZoneIndexSet first{ 1, 2, 65 };
+            ZoneIndexSet second{ 2, 3, 120 };
+
+            // test
+            Assert::IsTrue(ZoneIndexSet{ 1, 2, 3, 65, 120 } == (first | second));
+            Assert::IsTrue(ZoneIndexSet{ 2 } == (first & second));
+        }
+
+        TEST_METHOD (OrderingIsConsistentWithEquality)
+        {
+            // prepare
+            std::map<ZoneIndexSet, int> sets;
+            sets[ZoneIndexSet{ 0 }] = 1;
+            sets[ZoneIndexSet{ 64 }] = 2;
+            sets[ZoneIndexSet{ 0, 64 }] = 3;
+            sets[ZoneIndexSet{ 0 }] = 4;
+
+            // test
+            Assert::AreEqual(static_cast<size_t>(3), sets.size());
+            Assert::AreEqual(4, sets[ZoneIndexSet{ 0 }]);
         }
     };
 }
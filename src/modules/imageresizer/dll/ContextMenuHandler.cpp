@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "ContextMenuHandler.h"
+#include "ImageCodecCache.h"
 #include "Settings.h"
 #include <common/themes/icon_helpers.h>
 #include <common/utils/process_path.h>
@@ -12,11 +13,99 @@
 
 extern HINSTANCE g_hInst_imageResizer;
 
+namespace
+{
+    // Time the menu may spend looking for an image in a large selection before it has to answer
+    constexpr auto c_selectionTimeBudget = std::chrono::milliseconds(50);
+
+    // The file list is written to the resizer in chunks of about this many characters, so it can start
+    // reading before all the files are enumerated
+    constexpr DWORD c_fileListChunkSize = 32 * 1024;
+
+    // Selected files to send to the resizer, owned by the thread that sends them
+    struct FileListTransfer
+    {
+        CAtlFile writePipe;
+        // Files of the selection, taken on the invoking thread so the worker doesn't make COM calls into its apartment
+        STGMEDIUM drop{};
+
+        ~FileListTransfer()
+        {
+            if (drop.tymed != TYMED_NULL)
+            {
+                ReleaseStgMedium(&drop);
+            }
+        }
+    };
+
+    // Batches the file names, one per line, into chunks written to the pipe
+    class FileListWriter
+    {
+    public:
+        explicit FileListWriter(CAtlFile& pipe) :
+            m_pipe(pipe)
+        {
+            m_buffer.reserve(c_fileListChunkSize + MAX_PATH);
+        }
+
+        // Returns false once the resizer stopped reading
+        bool Append(std::wstring_view fileName)
+        {
+            m_buffer.append(fileName);
+            m_buffer.append(L"\r\n");
+            return m_buffer.size() < c_fileListChunkSize || Flush();
+        }
+
+        bool Flush()
+        {
+            if (m_buffer.empty())
+            {
+                return true;
+            }
+
+            const HRESULT hr = m_pipe.Write(m_buffer.data(), static_cast<DWORD>(m_buffer.size() * sizeof(wchar_t)));
+            m_buffer.clear();
+            return SUCCEEDED(hr);
+        }
+
+    private:
+        CAtlFile& m_pipe;
+        std::wstring m_buffer;
+    };
+
+    DWORD WINAPI TransferFileList(void* data)
+    {
+        std::unique_ptr<FileListTransfer> transfer{ static_cast<FileListTransfer*>(data) };
+        FileListWriter writer(transfer->writePipe);
+
+        if (transfer->drop.tymed == TYMED_HGLOBAL)
+        {
+            // Long enough for any path, so each name is copied with a single call
+            std::vector<wchar_t> fileName(UNICODE_STRING_MAX_CHARS + 1);
+            HDROP drop = static_cast<HDROP>(transfer->drop.hGlobal);
+            const UINT fileCount = DragQueryFile(drop, 0xFFFFFFFF, NULL, 0);
+            for (UINT i = 0; i < fileCount; i++)
+            {
+                const UINT length = DragQueryFile(drop, i, fileName.data(), static_cast<UINT>(fileName.size()));
+                if (!writer.Append({ fileName.data(), length }))
+                {
+                    break;
+                }
+            }
+        }
+
+        writer.Flush();
+        // Closing the pipe ends the list
+        return 0;
+    }
+}
+
 CContextMenuHandler::CContextMenuHandler()
 {
     m_pidlFolder = NULL;
     m_pdtobj = NULL;
     app_name = GET_RESOURCE_STRING(IDS_RESIZE_PICTURES);
+    ImageCodecCache::Warm();
 }
 
 CContextMenuHandler::~CContextMenuHandler()
@@ -69,23 +158,27 @@ HRESULT CContextMenuHandler::QueryContextMenu(_In_ HMENU hmenu, UINT indexMenu,
     {
         return E_FAIL;
     }
-    // NB: We just check the first item. We could iterate through more if the first one doesn't meet the criteria
     HDropIterator i(m_pdtobj);
     i.First();
-// Suppressing C26812 warning as the issue is in the shtypes.h library
-#pragma warning(suppress : 26812)
-    PERCEIVED type;
-    PERCEIVEDFLAG flag;
-    LPTSTR pszPath = i.CurrentItem();
-    LPTSTR pszExt = PathFindExtension(pszPath);
+    const auto selection = ImageCodecCache::Current()->FindImage(
+        [&i]() -> std::optional<std::wstring> {
+            if (i.IsDone())
+            {
+                return std::nullopt;
+            }
 
-    // TODO: Instead, detect whether there's a WIC codec installed that can handle this file
-    AssocGetPerceivedType(pszExt, &type, &flag, NULL);
+            LPTSTR pszPath = i.CurrentItem();
+            std::wstring path{ pszPath };
+            free(pszPath);
+            i.Next();
+            return path;
+        },
+        CodecExtensionTable::Clock::now() + c_selectionTimeBudget);
 
-    free(pszPath);
     bool dragDropFlag = false;
-    // If selected file is an image...
-    if (type == PERCEIVED_TYPE_IMAGE)
+    // If an installed codec can decode one of the selected files, or the selection is too large to check in time.
+    // The resizer reports the files it can't read.
+    if (selection != CodecExtensionTable::Selection::NoImages)
     {
         HRESULT hr = E_UNEXPECTED;
         wchar_t strResizePictures[64] = { 0 };
@@ -222,17 +315,43 @@ HRESULT CContextMenuHandler::ResizePictures(CMINVOKECOMMANDINFO* pici, IShellIte
     sa.lpSecurityDescriptor = NULL;
     sa.bInheritHandle = TRUE;
     HRESULT hr = E_FAIL;
-    if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, 0))
+    if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, c_fileListChunkSize * sizeof(wchar_t)))
     {
         hr = HRESULT_FROM_WIN32(GetLastError());
         return hr;
     }
+    CAtlFile readPipe(hReadPipe);
+    auto transfer = std::make_unique<FileListTransfer>();
+    transfer->writePipe.Attach(hWritePipe);
     if (!SetHandleInformation(hWritePipe, HANDLE_FLAG_INHERIT, 0))
     {
         hr = HRESULT_FROM_WIN32(GetLastError());
         return hr;
     }
-    CAtlFile writePipe(hWritePipe);
+
+    // psiItemArray is NULL if called from InvokeCommand. This part is used for the MSI installer. It is not NULL if it is called from Invoke (MSIX).
+    CComPtr<IDataObject> dataObject;
+    if (!psiItemArray)
+    {
+        dataObject = m_pdtobj;
+        hr = m_pdtobj ? S_OK : E_UNEXPECTED;
+    }
+    else
+    {
+        //m_pdtobj will be NULL when invoked from the MSIX build as Initialize is never called (IShellExtInit functions aren't called in case of MSIX).
+        hr = psiItemArray->BindToHandler(nullptr, BHID_DataObject, IID_PPV_ARGS(&dataObject));
+    }
+
+    // Only the file names leave this thread, the worker reads them from the drop data
+    if (SUCCEEDED(hr))
+    {
+        FORMATETC formatetc = { CF_HDROP, NULL, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+        hr = dataObject->GetData(&formatetc, &transfer->drop);
+    }
+    if (FAILED(hr))
+    {
+        return hr;
+    }
 
     CString commandLine;
     commandLine.Format(_T("\"%s\""), lpApplicationName);
@@ -267,7 +386,7 @@ HRESULT CContextMenuHandler::ResizePictures(CMINVOKECOMMANDINFO* pici, IShellIte
     PROCESS_INFORMATION processInformation;
 
     // Start the resizer
-    CreateProcess(
+    const BOOL started = CreateProcess(
         NULL,
         lpszCommandLine,
         NULL,
@@ -279,6 +398,11 @@ HRESULT CContextMenuHandler::ResizePictures(CMINVOKECOMMANDINFO* pici, IShellIte
         &startupInfo,
         &processInformation);
     delete[] lpszCommandLine;
+    if (!started)
+    {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+        return hr;
+    }
     if (!CloseHandle(processInformation.hProcess))
     {
         hr = HRESULT_FROM_WIN32(GetLastError());
@@ -290,41 +414,19 @@ HRESULT CContextMenuHandler::ResizePictures(CMINVOKECOMMANDINFO* pici, IShellIte
         return hr;
     }
 
-    // psiItemArray is NULL if called from InvokeCommand. This part is used for the MSI installer. It is not NULL if it is called from Invoke (MSIX).
-    if (!psiItemArray)
-    {
-        // Stream the input files
-        HDropIterator i(m_pdtobj);
-        for (i.First(); !i.IsDone(); i.Next())
-        {
-            CString fileName(i.CurrentItem());
-            fileName.Append(_T("\r\n"));
+    // The resizer has its own handle to the read end, closing ours lets writes fail if it exits early
+    readPipe.Close();
 
-            writePipe.Write(fileName, fileName.GetLength() * sizeof(TCHAR));
-        }
+    // Enumerate and stream the files off the invoking thread, the worker keeps the dll loaded until it's done
+    if (SHCreateThread(TransferFileList, transfer.get(), CTF_FREELIBANDEXIT, nullptr))
+    {
+        transfer.release();
     }
     else
     {
-        //m_pdtobj will be NULL when invoked from the MSIX build as Initialize is never called (IShellExtInit functions aren't called in case of MSIX).
-        DWORD fileCount = 0;
-        // Gets the list of files currently selected using the IShellItemArray
-        psiItemArray->GetCount(&fileCount);
-        // Iterate over the list of files
-        for (DWORD i = 0; i < fileCount; i++)
-        {
-            IShellItem* shellItem;
-            psiItemArray->GetItemAt(i, &shellItem);
-            LPWSTR itemName;
-            // Retrieves the entire file system path of the file from its shell item
-            shellItem->GetDisplayName(SIGDN_FILESYSPATH, &itemName);
-            CString fileName(itemName);
-            fileName.Append(_T("\r\n"));
-            // Write the file path into the input stream for image resizer
-            writePipe.Write(fileName, fileName.GetLength() * sizeof(TCHAR));
-        }
+        TransferFileList(transfer.release());
     }
 
-    writePipe.Close();
     hr = S_OK;
     return hr;
 }
@@ -362,26 +464,38 @@ HRESULT __stdcall CContextMenuHandler::GetState(IShellItemArray* psiItemArray, B
         *pCmdState = ECS_HIDDEN;
         return S_OK;
     }
-    // Hide if the file is not an image
+    // Hide if none of the files is an image
     *pCmdState = ECS_HIDDEN;
-    // Suppressing C26812 warning as the issue is in the shtypes.h library
-#pragma warning(suppress : 26812)
-    PERCEIVED type;
-    PERCEIVEDFLAG flag;
-    IShellItem* shellItem;
-    //Check extension of first item in the list (the item which is right-clicked on)
-    psiItemArray->GetItemAt(0, &shellItem);
-    LPTSTR pszPath;
-    // Retrieves the entire file system path of the file from its shell item
-    shellItem->GetDisplayName(SIGDN_FILESYSPATH, &pszPath);
-    LPTSTR pszExt = PathFindExtension(pszPath);
-
-    // TODO: Instead, detect whether there's a WIC codec installed that can handle this file
-    AssocGetPerceivedType(pszExt, &type, &flag, NULL);
-
-    CoTaskMemFree(pszPath);
-    // If selected file is an image...
-    if (type == PERCEIVED_TYPE_IMAGE)
+    DWORD fileCount = 0;
+    psiItemArray->GetCount(&fileCount);
+    DWORD index = 0;
+    const auto selection = ImageCodecCache::Current()->FindImage(
+        [&]() -> std::optional<std::wstring> {
+            while (index < fileCount)
+            {
+                CComPtr<IShellItem> shellItem;
+                LPWSTR pszPath = nullptr;
+                // Retrieves the entire file system path of the file from its shell item
+                if (SUCCEEDED(psiItemArray->GetItemAt(index++, &shellItem)) &&
+                    SUCCEEDED(shellItem->GetDisplayName(SIGDN_FILESYSPATH, &pszPath)))
+                {
+                    std::wstring path{ pszPath };
+                    CoTaskMemFree(pszPath);
+                    return path;
+                }
+            }
+
+            return std::nullopt;
+        },
+        fOkToBeSlow ? CodecExtensionTable::Clock::time_point::max() : CodecExtensionTable::Clock::now() + c_selectionTimeBudget);
+
+    // Explorer calls again with fOkToBeSlow set
+    if (selection == CodecExtensionTable::Selection::Pending)
+    {
+        return E_PENDING;
+    }
+
+    if (selection == CodecExtensionTable::Selection::HasImages)
     {
         *pCmdState = ECS_ENABLED;
     }
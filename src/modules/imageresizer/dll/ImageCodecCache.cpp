@@ -0,0 +1,192 @@
+#include "pch.h"
+#include "ImageCodecCache.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <wincodec.h>
+
+namespace
+{
+    // Instances of CATID_WICBitmapDecoders, under HKLM for every user and under HKCU for decoders registered per user
+    const wchar_t c_decodersKey[] = L"SOFTWARE\\Classes\\CLSID\\{7ED96837-96F0-4812-B211-F13C24117ED3}\\Instance";
+    // Parent of the per-user decoders key, watched while the user has none registered
+    const wchar_t c_userClassesKey[] = L"SOFTWARE\\Classes\\CLSID";
+
+    // Decoders that ship with Windows, used until the installed ones are enumerated or when they can't be
+    const std::vector<std::wstring> c_inboxDecoders = {
+        L".bmp,.dib,.rle",
+        L".gif",
+        L".ico,.icon",
+        L".jpeg,.jpe,.jpg,.jfif,.exif",
+        L".png",
+        L".tiff,.tif",
+        L".wdp,.jxr",
+        L".dds",
+    };
+
+    // Time before a failed enumeration is tried again
+    constexpr auto c_retryInterval = std::chrono::seconds(30);
+
+    std::mutex cacheMutex;
+    std::shared_ptr<const CodecExtensionTable> cachedTable;
+    // Bumped on every decoder change, the table is up to date while it was enumerated at the current one
+    size_t decodersGeneration = 1;
+    size_t enumeratedGeneration = 0;
+    bool refreshing = false;
+    std::chrono::steady_clock::time_point nextRefresh{};
+
+    bool decodersWatched = false;
+    HANDLE decodersChanged = nullptr;
+    HKEY machineDecodersKey = nullptr;
+    HKEY userDecodersKey = nullptr;
+
+    std::vector<std::wstring> EnumerateDecoderExtensions()
+    {
+        std::vector<std::wstring> result;
+
+        CComPtr<IWICImagingFactory> factory;
+        CComPtr<IEnumUnknown> decoders;
+        if (FAILED(factory.CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER)) ||
+            FAILED(factory->CreateComponentEnumerator(WICDecoder, WICComponentEnumerateDefault, &decoders)))
+        {
+            return result;
+        }
+
+        CComPtr<IUnknown> decoder;
+        while (decoders->Next(1, &decoder, nullptr) == S_OK)
+        {
+            CComQIPtr<IWICBitmapCodecInfo> info(decoder);
+            decoder.Release();
+
+            UINT length = 0;
+            if (!info || FAILED(info->GetFileExtensions(0, nullptr, &length)) || length == 0)
+            {
+                continue;
+            }
+
+            std::wstring extensions(length, L'\0');
+            if (SUCCEEDED(info->GetFileExtensions(length, extensions.data(), &length)))
+            {
+                extensions.resize(length - 1);
+                result.push_back(std::move(extensions));
+            }
+        }
+
+        return result;
+    }
+
+    // The keys are opened again on every change, which also picks up the per-user key once it's created
+    void WatchDecoders()
+    {
+        for (HKEY* key : { &machineDecodersKey, &userDecodersKey })
+        {
+            if (*key)
+            {
+                RegCloseKey(*key);
+                *key = nullptr;
+            }
+        }
+
+        RegOpenKeyExW(HKEY_LOCAL_MACHINE, c_decodersKey, 0, KEY_NOTIFY, &machineDecodersKey);
+        const bool userDecoders = RegOpenKeyExW(HKEY_CURRENT_USER, c_decodersKey, 0, KEY_NOTIFY, &userDecodersKey) == ERROR_SUCCESS;
+        if (!userDecoders)
+        {
+            RegOpenKeyExW(HKEY_CURRENT_USER, c_userClassesKey, 0, KEY_NOTIFY, &userDecodersKey);
+        }
+
+        const DWORD filter = REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC;
+        if (machineDecodersKey)
+        {
+            RegNotifyChangeKeyValue(machineDecodersKey, TRUE, filter, decodersChanged, TRUE);
+        }
+        if (userDecodersKey)
+        {
+            RegNotifyChangeKeyValue(userDecodersKey, userDecoders, filter, decodersChanged, TRUE);
+        }
+    }
+
+    // Returns true when the decoders may have changed since the last call, which includes the first call
+    bool DecodersChanged()
+    {
+        if (decodersWatched)
+        {
+            if (!decodersChanged || WaitForSingleObject(decodersChanged, 0) != WAIT_OBJECT_0)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            decodersWatched = true;
+            decodersChanged = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        }
+
+        // Rearm before enumerating, so a change made meanwhile isn't missed
+        if (decodersChanged)
+        {
+            WatchDecoders();
+        }
+
+        return true;
+    }
+
+    DWORD WINAPI RefreshTable(void* data)
+    {
+        const auto generation = reinterpret_cast<size_t>(data);
+        auto extensions = EnumerateDecoderExtensions();
+
+        std::scoped_lock lock(cacheMutex);
+        refreshing = false;
+        if (extensions.empty())
+        {
+            // Keeps the previous table, enumerating again right away would most likely fail the same way
+            nextRefresh = std::chrono::steady_clock::now() + c_retryInterval;
+            return 0;
+        }
+
+        cachedTable = std::make_shared<const CodecExtensionTable>(extensions);
+        enumeratedGeneration = generation;
+        return 0;
+    }
+}
+
+std::shared_ptr<const CodecExtensionTable> ImageCodecCache::Current()
+{
+    std::unique_lock lock(cacheMutex);
+    if (!cachedTable)
+    {
+        cachedTable = std::make_shared<const CodecExtensionTable>(c_inboxDecoders);
+    }
+
+    if (DecodersChanged())
+    {
+        decodersGeneration++;
+        nextRefresh = {};
+    }
+
+    auto table = cachedTable;
+    if (enumeratedGeneration == decodersGeneration || refreshing || std::chrono::steady_clock::now() < nextRefresh)
+    {
+        return table;
+    }
+
+    // Enumerating the decoders loads their DLLs, which the calling shell thread must not wait for
+    refreshing = true;
+    const auto generation = decodersGeneration;
+    lock.unlock();
+    if (!SHCreateThread(RefreshTable, reinterpret_cast<void*>(generation), CTF_COINIT_MTA | CTF_FREELIBANDEXIT, nullptr))
+    {
+        lock.lock();
+        refreshing = false;
+        nextRefresh = std::chrono::steady_clock::now() + c_retryInterval;
+    }
+
+    return table;
+}
+
+void ImageCodecCache::Warm()
+{
+    Current();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <memory>
+
+#include <common/utils/CodecExtensionTable.h>
+
+// Extensions readable by the WIC decoders installed on the machine, shared by the handlers in the process.
+// The table is built on a background thread and rebuilt after a decoder is registered or removed, the
+// decoders that ship with Windows are used until it's ready.
+namespace ImageCodecCache
+{
+    // Never waits for the decoders to be enumerated
+    std::shared_ptr<const CodecExtensionTable> Current();
+
+    // Starts building the table, so it's ready by the time a menu is shown
+    void Warm();
+}
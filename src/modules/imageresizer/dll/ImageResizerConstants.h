@@ -9,4 +9,7 @@ namespace ImageResizerConstants
     // Name of the ImageResizer save folder.
     inline const std::wstring ModuleOldSaveFolderKey = L"ImageResizer";
     inline const std::wstring ModuleSaveFolderKey = L"Image Resizer";
+
+    // Name of the shared memory section the settings are published to.
+    inline const std::wstring SharedSettingsName = L"Local\\PowerToys_ImageResizer_Settings";
 }
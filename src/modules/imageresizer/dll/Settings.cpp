@@ -13,6 +13,9 @@ namespace
     const wchar_t c_rootRegPath[] = L"Software\\Microsoft\\ImageResizer";
     const wchar_t c_enabled[] = L"Enabled";
 
+    // Bump when CSettings::SharedSettings changes
+    constexpr uint32_t c_sharedSettingsLayout = 1;
+
     unsigned int RegReadInteger(const std::wstring& valueName, unsigned int defaultValue)
     {
         DWORD type = REG_DWORD;
@@ -45,31 +48,32 @@ namespace
 
 CSettings::CSettings()
 {
-    std::wstring oldSavePath = PTSettingsHelper::get_module_save_folder_location(ImageResizerConstants::ModuleOldSaveFolderKey);
-    std::wstring savePath = PTSettingsHelper::get_module_save_folder_location(ImageResizerConstants::ModuleSaveFolderKey);
-    std::error_code ec;
-    if (std::filesystem::exists(oldSavePath, ec))
+    // The context menu handler is created for every right click in Explorer, it only goes to the disk
+    // when the settings aren't published to shared memory.
+    if (!ReadSharedSettings())
     {
-        std::filesystem::copy(oldSavePath, savePath, std::filesystem::copy_options::recursive, ec);
-        std::filesystem::remove_all(oldSavePath, ec);
+        Load();
     }
-
-    jsonFilePath = savePath + std::wstring(c_imageResizerDataFilePath);
-    Load();
 }
 
 void CSettings::Save()
 {
+    EnsureLoaded();
+
     json::JsonObject jsonData;
 
     jsonData.SetNamedValue(c_enabled, json::value(settings.enabled));
 
     json::to_file(jsonFilePath, jsonData);
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    PublishSharedSettings();
 }
 
 void CSettings::Load()
 {
+    ResolvePaths();
+    loaded = true;
+
     if (!std::filesystem::exists(jsonFilePath))
     {
         MigrateFromRegistry();
@@ -79,11 +83,94 @@ void CSettings::Load()
     else
     {
         ParseJson();
+        PublishSharedSettings();
     }
 }
 
+void CSettings::EnsureLoaded()
+{
+    if (!loaded)
+    {
+        Load();
+    }
+}
+
+void CSettings::ResolvePaths()
+{
+    if (!jsonFilePath.empty())
+    {
+        return;
+    }
+
+    std::wstring oldSavePath = PTSettingsHelper::get_module_save_folder_location(ImageResizerConstants::ModuleOldSaveFolderKey);
+    std::wstring savePath = PTSettingsHelper::get_module_save_folder_location(ImageResizerConstants::ModuleSaveFolderKey);
+    std::error_code ec;
+    if (std::filesystem::exists(oldSavePath, ec))
+    {
+        std::filesystem::copy(oldSavePath, savePath, std::filesystem::copy_options::recursive, ec);
+        std::filesystem::remove_all(oldSavePath, ec);
+    }
+
+    jsonFilePath = savePath + std::wstring(c_imageResizerDataFilePath);
+}
+
+bool CSettings::ReadSharedSettings()
+{
+    if (!sharedSettings)
+    {
+        sharedSettings = shared_settings::section<SharedSettings>::open(ImageResizerConstants::SharedSettingsName, c_sharedSettingsLayout);
+        if (!sharedSettings)
+        {
+            return false;
+        }
+    }
+
+    SharedSettings shared{};
+    switch (sharedSettings->data().read(shared, sharedSettingsGeneration))
+    {
+    case shared_settings::read_result::updated:
+        settings.enabled = shared.enabled;
+        return true;
+    case shared_settings::read_result::unchanged:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void CSettings::PublishSharedSettings()
+{
+    if (!sharedSettingsWritable)
+    {
+        // Fails when the section was created by a process this one can't write to, readers then keep
+        // falling back to the file.
+        auto writable = shared_settings::section<SharedSettings>::create(ImageResizerConstants::SharedSettingsName, c_sharedSettingsLayout);
+        if (!writable)
+        {
+            return;
+        }
+
+        sharedSettings = std::move(writable);
+        sharedSettingsWritable = true;
+    }
+
+    sharedSettingsGeneration = sharedSettings->data().write(SharedSettings{ .enabled = settings.enabled });
+}
+
 void CSettings::Reload()
 {
+    // Whoever changes the settings publishes them, the file only has to be checked when nothing is published.
+    if (ReadSharedSettings())
+    {
+        return;
+    }
+
+    if (!loaded)
+    {
+        Load();
+        return;
+    }
+
     // Load json settings from data file if it is modified in the meantime.
     FILETIME lastModifiedTime{};
     if (LastModifiedTime(jsonFilePath, &lastModifiedTime) &&
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <common/SettingsAPI/shared_settings.h>
+
+#include <optional>
+
 class CSettings
 {
 public:
@@ -13,6 +17,7 @@ public:
 
     inline void SetEnabled(bool enabled)
     {
+        EnsureLoaded();
         settings.enabled = enabled;
         Save();
     }
@@ -26,13 +31,28 @@ private:
         bool enabled{ true };
     };
 
+    // Part of the settings published to shared memory, everything the context menu handler needs
+    struct SharedSettings
+    {
+        bool enabled;
+    };
+
+    void EnsureLoaded();
+    void ResolvePaths();
+    bool ReadSharedSettings();
+    void PublishSharedSettings();
     void Reload();
     void MigrateFromRegistry();
     void ParseJson();
 
     Settings settings;
+    bool loaded{ false };
     std::wstring jsonFilePath;
-    FILETIME lastLoadedTime;
+    FILETIME lastLoadedTime{};
+
+    std::optional<shared_settings::section<SharedSettings>> sharedSettings;
+    bool sharedSettingsWritable{ false };
+    uint64_t sharedSettingsGeneration{ 0 };
 };
 
 CSettings& CSettingsInstance();
\ No newline at end of file
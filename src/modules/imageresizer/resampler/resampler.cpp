@@ -0,0 +1,225 @@
+#include "resampler_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <new>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    // Destination rows filtered together, the horizontal pass is repeated for the source rows shared by two bands
+    constexpr uint32_t band_rows = 64;
+
+    double kernel_support(resampler_kernel kernel) noexcept
+    {
+        switch (kernel)
+        {
+        case RESAMPLER_KERNEL_BOX:
+            return 0.5;
+        case RESAMPLER_KERNEL_BICUBIC:
+            return 2.0;
+        default:
+            return 3.0;
+        }
+    }
+
+    double sinc(double x) noexcept
+    {
+        if (x == 0.0)
+        {
+            return 1.0;
+        }
+
+        x *= pi;
+        return std::sin(x) / x;
+    }
+
+    double kernel_weight(resampler_kernel kernel, double x) noexcept
+    {
+        switch (kernel)
+        {
+        case RESAMPLER_KERNEL_BOX:
+            return x >= -0.5 && x < 0.5 ? 1.0 : 0.0;
+        case RESAMPLER_KERNEL_BICUBIC:
+        {
+            // Catmull-Rom
+            constexpr double a = -0.5;
+            x = std::abs(x);
+            if (x < 1.0)
+            {
+                return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+            }
+
+            if (x < 2.0)
+            {
+                return ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a;
+            }
+
+            return 0.0;
+        }
+        default:
+            return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        }
+    }
+
+    bool valid(const resampler_image* image) noexcept
+    {
+        return image && image->pixels && image->width > 0 && image->height > 0 && image->stride >= size_t{ image->width } * 4;
+    }
+}
+
+namespace resampler
+{
+    contributions compute_contributions(uint32_t source_size, uint32_t destination_size, resampler_kernel kernel)
+    {
+        const double scale = static_cast<double>(source_size) / destination_size;
+        // The kernel is stretched when downscaling, so every source pixel contributes
+        const double filter_scale = std::max(scale, 1.0);
+        const double support = kernel_support(kernel) * filter_scale;
+        const int source_last = static_cast<int>(source_size) - 1;
+
+        contributions result;
+        result.taps = std::min(static_cast<int>(std::ceil(support * 2)) + 1, static_cast<int>(source_size));
+        result.first.resize(destination_size);
+        result.weights.resize(size_t{ destination_size } * result.taps);
+
+        std::vector<double> window;
+        for (uint32_t i = 0; i < destination_size; i++)
+        {
+            const double center = (i + 0.5) * scale - 0.5;
+            const int left = std::clamp(static_cast<int>(std::ceil(center - support)), 0, source_last);
+            const int right = std::clamp(static_cast<int>(std::floor(center + support)), left, source_last);
+
+            window.assign(right - left + 1, 0.0);
+            double total = 0.0;
+            for (int s = left; s <= right; s++)
+            {
+                window[s - left] = kernel_weight(kernel, (s - center) / filter_scale);
+                total += window[s - left];
+            }
+
+            // Nothing in reach, like a box upscaled exactly between two pixels
+            if (total == 0.0)
+            {
+                const int nearest = std::clamp(static_cast<int>(std::lround(center)), left, right);
+                window[nearest - left] = 1.0;
+                total = 1.0;
+            }
+
+            const int first = std::min(left, static_cast<int>(source_size) - result.taps);
+            result.first[i] = first;
+            float* weights = &result.weights[size_t{ i } * result.taps];
+            for (int s = left; s <= right && s - first < result.taps; s++)
+            {
+                weights[s - first] = static_cast<float>(window[s - left] / total);
+            }
+        }
+
+        return result;
+    }
+
+    resampler_status resize(const resampler_image& source, const resampler_image& destination, resampler_kernel kernel, uint32_t threads, instruction_set set)
+    {
+        try
+        {
+            const contributions horizontal = compute_contributions(source.width, destination.width, kernel);
+            const contributions vertical = compute_contributions(source.height, destination.height, kernel);
+            const row_operations& ops = operations(set);
+
+            const size_t row_floats = size_t{ destination.width } * 4;
+            const uint32_t band_count = (destination.height + band_rows - 1) / band_rows;
+            if (threads == 0)
+            {
+                threads = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+
+            threads = std::min(threads, band_count);
+
+            std::atomic<uint32_t> next_band = 0;
+            std::atomic<bool> out_of_memory = false;
+            auto work = [&]() noexcept {
+                try
+                {
+                    std::vector<float> widened(size_t{ source.width } * 4);
+                    std::vector<float> filtered;
+                    std::vector<const float*> rows(vertical.taps);
+
+                    for (uint32_t band; (band = next_band++) < band_count && !out_of_memory;)
+                    {
+                        const uint32_t first_row = band * band_rows;
+                        const uint32_t last_row = std::min(first_row + band_rows, destination.height);
+                        const int first_source_row = vertical.first[first_row];
+                        const int source_rows = vertical.first[last_row - 1] + vertical.taps - first_source_row;
+
+                        filtered.resize(source_rows * row_floats);
+                        for (int row = 0; row < source_rows; row++)
+                        {
+                            ops.widen(source.pixels + (first_source_row + row) * source.stride, widened.data(), source.width);
+                            ops.horizontal(widened.data(), filtered.data() + row * row_floats, horizontal);
+                        }
+
+                        for (uint32_t row = first_row; row < last_row; row++)
+                        {
+                            for (int tap = 0; tap < vertical.taps; tap++)
+                            {
+                                rows[tap] = filtered.data() + (vertical.first[row] + tap - first_source_row) * row_floats;
+                            }
+
+                            ops.vertical(rows.data(), &vertical.weights[size_t{ row } * vertical.taps], vertical.taps, destination.pixels + row * destination.stride, static_cast<uint32_t>(row_floats));
+                        }
+                    }
+                }
+                catch (const std::bad_alloc&)
+                {
+                    out_of_memory = true;
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for (uint32_t i = 1; i < threads; i++)
+            {
+                try
+                {
+                    workers.emplace_back(work);
+                }
+                catch (const std::system_error&)
+                {
+                    // The bands are shared by whichever threads could be started
+                    break;
+                }
+            }
+
+            work();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+
+            return out_of_memory ? RESAMPLER_OUT_OF_MEMORY : RESAMPLER_OK;
+        }
+        catch (const std::bad_alloc&)
+        {
+            return RESAMPLER_OUT_OF_MEMORY;
+        }
+    }
+}
+
+extern "C" resampler_status resampler_resize(const resampler_image* source, const resampler_image* destination, resampler_kernel kernel, uint32_t threads)
+{
+    if (!valid(source) || !valid(destination) || kernel < RESAMPLER_KERNEL_BOX || kernel > RESAMPLER_KERNEL_LANCZOS3)
+    {
+        return RESAMPLER_INVALID_ARGUMENT;
+    }
+
+    return resampler::resize(*source, *destination, kernel, threads, resampler::best_instruction_set());
+}
+
+extern "C" const char* resampler_instruction_set(void)
+{
+    return resampler::name(resampler::best_instruction_set());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// C interface of the native resampler, so the resizer can scale decoded buffers without going
+// through the platform scaler.
+//
+// Images are 32 bits per pixel with 4 interleaved 8-bit channels. The channel order is preserved,
+// so both BGRA and RGBA work. Alpha should be premultiplied (Pbgra32 in WIC), otherwise colors of
+// transparent pixels bleed into their neighbors.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifdef RESAMPLER_EXPORTS
+#define RESAMPLER_API __declspec(dllexport)
+#else
+#define RESAMPLER_API __declspec(dllimport)
+#endif
+#elif defined(RESAMPLER_EXPORTS)
+#define RESAMPLER_API __attribute__((visibility("default")))
+#else
+#define RESAMPLER_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum resampler_kernel
+{
+    RESAMPLER_KERNEL_BOX = 0,
+    RESAMPLER_KERNEL_BICUBIC = 1,
+    RESAMPLER_KERNEL_LANCZOS3 = 2,
+} resampler_kernel;
+
+typedef enum resampler_status
+{
+    RESAMPLER_OK = 0,
+    RESAMPLER_INVALID_ARGUMENT = 1,
+    RESAMPLER_OUT_OF_MEMORY = 2,
+} resampler_status;
+
+typedef struct resampler_image
+{
+    uint8_t* pixels;
+    uint32_t width;
+    uint32_t height;
+    // Bytes between the starts of two rows, at least width * 4
+    size_t stride;
+} resampler_image;
+
+// Scales source into destination, both sizes are taken from the images. The work is split in bands of
+// rows processed by up to threads threads, 0 uses one per hardware thread.
+RESAMPLER_API resampler_status resampler_resize(const resampler_image* source, const resampler_image* destination, resampler_kernel kernel, uint32_t threads);
+
+// Name of the instruction set the resampler uses on this machine: "avx2", "sse2", "neon" or "scalar"
+RESAMPLER_API const char* resampler_instruction_set(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,214 @@
+// Times the resampler on synthetic images and compares every run with the scalar single threaded one,
+// which is the quality baseline the vectorized code has to match.
+//
+// resampler_benchmark [--check] [width height]
+// --check exits with an error when a run differs from the baseline by more than one level.
+
+#include "resampler_internal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace resampler;
+
+    struct image
+    {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> pixels;
+
+        image(uint32_t width, uint32_t height) :
+            width(width), height(height), pixels(size_t{ width } * height * 4)
+        {
+        }
+
+        resampler_image view() noexcept
+        {
+            return { pixels.data(), width, height, size_t{ width } * 4 };
+        }
+    };
+
+    // Gradients with noise and hard edges, so every kernel has detail to smooth and ring on
+    image make_source(uint32_t width, uint32_t height)
+    {
+        image result(width, height);
+        uint32_t noise = 12345;
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                noise = noise * 1664525 + 1013904223;
+                uint8_t* pixel = &result.pixels[(size_t{ y } * width + x) * 4];
+                const bool edge = ((x / 37) + (y / 53)) % 2 == 0;
+                pixel[0] = static_cast<uint8_t>(x * 255 / width);
+                pixel[1] = static_cast<uint8_t>(y * 255 / height);
+                pixel[2] = edge ? 230 : static_cast<uint8_t>(noise >> 24);
+                pixel[3] = 255;
+            }
+        }
+
+        return result;
+    }
+
+    struct run
+    {
+        double seconds;
+        int max_difference;
+    };
+
+    run measure(image& source, image& destination, const image* baseline, resampler_kernel kernel, uint32_t threads, instruction_set set, int repeats)
+    {
+        const auto source_view = source.view();
+        const auto destination_view = destination.view();
+        double best = 1e30;
+        for (int i = 0; i < repeats; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (resize(source_view, destination_view, kernel, threads, set) != RESAMPLER_OK)
+            {
+                std::fprintf(stderr, "resize failed\n");
+                std::exit(2);
+            }
+
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        int max_difference = 0;
+        if (baseline)
+        {
+            for (size_t i = 0; i < destination.pixels.size(); i++)
+            {
+                max_difference = std::max(max_difference, std::abs(destination.pixels[i] - baseline->pixels[i]));
+            }
+        }
+
+        return { best, max_difference };
+    }
+
+    const char* kernel_name(resampler_kernel kernel) noexcept
+    {
+        switch (kernel)
+        {
+        case RESAMPLER_KERNEL_BOX:
+            return "box";
+        case RESAMPLER_KERNEL_BICUBIC:
+            return "bicubic";
+        default:
+            return "lanczos3";
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool check = false;
+    uint32_t width = 6000;
+    uint32_t height = 4000;
+    int argument = 1;
+    if (argument < argc && std::strcmp(argv[argument], "--check") == 0)
+    {
+        check = true;
+        argument++;
+    }
+
+    if (argument + 1 < argc)
+    {
+        width = static_cast<uint32_t>(std::strtoul(argv[argument], nullptr, 10));
+        height = static_cast<uint32_t>(std::strtoul(argv[argument + 1], nullptr, 10));
+    }
+
+    if (width < 8 || height < 8)
+    {
+        std::fprintf(stderr, "usage: resampler_benchmark [--check] [width height]\n");
+        return 2;
+    }
+
+    // The check always splits the work, to cover the bands on machines with a single core
+    const uint32_t hardware_threads = check ? 4 : std::max(std::thread::hardware_concurrency(), 1u);
+    const int repeats = check ? 1 : 3;
+    const instruction_set best = best_instruction_set();
+
+    struct scenario
+    {
+        const char* name;
+        uint32_t source_width, source_height, destination_width, destination_height;
+    };
+
+    const scenario scenarios[] = {
+        { "down", width, height, std::max(width * 8 / 25, 1u), std::max(height * 8 / 25, 1u) },
+        { "up", width / 4, height / 4, width / 2, height / 2 },
+    };
+
+    std::printf("instruction set: %s, hardware threads: %u\n", name(best), hardware_threads);
+    std::printf("speed in source megapixels per second, difference in levels from the scalar single threaded baseline\n\n");
+    std::printf("%-5s %-9s %-17s %-7s %10s %9s %5s\n", "scale", "kernel", "size", "set", "threads", "MP/s", "diff");
+
+    struct configuration
+    {
+        instruction_set set;
+        uint32_t threads;
+    };
+
+    std::vector<instruction_set> sets = { instruction_set::scalar };
+    if (best == instruction_set::avx2)
+    {
+        sets.push_back(instruction_set::sse2);
+    }
+
+    if (best != instruction_set::scalar)
+    {
+        sets.push_back(best);
+    }
+
+    std::vector<uint32_t> thread_counts = { 1 };
+    if (hardware_threads > 1)
+    {
+        thread_counts.push_back(hardware_threads);
+    }
+
+    std::vector<configuration> configurations;
+    for (auto threads : thread_counts)
+    {
+        for (auto set : sets)
+        {
+            if (set != instruction_set::scalar || threads != 1)
+            {
+                configurations.push_back({ set, threads });
+            }
+        }
+    }
+
+    bool failed = false;
+    for (const auto& s : scenarios)
+    {
+        image source = make_source(s.source_width, s.source_height);
+        const double megapixels = static_cast<double>(s.source_width) * s.source_height / 1e6;
+        char size[32];
+        std::snprintf(size, sizeof(size), "%ux%u", s.destination_width, s.destination_height);
+
+        for (auto kernel : { RESAMPLER_KERNEL_BOX, RESAMPLER_KERNEL_BICUBIC, RESAMPLER_KERNEL_LANCZOS3 })
+        {
+            image baseline(s.destination_width, s.destination_height);
+            const run reference = measure(source, baseline, nullptr, kernel, 1, instruction_set::scalar, repeats);
+            std::printf("%-5s %-9s %-17s %-7s %10u %9.1f %5s\n", s.name, kernel_name(kernel), size, "scalar", 1u, megapixels / reference.seconds, "-");
+
+            for (const configuration& c : configurations)
+            {
+                image destination(s.destination_width, s.destination_height);
+                const run result = measure(source, destination, &baseline, kernel, c.threads, c.set, repeats);
+                std::printf("%-5s %-9s %-17s %-7s %10u %9.1f %5d\n", s.name, kernel_name(kernel), size, name(c.set), c.threads, megapixels / result.seconds, result.max_difference);
+                failed |= result.max_difference > 1;
+            }
+        }
+    }
+
+    return check && failed ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "resampler.h"
+
+#include <vector>
+
+namespace resampler
+{
+    enum class instruction_set
+    {
+        scalar,
+        sse2,
+        avx2,
+        neon,
+    };
+
+    // Best instruction set supported by the build and the processor
+    instruction_set best_instruction_set() noexcept;
+    const char* name(instruction_set set) noexcept;
+
+    // Filter taps of every destination index along one axis. Each index reads taps consecutive source
+    // indexes starting at first, windows near the edges are shifted inside the image and padded with
+    // zero weights so all of them have the same length.
+    struct contributions
+    {
+        int taps = 0;
+        std::vector<int> first;
+        std::vector<float> weights;
+    };
+
+    contributions compute_contributions(uint32_t source_size, uint32_t destination_size, resampler_kernel kernel);
+
+    // Operations on rows of interleaved 4 channel pixels, implemented for each instruction set
+    struct row_operations
+    {
+        // Converts width pixels to floats
+        void (*widen)(const uint8_t* source, float* destination, uint32_t width);
+        // Filters a widened row into weights.first.size() pixels
+        void (*horizontal)(const float* source, float* destination, const contributions& weights);
+        // Sums taps filtered rows with their weights into count bytes, count is a multiple of 4
+        void (*vertical)(const float* const* rows, const float* weights, int taps, uint8_t* destination, uint32_t count);
+    };
+
+    const row_operations& operations(instruction_set set) noexcept;
+
+    resampler_status resize(const resampler_image& source, const resampler_image& destination, resampler_kernel kernel, uint32_t threads, instruction_set set);
+}
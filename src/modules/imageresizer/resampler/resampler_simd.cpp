@@ -0,0 +1,353 @@
+#include "resampler_internal.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define RESAMPLER_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define RESAMPLER_AVX2_FUNCTION
+#else
+#define RESAMPLER_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define RESAMPLER_ARM64
+#include <arm_neon.h>
+#endif
+
+// The implementations only differ from the scalar one by the order some of the products are added in,
+// which can change a channel by one level at most.
+namespace
+{
+    using namespace resampler;
+
+    uint8_t to_byte(float value) noexcept
+    {
+        return static_cast<uint8_t>(std::nearbyint(std::clamp(value, 0.0f, 255.0f)));
+    }
+
+    void widen_scalar(const uint8_t* source, float* destination, uint32_t width)
+    {
+        for (uint32_t i = 0; i < width * 4; i++)
+        {
+            destination[i] = source[i];
+        }
+    }
+
+    void horizontal_scalar(const float* source, float* destination, const contributions& weights)
+    {
+        const int taps = weights.taps;
+        for (size_t x = 0; x < weights.first.size(); x++)
+        {
+            const float* w = &weights.weights[x * taps];
+            const float* pixel = source + size_t{ 4 } * weights.first[x];
+            float sum[4] = {};
+            for (int tap = 0; tap < taps; tap++, pixel += 4)
+            {
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    sum[channel] += w[tap] * pixel[channel];
+                }
+            }
+
+            std::copy_n(sum, 4, destination + x * 4);
+        }
+    }
+
+    void vertical_scalar(const float* const* rows, const float* weights, int taps, uint8_t* destination, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float sum = 0.0f;
+            for (int tap = 0; tap < taps; tap++)
+            {
+                sum += weights[tap] * rows[tap][i];
+            }
+
+            destination[i] = to_byte(sum);
+        }
+    }
+
+#ifdef RESAMPLER_X64
+    void widen_sse2(const uint8_t* source, float* destination, uint32_t width)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        uint32_t i = 0;
+        for (; i + 16 <= width * 4; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+            _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+            _mm_storeu_ps(destination + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+            _mm_storeu_ps(destination + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+        }
+
+        widen_scalar(source + i, destination + i, width - i / 4);
+    }
+
+    // One pixel is one vector of 4 channels
+    void horizontal_sse2(const float* source, float* destination, const contributions& weights)
+    {
+        const int taps = weights.taps;
+        for (size_t x = 0; x < weights.first.size(); x++)
+        {
+            const float* w = &weights.weights[x * taps];
+            const float* pixel = source + size_t{ 4 } * weights.first[x];
+            __m128 sum = _mm_setzero_ps();
+            for (int tap = 0; tap < taps; tap++)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(w[tap]), _mm_loadu_ps(pixel + tap * 4)));
+            }
+
+            _mm_storeu_ps(destination + x * 4, sum);
+        }
+    }
+
+    __m128 vertical_sum_sse2(const float* const* rows, const float* weights, int taps, uint32_t i) noexcept
+    {
+        __m128 sum = _mm_setzero_ps();
+        for (int tap = 0; tap < taps; tap++)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(rows[tap] + i)));
+        }
+
+        return sum;
+    }
+
+    // Clamping comes from the saturation of the packs
+    void store_pixel_sse2(__m128 sum, uint8_t* destination) noexcept
+    {
+        const __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(sum), _mm_setzero_si128());
+        const int pixel = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+        std::copy_n(reinterpret_cast<const uint8_t*>(&pixel), 4, destination);
+    }
+
+    void vertical_sse2(const float* const* rows, const float* weights, int taps, uint8_t* destination, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i a = _mm_cvtps_epi32(vertical_sum_sse2(rows, weights, taps, i));
+            const __m128i b = _mm_cvtps_epi32(vertical_sum_sse2(rows, weights, taps, i + 4));
+            const __m128i c = _mm_cvtps_epi32(vertical_sum_sse2(rows, weights, taps, i + 8));
+            const __m128i d = _mm_cvtps_epi32(vertical_sum_sse2(rows, weights, taps, i + 12));
+            const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), bytes);
+        }
+
+        for (; i < count; i += 4)
+        {
+            store_pixel_sse2(vertical_sum_sse2(rows, weights, taps, i), destination + i);
+        }
+    }
+
+    RESAMPLER_AVX2_FUNCTION void widen_avx2(const uint8_t* source, float* destination, uint32_t width)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= width * 4; i += 8)
+        {
+            const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+            _mm256_storeu_ps(destination + i, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)));
+        }
+
+        widen_scalar(source + i, destination + i, width - i / 4);
+    }
+
+    // Two taps per iteration, one pixel in each half of the vector
+    RESAMPLER_AVX2_FUNCTION void horizontal_avx2(const float* source, float* destination, const contributions& weights)
+    {
+        const int taps = weights.taps;
+        for (size_t x = 0; x < weights.first.size(); x++)
+        {
+            const float* w = &weights.weights[x * taps];
+            const float* pixel = source + size_t{ 4 } * weights.first[x];
+            __m256 pairs = _mm256_setzero_ps();
+            int tap = 0;
+            for (; tap + 2 <= taps; tap += 2)
+            {
+                const __m256 weight = _mm256_set_m128(_mm_set1_ps(w[tap + 1]), _mm_set1_ps(w[tap]));
+                pairs = _mm256_add_ps(pairs, _mm256_mul_ps(weight, _mm256_loadu_ps(pixel + tap * 4)));
+            }
+
+            __m128 sum = _mm_add_ps(_mm256_castps256_ps128(pairs), _mm256_extractf128_ps(pairs, 1));
+            if (tap < taps)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(w[tap]), _mm_loadu_ps(pixel + tap * 4)));
+            }
+
+            _mm_storeu_ps(destination + x * 4, sum);
+        }
+    }
+
+    RESAMPLER_AVX2_FUNCTION void vertical_avx2(const float* const* rows, const float* weights, int taps, uint8_t* destination, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (int tap = 0; tap < taps; tap++)
+            {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[tap]), _mm256_loadu_ps(rows[tap] + i)));
+            }
+
+            const __m256i values = _mm256_cvtps_epi32(sum);
+            const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(words, words));
+        }
+
+        for (; i < count; i += 4)
+        {
+            store_pixel_sse2(vertical_sum_sse2(rows, weights, taps, i), destination + i);
+        }
+    }
+
+    bool supports_avx2() noexcept
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // The OS has to save the AVX registers
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+#ifdef RESAMPLER_ARM64
+    void widen_neon(const uint8_t* source, float* destination, uint32_t width)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= width * 4; i += 8)
+        {
+            const uint16x8_t words = vmovl_u8(vld1_u8(source + i));
+            vst1q_f32(destination + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))));
+            vst1q_f32(destination + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))));
+        }
+
+        widen_scalar(source + i, destination + i, width - i / 4);
+    }
+
+    void horizontal_neon(const float* source, float* destination, const contributions& weights)
+    {
+        const int taps = weights.taps;
+        for (size_t x = 0; x < weights.first.size(); x++)
+        {
+            const float* w = &weights.weights[x * taps];
+            const float* pixel = source + size_t{ 4 } * weights.first[x];
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            for (int tap = 0; tap < taps; tap++)
+            {
+                sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(pixel + tap * 4), w[tap]));
+            }
+
+            vst1q_f32(destination + x * 4, sum);
+        }
+    }
+
+    float32x4_t vertical_sum_neon(const float* const* rows, const float* weights, int taps, uint32_t i) noexcept
+    {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for (int tap = 0; tap < taps; tap++)
+        {
+            sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(rows[tap] + i), weights[tap]));
+        }
+
+        return sum;
+    }
+
+    void vertical_neon(const float* const* rows, const float* weights, int taps, uint8_t* destination, uint32_t count)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const int32x4_t low = vcvtnq_s32_f32(vertical_sum_neon(rows, weights, taps, i));
+            const int32x4_t high = vcvtnq_s32_f32(vertical_sum_neon(rows, weights, taps, i + 4));
+            vst1_u8(destination + i, vqmovn_u16(vcombine_u16(vqmovun_s32(low), vqmovun_s32(high))));
+        }
+
+        if (i < count)
+        {
+            const uint16x4_t words = vqmovun_s32(vcvtnq_s32_f32(vertical_sum_neon(rows, weights, taps, i)));
+            const uint8x8_t bytes = vqmovn_u16(vcombine_u16(words, words));
+            vst1_lane_u32(reinterpret_cast<uint32_t*>(destination + i), vreinterpret_u32_u8(bytes), 0);
+        }
+    }
+#endif
+
+    constexpr row_operations scalar_operations{ widen_scalar, horizontal_scalar, vertical_scalar };
+#ifdef RESAMPLER_X64
+    constexpr row_operations sse2_operations{ widen_sse2, horizontal_sse2, vertical_sse2 };
+    constexpr row_operations avx2_operations{ widen_avx2, horizontal_avx2, vertical_avx2 };
+#endif
+#ifdef RESAMPLER_ARM64
+    constexpr row_operations neon_operations{ widen_neon, horizontal_neon, vertical_neon };
+#endif
+}
+
+namespace resampler
+{
+    instruction_set best_instruction_set() noexcept
+    {
+#if defined(RESAMPLER_X64)
+        static const instruction_set best = supports_avx2() ? instruction_set::avx2 : instruction_set::sse2;
+        return best;
+#elif defined(RESAMPLER_ARM64)
+        return instruction_set::neon;
+#else
+        return instruction_set::scalar;
+#endif
+    }
+
+    const char* name(instruction_set set) noexcept
+    {
+        switch (set)
+        {
+        case instruction_set::sse2:
+            return "sse2";
+        case instruction_set::avx2:
+            return "avx2";
+        case instruction_set::neon:
+            return "neon";
+        default:
+            return "scalar";
+        }
+    }
+
+    // Falls back to scalar for instruction sets this build doesn't have
+    const row_operations& operations(instruction_set set) noexcept
+    {
+        switch (set)
+        {
+#ifdef RESAMPLER_X64
+        case instruction_set::sse2:
+            return sse2_operations;
+        case instruction_set::avx2:
+            return avx2_operations;
+#endif
+#ifdef RESAMPLER_ARM64
+        case instruction_set::neon:
+            return neon_operations;
+#endif
+        default:
+            return scalar_operations;
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include <common/debug_control.h>
 #include <common/utils/winapi_error.h>
 #include <common/logger/logger_settings.h>
+#include <common/logger/perf_trace.h>
 
 #include <keyboardmanager/common/Shortcut.h>
 #include <keyboardmanager/common/RemapShortcut.h>
@@ -21,11 +22,10 @@ HHOOK KeyboardManager::hookHandleCopy;
 HHOOK KeyboardManager::hookHandle;
 KeyboardManager* KeyboardManager::keyboardManagerObjectPtr;
 
-KeyboardManager::KeyboardManager()
-{
+KeyboardManager::KeyboardManager() :
     // Load the initial settings.
-    LoadSettings();
-
+    states(LoadSettings())
+{
     // Set the static pointer to the newest object of the class
     keyboardManagerObjectPtr = this;
 
@@ -37,37 +37,40 @@ KeyboardManager::KeyboardManager()
             Logger::error(L"Failed to watch settings changes. {}", get_last_error_or_default(err));
         }
 
-        loadingSettings = true;
+        // The hook keeps using the previous state until the new one is completely loaded
         try
         {
-            LoadSettings();
+            states.Publish(LoadSettings());
         }
         catch (...)
         {
             Logger::error("Failed to load settings");
         }
-
-        loadingSettings = false;
     };
 
     editorIsRunningEvent = CreateEvent(nullptr, true, false, KeyboardManagerConstants::EditorWindowEventName.c_str());
     settingsEventWaiter = EventWaiter(KeyboardManagerConstants::SettingsEventName, changeSettingsCallback);
 }
 
-void KeyboardManager::LoadSettings()
+std::unique_ptr<State> KeyboardManager::LoadSettings()
 {
-    bool loadedSuccessful = state.LoadSettings();
+    auto state = std::make_unique<State>();
+    bool loadedSuccessful = state->LoadSettings();
     if (!loadedSuccessful)
     {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
         // retry once
-        state.LoadSettings();
+        state = std::make_unique<State>();
+        state->LoadSettings();
     }
+
+    return state;
 }
 
 LRESULT CALLBACK KeyboardManager::HookProc(int nCode, WPARAM wParam, LPARAM lParam)
 {
+    PerfTrace::Span span{ PerfTrace::Event::KeyboardManagerHook };
     LowlevelKeyboardEvent event;
     if (nCode == HC_ACTION)
     {
@@ -121,11 +124,6 @@ void KeyboardManager::StopLowlevelKeyboardHook()
 
 intptr_t KeyboardManager::HandleKeyboardHookEvent(LowlevelKeyboardEvent* data) noexcept
 {
-    if (loadingSettings)
-    {
-        return 0;
-    }
-
     // Suspend remapping if remap key/shortcut window is opened
     if (editorIsRunningEvent != nullptr && WaitForSingleObject(editorIsRunningEvent, 0) == WAIT_OBJECT_0)
     {
@@ -138,6 +136,8 @@ intptr_t KeyboardManager::HandleKeyboardHookEvent(LowlevelKeyboardEvent* data) n
         return 1;
     }
 
+    State& state = states.Acquire();
+
     // Remap a key
     intptr_t SingleKeyRemapResult = KeyboardEventHandlers::HandleSingleKeyRemapEvent(inputHandler, data, state);
 
@@ -2,7 +2,7 @@
 #include <common/hooks/LowlevelKeyboardEvent.h>
 #include <common/utils/EventWaiter.h>
 #include <keyboardmanager/common/Input.h>
-#include "State.h"
+#include "StatePublisher.h"
 
 class KeyboardManager
 {
@@ -35,8 +35,8 @@ private:
     // Only global or static variables can be accessed in a hook procedure CALLBACK
     static KeyboardManager* keyboardManagerObjectPtr;
 
-    // Variable which stores all the state information to be shared between the UI and back-end
-    State state;
+    // Stores all the state information to be shared between the UI and back-end. Reloaded states are swapped in by the hook
+    StatePublisher states;
 
     // Object of class which implements InputInterface. Required for calling library functions while enabling testing
     KeyboardManagerInput::Input inputHandler;
@@ -44,15 +44,13 @@ private:
     // Auto reset event for waiting for settings changes. The event is signaled when settings are changed
     EventWaiter settingsEventWaiter;
 
-    std::atomic_bool loadingSettings = false;
-
     HANDLE editorIsRunningEvent = nullptr;
 
     // Hook procedure definition
     static LRESULT CALLBACK HookProc(int nCode, WPARAM wParam, LPARAM lParam);
 
-    // Load settings from the file.
-    void LoadSettings();
+    // Load settings from the file into a new state.
+    static std::unique_ptr<State> LoadSettings();
 
     // Function called by the hook procedure to handle the events. This is the starting point function for remapping
     intptr_t HandleKeyboardHookEvent(LowlevelKeyboardEvent* data) noexcept;
@@ -61,3 +61,39 @@ std::wstring State::GetActivatedApp()
 {
     return activatedAppSpecificShortcutTarget;
 }
+
+namespace
+{
+    void CarryOverInvokedState(ShortcutRemapTable& table, const ShortcutRemapTable& previous)
+    {
+        for (auto& [shortcut, remap] : table)
+        {
+            auto it = previous.find(shortcut);
+            if (it != previous.end() && it->second.targetShortcut == remap.targetShortcut)
+            {
+                remap.isShortcutInvoked = it->second.isShortcutInvoked;
+                remap.winKeyInvoked = it->second.winKeyInvoked;
+                remap.isOriginalActionKeyPressed = it->second.isOriginalActionKeyPressed;
+            }
+        }
+    }
+}
+
+// Copies the invoked state of the shortcuts which are remapped the same way in both states, so a shortcut held down while the settings are reloaded is released correctly
+void State::CarryOverInvokedState(const State& previous)
+{
+    ::CarryOverInvokedState(osLevelShortcutReMap, previous.osLevelShortcutReMap);
+    for (auto& [app, table] : appSpecificShortcutReMap)
+    {
+        auto it = previous.appSpecificShortcutReMap.find(app);
+        if (it != previous.appSpecificShortcutReMap.end())
+        {
+            ::CarryOverInvokedState(table, it->second);
+        }
+    }
+
+    if (appSpecificShortcutReMap.contains(previous.activatedAppSpecificShortcutTarget))
+    {
+        activatedAppSpecificShortcutTarget = previous.activatedAppSpecificShortcutTarget;
+    }
+}
@@ -23,4 +23,7 @@ public:
 
     // Gets the activated target application in app-specific shortcut
     std::wstring GetActivatedApp();
+
+    // Copies the invoked state of the shortcuts which are remapped the same way in both states, so a shortcut held down while the settings are reloaded is released correctly
+    void CarryOverInvokedState(const State& previous);
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "pch.h"
+#include "StatePublisher.h"
+
+StatePublisher::StatePublisher(std::unique_ptr<State> initialState) :
+    current(std::move(initialState))
+{
+}
+
+StatePublisher::~StatePublisher()
+{
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+void StatePublisher::Publish(std::unique_ptr<State> state)
+{
+    delete retired.exchange(nullptr);
+    delete pending.exchange(state.release(), std::memory_order_acq_rel);
+}
+
+State& StatePublisher::Acquire() noexcept
+{
+    if (State* published = pending.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        published->CarryOverInvokedState(*current);
+
+        // Only happens if the settings thread didn't get to free the previously retired state yet
+        delete retired.exchange(current.release());
+        current.reset(published);
+    }
+
+    return *current;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "State.h"
+
+// Hands the states loaded on the settings thread over to the hook thread.
+// A state is fully built before it's published with a single pointer exchange, and only the hook thread uses it afterwards,
+// so the hook never waits for a lock and never sees a partially loaded state.
+class StatePublisher
+{
+public:
+    explicit StatePublisher(std::unique_ptr<State> initialState);
+    ~StatePublisher();
+
+    StatePublisher(const StatePublisher&) = delete;
+    StatePublisher& operator=(const StatePublisher&) = delete;
+
+    // Called from the settings thread. A state which wasn't picked up by the hook yet is replaced.
+    void Publish(std::unique_ptr<State> state);
+
+    // Called from the hook thread. Switches to the most recently published state, if any, and returns the state to use for the current event.
+    State& Acquire() noexcept;
+
+private:
+    // Only accessed by the hook thread
+    std::unique_ptr<State> current;
+
+    std::atomic<State*> pending = nullptr;
+
+    // The state replaced by the hook is destroyed on the settings thread, to keep deallocations out of the hook
+    std::atomic<State*> retired = nullptr;
+};
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "MockedInput.h"
+#include <keyboardmanager/KeyboardManagerEngineLibrary/StatePublisher.h>
+#include <keyboardmanager/KeyboardManagerEngineLibrary/KeyboardEventHandlers.h>
+#include "TestHelpers.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RemappingLogicTests
+{
+    // Tests for swapping the remap state while keys are being handled
+    TEST_CLASS (StatePublisherTests)
+    {
+    private:
+        KeyboardManagerInput::MockedInput mockedInputHandler;
+
+        // Remaps Ctrl+A to Ctrl+V and B to C in every configuration. The other remaps depend on the configuration
+        static std::unique_ptr<State> CreateState(int configuration)
+        {
+            auto state = std::make_unique<State>();
+
+            Shortcut src;
+            src.SetKey(VK_CONTROL);
+            src.SetKey(0x41);
+            Shortcut dest;
+            dest.SetKey(VK_CONTROL);
+            dest.SetKey(0x56);
+            state->AddOSLevelShortcut(src, dest);
+            state->AddSingleKeyRemap(0x42, (DWORD)0x43);
+
+            if (configuration % 2)
+            {
+                Shortcut otherSrc;
+                otherSrc.SetKey(VK_CONTROL);
+                otherSrc.SetKey(0x58);
+                state->AddOSLevelShortcut(otherSrc, (DWORD)VK_DELETE);
+                state->AddSingleKeyRemap(VK_CAPITAL, (DWORD)VK_ESCAPE);
+            }
+
+            return state;
+        }
+
+        static void SendKey(KeyboardManagerInput::MockedInput& input, WORD key, bool down)
+        {
+            INPUT event{};
+            event.type = INPUT_KEYBOARD;
+            event.ki.wVk = key;
+            event.ki.dwFlags = down ? 0 : KEYEVENTF_KEYUP;
+            input.SendVirtualInput(1, &event, sizeof(INPUT));
+        }
+
+        void SetHookProc(StatePublisher& publisher)
+        {
+            mockedInputHandler.SetHookProc([this, &publisher](LowlevelKeyboardEvent* data) {
+                if (data->lParam->dwExtraInfo == KeyboardManagerConstants::KEYBOARDMANAGER_SUPPRESS_FLAG)
+                {
+                    return (intptr_t)1;
+                }
+
+                State& state = publisher.Acquire();
+                if (KeyboardEventHandlers::HandleSingleKeyRemapEvent(mockedInputHandler, data, state) == 1)
+                {
+                    return (intptr_t)1;
+                }
+
+                return KeyboardEventHandlers::HandleOSLevelShortcutRemapEvent(mockedInputHandler, data, state);
+            });
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(InitializeTestEnv)
+        {
+            State state;
+            TestHelpers::ResetTestEnv(mockedInputHandler, state);
+        }
+
+        // Test if a published state is only used once the hook acquires it
+        TEST_METHOD (PublishedState_ShouldBeUsed_OnNextAcquire)
+        {
+            StatePublisher publisher(std::make_unique<State>());
+            Assert::IsTrue(publisher.Acquire().singleKeyReMap.empty());
+
+            publisher.Publish(CreateState(0));
+            publisher.Publish(CreateState(1));
+
+            // Only the most recently published state is used
+            Assert::AreEqual(size_t{ 2 }, publisher.Acquire().singleKeyReMap.size());
+            Assert::AreEqual(size_t{ 2 }, publisher.Acquire().singleKeyReMap.size());
+        }
+
+        // Test if a shortcut held down while the state is swapped is released correctly
+        TEST_METHOD (InvokedShortcut_ShouldBeReleased_WhenStateIsSwappedWhileHeld)
+        {
+            StatePublisher publisher(CreateState(0));
+            SetHookProc(publisher);
+
+            SendKey(mockedInputHandler, VK_CONTROL, true);
+            SendKey(mockedInputHandler, 0x41, true);
+            Assert::AreEqual(true, mockedInputHandler.GetVirtualKeyState(0x56));
+
+            publisher.Publish(CreateState(1));
+
+            SendKey(mockedInputHandler, 0x41, false);
+            SendKey(mockedInputHandler, VK_CONTROL, false);
+
+            Assert::AreEqual(false, mockedInputHandler.GetVirtualKeyState(VK_CONTROL));
+            Assert::AreEqual(false, mockedInputHandler.GetVirtualKeyState(0x41));
+            Assert::AreEqual(false, mockedInputHandler.GetVirtualKeyState(0x56));
+        }
+
+        // Test if remapping stays consistent while the state is reloaded 1000 times during key input
+        TEST_METHOD (KeyStreams_ShouldBeRemappedConsistently_WhileStateIsReloaded)
+        {
+            constexpr int reloadCount = 1000;
+            StatePublisher publisher(CreateState(0));
+            SetHookProc(publisher);
+
+            std::atomic_int published = 0;
+            std::thread reloader([&] {
+                for (int i = 1; i <= reloadCount; ++i)
+                {
+                    publisher.Publish(CreateState(i));
+                    published = i;
+                    std::this_thread::yield();
+                }
+            });
+
+            int iterations = 0;
+            bool consistent = true;
+            while (published < reloadCount || iterations < reloadCount)
+            {
+                // Ctrl+A is remapped to Ctrl+V
+                SendKey(mockedInputHandler, VK_CONTROL, true);
+                SendKey(mockedInputHandler, 0x41, true);
+                consistent = consistent && mockedInputHandler.GetVirtualKeyState(0x56) && !mockedInputHandler.GetVirtualKeyState(0x41);
+                SendKey(mockedInputHandler, 0x41, false);
+                SendKey(mockedInputHandler, VK_CONTROL, false);
+
+                // B is remapped to C
+                SendKey(mockedInputHandler, 0x42, true);
+                consistent = consistent && mockedInputHandler.GetVirtualKeyState(0x43) && !mockedInputHandler.GetVirtualKeyState(0x42);
+                SendKey(mockedInputHandler, 0x42, false);
+
+                for (int key = 0; key < 256; ++key)
+                {
+                    consistent = consistent && !mockedInputHandler.GetVirtualKeyState(key);
+                }
+
+                ++iterations;
+            }
+
+            reloader.join();
+            Logger::WriteMessage(std::format(L"Replayed {} key streams during {} reloads\n", iterations, reloadCount).c_str());
+            Assert::IsTrue(consistent);
+        }
+    };
+}
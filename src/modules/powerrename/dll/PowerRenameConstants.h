@@ -5,4 +5,7 @@ namespace PowerRenameConstants
 {
     // Name of the powertoy module.
     inline const std::wstring ModuleKey = L"PowerRename";
+
+    // Name of the shared memory section the settings are published to.
+    inline const std::wstring SharedSettingsName = L"Local\\PowerToys_PowerRename_Settings";
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <filesystem>
 #include "trace.h"
 #include <winrt/base.h>
+#include <common/logger/perf_trace.h>
 
 namespace fs = std::filesystem;
 
@@ -736,6 +737,7 @@ DWORD WINAPI CPowerRenameManager::s_fileOpWorkerThread(_In_ void* pv)
             // Wait to be told we can begin
             if (WaitForSingleObject(pwtd->startEvent, INFINITE) == WAIT_OBJECT_0)
             {
+                PerfTrace::Span span{ PerfTrace::Event::PowerRenameFileOpWorker };
                 CComPtr<IPowerRenameRegEx> spRenameRegEx;
                 if (SUCCEEDED(pwtd->spsrm->GetRenameRegEx(&spRenameRegEx)))
                 {
@@ -767,6 +769,7 @@ DWORD WINAPI CPowerRenameManager::s_fileOpWorkerThread(_In_ void* pv)
                         }
 
                         // From the greatest depth first, add all items of that depth to the operation
+                        int64_t renamedItems = 0;
                         for (LONG v = itemCount - 1; v >= 0; v--)
                         {
                             for (auto it : matrix[v])
@@ -784,6 +787,7 @@ DWORD WINAPI CPowerRenameManager::s_fileOpWorkerThread(_In_ void* pv)
                                             if (SUCCEEDED(spItem->GetShellItem(&spShellItem)))
                                             {
                                                 spFileOp->RenameItem(spShellItem, newName, nullptr);
+                                                renamedItems++;
                                                 if (!closeUIWindowAfterRenaming)
                                                 {
                                                     // Update item data
@@ -824,6 +828,8 @@ DWORD WINAPI CPowerRenameManager::s_fileOpWorkerThread(_In_ void* pv)
                             }
                         }
 
+                        PerfTrace::Counter(PerfTrace::Event::PowerRenameItemsRenamed, renamedItems);
+
                         // Set the operation flags
                         if (SUCCEEDED(spFileOp->SetOperationFlags(FOF_DEFAULTFLAGS)))
                         {
@@ -922,6 +928,7 @@ DWORD WINAPI CPowerRenameManager::s_regexWorkerThread(_In_ void* pv)
             // Wait to be told we can begin
             if (WaitForSingleObject(pwtd->startEvent, INFINITE) == WAIT_OBJECT_0)
             {
+                PerfTrace::Span span{ PerfTrace::Event::PowerRenameRegexWorker };
                 CComPtr<IPowerRenameRegEx> spRenameRegEx;
 
                 winrt::check_hresult(pwtd->spsrm->GetRenameRegEx(&spRenameRegEx));
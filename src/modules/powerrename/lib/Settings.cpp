@@ -26,18 +26,24 @@ namespace
     const wchar_t c_mruEnabled[] = L"MRUEnabled";
     const wchar_t c_useBoostLib[] = L"UseBoostLib";
 
+    // Bump when CSettings::SharedSettings changes
+    constexpr uint32_t c_sharedSettingsLayout = 1;
 }
 
 CSettings::CSettings()
 {
-    std::wstring result = PTSettingsHelper::get_module_save_folder_location(PowerRenameConstants::ModuleKey);
-    jsonFilePath = result + std::wstring(c_powerRenameDataFilePath);
-    UIFlagsFilePath = result + std::wstring(c_powerRenameUIFlagsFilePath);
-    Load();
+    // The context menu handler is created for every right click in Explorer. When the settings are
+    // published to shared memory, the disk isn't touched until a setting that isn't published is needed.
+    if (!ReadSharedSettings())
+    {
+        Load();
+    }
 }
 
 void CSettings::Save()
 {
+    EnsureLoaded();
+
     json::JsonObject jsonData;
 
     jsonData.SetNamedValue(c_enabled, json::value(settings.enabled));
@@ -52,10 +58,14 @@ void CSettings::Save()
 
     json::to_file(jsonFilePath, jsonData);
     GetSystemTimeAsFileTime(&lastLoadedTime);
+    PublishSharedSettings();
 }
 
 void CSettings::Load()
 {
+    ResolvePaths();
+    loaded = true;
+
     if (!std::filesystem::exists(jsonFilePath))
     {
         MigrateFromRegistry();
@@ -67,11 +77,100 @@ void CSettings::Load()
     {
         ParseJson();
         ReadFlags();
+        PublishSharedSettings();
+    }
+}
+
+void CSettings::EnsureLoaded()
+{
+    if (!loaded)
+    {
+        Load();
+    }
+}
+
+void CSettings::ResolvePaths()
+{
+    if (jsonFilePath.empty())
+    {
+        std::wstring result = PTSettingsHelper::get_module_save_folder_location(PowerRenameConstants::ModuleKey);
+        jsonFilePath = result + std::wstring(c_powerRenameDataFilePath);
+        UIFlagsFilePath = result + std::wstring(c_powerRenameUIFlagsFilePath);
+    }
+}
+
+bool CSettings::ReadSharedSettings()
+{
+    if (!sharedSettings)
+    {
+        sharedSettings = shared_settings::section<SharedSettings>::open(PowerRenameConstants::SharedSettingsName, c_sharedSettingsLayout);
+        if (!sharedSettings)
+        {
+            return false;
+        }
+    }
+
+    SharedSettings shared{};
+    switch (sharedSettings->data().read(shared, sharedSettingsGeneration))
+    {
+    case shared_settings::read_result::updated:
+        settings.enabled = shared.enabled;
+        settings.showIconOnMenu = shared.showIconOnMenu;
+        settings.extendedContextMenuOnly = shared.extendedContextMenuOnly;
+        settings.persistState = shared.persistState;
+        settings.useBoostLib = shared.useBoostLib;
+        settings.MRUEnabled = shared.MRUEnabled;
+        settings.maxMRUSize = shared.maxMRUSize;
+        return true;
+    case shared_settings::read_result::unchanged:
+        return true;
+    default:
+        return false;
     }
 }
 
+void CSettings::PublishSharedSettings()
+{
+    if (!sharedSettingsWritable)
+    {
+        // Fails when the section was created by a process this one can't write to, readers then keep
+        // falling back to the file.
+        auto writable = shared_settings::section<SharedSettings>::create(PowerRenameConstants::SharedSettingsName, c_sharedSettingsLayout);
+        if (!writable)
+        {
+            return;
+        }
+
+        sharedSettings = std::move(writable);
+        sharedSettingsWritable = true;
+    }
+
+    const SharedSettings shared{
+        .enabled = settings.enabled,
+        .showIconOnMenu = settings.showIconOnMenu,
+        .extendedContextMenuOnly = settings.extendedContextMenuOnly,
+        .persistState = settings.persistState,
+        .useBoostLib = settings.useBoostLib,
+        .MRUEnabled = settings.MRUEnabled,
+        .maxMRUSize = settings.maxMRUSize,
+    };
+    sharedSettingsGeneration = sharedSettings->data().write(shared);
+}
+
 void CSettings::Reload()
 {
+    // Whoever changes the settings publishes them, the file only has to be checked when nothing is published.
+    if (ReadSharedSettings())
+    {
+        return;
+    }
+
+    if (!loaded)
+    {
+        Load();
+        return;
+    }
+
     // Load json settings from data file if it is modified in the meantime.
     FILETIME lastModifiedTime{};
     if (LastModifiedTime(jsonFilePath, &lastModifiedTime) &&
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <common/utils/json.h>
+#include <common/SettingsAPI/shared_settings.h>
+
+#include <optional>
 
 class CSettings
 {
@@ -15,6 +18,7 @@ public:
 
     inline void SetEnabled(bool enabled)
     {
+        EnsureLoaded();
         settings.enabled = enabled;
         Save();
     }
@@ -26,6 +30,7 @@ public:
 
     inline void SetShowIconOnMenu(bool show)
     {
+        EnsureLoaded();
         settings.showIconOnMenu = show;
     }
 
@@ -36,6 +41,7 @@ public:
 
     inline void SetExtendedContextMenuOnly(bool extendedOnly)
     {
+        EnsureLoaded();
         settings.extendedContextMenuOnly = extendedOnly;
     }
 
@@ -46,6 +52,7 @@ public:
 
     inline void SetPersistState(bool persistState)
     {
+        EnsureLoaded();
         settings.persistState = persistState;
     }
 
@@ -56,6 +63,7 @@ public:
 
     inline void SetUseBoostLib(bool useBoostLib)
     {
+        EnsureLoaded();
         settings.useBoostLib = useBoostLib;
     }
 
@@ -66,6 +74,7 @@ public:
 
     inline void SetMRUEnabled(bool MRUEnabled)
     {
+        EnsureLoaded();
         settings.MRUEnabled = MRUEnabled;
     }
 
@@ -76,38 +85,45 @@ public:
 
     inline void SetMaxMRUSize(unsigned int maxMRUSize)
     {
+        EnsureLoaded();
         settings.maxMRUSize = maxMRUSize;
     }
 
-    inline unsigned int GetFlags() const
+    inline unsigned int GetFlags()
     {
+        EnsureLoaded();
         return settings.flags;
     }
 
     inline void SetFlags(unsigned int flags)
     {
+        EnsureLoaded();
         settings.flags = flags;
         WriteFlags();
     }
 
-    inline const std::wstring& GetSearchText() const
+    inline const std::wstring& GetSearchText()
     {
+        EnsureLoaded();
         return settings.searchText;
     }
 
     inline void SetSearchText(const std::wstring& text)
     {
+        EnsureLoaded();
         settings.searchText = text;
         Save();
     }
 
-    inline const std::wstring& GetReplaceText() const
+    inline const std::wstring& GetReplaceText()
     {
+        EnsureLoaded();
         return settings.replaceText;
     }
 
     inline void SetReplaceText(const std::wstring& text)
     {
+        EnsureLoaded();
         settings.replaceText = text;
         Save();
     }
@@ -130,6 +146,22 @@ private:
         std::wstring replaceText{};
     };
 
+    // Part of the settings published to shared memory, everything the context menu handler needs
+    struct SharedSettings
+    {
+        bool enabled;
+        bool showIconOnMenu;
+        bool extendedContextMenuOnly;
+        bool persistState;
+        bool useBoostLib;
+        bool MRUEnabled;
+        unsigned int maxMRUSize;
+    };
+
+    void EnsureLoaded();
+    void ResolvePaths();
+    bool ReadSharedSettings();
+    void PublishSharedSettings();
     void Reload();
     void MigrateFromRegistry();
     void ParseJson();
@@ -138,9 +170,14 @@ private:
     void WriteFlags();
 
     Settings settings;
+    bool loaded{ false };
     std::wstring jsonFilePath;
     std::wstring UIFlagsFilePath;
-    FILETIME lastLoadedTime;
+    FILETIME lastLoadedTime{};
+
+    std::optional<shared_settings::section<SharedSettings>> sharedSettings;
+    bool sharedSettingsWritable{ false };
+    uint64_t sharedSettingsGeneration{ 0 };
 };
 
 CSettings& CSettingsInstance();
@@ -18,6 +18,17 @@ const int TOP_RIGHT_BORDER_OFFSET = 40;
 Toolbar::Toolbar()
 {
     toolbar = this;
+}
+
+// The toolbar is created when the module is loaded, which may happen off the thread that shows it
+void Toolbar::loadImages()
+{
+    if (imagesLoaded)
+    {
+        return;
+    }
+
+    imagesLoaded = true;
     darkImages.camOnMicOn = Gdiplus::Image::FromFile(L"modules/VideoConference/Icons/On-On Dark.png");
     darkImages.camOffMicOn = Gdiplus::Image::FromFile(L"modules/VideoConference/Icons/On-Off Dark.png");
     darkImages.camOnMicOff = Gdiplus::Image::FromFile(L"modules/VideoConference/Icons/Off-On Dark.png");
@@ -202,6 +213,7 @@ void Toolbar::show(std::wstring position, std::wstring monitorString)
     }
     hwnds.clear();
 
+    loadImages();
     int overlayWidth = darkImages.camOffMicOff->GetWidth();
     int overlayHeight = darkImages.camOffMicOff->GetHeight();
 
@@ -40,9 +40,12 @@ public:
 private:
     static LRESULT CALLBACK WindowProcessMessages(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
 
+    void loadImages();
+
     // Window callback can't be non-static so this members can't as well
     std::vector<HWND> hwnds;
 
+    bool imagesLoaded = false;
     ToolbarImages darkImages;
     ToolbarImages lightImages;
     AudioDeviceNotificationClient audioConfChangesNotifier;
@@ -11,6 +11,7 @@
 #include <common/updating/installer.h>
 #include <common/updating/updating.h>
 #include <common/updating/updateState.h>
+#include <common/updating/update_cache.h>
 #include <common/utils/HttpClient.h>
 #include <common/utils/process_path.h>
 #include <common/utils/resources.h>
@@ -123,6 +124,8 @@ void ProcessNewVersionInfo(const github_version_info& version_info,
         Logger::trace(L"Downloading installer for a new version");
         if (download_new_version(new_version_info).get())
         {
+            const auto metrics = update_cache{}.metrics();
+            Logger::trace(L"Update cache saved {} bytes of release metadata, {} installer bytes came from the mirror", metrics.metadata_bytes_saved, metrics.mirror_bytes);
             state.state = UpdateState::readyToInstall;
             state.downloadedInstallerFilename = new_version_info.installer_filename;
             if (show_notifications)
@@ -5,6 +5,7 @@
 
 #include <common/SettingsAPI/settings_helpers.h>
 #include "powertoy_module.h"
+#include "startup_timeline.h"
 #include <common/themes/windows_colors.h>
 
 #include "trace.h"
@@ -16,6 +17,7 @@
 static std::wstring settings_theme = L"system";
 static bool run_as_elevated = false;
 static bool download_updates_automatically = true;
+static bool lazy_module_activation = false;
 
 json::JsonObject GeneralSettings::to_json()
 {
@@ -37,6 +39,7 @@ json::JsonObject GeneralSettings::to_json()
     result.SetNamedValue(L"is_elevated", json::value(isElevated));
     result.SetNamedValue(L"run_elevated", json::value(isRunElevated));
     result.SetNamedValue(L"download_updates_automatically", json::value(downloadUpdatesAutomatically));
+    result.SetNamedValue(L"lazy_module_activation", json::value(lazyModuleActivation));
     result.SetNamedValue(L"is_admin", json::value(isAdmin));
     result.SetNamedValue(L"theme", json::value(theme));
     result.SetNamedValue(L"system_theme", json::value(systemTheme));
@@ -55,6 +58,7 @@ json::JsonObject load_general_settings()
     }
     run_as_elevated = loaded.GetNamedBoolean(L"run_elevated", false);
     download_updates_automatically = loaded.GetNamedBoolean(L"download_updates_automatically", true) && check_user_is_admin();
+    lazy_module_activation = loaded.GetNamedBoolean(L"lazy_module_activation", false);
 
     return loaded;
 }
@@ -67,6 +71,7 @@ GeneralSettings get_general_settings()
         .isRunElevated = run_as_elevated,
         .isAdmin = is_user_admin,
         .downloadUpdatesAutomatically = download_updates_automatically && is_user_admin,
+        .lazyModuleActivation = lazy_module_activation,
         .theme = settings_theme,
         .systemTheme = WindowsColors::is_dark_mode() ? L"dark" : L"light",
         .powerToysVersion = get_product_version()
@@ -88,6 +93,8 @@ void apply_general_settings(const json::JsonObject& general_configs, bool save)
     run_as_elevated = general_configs.GetNamedBoolean(L"run_elevated", false);
 
     download_updates_automatically = general_configs.GetNamedBoolean(L"download_updates_automatically", true);
+    // Kept as is when the settings don't have it, an opt-out set by hand isn't lost on the next save
+    lazy_module_activation = general_configs.GetNamedBoolean(L"lazy_module_activation", lazy_module_activation);
 
     if (json::has(general_configs, L"startup", json::JsonValueType::Boolean))
     {
@@ -153,8 +160,9 @@ void apply_general_settings(const json::JsonObject& general_configs, bool save)
                 Logger::info(L"apply_general_settings: Disabling powertoy {}", name);
                 powertoy->disable();
             }
+            powertoy.invalidate_config();
             // Sync the hotkey state with the module state, so it can be removed for disabled modules.
-            powertoy.UpdateHotkeyEx();
+            powertoy.sync_hotkeys();
         }
     }
 
@@ -215,8 +223,35 @@ void start_enabled_powertoys()
         if (!powertoys_to_disable.contains(name))
         {
             Logger::info(L"start_enabled_powertoys: Enabling powertoy {}", name);
+            startup_timeline::scope timing{ name, startup_timeline::phase::enable };
             powertoy->enable();
-            powertoy.UpdateHotkeyEx();
+            powertoy.invalidate_config();
+            powertoy.sync_hotkeys();
         }
     }
 }
+
+bool is_powertoy_enabled_at_start(const json::JsonObject& general_settings, const std::wstring& key, bool enabled_by_default)
+{
+    try
+    {
+        if (json::has(general_settings, L"enabled", json::JsonValueType::Object))
+        {
+            const auto enabled = general_settings.GetNamedObject(L"enabled");
+            if (json::has(enabled, key, json::JsonValueType::Boolean))
+            {
+                return enabled.GetNamedBoolean(key);
+            }
+        }
+    }
+    catch (...)
+    {
+    }
+
+    return enabled_by_default;
+}
+
+bool is_lazy_module_activation_enabled()
+{
+    return lazy_module_activation;
+}
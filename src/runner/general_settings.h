@@ -11,6 +11,7 @@ struct GeneralSettings
     bool isRunElevated;
     bool isAdmin;
     bool downloadUpdatesAutomatically;
+    bool lazyModuleActivation;
     std::wstring theme;
     std::wstring systemTheme;
     std::wstring powerToysVersion;
@@ -21,4 +22,10 @@ struct GeneralSettings
 json::JsonObject load_general_settings();
 GeneralSettings get_general_settings();
 void apply_general_settings(const json::JsonObject& general_configs, bool save = true);
-void start_enabled_powertoys();
\ No newline at end of file
+void start_enabled_powertoys();
+
+// Whether the module with the given key is enabled when the runner starts with these general settings
+bool is_powertoy_enabled_at_start(const json::JsonObject& general_settings, const std::wstring& key, bool enabled_by_default);
+
+// Modules that start disabled are only loaded once they're enabled
+bool is_lazy_module_activation_enabled();
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "pch.h"
+#include "lazy_powertoy.h"
+
+#include <common/logger/logger.h>
+#include <common/version/version.h>
+
+namespace
+{
+    std::vector<LazyPowertoy*>& instances()
+    {
+        static std::vector<LazyPowertoy*> instances;
+        return instances;
+    }
+}
+
+LazyPowertoy::LazyPowertoy(std::wstring dll, module_manifest::manifest manifest) :
+    dll(std::move(dll)), manifest(std::move(manifest))
+{
+    instances().push_back(this);
+}
+
+LazyPowertoy::LazyPowertoy(std::wstring dll, LoadedPowertoy loaded) :
+    dll(std::move(dll)), manifest(module_manifest::read_from(loaded.pt_module.get())), handle(std::move(loaded.handle)), pt_module(std::move(loaded.pt_module))
+{
+    instances().push_back(this);
+}
+
+LazyPowertoy::~LazyPowertoy()
+{
+    std::erase(instances(), this);
+}
+
+bool LazyPowertoy::is_loaded() const noexcept
+{
+    return pt_module != nullptr;
+}
+
+void LazyPowertoy::save_manifests()
+{
+    std::map<std::wstring, module_manifest::manifest> manifests;
+    for (auto instance : instances())
+    {
+        if (instance->pt_module)
+        {
+            instance->manifest = module_manifest::read_from(instance->pt_module.get());
+        }
+
+        manifests.emplace(instance->dll, instance->manifest);
+    }
+
+    module_manifest::save(manifests, get_product_version());
+}
+
+PowertoyModuleIface* LazyPowertoy::loaded_module()
+{
+    if (!pt_module)
+    {
+        try
+        {
+            Logger::info(L"Loading {} on demand", manifest.key);
+            auto loaded = create_powertoy(dll);
+            handle = std::move(loaded.handle);
+            pt_module = std::move(loaded.pt_module);
+        }
+        catch (...)
+        {
+            Logger::error(L"Failed to load {}", dll);
+        }
+    }
+
+    return pt_module.get();
+}
+
+const wchar_t* LazyPowertoy::get_name()
+{
+    return pt_module ? pt_module->get_name() : manifest.name.c_str();
+}
+
+const wchar_t* LazyPowertoy::get_key()
+{
+    return manifest.key.c_str();
+}
+
+bool LazyPowertoy::get_config(wchar_t* buffer, int* buffer_size)
+{
+    if (pt_module || manifest.config.empty())
+    {
+        auto module = loaded_module();
+        return module && module->get_config(buffer, buffer_size);
+    }
+
+    const int size = static_cast<int>(manifest.config.size() + 1);
+    if (!buffer || *buffer_size < size)
+    {
+        *buffer_size = size;
+        return false;
+    }
+
+    wcscpy_s(buffer, *buffer_size, manifest.config.c_str());
+    return true;
+}
+
+void LazyPowertoy::set_config(const wchar_t* config)
+{
+    if (auto module = loaded_module())
+    {
+        module->set_config(config);
+    }
+}
+
+void LazyPowertoy::call_custom_action(const wchar_t* action)
+{
+    if (auto module = loaded_module())
+    {
+        module->call_custom_action(action);
+    }
+}
+
+void LazyPowertoy::enable()
+{
+    if (auto module = loaded_module())
+    {
+        module->enable();
+    }
+}
+
+void LazyPowertoy::disable()
+{
+    if (pt_module)
+    {
+        pt_module->disable();
+    }
+}
+
+bool LazyPowertoy::is_enabled()
+{
+    return pt_module && pt_module->is_enabled();
+}
+
+void LazyPowertoy::destroy()
+{
+    delete this;
+}
+
+size_t LazyPowertoy::get_hotkeys(Hotkey* buffer, size_t buffer_size)
+{
+    if (pt_module)
+    {
+        return pt_module->get_hotkeys(buffer, buffer_size);
+    }
+
+    if (buffer)
+    {
+        std::copy_n(manifest.hotkeys.begin(), std::min(buffer_size, manifest.hotkeys.size()), buffer);
+    }
+
+    return manifest.hotkeys.size();
+}
+
+std::optional<PowertoyModuleIface::HotkeyEx> LazyPowertoy::GetHotkeyEx()
+{
+    return pt_module ? pt_module->GetHotkeyEx() : manifest.hotkey_ex;
+}
+
+// A module that isn't loaded yet is disabled, so its hotkeys are ignored like a disabled module would
+void LazyPowertoy::OnHotkeyEx()
+{
+    if (pt_module)
+    {
+        pt_module->OnHotkeyEx();
+    }
+}
+
+bool LazyPowertoy::on_hotkey(size_t hotkeyId)
+{
+    if (!pt_module)
+    {
+        return false;
+    }
+
+    return pt_module->on_hotkey(hotkeyId);
+}
+
+bool LazyPowertoy::keep_track_of_pressed_win_key()
+{
+    return pt_module ? pt_module->keep_track_of_pressed_win_key() : manifest.keep_track_of_pressed_win_key;
+}
+
+UINT LazyPowertoy::milliseconds_win_key_must_be_pressed()
+{
+    return pt_module ? pt_module->milliseconds_win_key_must_be_pressed() : manifest.milliseconds_win_key_must_be_pressed;
+}
+
+void LazyPowertoy::send_settings_telemetry()
+{
+    if (pt_module)
+    {
+        pt_module->send_settings_telemetry();
+    }
+}
+
+bool LazyPowertoy::is_enabled_by_default() const
+{
+    return manifest.enabled_by_default;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+
+#include "module_manifest.h"
+#include "powertoy_module.h"
+
+// Stands in for a module in lazy activation mode. While the module DLL isn't loaded, the queries the
+// runner makes for every module are answered from the module manifest. The DLL is loaded when the module
+// is enabled or a call needs the module itself, and stays loaded from then on: the threads modules keep
+// in their statics can't be stopped safely while the DLL is being unloaded.
+// All methods have to be called on the runner main thread.
+class LazyPowertoy final : public PowertoyModuleIface
+{
+public:
+    // Module that isn't loaded yet
+    LazyPowertoy(std::wstring dll, module_manifest::manifest manifest);
+    // Module that was already loaded
+    LazyPowertoy(std::wstring dll, LoadedPowertoy loaded);
+
+    bool is_loaded() const noexcept;
+
+    // Saves the manifests of all the modules, refreshed from the ones that are loaded
+    static void save_manifests();
+
+    // PowertoyModuleIface
+    const wchar_t* get_name() override;
+    const wchar_t* get_key() override;
+    bool get_config(wchar_t* buffer, int* buffer_size) override;
+    void set_config(const wchar_t* config) override;
+    void call_custom_action(const wchar_t* action) override;
+    void enable() override;
+    void disable() override;
+    bool is_enabled() override;
+    void destroy() override;
+    size_t get_hotkeys(Hotkey* buffer, size_t buffer_size) override;
+    std::optional<HotkeyEx> GetHotkeyEx() override;
+    void OnHotkeyEx() override;
+    bool on_hotkey(size_t hotkeyId) override;
+    bool keep_track_of_pressed_win_key() override;
+    UINT milliseconds_win_key_must_be_pressed() override;
+    void send_settings_telemetry() override;
+    bool is_enabled_by_default() const override;
+
+private:
+    ~LazyPowertoy();
+
+    // Returns the loaded module, or nullptr if it failed to load
+    PowertoyModuleIface* loaded_module();
+
+    std::wstring dll;
+    module_manifest::manifest manifest;
+
+    std::unique_ptr<HMODULE, PowertoyModuleDLLDeleter> handle;
+    std::unique_ptr<PowertoyModuleIface, PowertoyModuleDeleter> pt_module;
+};
@@ -11,6 +11,9 @@
 #include "RestartManagement.h"
 #include "Generated files/resource.h"
 #include "settings_telemetry.h"
+#include "startup_timeline.h"
+#include "lazy_powertoy.h"
+#include "module_manifest.h"
 
 #include <common/comUtils/comUtils.h>
 #include <common/display/dpi_aware.h>
@@ -51,6 +54,7 @@ namespace
 {
     const wchar_t PT_URI_PROTOCOL_SCHEME[] = L"powertoys://";
     const wchar_t POWER_TOYS_MODULE_LOAD_FAIL[] = L"Failed to load "; // Module name will be appended on this message and it is not localized.
+    const size_t MAX_MODULE_LOADER_THREADS = 4;
 }
 
 void chdir_current_executable()
@@ -160,17 +164,64 @@ int runner(bool isProcessElevated, bool openSettings, std::string settingsWindow
             knownModules.emplace_back(VCM_PATH);
         }
 
-        for (const auto& moduleSubdir : knownModules)
+        // With lazy activation, modules that have a manifest and start disabled aren't loaded until they're enabled
+        const bool lazyActivation = is_lazy_module_activation_enabled();
+        std::map<std::wstring, module_manifest::manifest> manifests;
+        std::vector<std::wstring_view> modulesToLoad;
+        if (lazyActivation)
+        {
+            manifests = module_manifest::load(get_product_version());
+            const auto generalSettings = load_general_settings();
+            for (const auto& dll : knownModules)
+            {
+                const auto manifest = manifests.find(std::wstring{ dll });
+                if (manifest == end(manifests) || is_powertoy_enabled_at_start(generalSettings, manifest->second.key, manifest->second.enabled_by_default))
+                {
+                    modulesToLoad.push_back(dll);
+                }
+            }
+        }
+        else
+        {
+            modulesToLoad = knownModules;
+        }
+
+        // The DLLs are loaded and the modules created concurrently. They're registered here in the order
+        // of knownModules, so their hotkeys are registered in the same order on every start.
+        const size_t loaderThreads = std::min<size_t>(MAX_MODULE_LOADER_THREADS, std::max(std::thread::hardware_concurrency(), 1u));
+        auto loadedModules = create_powertoys(modulesToLoad, loaderThreads);
+        for (size_t i = 0, loadedIndex = 0; i < knownModules.size(); i++)
         {
             try
             {
-                auto pt_module = load_powertoy(moduleSubdir);
-                modules().emplace(pt_module->get_key(), std::move(pt_module));
+                const std::wstring dll{ knownModules[i] };
+                const bool loaded = loadedIndex < modulesToLoad.size() && modulesToLoad[loadedIndex] == knownModules[i];
+                if (!loaded)
+                {
+                    modules().emplace(manifests[dll].key, PowertoyModule{ new LazyPowertoy(dll, manifests[dll]), nullptr });
+                    continue;
+                }
+
+                auto& loadedModule = loadedModules[loadedIndex++];
+                if (!loadedModule.has_value())
+                {
+                    throw std::runtime_error("Module not loaded");
+                }
+
+                if (lazyActivation)
+                {
+                    auto config = std::move(loadedModule->config);
+                    loadedModule = LoadedPowertoy{ .pt_module{ new LazyPowertoy(dll, std::move(loadedModule.value())) }, .config = std::move(config) };
+                }
+
+                PowertoyModule pt_module{ std::move(loadedModule.value()) };
+                std::wstring key = pt_module->get_key();
+                modules().emplace(std::move(key), std::move(pt_module));
             }
             catch (...)
             {
                 std::wstring errorMessage = POWER_TOYS_MODULE_LOAD_FAIL;
-                errorMessage += moduleSubdir;
+                errorMessage += knownModules[i];
                 MessageBoxW(NULL,
                             errorMessage.c_str(),
                             L"PowerToys",
@@ -180,6 +231,11 @@ int runner(bool isProcessElevated, bool openSettings, std::string settingsWindow
         // Start initial powertoys
         start_enabled_powertoys();
         std::wstring product_version = get_product_version();
+        startup_timeline::save(product_version, loaderThreads);
+        if (lazyActivation)
+        {
+            LazyPowertoy::save_manifests();
+        }
         Trace::EventLaunch(product_version, isProcessElevated);
         PTSettingsHelper::save_last_version_run(product_version);
 
@@ -205,6 +261,10 @@ int runner(bool isProcessElevated, bool openSettings, std::string settingsWindow
 
         settings_telemetry::init();
         result = run_message_loop();
+        if (lazyActivation)
+        {
+            LazyPowertoy::save_manifests();
+        }
     }
     catch (std::runtime_error& err)
     {
@@ -449,5 +509,6 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         }
     }
     stop_tray_icon();
+    Logger::shutdown();
     return result;
 }
@@ -0,0 +1,185 @@
+#include "pch.h"
+#include "module_manifest.h"
+
+#include <filesystem>
+
+#include <common/logger/logger.h>
+#include <common/SettingsAPI/settings_helpers.h>
+#include <common/utils/json.h>
+
+namespace
+{
+    std::wstring get_manifests_file_path()
+    {
+        std::filesystem::path path(PTSettingsHelper::get_root_save_folder_location());
+        return path.append(module_manifest::manifests_file).wstring();
+    }
+
+    std::wstring read_config(PowertoyModuleIface* pt_module)
+    {
+        try
+        {
+            int size = 0;
+            pt_module->get_config(nullptr, &size);
+            if (size <= 1)
+            {
+                return {};
+            }
+
+            std::wstring result;
+            result.resize(size - 1);
+            if (!pt_module->get_config(result.data(), &size))
+            {
+                return {};
+            }
+
+            return result;
+        }
+        catch (...)
+        {
+            return {};
+        }
+    }
+
+    json::JsonObject hotkey_to_json(const PowertoyModuleIface::Hotkey& hotkey)
+    {
+        json::JsonObject result;
+        result.SetNamedValue(L"win", json::value(hotkey.win));
+        result.SetNamedValue(L"ctrl", json::value(hotkey.ctrl));
+        result.SetNamedValue(L"shift", json::value(hotkey.shift));
+        result.SetNamedValue(L"alt", json::value(hotkey.alt));
+        result.SetNamedValue(L"key", json::value(hotkey.key));
+        return result;
+    }
+
+    PowertoyModuleIface::Hotkey hotkey_from_json(const json::JsonObject& obj)
+    {
+        return PowertoyModuleIface::Hotkey{
+            .win = obj.GetNamedBoolean(L"win"),
+            .ctrl = obj.GetNamedBoolean(L"ctrl"),
+            .shift = obj.GetNamedBoolean(L"shift"),
+            .alt = obj.GetNamedBoolean(L"alt"),
+            .key = static_cast<unsigned char>(obj.GetNamedNumber(L"key")),
+        };
+    }
+
+    json::JsonObject manifest_to_json(const module_manifest::manifest& manifest)
+    {
+        json::JsonObject result;
+        result.SetNamedValue(L"key", json::value(manifest.key));
+        result.SetNamedValue(L"name", json::value(manifest.name));
+        result.SetNamedValue(L"enabled_by_default", json::value(manifest.enabled_by_default));
+
+        json::JsonArray hotkeys;
+        for (const auto& hotkey : manifest.hotkeys)
+        {
+            hotkeys.Append(hotkey_to_json(hotkey));
+        }
+        result.SetNamedValue(L"hotkeys", hotkeys);
+
+        if (manifest.hotkey_ex.has_value())
+        {
+            json::JsonObject hotkey_ex;
+            hotkey_ex.SetNamedValue(L"modifiers", json::value(manifest.hotkey_ex->modifiersMask));
+            hotkey_ex.SetNamedValue(L"vk_code", json::value(manifest.hotkey_ex->vkCode));
+            result.SetNamedValue(L"hotkey_ex", hotkey_ex);
+        }
+
+        result.SetNamedValue(L"keep_track_of_pressed_win_key", json::value(manifest.keep_track_of_pressed_win_key));
+        result.SetNamedValue(L"milliseconds_win_key_must_be_pressed", json::value(manifest.milliseconds_win_key_must_be_pressed));
+        result.SetNamedValue(L"config", json::value(manifest.config));
+        return result;
+    }
+
+    module_manifest::manifest manifest_from_json(const json::JsonObject& obj)
+    {
+        module_manifest::manifest result{
+            .key = std::wstring{ obj.GetNamedString(L"key") },
+            .name = std::wstring{ obj.GetNamedString(L"name") },
+            .enabled_by_default = obj.GetNamedBoolean(L"enabled_by_default"),
+            .keep_track_of_pressed_win_key = obj.GetNamedBoolean(L"keep_track_of_pressed_win_key"),
+            .milliseconds_win_key_must_be_pressed = static_cast<UINT>(obj.GetNamedNumber(L"milliseconds_win_key_must_be_pressed")),
+            .config = std::wstring{ obj.GetNamedString(L"config") },
+        };
+
+        for (const auto& hotkey : obj.GetNamedArray(L"hotkeys"))
+        {
+            result.hotkeys.push_back(hotkey_from_json(hotkey.GetObjectW()));
+        }
+
+        if (json::has(obj, L"hotkey_ex"))
+        {
+            const auto hotkey_ex = obj.GetNamedObject(L"hotkey_ex");
+            result.hotkey_ex = PowertoyModuleIface::HotkeyEx{
+                .modifiersMask = static_cast<WORD>(hotkey_ex.GetNamedNumber(L"modifiers")),
+                .vkCode = static_cast<WORD>(hotkey_ex.GetNamedNumber(L"vk_code")),
+            };
+        }
+
+        return result;
+    }
+}
+
+namespace module_manifest
+{
+    manifest read_from(PowertoyModuleIface* pt_module)
+    {
+        manifest result{
+            .key = pt_module->get_key(),
+            .name = pt_module->get_name(),
+            .enabled_by_default = pt_module->is_enabled_by_default(),
+            .hotkey_ex = pt_module->GetHotkeyEx(),
+            .keep_track_of_pressed_win_key = pt_module->keep_track_of_pressed_win_key(),
+            .milliseconds_win_key_must_be_pressed = pt_module->milliseconds_win_key_must_be_pressed(),
+            .config = read_config(pt_module),
+        };
+
+        result.hotkeys.resize(pt_module->get_hotkeys(nullptr, 0));
+        pt_module->get_hotkeys(result.hotkeys.data(), result.hotkeys.size());
+        return result;
+    }
+
+    std::map<std::wstring, manifest> load(const std::wstring& product_version)
+    {
+        std::map<std::wstring, manifest> result;
+        auto saved = json::from_file(get_manifests_file_path());
+        if (!saved.has_value())
+        {
+            return result;
+        }
+
+        try
+        {
+            if (saved->GetNamedString(L"version", L"") != product_version)
+            {
+                return result;
+            }
+
+            for (const auto& element : saved->GetNamedObject(L"modules"))
+            {
+                result.emplace(element.Key().c_str(), manifest_from_json(element.Value().GetObjectW()));
+            }
+        }
+        catch (...)
+        {
+            Logger::warn(L"Module manifests are malformed, all modules will be loaded");
+            result.clear();
+        }
+
+        return result;
+    }
+
+    void save(const std::map<std::wstring, manifest>& manifests, const std::wstring& product_version)
+    {
+        json::JsonObject modules;
+        for (const auto& [dll, manifest] : manifests)
+        {
+            modules.SetNamedValue(dll, manifest_to_json(manifest));
+        }
+
+        json::JsonObject root;
+        root.SetNamedValue(L"version", json::value(product_version));
+        root.SetNamedValue(L"modules", modules);
+        json::to_file(get_manifests_file_path(), root);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <interface/powertoy_module_interface.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+// What the runner needs to know about a module without loading its DLL. The manifests are
+// taken from the loaded modules and kept in module-manifests.json in the PowerToys settings folder.
+namespace module_manifest
+{
+    static std::wstring manifests_file = L"module-manifests.json";
+
+    struct manifest
+    {
+        std::wstring key;
+        std::wstring name;
+        bool enabled_by_default = true;
+        std::vector<PowertoyModuleIface::Hotkey> hotkeys;
+        std::optional<PowertoyModuleIface::HotkeyEx> hotkey_ex;
+        bool keep_track_of_pressed_win_key = false;
+        UINT milliseconds_win_key_must_be_pressed = 0;
+        // Last configuration reported by get_config, empty if the module didn't report one
+        std::wstring config;
+    };
+
+    // Reads the manifest of a loaded module
+    manifest read_from(PowertoyModuleIface* pt_module);
+
+    // Returns the saved manifests by module DLL path. Manifests saved by another
+    // PowerToys version are dropped, since the modules may have changed.
+    std::map<std::wstring, manifest> load(const std::wstring& product_version);
+    void save(const std::map<std::wstring, manifest>& manifests, const std::wstring& product_version);
+}
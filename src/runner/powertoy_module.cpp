@@ -2,41 +2,150 @@
 #include "powertoy_module.h"
 #include "centralized_kb_hook.h"
 #include "centralized_hotkeys.h"
+#include "startup_timeline.h"
 #include <common/logger/logger.h>
 #include <common/utils/winapi_error.h>
 
+#include <atomic>
+
 std::map<std::wstring, PowertoyModule>& modules()
 {
     static std::map<std::wstring, PowertoyModule> modules;
     return modules;
 }
 
-PowertoyModule load_powertoy(const std::wstring_view filename)
+namespace
 {
-    auto handle = winrt::check_pointer(LoadLibraryW(filename.data()));
-    auto create = reinterpret_cast<powertoy_create_func>(GetProcAddress(handle, "powertoy_create"));
+    json::JsonObject read_config(PowertoyModuleIface* pt_module)
+    {
+        int size = 0;
+        pt_module->get_config(nullptr, &size);
+        std::wstring result;
+        result.resize(size - 1);
+        pt_module->get_config(result.data(), &size);
+        return json::JsonObject::Parse(result);
+    }
+}
+
+LoadedPowertoy create_powertoy(const std::wstring_view filename)
+{
+    const auto load_start = startup_timeline::clock::now();
+    std::unique_ptr<HMODULE, PowertoyModuleDLLDeleter> handle{ winrt::check_pointer(LoadLibraryW(filename.data())) };
+    auto create = reinterpret_cast<powertoy_create_func>(GetProcAddress(handle.get(), "powertoy_create"));
     if (!create)
     {
-        FreeLibrary(handle);
         winrt::throw_last_error();
     }
-    auto pt_module = create();
+
+    const auto create_start = startup_timeline::clock::now();
+    std::unique_ptr<PowertoyModuleIface, PowertoyModuleDeleter> pt_module{ create() };
     if (!pt_module)
     {
-        FreeLibrary(handle);
         winrt::throw_hresult(winrt::hresult(E_POINTER));
     }
-    return PowertoyModule(pt_module, handle);
+
+    // Modules that fail to report their config here are asked again when it's first needed
+    const auto config_start = startup_timeline::clock::now();
+    std::optional<json::JsonObject> config;
+    try
+    {
+        config = read_config(pt_module.get());
+    }
+    catch (...)
+    {
+    }
+
+    const auto end = startup_timeline::clock::now();
+    const std::wstring key = pt_module->get_key();
+    startup_timeline::record(key, startup_timeline::phase::load, load_start, create_start);
+    startup_timeline::record(key, startup_timeline::phase::create, create_start, config_start);
+    startup_timeline::record(key, startup_timeline::phase::config, config_start, end);
+
+    return LoadedPowertoy{ std::move(handle), std::move(pt_module), std::move(config) };
+}
+
+PowertoyModule load_powertoy(const std::wstring_view filename)
+{
+    return PowertoyModule(create_powertoy(filename));
+}
+
+std::vector<std::optional<LoadedPowertoy>> create_powertoys(const std::vector<std::wstring_view>& filenames, size_t max_threads)
+{
+    std::vector<std::optional<LoadedPowertoy>> result(filenames.size());
+    std::atomic_size_t next = 0;
+    auto worker = [&] {
+        winrt::init_apartment();
+        for (size_t i = next++; i < filenames.size(); i = next++)
+        {
+            try
+            {
+                result[i] = create_powertoy(filenames[i]);
+            }
+            catch (const winrt::hresult_error& e)
+            {
+                Logger::error(L"Failed to load {}: {}", filenames[i], e.message());
+            }
+            catch (const std::exception& e)
+            {
+                Logger::error("Failed to load {}: {}", winrt::to_string(filenames[i]), e.what());
+            }
+            catch (...)
+            {
+                Logger::error(L"Failed to load {}", filenames[i]);
+            }
+        }
+        winrt::uninit_apartment();
+    };
+
+    const size_t thread_count = std::clamp<size_t>(max_threads, 1, std::max<size_t>(filenames.size(), 1));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        threads.emplace_back(worker);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return result;
 }
 
 json::JsonObject PowertoyModule::json_config() const
 {
-    int size = 0;
-    pt_module->get_config(nullptr, &size);
-    std::wstring result;
-    result.resize(size - 1);
-    pt_module->get_config(result.data(), &size);
-    return json::JsonObject::Parse(result);
+    if (!cached_config)
+    {
+        cached_config = read_config(pt_module.get());
+    }
+
+    return *cached_config;
+}
+
+void PowertoyModule::invalidate_config()
+{
+    cached_config.reset();
+    applied_settings.reset();
+}
+
+void PowertoyModule::call_custom_action(const wchar_t* action)
+{
+    pt_module->call_custom_action(action);
+    invalidate_config();
+}
+
+bool PowertoyModule::apply_config(const std::wstring& settings)
+{
+    if (applied_settings == settings)
+    {
+        Logger::trace(L"Settings for {} are unchanged, skipping set_config", pt_module->get_key());
+        return false;
+    }
+
+    pt_module->set_config(settings.c_str());
+    cached_config.reset();
+    applied_settings = settings;
+    return true;
 }
 
 PowertoyModule::PowertoyModule(PowertoyModuleIface* pt_module, HMODULE handle) :
@@ -47,8 +156,54 @@ PowertoyModule::PowertoyModule(PowertoyModuleIface* pt_module, HMODULE handle) :
         throw std::runtime_error("Module not initialized");
     }
 
+    sync_hotkeys();
+}
+
+PowertoyModule::PowertoyModule(LoadedPowertoy loaded) :
+    handle(std::move(loaded.handle)), pt_module(std::move(loaded.pt_module)), cached_config(std::move(loaded.config))
+{
+    if (!pt_module)
+    {
+        throw std::runtime_error("Module not initialized");
+    }
+
+    // Hotkeys are registered on the calling thread, in the order the modules are registered
+    sync_hotkeys();
+}
+
+bool PowertoyModule::HotkeyState::operator==(const HotkeyState& other) const
+{
+    if (enabled != other.enabled || hotkeys != other.hotkeys || hotkeyEx.has_value() != other.hotkeyEx.has_value())
+    {
+        return false;
+    }
+
+    return !hotkeyEx.has_value() ||
+           (hotkeyEx->modifiersMask == other.hotkeyEx->modifiersMask && hotkeyEx->vkCode == other.hotkeyEx->vkCode);
+}
+
+PowertoyModule::HotkeyState PowertoyModule::query_hotkey_state()
+{
+    HotkeyState state;
+    size_t hotkeyCount = pt_module->get_hotkeys(nullptr, 0);
+    state.hotkeys.resize(hotkeyCount);
+    pt_module->get_hotkeys(state.hotkeys.data(), hotkeyCount);
+    state.hotkeyEx = pt_module->GetHotkeyEx();
+    state.enabled = pt_module->is_enabled();
+    return state;
+}
+
+void PowertoyModule::sync_hotkeys()
+{
+    auto state = query_hotkey_state();
+    if (registered_hotkeys == state)
+    {
+        return;
+    }
+
     update_hotkeys();
     UpdateHotkeyEx();
+    registered_hotkeys = std::move(state);
 }
 
 void PowertoyModule::update_hotkeys()
@@ -5,6 +5,7 @@
 #include <mutex>
 #include <vector>
 #include <functional>
+#include <optional>
 
 #include <common/utils/json.h>
 
@@ -28,26 +29,72 @@ struct PowertoyModuleDLLDeleter
     }
 };
 
+// Module DLL that was loaded and instantiated, but isn't registered with the runner yet
+struct LoadedPowertoy
+{
+    std::unique_ptr<HMODULE, PowertoyModuleDLLDeleter> handle;
+    std::unique_ptr<PowertoyModuleIface, PowertoyModuleDeleter> pt_module;
+    std::optional<json::JsonObject> config;
+};
+
 class PowertoyModule
 {
 public:
     PowertoyModule(PowertoyModuleIface* pt_module, HMODULE handle);
+    explicit PowertoyModule(LoadedPowertoy loaded);
 
     inline PowertoyModuleIface* operator->()
     {
         return pt_module.get();
     }
 
+    // Returns the module configuration, as reported by get_config(). The result is cached
+    // and only requested from the module again after invalidate_config() was called.
     json::JsonObject json_config() const;
 
+    // Forgets the cached configuration and the last applied settings, for when the module
+    // may have changed its settings on its own.
+    void invalidate_config();
+
+    // Custom actions may change the module settings, so the configuration is invalidated.
+    void call_custom_action(const wchar_t* action);
+
+    // Passes the settings to the module, unless they're identical to the last ones applied.
+    // Returns true if set_config() was called.
+    bool apply_config(const std::wstring& settings);
+
     void update_hotkeys();
 
     void UpdateHotkeyEx();
 
+    // Re-registers the module hotkeys only if they differ from the currently registered ones.
+    void sync_hotkeys();
+
 private:
+    struct HotkeyState
+    {
+        std::vector<PowertoyModuleIface::Hotkey> hotkeys;
+        std::optional<PowertoyModuleIface::HotkeyEx> hotkeyEx;
+        bool enabled = false;
+
+        bool operator==(const HotkeyState& other) const;
+    };
+
+    HotkeyState query_hotkey_state();
+
     std::unique_ptr<HMODULE, PowertoyModuleDLLDeleter> handle;
     std::unique_ptr<PowertoyModuleIface, PowertoyModuleDeleter> pt_module;
+
+    mutable std::optional<json::JsonObject> cached_config;
+    std::optional<std::wstring> applied_settings;
+    std::optional<HotkeyState> registered_hotkeys;
 };
 
+LoadedPowertoy create_powertoy(const std::wstring_view filename);
 PowertoyModule load_powertoy(const std::wstring_view filename);
+
+// Loads the DLLs and creates the modules on up to max_threads threads. Modules must not create
+// thread-affine resources such as windows or hooks in powertoy_create, those belong in enable().
+// The results are in the order of filenames, a module that failed to load is left empty.
+std::vector<std::optional<LoadedPowertoy>> create_powertoys(const std::vector<std::wstring_view>& filenames, size_t max_threads);
 std::map<std::wstring, PowertoyModule>& modules();
@@ -110,7 +110,7 @@ std::optional<std::wstring> dispatch_json_action_to_module(const json::JsonObjec
         else if (modules().find(name) != modules().end())
         {
             const auto element = powertoy_element.Value().Stringify();
-            modules().at(name)->call_custom_action(element.c_str());
+            modules().at(name).call_custom_action(element.c_str());
         }
     }
 
@@ -122,9 +122,12 @@ void send_json_config_to_module(const std::wstring& module_key, const std::wstri
     auto moduleIt = modules().find(module_key);
     if (moduleIt != modules().end())
     {
-        moduleIt->second->set_config(settings.c_str());
-        moduleIt->second.update_hotkeys();
-        moduleIt->second.UpdateHotkeyEx();
+        // Only modules whose settings actually changed get called, and their hotkeys
+        // are re-registered only if set_config changed them.
+        if (moduleIt->second.apply_config(settings))
+        {
+            moduleIt->second.sync_hotkeys();
+        }
     }
 }
 
@@ -132,8 +135,8 @@ void dispatch_json_config_to_modules(const json::JsonObject& powertoys_configs)
 {
     for (const auto& powertoy_element : powertoys_configs)
     {
-        const auto element = powertoy_element.Value().Stringify();
-        send_json_config_to_module(powertoy_element.Key().c_str(), element.c_str());
+        const std::wstring element{ powertoy_element.Value().Stringify() };
+        send_json_config_to_module(powertoy_element.Key().c_str(), element);
     }
 };
 
@@ -160,19 +163,25 @@ void dispatch_received_json(const std::wstring& json_to_parse)
         if (name == L"general")
         {
             apply_general_settings(value.GetObjectW());
-            const std::wstring settings_string{ get_all_settings().Stringify().c_str() };
-            current_settings_ipc->send(settings_string);
+            std::wstring settings_string{ get_all_settings().Stringify().c_str() };
+            current_settings_ipc->send(std::move(settings_string));
         }
         else if (name == L"powertoys")
         {
             dispatch_json_config_to_modules(value.GetObjectW());
-            const std::wstring settings_string{ get_all_settings().Stringify().c_str() };
-            current_settings_ipc->send(settings_string);
+            std::wstring settings_string{ get_all_settings().Stringify().c_str() };
+            current_settings_ipc->send(std::move(settings_string));
         }
         else if (name == L"refresh")
         {
-            const std::wstring settings_string{ get_all_settings().Stringify().c_str() };
-            current_settings_ipc->send(settings_string);
+            // Modules may have changed their settings since they were cached
+            for (auto& [key, powertoy] : modules())
+            {
+                powertoy.invalidate_config();
+            }
+
+            std::wstring settings_string{ get_all_settings().Stringify().c_str() };
+            current_settings_ipc->send(std::move(settings_string));
         }
         else if (name == L"action")
         {
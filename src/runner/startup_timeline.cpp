@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "startup_timeline.h"
+
+#include <filesystem>
+#include <map>
+
+#include <common/logger/logger.h>
+#include <common/SettingsAPI/settings_helpers.h>
+#include <common/utils/json.h>
+#include <common/utils/timeutil.h>
+
+namespace
+{
+    // Number of runs kept in the timeline file
+    const uint32_t max_saved_runs = 20;
+
+    struct event
+    {
+        std::wstring module;
+        startup_timeline::phase phase;
+        startup_timeline::clock::time_point start;
+        startup_timeline::clock::time_point end;
+    };
+
+    // Offsets in the timeline are relative to the start of the process
+    const startup_timeline::clock::time_point origin = startup_timeline::clock::now();
+
+    std::mutex events_mutex;
+    std::vector<event> events;
+    bool saved = false;
+
+    const wchar_t* phase_name(startup_timeline::phase phase)
+    {
+        switch (phase)
+        {
+        case startup_timeline::phase::load:
+            return L"load";
+        case startup_timeline::phase::create:
+            return L"create";
+        case startup_timeline::phase::config:
+            return L"config";
+        case startup_timeline::phase::enable:
+            return L"enable";
+        }
+
+        return L"unknown";
+    }
+
+    double to_ms(startup_timeline::clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    std::wstring get_timeline_file_path()
+    {
+        std::filesystem::path path(PTSettingsHelper::get_root_save_folder_location());
+        return path.append(startup_timeline::timeline_file).wstring();
+    }
+}
+
+namespace startup_timeline
+{
+    void record(const std::wstring& module, phase phase, clock::time_point start, clock::time_point end)
+    {
+        std::lock_guard lock{ events_mutex };
+        if (!saved)
+        {
+            events.push_back({ module, phase, start, end });
+        }
+    }
+
+    void save(const std::wstring& product_version, size_t loader_threads)
+    {
+        std::vector<event> timeline;
+        {
+            std::lock_guard lock{ events_mutex };
+            timeline = std::move(events);
+            saved = true;
+        }
+
+        // Modules by name, so runs can be compared even if the modules were loaded in another order
+        std::map<std::wstring, json::JsonObject> modules;
+        clock::time_point end = origin;
+        for (const auto& e : timeline)
+        {
+            json::JsonObject phase;
+            phase.SetNamedValue(L"start_ms", json::value(to_ms(e.start - origin)));
+            phase.SetNamedValue(L"duration_ms", json::value(to_ms(e.end - e.start)));
+
+            auto [it, inserted] = modules.try_emplace(e.module);
+            it->second.SetNamedValue(phase_name(e.phase), phase);
+            end = std::max(end, e.end);
+
+            Logger::trace(L"Startup timeline: {} {} took {:.2f} ms", e.module, phase_name(e.phase), to_ms(e.end - e.start));
+        }
+
+        Logger::info(L"Startup of {} modules took {:.2f} ms on {} loader threads", modules.size(), to_ms(end - origin), loader_threads);
+
+        json::JsonObject modules_json;
+        for (auto& [name, phases] : modules)
+        {
+            modules_json.SetNamedValue(name, phases);
+        }
+
+        json::JsonObject run;
+        run.SetNamedValue(L"version", json::value(product_version));
+        run.SetNamedValue(L"time", json::value(timeutil::to_string(std::time(nullptr))));
+        run.SetNamedValue(L"loader_threads", json::value(static_cast<double>(loader_threads)));
+        run.SetNamedValue(L"total_ms", json::value(to_ms(end - origin)));
+        run.SetNamedValue(L"modules", modules_json);
+
+        try
+        {
+            const auto path = get_timeline_file_path();
+            json::JsonArray runs;
+            if (auto previous = json::from_file(path); previous.has_value() && json::has(*previous, L"runs", json::JsonValueType::Array))
+            {
+                const auto previous_runs = previous->GetNamedArray(L"runs");
+                const uint32_t first = previous_runs.Size() >= max_saved_runs ? previous_runs.Size() - max_saved_runs + 1 : 0;
+                for (uint32_t i = first; i < previous_runs.Size(); i++)
+                {
+                    runs.Append(previous_runs.GetAt(i));
+                }
+            }
+            runs.Append(run);
+
+            json::JsonObject root;
+            root.SetNamedValue(L"runs", runs);
+            json::to_file(path, root);
+        }
+        catch (...)
+        {
+            Logger::warn("Failed to save the startup timeline");
+        }
+    }
+}
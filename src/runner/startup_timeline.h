@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// Records how long each step of the runner startup takes per module. The timelines of the last
+// runs are kept in startup-timeline.json in the PowerToys settings folder, so they can be compared.
+namespace startup_timeline
+{
+    static std::wstring timeline_file = L"startup-timeline.json";
+
+    enum class phase
+    {
+        load, // LoadLibrary of the module DLL
+        create, // powertoy_create
+        config, // get_config
+        enable, // enable, for the modules enabled at startup
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    // Thread-safe. Calls made after save() are ignored.
+    void record(const std::wstring& module, phase phase, clock::time_point start, clock::time_point end);
+
+    // Records the time between its construction and destruction
+    class scope
+    {
+    public:
+        scope(std::wstring module, phase phase) :
+            module(std::move(module)), timed_phase(phase), start(clock::now())
+        {
+        }
+
+        ~scope()
+        {
+            record(module, timed_phase, start, clock::now());
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        std::wstring module;
+        phase timed_phase;
+        clock::time_point start;
+    };
+
+    // Logs the timeline and saves it together with the timelines of the previous runs
+    void save(const std::wstring& product_version, size_t loader_threads);
+}
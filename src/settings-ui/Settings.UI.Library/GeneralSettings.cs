@@ -50,6 +50,10 @@ namespace Microsoft.PowerToys.Settings.UI.Library
         [JsonPropertyName("download_updates_automatically")]
         public bool AutoDownloadUpdates { get; set; }
 
+        // Gets or sets a value indicating whether modules that start disabled are only loaded once they're enabled.
+        [JsonPropertyName("lazy_module_activation")]
+        public bool LazyModuleActivation { get; set; }
+
         [SuppressMessage("Design", "CA1031:Do not catch general exception types", Justification = "Any error from calling interop code should not prevent the program from loading.")]
         public GeneralSettings()
         {
@@ -57,6 +61,7 @@ namespace Microsoft.PowerToys.Settings.UI.Library
             IsAdmin = false;
             IsElevated = false;
             AutoDownloadUpdates = false;
+            LazyModuleActivation = false;
             Theme = "system";
             SystemTheme = "light";
             try
@@ -15,6 +15,8 @@ namespace Microsoft.PowerToys.Settings.UI.Library
             PressTime = new IntProperty(900);
             Theme = new StringProperty("system");
             DisabledApps = new StringProperty();
+            KeepResident = new BoolProperty(false);
+            ResidentMemoryBudget = new IntProperty(64);
             OpenShortcutGuide = new HotkeySettings(true, false, false, true, 0xBF);
         }
 
@@ -35,5 +37,11 @@ namespace Microsoft.PowerToys.Settings.UI.Library
 
         [JsonPropertyName("disabled_apps")]
         public StringProperty DisabledApps { get; set; }
+
+        [JsonPropertyName("keep_resident")]
+        public BoolProperty KeepResident { get; set; }
+
+        [JsonPropertyName("resident_memory_budget")]
+        public IntProperty ResidentMemoryBudget { get; set; }
     }
 }
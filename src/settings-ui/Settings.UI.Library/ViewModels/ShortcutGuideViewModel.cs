@@ -56,6 +56,8 @@ namespace Microsoft.PowerToys.Settings.UI.Library.ViewModels
             _pressTime = Settings.Properties.PressTime.Value;
             _opacity = Settings.Properties.OverlayOpacity.Value;
             _disabledApps = Settings.Properties.DisabledApps.Value;
+            _keepResident = Settings.Properties.KeepResident.Value;
+            _residentMemoryBudget = Settings.Properties.ResidentMemoryBudget.Value;
 
             switch (Settings.Properties.Theme.Value)
             {
@@ -70,6 +72,8 @@ namespace Microsoft.PowerToys.Settings.UI.Library.ViewModels
         private bool _useLegacyPressWinKeyBehavior;
         private int _pressTime;
         private int _opacity;
+        private bool _keepResident;
+        private int _residentMemoryBudget;
 
         public bool IsEnabled
         {
@@ -207,6 +211,42 @@ namespace Microsoft.PowerToys.Settings.UI.Library.ViewModels
             }
         }
 
+        public bool KeepResident
+        {
+            get
+            {
+                return _keepResident;
+            }
+
+            set
+            {
+                if (_keepResident != value)
+                {
+                    _keepResident = value;
+                    Settings.Properties.KeepResident.Value = value;
+                    NotifyPropertyChanged();
+                }
+            }
+        }
+
+        public int ResidentMemoryBudget
+        {
+            get
+            {
+                return _residentMemoryBudget;
+            }
+
+            set
+            {
+                if (_residentMemoryBudget != value)
+                {
+                    _residentMemoryBudget = value;
+                    Settings.Properties.ResidentMemoryBudget.Value = value;
+                    NotifyPropertyChanged();
+                }
+            }
+        }
+
         public string GetSettingsSubPath()
         {
             return _settingsConfigFileFolder + "\\" + ModuleName;
@@ -4,7 +4,7 @@
 #include <sddl.h>
 #include <stdio.h>
 #include <winevt.h>
-#include <fstream>
+#include <sstream>
 #include <string>
 #include <common/utils/winapi_error.h>
 
@@ -40,7 +40,8 @@ namespace
             return buff;
         }
 
-        std::wofstream report;
+        std::wostringstream report;
+        std::wstring reportName;
         EVT_HANDLE hResults;
 
         void PrintEvent(EVT_HANDLE hEvent)
@@ -130,12 +131,9 @@ namespace
         }
 
     public:
-        EventViewerReporter(const std::filesystem::path& tmpDir, std::wstring processName)
+        EventViewerReporter(std::wstring processName)
         {
-            auto query = GetQuery(processName);
-            auto reportPath = tmpDir;
-            reportPath.append(L"EventViewer-" + processName + L".xml");
-            report = std::wofstream(reportPath);
+            reportName = L"EventViewer-" + processName + L".xml";
 
             hResults = EvtQuery(NULL, NULL, GetQuery(processName).c_str(), EvtQueryChannelPath);
             if (NULL == hResults)
@@ -154,7 +152,7 @@ namespace
             }
         }
 
-        void Report()
+        void Report(ReportArchive& archive)
         {
             try
             {
@@ -167,14 +165,16 @@ namespace
             {
                 report << "Failed to report info" << std::endl;
             }
+
+            archive.AddText(reportName, report.str());
         }
     };
 }
 
-void EventViewer::ReportEventViewerInfo(const std::filesystem::path& tmpDir)
+void EventViewer::ReportEventViewerInfo(ReportArchive& archive)
 {
     for (auto& process : processes)
     {
-        EventViewerReporter(tmpDir, process).Report();
+        EventViewerReporter(process).Report(archive);
     }
 }
@@ -1,7 +1,7 @@
 #pragma once
-#include <filesystem>
+#include "ZipTools/ReportArchive.h"
 
 namespace EventViewer
 {
-    void ReportEventViewerInfo(const std::filesystem::path& tmpDir);
+    void ReportEventViewerInfo(ReportArchive& archive);
 }
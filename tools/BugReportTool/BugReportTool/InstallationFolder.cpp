@@ -1,7 +1,7 @@
 #include "InstallationFolder.h"
 
-#include <fstream>
 #include <set>
+#include <sstream>
 #include <Windows.h>
 #include <common/utils/winapi_error.h>
 
@@ -155,18 +155,11 @@ wstring GetChecksum(path filePath)
 class Reporter
 {
 private:
-	std::wofstream os;
-	std::wofstream GetOutputStream(const path& tmpDir)
-	{
-		auto path = tmpDir;
-		path += "installationFolderStructure.txt";
-		std::wofstream os = std::wofstream(path);
-		return os;
-	}
+	std::wostringstream os;
 public:
-	Reporter(const path& tmpDir)
+	std::wstring Text() const
 	{
-		os = GetOutputStream(tmpDir);
+		return os.str();
 	}
 
 	void Report(path dirPath, int indentation = 0)
@@ -206,11 +199,13 @@ public:
 	}
 };
 
-void InstallationFolder::ReportStructure(const path& tmpDir)
+void InstallationFolder::ReportStructure(ReportArchive& archive)
 {
 	auto rootPath = GetRootPath();
 	if (rootPath)
 	{
-		Reporter(tmpDir).Report(rootPath.value());
+		Reporter reporter;
+		reporter.Report(rootPath.value());
+		archive.AddText("installationFolderStructure.txt", reporter.Text());
 	}
 }
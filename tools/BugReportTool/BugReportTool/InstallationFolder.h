@@ -1,7 +1,7 @@
 ﻿#pragma once
-#include <filesystem>
+#include "ZipTools/ReportArchive.h"
 
 namespace InstallationFolder
 {
-	void ReportStructure(const std::filesystem::path& tmpDir);
+	void ReportStructure(ReportArchive& archive);
 };
@@ -1,15 +1,23 @@
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <Shlobj.h>
+#include <Psapi.h>
 #include <winrt/Windows.Data.Json.h>
 #include <winrt/Windows.Foundation.Collections.h>
 #include <winrt/Windows.System.UserProfile.h>
 #include <winrt/Windows.Globalization.h>
 
-#include "ZipTools/ZipFolder.h"
+#include "ZipTools/ReportArchive.h"
 #include <common/SettingsAPI/settings_helpers.h>
+#include <common/logger/log_retention.h>
+#include <common/logger/logger_settings.h>
 #include <common/utils/json.h>
 #include <common/utils/timeutil.h>
 #include <common/utils/exec.h>
@@ -28,7 +36,9 @@ map<wstring, vector<wstring>> escapeInfo = {
     { L"FancyZones\\settings.json", { L"properties/fancyzones_excluded_apps" } }
 };
 
-vector<wstring> filesToDelete = {
+// Left out of the report
+vector<wstring> filesToExclude = {
+    L"Updates",
     L"PowerToys Run\\Cache",
     L"PowerRename\\replace-mru.json",
     L"PowerRename\\search-mru.json",
@@ -103,61 +113,105 @@ void HideByXPath(IJsonValue& val, vector<wstring>& xpathArray, int p)
     }
 }
 
-void HideForFile(const path& dir, const wstring& relativePath)
+// Returns the content of a settings file with its private data hidden
+string HideForFile(const wstring& relativePath, string content)
 {
-    path jsonPath = dir;
-    jsonPath.append(relativePath);
-    auto jObject = json::from_file(jsonPath.wstring());
-    if (!jObject.has_value())
+    JsonObject jObject;
+    try
     {
-        wprintf(L"Failed to parse file %s\n", jsonPath.c_str());
-        return;
+        jObject = JsonValue::Parse(winrt::to_hstring(content)).GetObjectW();
+    }
+    catch (...)
+    {
+        wprintf(L"Failed to parse file %s\n", relativePath.c_str());
+        return content;
     }
 
-    JsonValue jValue = json::value(jObject.value());
-    for (auto xpath : escapeInfo[relativePath])
+    JsonValue jValue = json::value(jObject);
+    for (auto xpath : escapeInfo.at(relativePath))
     {
         vector<wstring> xpathArray = GetXpathArray(xpath);
         HideByXPath(jValue, xpathArray, 0);
     }
 
-    json::to_file(jsonPath.wstring(), jObject.value());
+    return winrt::to_string(jObject.Stringify());
 }
 
-bool DeleteFolder(wstring path)
+bool IsExcluded(const path& relativePath)
 {
-    error_code err;
-    remove_all(path, err);
-    if (err.value() != 0)
+    auto lowerPath = relativePath.wstring();
+    transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), towlower);
+    for (auto excluded : filesToExclude)
     {
-        wprintf_s(L"Failed to delete %s. Error code: %d\n", path.c_str(), err.value());
-        return false;
+        transform(excluded.begin(), excluded.end(), excluded.begin(), towlower);
+        if (lowerPath == excluded || lowerPath.starts_with(excluded + L"\\"))
+        {
+            return true;
+        }
     }
 
-    return true;
+    return false;
 }
 
-void HideUserPrivateInfo(const filesystem::path& dir)
+// Adds the settings folder, hiding the private data of the files in escapeInfo on the way.
+// With logsSince, only the messages logged from that hour on are added from the daily logs.
+void ReportSettings(ReportArchive& archive, const path& settingsRoot, optional<time_t> logsSince)
 {
-    // Replace data in json files
-    for (auto& it : escapeInfo)
+    error_code err;
+    recursive_directory_iterator it{ settingsRoot, directory_options::skip_permission_denied, err };
+    for (; !err && it != recursive_directory_iterator{}; it.increment(err))
     {
-        HideForFile(dir, it.first);
+        const auto relativePath = it->path().lexically_relative(settingsRoot);
+        if (IsExcluded(relativePath))
+        {
+            it.disable_recursion_pending();
+            continue;
+        }
+
+        error_code fileErr;
+        if (!it->is_regular_file(fileErr))
+        {
+            continue;
+        }
+
+        if (logsSince)
+        {
+            if (const auto log = LogRetention::ParseDailyLogName(it->path()))
+            {
+                if (LogRetention::NextDay(LogRetention::StartOfDay(log->day)) > *logsSince)
+                {
+                    // Compacted logs are added as text as well, so all of them read the same
+                    auto name = relativePath;
+                    name.replace_extension(L".txt");
+                    archive.AddText(name, LogRetention::ReadSince(it->path(), *logsSince));
+                }
+
+                continue;
+            }
+
+            if (it->path().extension() == L".index")
+            {
+                continue;
+            }
+        }
+
+        ReportArchive::Transform hide;
+        if (escapeInfo.contains(relativePath.wstring()))
+        {
+            hide = [name = relativePath.wstring()](string content) { return HideForFile(name, std::move(content)); };
+        }
+
+        archive.AddFile(relativePath, it->path(), std::move(hide));
     }
 
-    // Delete files
-    for (auto it : filesToDelete)
+    if (err)
     {
-        auto path = dir;
-        path = path.append(it);
-        DeleteFolder(path);
+        wprintf_s(L"Failed to read the PowerToys folder. Error code: %d\n", err.value());
     }
 }
 
-void ReportWindowsVersion(const filesystem::path& tmpDir)
+void ReportWindowsVersion(ReportArchive& archive)
 {
-    auto versionReportPath = tmpDir;
-    versionReportPath = versionReportPath.append("windows-version.txt");
     OSVERSIONINFOEXW osInfo;
 
     try
@@ -177,20 +231,14 @@ void ReportWindowsVersion(const filesystem::path& tmpDir)
         return;
     }
 
-    try
-    {
-        wofstream versionReport(versionReportPath);
-        versionReport << "MajorVersion: " << osInfo.dwMajorVersion << endl;
-        versionReport << "MinorVersion: " << osInfo.dwMinorVersion << endl;
-        versionReport << "BuildNumber: " << osInfo.dwBuildNumber << endl;
-    }
-    catch (...)
-    {
-        printf("Failed to write to %s\n", versionReportPath.string().c_str());
-    }
+    wostringstream versionReport;
+    versionReport << "MajorVersion: " << osInfo.dwMajorVersion << endl;
+    versionReport << "MinorVersion: " << osInfo.dwMinorVersion << endl;
+    versionReport << "BuildNumber: " << osInfo.dwBuildNumber << endl;
+    archive.AddText("windows-version.txt", versionReport.str());
 }
 
-void ReportWindowsSettings(const filesystem::path& tmpDir)
+void ReportWindowsSettings(ReportArchive& archive)
 {
     std::wstring userLanguage;
     std::wstring userLocale;
@@ -211,25 +259,16 @@ void ReportWindowsSettings(const filesystem::path& tmpDir)
         return;
     }
 
-    try
-    {
-        wofstream settingsReport(tmpDir / "windows-settings.txt");
-        settingsReport << "Preferred user language: " << userLanguage << endl;
-        settingsReport << "User locale: " << userLocale << endl;
-    }
-    catch (...)
-    {
-        printf("Failed to write windows settings\n");
-    }
+    wostringstream settingsReport;
+    settingsReport << "Preferred user language: " << userLanguage << endl;
+    settingsReport << "User locale: " << userLocale << endl;
+    archive.AddText("windows-settings.txt", settingsReport.str());
 }
 
-void ReportDotNetInstallationInfo(const filesystem::path& tmpDir)
+void ReportDotNetInstallationInfo(ReportArchive& archive)
 {
-    auto dotnetInfoPath = tmpDir;
-    dotnetInfoPath.append("dotnet-installation-info.txt");
     try
     {
-        wofstream dotnetReport(dotnetInfoPath);
         auto dotnetInfo = exec_and_read_output(LR"(dotnet --list-runtimes)");
         if (!dotnetInfo.has_value())
         {
@@ -237,7 +276,7 @@ void ReportDotNetInstallationInfo(const filesystem::path& tmpDir)
             return;
         }
 
-        dotnetReport << dotnetInfo.value().c_str();
+        archive.AddText("dotnet-installation-info.txt", dotnetInfo.value());
     }
     catch (...)
     {
@@ -245,14 +284,19 @@ void ReportDotNetInstallationInfo(const filesystem::path& tmpDir)
     }
 }
 
-void ReportVCMLogs(const filesystem::path& tmpDir, const filesystem::path& reportDir)
+void ReportVCMLogs(const filesystem::path& tmpDir, ReportArchive& archive)
 {
-    error_code ec;
-    copy(tmpDir / "PowerToysVideoConference_x86.log", reportDir, ec);
-    copy(tmpDir / "PowerToysVideoConference_x64.log", reportDir, ec);
+    for (auto fileName : { "PowerToysVideoConference_x86.log", "PowerToysVideoConference_x64.log" })
+    {
+        error_code ec;
+        if (is_regular_file(tmpDir / fileName, ec))
+        {
+            archive.AddFile(fileName, tmpDir / fileName);
+        }
+    }
 }
 
-void ReportInstallerLogs(const filesystem::path& tmpDir, const filesystem::path& reportDir)
+void ReportInstallerLogs(const filesystem::path& tmpDir, ReportArchive& archive)
 {
     const char* logFilePrefix = "powertoys-bootstrapper-msi-";
 
@@ -269,19 +313,81 @@ void ReportInstallerLogs(const filesystem::path& tmpDir, const filesystem::path&
         {
             continue;
         }
-        copy(entry.path(), reportDir / fileName, ec);
+        archive.AddFile(fileName, entry.path());
+    }
+}
+
+// Processes tracing their hot paths write the trace next to their log, which is collected with the settings
+void RequestPerfTraces()
+{
+    vector<DWORD> processIds(1024);
+    DWORD bytesReturned = 0;
+    while (EnumProcesses(processIds.data(), static_cast<DWORD>(processIds.size() * sizeof(DWORD)), &bytesReturned) &&
+           bytesReturned == processIds.size() * sizeof(DWORD))
+    {
+        processIds.resize(processIds.size() * 2);
+    }
+    processIds.resize(bytesReturned / sizeof(DWORD));
+
+    // Only the tracing modules create the events, every module of a process has its own slot
+    vector<HANDLE> writtenEvents;
+    for (const auto processId : processIds)
+    {
+        for (size_t slot = 0;; ++slot)
+        {
+            const auto eventSuffix = to_wstring(processId) + L"-" + to_wstring(slot);
+            HANDLE dumpEvent = OpenEventW(EVENT_MODIFY_STATE, FALSE, (LogSettings::perfTraceDumpEventPrefix + eventSuffix).c_str());
+            if (!dumpEvent)
+            {
+                break;
+            }
+
+            HANDLE writtenEvent = OpenEventW(SYNCHRONIZE, FALSE, (LogSettings::perfTraceWrittenEventPrefix + eventSuffix).c_str());
+            if (writtenEvent)
+            {
+                // Clears a signal left by a request that stopped waiting before the trace was written
+                WaitForSingleObject(writtenEvent, 0);
+                SetEvent(dumpEvent);
+                writtenEvents.push_back(writtenEvent);
+            }
+
+            CloseHandle(dumpEvent);
+        }
+    }
+
+    // The traces of processes that don't answer in time are left out of the report
+    const auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    for (HANDLE writtenEvent : writtenEvents)
+    {
+        const auto timeLeft = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+        WaitForSingleObject(writtenEvent, static_cast<DWORD>(max<long long>(timeLeft, 0)));
+        CloseHandle(writtenEvent);
     }
 }
 
 int wmain(int argc, wchar_t* argv[], wchar_t*)
 {
-    // Get path to save zip
+    // BugReportTool.exe [path to save zip] [--hours <only report the logs of the last hours>]
     wstring saveZipPath;
-    if (argc > 1)
+    optional<time_t> logsSince;
+    for (int i = 1; i < argc; ++i)
     {
-        saveZipPath = argv[1];
+        const wstring_view arg = argv[i];
+        if (arg == L"--hours" && i + 1 < argc)
+        {
+            const auto hours = _wtoi(argv[++i]);
+            if (hours > 0)
+            {
+                logsSince = time(nullptr) - static_cast<time_t>(hours) * 60 * 60;
+            }
+        }
+        else
+        {
+            saveZipPath = arg;
+        }
     }
-    else
+
+    if (saveZipPath.empty())
     {
         wchar_t buffer[MAX_PATH];
         if (SHGetSpecialFolderPath(HWND_DESKTOP, buffer, CSIDL_DESKTOP, FALSE))
@@ -295,75 +401,63 @@ int wmain(int argc, wchar_t* argv[], wchar_t*)
         }
     }
 
-    auto settingsRootPath = PTSettingsHelper::get_root_save_folder_location();
-    settingsRootPath = settingsRootPath + L"\\";
-
+    const path settingsRootPath = PTSettingsHelper::get_root_save_folder_location();
     const auto tempDir = temp_directory_path();
-    auto reportDir = temp_directory_path() / "PowerToys\\";
-    if (!DeleteFolder(reportDir))
-    {
-        printf("Failed to delete temp folder\n");
-        return 1;
-    }
 
+    string reportFilename{ "PowerToysReport_" };
+    reportFilename += timeutil::format_as_local("%F-%H-%M-%S", timeutil::now());
+    reportFilename += ".zip";
+    const auto zipPath = path{ saveZipPath } / reportFilename;
+
+    RequestPerfTraces();
+
+    optional<ReportArchive> archive;
     try
     {
-        copy(settingsRootPath, reportDir, copy_options::recursive);
-
-        // Remove updates folder contents
-        DeleteFolder(reportDir / "Updates");
+        archive.emplace(zipPath);
     }
     catch (...)
     {
-        printf("Failed to copy PowerToys folder\n");
+        printf("Failed to zip folder\n");
         return 1;
     }
 
+    // The collectors run in parallel and push their entries into the archive as soon as they have them
+    vector<future<void>> collectors;
+    auto collect = [&](auto report) {
+        collectors.push_back(async(launch::async, [&archive, report] { report(*archive); }));
+    };
+
+    collect([&](ReportArchive& archive) { ReportSettings(archive, settingsRootPath, logsSince); });
 #ifndef _DEBUG
-    InstallationFolder::ReportStructure(reportDir);
+    collect([](ReportArchive& archive) { InstallationFolder::ReportStructure(archive); });
 #endif
-
-    // Hide sensitive information
-    HideUserPrivateInfo(reportDir);
-
-    // Write windows settings to the temporary folder
-    ReportWindowsSettings(reportDir);
-
-    // Write monitors info to the temporary folder
-    ReportMonitorInfo(reportDir);
-
-    // Write windows version info to the temporary folder
-    ReportWindowsVersion(reportDir);
-
-    // Write dotnet installation info to the temporary folder
-    ReportDotNetInstallationInfo(reportDir);
-
-    // Write registry to the temporary folder
-    ReportRegistry(reportDir);
-
-    // Write compatibility tab info to the temporary folder
-    ReportCompatibilityTab(reportDir);
-
-    // Write event viewer logs info to the temporary folder
-    EventViewer::ReportEventViewerInfo(reportDir);
-
-    ReportVCMLogs(tempDir, reportDir);
-    
-    ReportInstallerLogs(tempDir, reportDir);
-
-    // Zip folder
-    auto zipPath = path::path(saveZipPath);
-
-    try
+    collect([](ReportArchive& archive) { ReportWindowsSettings(archive); });
+    collect([](ReportArchive& archive) { ReportMonitorInfo(archive); });
+    collect([](ReportArchive& archive) { ReportWindowsVersion(archive); });
+    collect([](ReportArchive& archive) { ReportDotNetInstallationInfo(archive); });
+    collect([](ReportArchive& archive) { ReportRegistry(archive); });
+    collect([](ReportArchive& archive) { ReportCompatibilityTab(archive); });
+    collect([](ReportArchive& archive) { EventViewer::ReportEventViewerInfo(archive); });
+    collect([&](ReportArchive& archive) { ReportVCMLogs(tempDir, archive); });
+    collect([&](ReportArchive& archive) { ReportInstallerLogs(tempDir, archive); });
+
+    for (auto& collector : collectors)
     {
-        ZipFolder(zipPath, reportDir);
+        try
+        {
+            collector.get();
+        }
+        catch (...)
+        {
+            printf("Failed to collect a part of the report\n");
+        }
     }
-    catch (...)
+
+    if (!archive->Close())
     {
-        printf("Failed to zip folder\n");
-        return 1;
+        printf("Some files couldn't be added to the report\n");
     }
 
-    DeleteFolder(reportDir);
     return 0;
 }
@@ -1,6 +1,7 @@
 #include "RegistryUtils.h"
 #include <common/utils/winapi_error.h>
 #include <map>
+#include <sstream>
 
 using namespace std;
 
@@ -170,7 +171,7 @@ namespace
     }
 }
 
-void ReportCompatibilityTab(HKEY key, wofstream& report)
+void ReportCompatibilityTab(HKEY key, wostream& report)
 {
     map<wstring, wstring> flags;
     for (auto app : processes)
@@ -214,24 +215,20 @@ void ReportCompatibilityTab(HKEY key, wofstream& report)
     }
 }
 
-void ReportCompatibilityTab(const std::filesystem::path& tmpDir)
+void ReportCompatibilityTab(ReportArchive& archive)
 {
-    auto reportPath = tmpDir;
-    reportPath.append(L"compatibility-tab-info.txt");
-    wofstream report(reportPath);
+    wostringstream report;
     report << "Current user report" << endl;
     ReportCompatibilityTab(HKEY_CURRENT_USER, report);
     report << endl << endl;
     report << "Local machine report" << endl;
     ReportCompatibilityTab(HKEY_LOCAL_MACHINE, report);
+    archive.AddText(L"compatibility-tab-info.txt", report.str());
 }
 
-void ReportRegistry(const filesystem::path& tmpDir)
+void ReportRegistry(ReportArchive& archive)
 {
-    auto registryReportPath = tmpDir;
-    registryReportPath.append("registry-report-info.txt");
-
-    wofstream registryReport(registryReportPath);
+    wostringstream registryReport;
     try
     {
         for (auto [rootKey, subKey] : registryKeys)
@@ -307,4 +304,6 @@ void ReportRegistry(const filesystem::path& tmpDir)
     {
         printf("Failed to get registry keys\n");
     }
+
+    archive.AddText("registry-report-info.txt", registryReport.str());
 }
@@ -7,5 +7,7 @@
 #include <unordered_map>
 #include <Windows.h>
 
-void ReportRegistry(const std::filesystem::path& tmpDir);
-void ReportCompatibilityTab(const std::filesystem::path& tmpDir);
+#include "ZipTools/ReportArchive.h"
+
+void ReportRegistry(ReportArchive& archive);
+void ReportCompatibilityTab(ReportArchive& archive);
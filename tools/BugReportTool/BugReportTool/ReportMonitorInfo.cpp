@@ -2,6 +2,7 @@
 #include "ReportMonitorInfo.h"
 #include <Windows.h>
 #include <filesystem>
+#include <sstream>
 #include "../../../src/common/utils/winapi_error.h"
 using namespace std;
 
@@ -61,16 +62,14 @@ namespace
     }
 }
 
-void ReportMonitorInfo(const filesystem::path& tmpDir)
+void ReportMonitorInfo(ReportArchive& archive)
 {
-    auto monitorReportPath = tmpDir;
-    monitorReportPath.append("monitor-report-info.txt");
-
     try
     {
-        wofstream monitorReport(monitorReportPath);
+        wostringstream monitorReport;
         monitorReport << "GetSystemMetrics = " << GetSystemMetrics(SM_CMONITORS) << '\n';
         BuildMonitorInfoReport(monitorReport);
+        archive.AddText("monitor-report-info.txt", monitorReport.str());
     }
     catch (std::exception& ex)
     {
@@ -1,4 +1,4 @@
 #pragma once
-#include <fstream>
+#include "ZipTools/ReportArchive.h"
 
-void ReportMonitorInfo(const std::filesystem::path& tmpDir);
+void ReportMonitorInfo(ReportArchive& archive);
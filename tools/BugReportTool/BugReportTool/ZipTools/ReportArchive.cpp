@@ -0,0 +1,192 @@
+#include "ReportArchive.h"
+#include "..\..\..\..\deps\cziplib\src\zip.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <Windows.h>
+
+namespace
+{
+    // Read and compressed in pieces of this size, so large logs are never loaded whole
+    constexpr size_t FILE_BUFFER_SIZE = 1024 * 1024;
+
+    std::string ToUtf8(const std::wstring& text)
+    {
+        if (text.empty())
+        {
+            return {};
+        }
+
+        const int size = WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+        std::string result(size, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), result.data(), size, nullptr, nullptr);
+        return result;
+    }
+
+    std::string EntryName(const std::filesystem::path& name)
+    {
+        return ToUtf8(name.generic_wstring());
+    }
+}
+
+ReportArchive::ReportArchive(const std::filesystem::path& zipPath)
+{
+    m_zip = zip_open(zipPath.string().c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+    if (!m_zip)
+    {
+        throw std::runtime_error("Can not open zip");
+    }
+
+    m_writer = std::thread([this] { WriteEntries(); });
+}
+
+ReportArchive::~ReportArchive()
+{
+    Close();
+}
+
+void ReportArchive::AddText(const std::filesystem::path& name, std::string text)
+{
+    Add({ EntryName(name), std::move(text) });
+}
+
+void ReportArchive::AddText(const std::filesystem::path& name, const std::wstring& text)
+{
+    AddText(name, ToUtf8(text));
+}
+
+void ReportArchive::AddFile(const std::filesystem::path& name, const std::filesystem::path& source, Transform transform)
+{
+    Add({ EntryName(name), source, std::move(transform) });
+}
+
+bool ReportArchive::Close()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_closing = true;
+    }
+
+    m_added.notify_all();
+    if (m_writer.joinable())
+    {
+        m_writer.join();
+
+        // Reported once the writer is done, so it's not interleaved with the output of the collectors
+        for (const auto& name : m_failedEntries)
+        {
+            printf("Failed to archive %s\n", name.c_str());
+        }
+    }
+
+    if (m_zip)
+    {
+        zip_close(m_zip);
+        m_zip = nullptr;
+    }
+
+    return m_failedEntries.empty();
+}
+
+void ReportArchive::Add(Entry entry)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_closing)
+        {
+            return;
+        }
+
+        m_entries.push_back(std::move(entry));
+    }
+
+    m_added.notify_one();
+}
+
+void ReportArchive::WriteEntries()
+{
+    for (;;)
+    {
+        Entry entry;
+        {
+            std::unique_lock lock(m_mutex);
+            m_added.wait(lock, [this] { return m_closing || !m_entries.empty(); });
+            if (m_entries.empty())
+            {
+                return;
+            }
+
+            entry = std::move(m_entries.front());
+            m_entries.pop_front();
+        }
+
+        if (!WriteEntry(entry))
+        {
+            m_failedEntries.push_back(std::move(entry.name));
+        }
+    }
+}
+
+bool ReportArchive::WriteEntry(Entry& entry)
+{
+    std::string* text = std::get_if<std::string>(&entry.content);
+    std::ifstream file;
+    std::string transformed;
+    if (!text)
+    {
+        // Opened first, so a file that can't be read doesn't leave an empty entry
+        file.open(std::get<std::filesystem::path>(entry.content), std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        if (entry.transform)
+        {
+            // Files that are rewritten are small settings files, they're read whole
+            std::string content{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+            try
+            {
+                transformed = entry.transform(std::move(content));
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            text = &transformed;
+        }
+    }
+
+    if (zip_entry_open(m_zip, entry.name.c_str()) != 0)
+    {
+        return false;
+    }
+
+    const bool written = text ? zip_entry_write(m_zip, text->data(), text->size()) == 0 : WriteFile(file);
+    return zip_entry_close(m_zip) == 0 && written;
+}
+
+bool ReportArchive::WriteFile(std::ifstream& file)
+{
+    std::vector<char> buffer(FILE_BUFFER_SIZE);
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        const auto read = static_cast<size_t>(file.gcount());
+        if (read == 0)
+        {
+            break;
+        }
+
+        if (zip_entry_write(m_zip, buffer.data(), read) != 0)
+        {
+            return false;
+        }
+    }
+
+    return !file.bad();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+struct zip_t;
+
+// Zip archive that the report is written into while it's being collected. Collectors add entries from any
+// thread and a single writer thread compresses them, in the order they were added. Files are read from
+// disk while they're compressed, so nothing is copied to a temporary folder first.
+class ReportArchive
+{
+public:
+    // Rewrites the content of a file before it's archived, e.g. to hide private data
+    using Transform = std::function<std::string(std::string)>;
+
+    // Throws if the archive can't be created
+    explicit ReportArchive(const std::filesystem::path& zipPath);
+    ~ReportArchive();
+
+    ReportArchive(const ReportArchive&) = delete;
+    ReportArchive& operator=(const ReportArchive&) = delete;
+
+    void AddText(const std::filesystem::path& name, std::string text);
+    // Stored as UTF-8
+    void AddText(const std::filesystem::path& name, const std::wstring& text);
+    void AddFile(const std::filesystem::path& name, const std::filesystem::path& source, Transform transform = {});
+
+    // Writes the remaining entries and finishes the archive. Returns false if an entry couldn't be written.
+    bool Close();
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::variant<std::string, std::filesystem::path> content;
+        Transform transform;
+    };
+
+    void Add(Entry entry);
+    void WriteEntries();
+    bool WriteEntry(Entry& entry);
+    bool WriteFile(std::ifstream& file);
+
+    zip_t* m_zip = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_added;
+    std::deque<Entry> m_entries;
+    bool m_closing = false;
+    // Only touched by the writer thread until it's joined
+    std::vector<std::string> m_failedEntries;
+    std::thread m_writer;
+};
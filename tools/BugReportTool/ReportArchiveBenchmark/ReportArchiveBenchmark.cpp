@@ -0,0 +1,155 @@
+// Compares the two ways BugReportTool has built its zip on a synthetic log tree: copying the settings
+// folder to a temporary report folder and zipping that, or streaming the files straight into the archive.
+//
+// Usage: PowerToys.ReportArchiveBenchmark.exe [size in MB, 1024 by default] [work folder]
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "../BugReportTool/ZipTools/ReportArchive.h"
+#include "../BugReportTool/ZipTools/ZipFolder.h"
+
+using namespace std;
+using namespace std::filesystem;
+
+namespace
+{
+    constexpr uint64_t MB = 1024 * 1024;
+    constexpr uint64_t LOG_FILE_SIZE = 16 * MB;
+
+    const char* modules[] = { "FancyZones", "PowerToys Run", "Keyboard Manager", "ColorPicker", "PowerRename", "Image Resizer", "Awake", "runner" };
+    const char* levels[] = { "trace", "debug", "info", "warning", "error" };
+
+    // Log lines with timestamps, levels and varying messages, so they compress like real logs
+    void WriteLog(const path& file, uint64_t bytes, mt19937& random)
+    {
+        ofstream log(file, ios::binary);
+        uint64_t written = 0;
+        uint64_t line = 0;
+        char buffer[256];
+        auto next = [&random](unsigned range) { return static_cast<unsigned>(random() % range); };
+        while (written < bytes)
+        {
+            const int length = snprintf(buffer, sizeof(buffer), "[2022-07-%02u %02u:%02u:%02u.%06u] [p-%u] [t-%u] [%s] Handled message %u for window 0x%08x in %u us\n", 1 + next(28), next(24), next(60), next(60), next(1000000), 1000 + next(8), 2000 + next(64), levels[next(static_cast<unsigned>(size(levels)))], static_cast<unsigned>(line++), next(0xffffffffu), next(5000));
+            log.write(buffer, length);
+            written += length;
+        }
+    }
+
+    uint64_t TreeSize(const path& root)
+    {
+        uint64_t size = 0;
+        for (const auto& entry : recursive_directory_iterator(root))
+        {
+            if (entry.is_regular_file())
+            {
+                size += entry.file_size();
+            }
+        }
+
+        return size;
+    }
+
+    void GenerateTree(const path& root, uint64_t bytes)
+    {
+        if (exists(root) && TreeSize(root) >= bytes)
+        {
+            return;
+        }
+
+        printf("Generating a %llu MB log tree in %ls\n", bytes / MB, root.c_str());
+        remove_all(root);
+        mt19937 random{ 42 };
+        uint64_t generated = 0;
+        for (size_t file = 0; generated < bytes; file++)
+        {
+            const auto folder = root / modules[file % size(modules)] / "Logs" / ("v0.60." + to_string(file / size(modules) % 4));
+            create_directories(folder);
+            const uint64_t fileSize = min(LOG_FILE_SIZE, bytes - generated);
+            WriteLog(folder / ("log_" + to_string(file) + ".txt"), fileSize, random);
+            generated += fileSize;
+        }
+
+        ofstream(root / "settings.json") << R"({"enabled":{"FancyZones":true,"PowerToys Run":true}})";
+    }
+
+    double SecondsSince(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    uint64_t ZipSize(const path& folder)
+    {
+        uint64_t size = 0;
+        for (const auto& entry : directory_iterator(folder))
+        {
+            if (entry.path().extension() == ".zip")
+            {
+                size += entry.file_size();
+            }
+        }
+
+        return size;
+    }
+
+    void Print(const char* name, double seconds, uint64_t treeSize, uint64_t bytesRead, uint64_t bytesWritten, uint64_t peakDisk)
+    {
+        printf("%-10s %8.2f s %8.1f MB/s %10llu MB read %10llu MB written %10llu MB peak disk\n", name, seconds, treeSize / MB / seconds, bytesRead / MB, bytesWritten / MB, peakDisk / MB);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const uint64_t treeBytes = (argc > 1 ? stoull(argv[1]) : 1024) * MB;
+    const path work = argc > 2 ? path{ argv[2] } : temp_directory_path() / "PowerToysReportArchiveBenchmark";
+    const auto tree = work / "Settings";
+    const auto output = work / "Output";
+
+    GenerateTree(tree, treeBytes);
+    const uint64_t treeSize = TreeSize(tree);
+
+    // Copy, then zip the copy
+    remove_all(output);
+    create_directories(output);
+    auto start = chrono::steady_clock::now();
+    const auto reportDir = work / "Report";
+    remove_all(reportDir);
+    copy(tree, reportDir, copy_options::recursive);
+    ZipFolder(output, reportDir);
+    remove_all(reportDir);
+    const double copySeconds = SecondsSince(start);
+    const uint64_t copyZipSize = ZipSize(output);
+    // The copy is read again to be zipped, and the zip is written to the temporary folder before being copied
+    Print("copy+zip", copySeconds, treeSize, 2 * treeSize + copyZipSize, treeSize + 2 * copyZipSize, treeSize + 2 * copyZipSize);
+
+    // Stream into the archive
+    remove_all(output);
+    create_directories(output);
+    start = chrono::steady_clock::now();
+    {
+        ReportArchive archive{ output / "PowerToysReport.zip" };
+        for (const auto& entry : recursive_directory_iterator(tree))
+        {
+            if (entry.is_regular_file())
+            {
+                archive.AddFile(entry.path().lexically_relative(tree), entry.path());
+            }
+        }
+
+        if (!archive.Close())
+        {
+            printf("Failed to write the archive\n");
+            return 1;
+        }
+    }
+    const double streamSeconds = SecondsSince(start);
+    const uint64_t streamZipSize = ZipSize(output);
+    Print("streaming", streamSeconds, treeSize, treeSize, streamZipSize, streamZipSize);
+
+    remove_all(output);
+    return 0;
+}